@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "ArrowExporter.hpp"
+#include "ArrowWriter.hpp"
+#include "BoundingBox.hpp"
+#include "CfbfStreamLocation.hpp"
+#include "Database.hpp"
+#include "Enums/Color.hpp"
+#include "Enums/LineStyle.hpp"
+#include "Enums/LineWidth.hpp"
+#include "Enums/PortType.hpp"
+#include "Enums/Primitive.hpp"
+#include "OutputSink.hpp"
+#include "ParallelFor.hpp"
+#include "PinTable.hpp"
+#include "Primitives/PrimBase.hpp"
+#include "Stream.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Structures/StructDevice.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+#include "Structures/StructSymbolPin.hpp"
+#include "Structures/StructWire.hpp"
+#include "Structures/StructWireBus.hpp"
+
+namespace
+{
+// Number of streams converted into one record batch
+constexpr std::size_t StreamsPerBatch = 256U;
+
+// Index into `ArrowExporter::getTables()`
+enum TableIdx : std::size_t
+{
+    Packages,
+    Pins,
+    Primitives,
+    Instances,
+    Wires,
+    Properties,
+    TableCount
+};
+
+int32_t toDegree(OOCP::Rotation aRotation)
+{
+    return 90 * static_cast<int32_t>(aRotation);
+}
+
+void addPackage(std::vector<OOCP::ArrowBatch>& aBatches, const std::string& aLibrary, const OOCP::StreamPackage& aPkg)
+{
+    if(!aPkg.package)
+    {
+        return;
+    }
+
+    const OOCP::StructPackage& package = *aPkg.package;
+
+    aBatches[Packages].addRow(aLibrary, package.name, package.refDes, package.pcbFootprint, package.devices.size(),
+        aPkg.libraryParts.size());
+
+    aBatches[Properties].addRow(aLibrary, "Package", package.name, "Reference", package.refDes);
+    aBatches[Properties].addRow(aLibrary, "Package", package.name, "PCB Footprint", package.pcbFootprint);
+
+    for(const auto& libraryPart : aPkg.libraryParts)
+    {
+        if(!libraryPart)
+        {
+            continue;
+        }
+
+        const auto& props = libraryPart->generalProperties;
+
+        aBatches[Properties].addRow(aLibrary, "View", libraryPart->name, "Implementation", props.implementation);
+        aBatches[Properties].addRow(
+            aLibrary, "View", libraryPart->name, "Implementation Path", props.implementationPath);
+        aBatches[Properties].addRow(aLibrary, "View", libraryPart->name, "Reference", props.refDes);
+        aBatches[Properties].addRow(aLibrary, "View", libraryPart->name, "Value", props.partValue);
+
+        for(std::size_t i = 0U; i < libraryPart->primitives.size(); ++i)
+        {
+            const auto& primitive = libraryPart->primitives[i];
+
+            if(!primitive)
+            {
+                continue;
+            }
+
+            OOCP::BoundingBox bbox = OOCP::getBoundingBox(*primitive);
+
+            if(bbox.isEmpty())
+            {
+                bbox = OOCP::BoundingBox{0, 0, 0, 0};
+            }
+
+            aBatches[Primitives].addRow(aLibrary, package.name, libraryPart->name, i,
+                OOCP::to_string(primitive->getObjectType()), bbox.x1, bbox.y1, bbox.x2, bbox.y2);
+        }
+    }
+
+    // Pins are exported per unit s.t. each row carries its pin number
+    const auto unitViews = OOCP::PinTable::getUnitViews(aPkg);
+
+    const bool isHomogeneous = unitViews.size() == 1U;
+
+    const std::size_t unitCount = isHomogeneous ? std::max<std::size_t>(package.devices.size(), 1U) : unitViews.size();
+
+    for(std::size_t unit = 0U; unit < unitCount; ++unit)
+    {
+        const OOCP::StructLibraryPart& view = *unitViews[isHomogeneous ? 0U : unit].normalView;
+
+        const OOCP::StructDevice* device = unit < package.devices.size() ? package.devices[unit].get() : nullptr;
+
+        for(std::size_t position = 0U; position < view.symbolPins.size(); ++position)
+        {
+            const auto& pin = view.symbolPins[position];
+
+            if(!pin)
+            {
+                continue;
+            }
+
+            const bool isMapped = device && position < device->pinMap.size();
+            const bool isIgnored = device && position < device->pinIgnore.size() && device->pinIgnore[position];
+
+            aBatches[Pins].addRow(aLibrary, package.name, unit + 1U, view.name, position, pin->name,
+                isMapped ? device->pinMap[position] : std::string{}, OOCP::to_string(pin->portType), pin->startX,
+                pin->startY, pin->hotptX, pin->hotptY, isIgnored);
+        }
+    }
+}
+
+void addPage(std::vector<OOCP::ArrowBatch>& aBatches, const std::string& aLibrary, const OOCP::StreamPage& aPage)
+{
+    // Location is `Views/<Schematic>/Pages/<Page>`
+    const auto& location = aPage.mCtx.mCfbfStreamLocation.get_vector();
+
+    const std::string schematic = location.size() > 1U ? location.at(1U) : std::string{};
+
+    for(const auto& inst : aPage.placedInstances)
+    {
+        if(!inst)
+        {
+            continue;
+        }
+
+        aBatches[Instances].addRow(aLibrary, schematic, aPage.name, inst->dbId, inst->reference, inst->pkgName,
+            inst->locX, inst->locY, toDegree(inst->rotation), inst->mirrored);
+    }
+
+    for(const auto& wire : aPage.wires)
+    {
+        if(!wire)
+        {
+            continue;
+        }
+
+        const bool isBus = dynamic_cast<const OOCP::StructWireBus*>(wire.get()) != nullptr;
+
+        aBatches[Wires].addRow(aLibrary, schematic, aPage.name, wire->id, isBus, wire->startX, wire->startY,
+            wire->endX, wire->endY, OOCP::to_string(wire->lineStyle), OOCP::to_string(wire->lineWidth),
+            OOCP::to_string(wire->color));
+    }
+}
+} // namespace
+
+const std::vector<OOCP::ArrowExporter::Table>& OOCP::ArrowExporter::getTables()
+{
+    static const std::vector<Table> tables = {
+        {"packages",
+            {
+                {"library", ArrowType::String},
+                {"package", ArrowType::String},
+                {"refDes", ArrowType::String},
+                {"pcbFootprint", ArrowType::String},
+                {"deviceCount", ArrowType::Int32},
+                {"viewCount", ArrowType::Int32},
+            }},
+        {"pins",
+            {
+                {"library", ArrowType::String},
+                {"package", ArrowType::String},
+                {"unit", ArrowType::Int32},
+                {"view", ArrowType::String},
+                {"position", ArrowType::Int32},
+                {"name", ArrowType::String},
+                {"number", ArrowType::String},
+                {"portType", ArrowType::String},
+                {"startX", ArrowType::Int32},
+                {"startY", ArrowType::Int32},
+                {"hotptX", ArrowType::Int32},
+                {"hotptY", ArrowType::Int32},
+                {"ignored", ArrowType::Bool},
+            }},
+        {"primitives",
+            {
+                {"library", ArrowType::String},
+                {"package", ArrowType::String},
+                {"view", ArrowType::String},
+                {"index", ArrowType::Int32},
+                {"type", ArrowType::String},
+                {"minX", ArrowType::Int32},
+                {"minY", ArrowType::Int32},
+                {"maxX", ArrowType::Int32},
+                {"maxY", ArrowType::Int32},
+            }},
+        {"instances",
+            {
+                {"library", ArrowType::String},
+                {"schematic", ArrowType::String},
+                {"page", ArrowType::String},
+                {"dbId", ArrowType::Int64},
+                {"reference", ArrowType::String},
+                {"package", ArrowType::String},
+                {"locX", ArrowType::Int32},
+                {"locY", ArrowType::Int32},
+                {"rotation", ArrowType::Int32},
+                {"mirrored", ArrowType::Bool},
+            }},
+        {"wires",
+            {
+                {"library", ArrowType::String},
+                {"schematic", ArrowType::String},
+                {"page", ArrowType::String},
+                {"id", ArrowType::Int64},
+                {"bus", ArrowType::Bool},
+                {"startX", ArrowType::Int32},
+                {"startY", ArrowType::Int32},
+                {"endX", ArrowType::Int32},
+                {"endY", ArrowType::Int32},
+                {"lineStyle", ArrowType::String},
+                {"lineWidth", ArrowType::String},
+                {"color", ArrowType::String},
+            }},
+        {"properties",
+            {
+                {"library", ArrowType::String},
+                {"owner", ArrowType::String},
+                {"ownerName", ArrowType::String},
+                {"name", ArrowType::String},
+                {"value", ArrowType::String},
+            }},
+    };
+
+    return tables;
+}
+
+std::vector<fs::path> OOCP::ArrowExporter::exportTables(const fs::path& aOutDir)
+{
+    const auto& tables = getTables();
+
+    const std::string library = mCtx.mInputCfbfFile.filename().string();
+
+    // Sort for reproducible output, streams are stored in order of completion
+    std::vector<const Stream*> streams;
+
+    for(const auto& stream : mCtx.mDb.mStreams)
+    {
+        if(stream)
+        {
+            streams.push_back(stream.get());
+        }
+    }
+
+    std::sort(streams.begin(), streams.end(),
+        [](const Stream* aLhs, const Stream* aRhs)
+        { return aLhs->mCtx.mCfbfStreamLocation.get_vector() < aRhs->mCtx.mCfbfStreamLocation.get_vector(); });
+
+    const std::size_t batchCount = (streams.size() + StreamsPerBatch - 1U) / StreamsPerBatch;
+
+    std::vector<std::vector<ArrowBatch>> batches(batchCount);
+
+    parallelFor(mCtx.mCfg.mThreadCount, batchCount,
+        [&](std::size_t aIdx)
+        {
+            auto& tableBatches = batches[aIdx];
+
+            for(const auto& table : tables)
+            {
+                tableBatches.emplace_back(table.schema);
+            }
+
+            const std::size_t end = std::min(streams.size(), (aIdx + 1U) * StreamsPerBatch);
+
+            for(std::size_t i = aIdx * StreamsPerBatch; i < end; ++i)
+            {
+                if(const auto* package = dynamic_cast<const StreamPackage*>(streams[i]))
+                {
+                    addPackage(tableBatches, library, *package);
+                }
+                else if(const auto* page = dynamic_cast<const StreamPage*>(streams[i]))
+                {
+                    addPage(tableBatches, library, *page);
+                }
+            }
+        });
+
+    fs::create_directories(aOutDir);
+
+    std::vector<fs::path> paths;
+
+    for(std::size_t i = 0U; i < TableCount; ++i)
+    {
+        const fs::path path = aOutDir / fmt::format("{}_{}.arrow", mCtx.mInputCfbfFile.stem().string(), tables[i].name);
+
+        OutputSink sink{path};
+
+        ArrowFileWriter writer{sink.getStream(), tables[i].schema};
+
+        for(auto& tableBatches : batches)
+        {
+            writer.addBatch(std::move(tableBatches[i]));
+        }
+
+        writer.finish();
+        sink.close();
+
+        mCtx.mLogger.debug("{}: Wrote {} rows to {}", __func__, writer.getRowCount(), path.string());
+
+        paths.push_back(path);
+    }
+
+    return paths;
+}
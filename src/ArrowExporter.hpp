@@ -0,0 +1,54 @@
+#ifndef ARROWEXPORTER_HPP
+#define ARROWEXPORTER_HPP
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "ArrowWriter.hpp"
+#include "ContainerContext.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+/**
+ * @brief Exports the parsed database as Arrow IPC files (Feather v2) for analytics.
+ *
+ * @note Writes one file per table: packages, pins, primitives, instances, wires
+ *       and properties. All tables contain a `library` column with the input
+ *       file name s.t. files of many libraries can be queried together. Streams
+ *       are converted into record batches in parallel.
+ */
+class ArrowExporter
+{
+public:
+    struct Table
+    {
+        std::string name;
+        ArrowSchema schema;
+    };
+
+    ArrowExporter(ContainerContext& aCtx)
+        : mCtx{aCtx}
+    {
+    }
+
+    /**
+     * @brief Export all tables.
+     *
+     * @param aOutDir Output directory.
+     * @return std::vector<fs::path> Paths to the table files, named `<input stem>_<table>.arrow`.
+     */
+    std::vector<fs::path> exportTables(const fs::path& aOutDir);
+
+    /**
+     * @brief Tables in the order they are exported.
+     */
+    static const std::vector<Table>& getTables();
+
+private:
+    ContainerContext& mCtx;
+};
+} // namespace OOCP
+#endif // ARROWEXPORTER_HPP
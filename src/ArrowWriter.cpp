@@ -0,0 +1,657 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "ArrowWriter.hpp"
+
+namespace
+{
+// Minimal FlatBuffers serialization for the Arrow metadata, see
+// https://flatbuffers.dev/internals/ and Arrow's Schema.fbs, Message.fbs and File.fbs
+
+struct FbObject;
+
+using FbRef = std::shared_ptr<const FbObject>;
+
+struct FbField
+{
+    uint16_t id;
+    std::size_t size; //!< Size of the scalar, 0 for offsets to child objects
+    uint64_t bits;
+    FbRef child;
+};
+
+struct FbObject
+{
+    enum class Kind
+    {
+        Table,
+        String,
+        Vector,
+        StructVector
+    };
+
+    Kind kind;
+
+    std::vector<FbField> fields; //!< Table fields
+    std::string bytes;           //!< String or inline struct data
+    std::vector<FbRef> elements; //!< Vector of tables
+    std::size_t count;           //!< Number of structs
+};
+
+class FbTable
+{
+public:
+    template <typename T> FbTable& add(uint16_t aId, T aVal)
+    {
+        static_assert(std::is_arithmetic_v<T> && sizeof(T) <= sizeof(uint64_t));
+
+        FbField field{aId, sizeof(T), 0U, nullptr};
+        std::memcpy(&field.bits, &aVal, sizeof(T));
+
+        mObject.fields.push_back(std::move(field));
+
+        return *this;
+    }
+
+    FbTable& add(uint16_t aId, FbRef aChild)
+    {
+        mObject.fields.push_back(FbField{aId, 0U, 0U, std::move(aChild)});
+
+        return *this;
+    }
+
+    FbRef build() const
+    {
+        return std::make_shared<const FbObject>(mObject);
+    }
+
+private:
+    FbObject mObject{FbObject::Kind::Table, {}, {}, {}, 0U};
+};
+
+FbRef fbString(std::string_view aStr)
+{
+    return std::make_shared<const FbObject>(FbObject{FbObject::Kind::String, {}, std::string{aStr}, {}, 0U});
+}
+
+FbRef fbVector(std::vector<FbRef> aElements)
+{
+    return std::make_shared<const FbObject>(FbObject{FbObject::Kind::Vector, {}, {}, std::move(aElements), 0U});
+}
+
+template <typename T> FbRef fbStructVector(const std::vector<T>& aStructs)
+{
+    static_assert(std::is_trivially_copyable_v<T> && alignof(T) == 8U);
+
+    std::string bytes(aStructs.size() * sizeof(T), '\0');
+
+    if(!aStructs.empty())
+    {
+        std::memcpy(bytes.data(), aStructs.data(), bytes.size());
+    }
+
+    return std::make_shared<const FbObject>(
+        FbObject{FbObject::Kind::StructVector, {}, std::move(bytes), {}, aStructs.size()});
+}
+
+/**
+ * @brief Writes objects front to back, children are placed behind their parent
+ *        s.t. all offsets point forward as required by the format. vtables are
+ *        placed directly in front of their table.
+ */
+class FbSerializer
+{
+public:
+    std::string finish(const FbObject& aRoot)
+    {
+        mBuf.clear();
+
+        put<uint32_t>(0U);
+        patch<uint32_t>(0U, static_cast<uint32_t>(write(aRoot)));
+
+        pad(8U);
+
+        return std::move(mBuf);
+    }
+
+private:
+    void pad(std::size_t aAlign)
+    {
+        mBuf.resize((mBuf.size() + aAlign - 1U) / aAlign * aAlign, '\0');
+    }
+
+    template <typename T> void put(T aVal)
+    {
+        const std::size_t pos = mBuf.size();
+
+        mBuf.resize(pos + sizeof(T));
+        std::memcpy(mBuf.data() + pos, &aVal, sizeof(T));
+    }
+
+    template <typename T> void patch(std::size_t aPos, T aVal)
+    {
+        std::memcpy(mBuf.data() + aPos, &aVal, sizeof(T));
+    }
+
+    void patchOffset(std::size_t aPos, std::size_t aTarget)
+    {
+        patch<uint32_t>(aPos, static_cast<uint32_t>(aTarget - aPos));
+    }
+
+    std::size_t write(const FbObject& aObj)
+    {
+        switch(aObj.kind)
+        {
+            case FbObject::Kind::Table:        return writeTable(aObj);
+            case FbObject::Kind::String:       return writeString(aObj);
+            case FbObject::Kind::Vector:       return writeVector(aObj);
+            case FbObject::Kind::StructVector: return writeStructVector(aObj);
+            default:                           break;
+        }
+
+        throw std::logic_error("FbSerializer: Unknown object kind");
+    }
+
+    std::size_t writeTable(const FbObject& aObj)
+    {
+        // Place large fields first to reduce padding
+        std::vector<const FbField*> fields;
+
+        for(const auto& field : aObj.fields)
+        {
+            fields.push_back(&field);
+        }
+
+        const auto getSize = [](const FbField* aField) { return aField->size > 0U ? aField->size : 4U; };
+
+        std::stable_sort(fields.begin(), fields.end(),
+            [&getSize](const FbField* aLhs, const FbField* aRhs) { return getSize(aLhs) > getSize(aRhs); });
+
+        // Table starts with the soffset to its vtable
+        std::size_t inlineSize = 4U;
+        std::size_t maxAlign   = 4U;
+        uint16_t fieldCount    = 0U;
+
+        std::vector<std::size_t> fieldOffsets;
+
+        for(const FbField* field : fields)
+        {
+            const std::size_t size = getSize(field);
+
+            inlineSize = (inlineSize + size - 1U) / size * size;
+            fieldOffsets.push_back(inlineSize);
+            inlineSize += size;
+
+            maxAlign   = std::max(maxAlign, size);
+            fieldCount = std::max<uint16_t>(fieldCount, field->id + 1U);
+        }
+
+        std::vector<uint16_t> vtable(fieldCount, 0U);
+
+        for(std::size_t i = 0U; i < fields.size(); ++i)
+        {
+            vtable[fields[i]->id] = static_cast<uint16_t>(fieldOffsets[i]);
+        }
+
+        pad(2U);
+
+        const std::size_t vtablePos = mBuf.size();
+
+        put<uint16_t>(static_cast<uint16_t>(4U + 2U * fieldCount));
+        put<uint16_t>(static_cast<uint16_t>(inlineSize));
+
+        for(const uint16_t offset : vtable)
+        {
+            put<uint16_t>(offset);
+        }
+
+        pad(maxAlign);
+
+        const std::size_t tablePos = mBuf.size();
+
+        mBuf.resize(tablePos + inlineSize, '\0');
+        patch<int32_t>(tablePos, static_cast<int32_t>(tablePos - vtablePos));
+
+        for(std::size_t i = 0U; i < fields.size(); ++i)
+        {
+            if(fields[i]->size > 0U)
+            {
+                std::memcpy(mBuf.data() + tablePos + fieldOffsets[i], &fields[i]->bits, fields[i]->size);
+            }
+        }
+
+        for(std::size_t i = 0U; i < fields.size(); ++i)
+        {
+            if(fields[i]->size == 0U)
+            {
+                const std::size_t childPos = write(*fields[i]->child);
+
+                patchOffset(tablePos + fieldOffsets[i], childPos);
+            }
+        }
+
+        return tablePos;
+    }
+
+    std::size_t writeString(const FbObject& aObj)
+    {
+        pad(4U);
+
+        const std::size_t pos = mBuf.size();
+
+        put<uint32_t>(static_cast<uint32_t>(aObj.bytes.size()));
+        mBuf += aObj.bytes;
+        mBuf += '\0';
+
+        return pos;
+    }
+
+    std::size_t writeVector(const FbObject& aObj)
+    {
+        pad(4U);
+
+        const std::size_t pos = mBuf.size();
+
+        put<uint32_t>(static_cast<uint32_t>(aObj.elements.size()));
+
+        const std::size_t slotPos = mBuf.size();
+
+        mBuf.resize(slotPos + 4U * aObj.elements.size(), '\0');
+
+        for(std::size_t i = 0U; i < aObj.elements.size(); ++i)
+        {
+            const std::size_t childPos = write(*aObj.elements[i]);
+
+            patchOffset(slotPos + 4U * i, childPos);
+        }
+
+        return pos;
+    }
+
+    std::size_t writeStructVector(const FbObject& aObj)
+    {
+        // Structs following the length prefix are 8 byte aligned
+        while((mBuf.size() + 4U) % 8U != 0U)
+        {
+            mBuf += '\0';
+        }
+
+        const std::size_t pos = mBuf.size();
+
+        put<uint32_t>(static_cast<uint32_t>(aObj.count));
+        mBuf += aObj.bytes;
+
+        return pos;
+    }
+
+    std::string mBuf;
+};
+
+// Structs from Message.fbs and File.fbs
+
+struct FieldNode
+{
+    int64_t length;
+    int64_t nullCount;
+};
+
+struct Buffer
+{
+    int64_t offset;
+    int64_t length;
+};
+
+struct Block
+{
+    int64_t offset;
+    int32_t metaDataLength;
+    int32_t padding;
+    int64_t bodyLength;
+};
+
+static_assert(sizeof(FieldNode) == 16U && sizeof(Buffer) == 16U && sizeof(Block) == 24U);
+
+// Enumerations from Schema.fbs and Message.fbs
+constexpr int16_t MetadataVersionV5 = 4;
+
+constexpr uint8_t TypeInt           = 2U;
+constexpr uint8_t TypeFloatingPoint = 3U;
+constexpr uint8_t TypeUtf8          = 5U;
+constexpr uint8_t TypeBool          = 6U;
+
+constexpr int16_t PrecisionDouble = 2;
+
+constexpr uint8_t HeaderSchema          = 1U;
+constexpr uint8_t HeaderDictionaryBatch = 2U;
+constexpr uint8_t HeaderRecordBatch     = 3U;
+
+constexpr std::string_view Magic = "ARROW1";
+
+constexpr uint32_t ContinuationMarker = 0xffffffffU;
+
+/**
+ * @brief Body of a record batch, buffers are 8 byte aligned.
+ */
+struct Body
+{
+    std::string data;
+    std::vector<FieldNode> nodes;
+    std::vector<Buffer> buffers;
+
+    void addBuffer(const void* aData, std::size_t aSize)
+    {
+        buffers.push_back(Buffer{static_cast<int64_t>(data.size()), static_cast<int64_t>(aSize)});
+
+        if(aSize > 0U)
+        {
+            data.append(static_cast<const char*>(aData), aSize);
+        }
+
+        data.resize((data.size() + 7U) / 8U * 8U, '\0');
+    }
+
+    void addStrings(const std::vector<std::string>& aStrings)
+    {
+        std::vector<int32_t> offsets{0};
+        std::string values;
+
+        for(const auto& str : aStrings)
+        {
+            values += str;
+            offsets.push_back(static_cast<int32_t>(values.size()));
+        }
+
+        nodes.push_back(FieldNode{static_cast<int64_t>(aStrings.size()), 0});
+
+        addBuffer(nullptr, 0U); // Validity, all valid
+        addBuffer(offsets.data(), offsets.size() * sizeof(int32_t));
+        addBuffer(values.data(), values.size());
+    }
+};
+
+FbRef makeIntType(int32_t aBitWidth)
+{
+    return FbTable{}.add<int32_t>(0U, aBitWidth).add<bool>(1U, true).build();
+}
+
+FbRef makeSchema(const OOCP::ArrowSchema& aSchema)
+{
+    std::vector<FbRef> fields;
+
+    for(std::size_t i = 0U; i < aSchema.size(); ++i)
+    {
+        const auto& field = aSchema[i];
+
+        FbTable table;
+
+        table.add(0U, fbString(field.name));
+        table.add<bool>(1U, false);
+
+        switch(field.type)
+        {
+            case OOCP::ArrowType::Bool:
+                table.add<uint8_t>(2U, TypeBool).add(3U, FbTable{}.build());
+                break;
+
+            case OOCP::ArrowType::Int32:
+                table.add<uint8_t>(2U, TypeInt).add(3U, makeIntType(32));
+                break;
+
+            case OOCP::ArrowType::Int64:
+                table.add<uint8_t>(2U, TypeInt).add(3U, makeIntType(64));
+                break;
+
+            case OOCP::ArrowType::Float64:
+                table.add<uint8_t>(2U, TypeFloatingPoint)
+                    .add(3U, FbTable{}.add<int16_t>(0U, PrecisionDouble).build());
+                break;
+
+            case OOCP::ArrowType::String:
+                // Dictionary id equals the column index
+                table.add<uint8_t>(2U, TypeUtf8).add(3U, FbTable{}.build());
+                table.add(4U, FbTable{}
+                                  .add<int64_t>(0U, static_cast<int64_t>(i))
+                                  .add(1U, makeIntType(32))
+                                  .add<bool>(2U, false)
+                                  .build());
+                break;
+
+            default: throw std::logic_error("ArrowFileWriter: Unknown column type");
+        }
+
+        // Readers reject fields without children vector
+        table.add(5U, fbVector({}));
+
+        fields.push_back(table.build());
+    }
+
+    return FbTable{}.add<int16_t>(0U, 0).add(1U, fbVector(std::move(fields))).build();
+}
+
+FbRef makeRecordBatch(int64_t aLength, const Body& aBody)
+{
+    return FbTable{}
+        .add<int64_t>(0U, aLength)
+        .add(1U, fbStructVector(aBody.nodes))
+        .add(2U, fbStructVector(aBody.buffers))
+        .build();
+}
+} // namespace
+
+OOCP::ArrowFileWriter::ArrowFileWriter(std::ostream& aStream, ArrowSchema aSchema)
+    : mSchema{std::move(aSchema)},
+      mStream{aStream},
+      mBatches{},
+      mDictionaries(mSchema.size()),
+      mLookups(mSchema.size()),
+      mRowCount{0U},
+      mFinished{false}
+{
+}
+
+void OOCP::ArrowFileWriter::addBatch(ArrowBatch&& aBatch)
+{
+    if(mFinished)
+    {
+        throw std::logic_error("ArrowFileWriter: Batch added after finish");
+    }
+
+    if(aBatch.mColumns.size() != mSchema.size())
+    {
+        throw std::logic_error("ArrowFileWriter: Batch does not match the schema");
+    }
+
+    if(aBatch.getRowCount() == 0U)
+    {
+        return;
+    }
+
+    for(std::size_t i = 0U; i < mSchema.size(); ++i)
+    {
+        auto& column = aBatch.mColumns[i];
+
+        if(column.type != ArrowType::String)
+        {
+            continue;
+        }
+
+        // Remap batch local indices, only unique strings are looked up
+        std::vector<int32_t> remap;
+        remap.reserve(column.dictionary.size());
+
+        for(auto& str : column.dictionary)
+        {
+            const auto [it, inserted] = mLookups[i].try_emplace(str, static_cast<int32_t>(mDictionaries[i].size()));
+
+            if(inserted)
+            {
+                mDictionaries[i].push_back(std::move(str));
+            }
+
+            remap.push_back(it->second);
+        }
+
+        for(auto& index : column.indices)
+        {
+            index = remap[index];
+        }
+
+        column.dictionary.clear();
+        column.lookup.clear();
+    }
+
+    mRowCount += aBatch.getRowCount();
+
+    mBatches.push_back(std::move(aBatch));
+}
+
+void OOCP::ArrowFileWriter::finish()
+{
+    if(mFinished)
+    {
+        throw std::logic_error("ArrowFileWriter: Finished twice");
+    }
+
+    mFinished = true;
+
+    int64_t offset = 0;
+
+    const auto writeRaw = [&](const void* aData, std::size_t aSize)
+    {
+        mStream.write(static_cast<const char*>(aData), static_cast<std::streamsize>(aSize));
+        offset += static_cast<int64_t>(aSize);
+    };
+
+    const auto writeMessage = [&](uint8_t aHeaderType, FbRef aHeader, const std::string& aBody)
+    {
+        const FbRef message = FbTable{}
+                                  .add<int16_t>(0U, MetadataVersionV5)
+                                  .add<uint8_t>(1U, aHeaderType)
+                                  .add(2U, std::move(aHeader))
+                                  .add<int64_t>(3U, static_cast<int64_t>(aBody.size()))
+                                  .build();
+
+        // Serialized size is a multiple of 8, i.e. the body stays aligned
+        const std::string metadata = FbSerializer{}.finish(*message);
+
+        const Block block{offset, static_cast<int32_t>(8U + metadata.size()), 0, static_cast<int64_t>(aBody.size())};
+
+        const int32_t metadataSize = static_cast<int32_t>(metadata.size());
+
+        writeRaw(&ContinuationMarker, sizeof(ContinuationMarker));
+        writeRaw(&metadataSize, sizeof(metadataSize));
+        writeRaw(metadata.data(), metadata.size());
+        writeRaw(aBody.data(), aBody.size());
+
+        return block;
+    };
+
+    writeRaw(Magic.data(), Magic.size());
+    writeRaw("\0\0", 2U);
+
+    const FbRef schema = makeSchema(mSchema);
+
+    writeMessage(HeaderSchema, schema, {});
+
+    std::vector<Block> dictionaryBlocks;
+
+    for(std::size_t i = 0U; i < mSchema.size(); ++i)
+    {
+        if(mSchema[i].type != ArrowType::String)
+        {
+            continue;
+        }
+
+        Body body;
+        body.addStrings(mDictionaries[i]);
+
+        const FbRef dictionaryBatch =
+            FbTable{}
+                .add<int64_t>(0U, static_cast<int64_t>(i))
+                .add(1U, makeRecordBatch(static_cast<int64_t>(mDictionaries[i].size()), body))
+                .add<bool>(2U, false)
+                .build();
+
+        dictionaryBlocks.push_back(writeMessage(HeaderDictionaryBatch, dictionaryBatch, body.data));
+    }
+
+    std::vector<Block> recordBatchBlocks;
+
+    for(auto& batch : mBatches)
+    {
+        const int64_t rowCount = static_cast<int64_t>(batch.getRowCount());
+
+        Body body;
+
+        for(const auto& column : batch.mColumns)
+        {
+            body.nodes.push_back(FieldNode{rowCount, 0});
+            body.addBuffer(nullptr, 0U); // Validity, all valid
+
+            switch(column.type)
+            {
+                case ArrowType::Bool:
+                    {
+                        std::vector<uint8_t> bitmap((column.values.size() + 7U) / 8U, 0U);
+
+                        for(std::size_t row = 0U; row < column.values.size(); ++row)
+                        {
+                            bitmap[row / 8U] |= static_cast<uint8_t>(column.values[row] << (row % 8U));
+                        }
+
+                        body.addBuffer(bitmap.data(), bitmap.size());
+                    }
+                    break;
+
+                case ArrowType::String:
+                    body.addBuffer(column.indices.data(), column.indices.size() * sizeof(int32_t));
+                    break;
+
+                default: body.addBuffer(column.values.data(), column.values.size()); break;
+            }
+        }
+
+        recordBatchBlocks.push_back(writeMessage(HeaderRecordBatch, makeRecordBatch(rowCount, body), body.data));
+
+        // Release memory as early as possible
+        batch = ArrowBatch{{}};
+    }
+
+    // End-of-stream marker
+    const uint32_t eos[2] = {ContinuationMarker, 0U};
+    writeRaw(eos, sizeof(eos));
+
+    const FbRef footer = FbTable{}
+                             .add<int16_t>(0U, MetadataVersionV5)
+                             .add(1U, schema)
+                             .add(2U, fbStructVector(dictionaryBlocks))
+                             .add(3U, fbStructVector(recordBatchBlocks))
+                             .build();
+
+    const std::string footerData = FbSerializer{}.finish(*footer);
+
+    const int32_t footerSize = static_cast<int32_t>(footerData.size());
+
+    writeRaw(footerData.data(), footerData.size());
+    writeRaw(&footerSize, sizeof(footerSize));
+    writeRaw(Magic.data(), Magic.size());
+
+    mBatches.clear();
+
+    if(!mStream)
+    {
+        throw std::runtime_error("ArrowFileWriter: Failed to write the output stream");
+    }
+}
@@ -0,0 +1,204 @@
+#ifndef ARROWWRITER_HPP
+#define ARROWWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "Encoding.hpp"
+
+namespace OOCP
+{
+/**
+ * @brief Column types supported by the Arrow writer.
+ *
+ * @note String columns are always dictionary encoded with Int32 indices.
+ */
+enum class ArrowType
+{
+    Bool,
+    Int32,
+    Int64,
+    Float64,
+    String
+};
+
+struct ArrowField
+{
+    std::string name;
+    ArrowType type;
+};
+
+using ArrowSchema = std::vector<ArrowField>;
+
+/**
+ * @brief Rows of a single record batch, stored column-wise.
+ *
+ * @note Batches are independent of each other s.t. they can be filled
+ *       in parallel. Strings are deduplicated into a batch local dictionary
+ *       that is merged into the file dictionary by `ArrowFileWriter`.
+ *       Strings are expected to be CP1252 encoded as in OrCAD files, they
+ *       are transcoded to UTF-8 when added to the dictionary.
+ */
+class ArrowBatch
+{
+public:
+    explicit ArrowBatch(const ArrowSchema& aSchema)
+        : mColumns{},
+          mRowCount{0U}
+    {
+        for(const auto& field : aSchema)
+        {
+            mColumns.push_back(Column{field.type, {}, {}, {}, {}});
+        }
+    }
+
+    /**
+     * @brief Append a row, one value per column in schema order.
+     *
+     * @note Arithmetic values are converted into the column type, strings
+     *       are accepted for string columns only.
+     */
+    template <typename... Args> void addRow(const Args&... aArgs)
+    {
+        if(sizeof...(Args) != mColumns.size())
+        {
+            throw std::logic_error(fmt::format("ArrowBatch: Row contains {} values but the schema {} columns",
+                sizeof...(Args), mColumns.size()));
+        }
+
+        std::size_t col = 0U;
+
+        (append(mColumns[col++], aArgs), ...);
+
+        ++mRowCount;
+    }
+
+    std::size_t getRowCount() const
+    {
+        return mRowCount;
+    }
+
+private:
+    friend class ArrowFileWriter;
+
+    struct Column
+    {
+        ArrowType type;
+
+        std::vector<uint8_t> values; //!< Fixed width values in native byte order, one byte per bool
+
+        std::vector<int32_t> indices; //!< Indices into the dictionary for string columns
+        std::vector<std::string> dictionary;              //!< UTF-8 encoded
+        std::unordered_map<std::string, int32_t> lookup; //!< CP1252 encoded string -> index into `dictionary`
+    };
+
+    template <typename T> static void appendValue(Column& aCol, T aVal)
+    {
+        const std::size_t size = aCol.values.size();
+
+        aCol.values.resize(size + sizeof(T));
+        std::memcpy(aCol.values.data() + size, &aVal, sizeof(T));
+    }
+
+    template <typename T> static void append(Column& aCol, const T& aVal)
+    {
+        if constexpr(std::is_same_v<T, bool>)
+        {
+            if(aCol.type != ArrowType::Bool)
+            {
+                throw std::logic_error("ArrowBatch: Bool value written into a non-bool column");
+            }
+
+            aCol.values.push_back(aVal ? 1U : 0U);
+        }
+        else if constexpr(std::is_arithmetic_v<T>)
+        {
+            switch(aCol.type)
+            {
+                case ArrowType::Int32:   appendValue(aCol, static_cast<int32_t>(aVal)); break;
+                case ArrowType::Int64:   appendValue(aCol, static_cast<int64_t>(aVal)); break;
+                case ArrowType::Float64: appendValue(aCol, static_cast<double>(aVal)); break;
+                default: throw std::logic_error("ArrowBatch: Numeric value written into a non-numeric column");
+            }
+        }
+        else
+        {
+            if(aCol.type != ArrowType::String)
+            {
+                throw std::logic_error("ArrowBatch: String value written into a non-string column");
+            }
+
+            const std::string_view str{aVal};
+
+            const auto [it, inserted] =
+                aCol.lookup.try_emplace(std::string{str}, static_cast<int32_t>(aCol.dictionary.size()));
+
+            // Columns are declared as UTF-8, transcode each distinct string once
+            if(inserted)
+            {
+                aCol.dictionary.push_back(cp1252ToUtf8(it->first));
+            }
+
+            aCol.indices.push_back(it->second);
+        }
+    }
+
+    std::vector<Column> mColumns;
+    std::size_t mRowCount;
+};
+
+/**
+ * @brief Minimal self-contained writer for the Arrow IPC file format (Feather v2).
+ *
+ * @note Only the subset required for flat tables is implemented: non-nullable
+ *       columns of the types in `ArrowType`, one dictionary per string column
+ *       and no compression. Batches are kept in memory until `finish` as all
+ *       dictionaries need to be written before the first record batch.
+ *       Values are written in native byte order which is expected to be
+ *       little endian.
+ */
+class ArrowFileWriter
+{
+public:
+    ArrowFileWriter(std::ostream& aStream, ArrowSchema aSchema);
+
+    /**
+     * @brief Add a batch, its dictionary indices are remapped into the file dictionaries.
+     */
+    void addBatch(ArrowBatch&& aBatch);
+
+    /**
+     * @brief Write schema, dictionaries, record batches and footer.
+     */
+    void finish();
+
+    std::size_t getRowCount() const
+    {
+        return mRowCount;
+    }
+
+private:
+    ArrowSchema mSchema;
+
+    std::ostream& mStream;
+
+    std::vector<ArrowBatch> mBatches;
+
+    std::vector<std::vector<std::string>> mDictionaries; //!< Per column, empty for non-string columns
+    std::vector<std::unordered_map<std::string, int32_t>> mLookups;
+
+    std::size_t mRowCount;
+    bool mFinished;
+};
+} // namespace OOCP
+#endif // ARROWWRITER_HPP
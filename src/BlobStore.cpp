@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "BlobStore.hpp"
+#include "CfbfStreamLocation.hpp"
+#include "Database.hpp"
+#include "JsonWriter.hpp"
+#include "Stream.hpp"
+
+namespace
+{
+constexpr std::size_t CmpChunkSize = 65536U;
+
+std::string getSourceKey(const std::string& aContainer, const std::string& aStreamLocation, std::size_t aOffset)
+{
+    return fmt::format("{}:{}@{}", aContainer, aStreamLocation, aOffset);
+}
+
+void openSource(std::ifstream& aIs, const OOCP::BlobSource& aSource)
+{
+    aIs.open(aSource.stream, std::ios::in | std::ios::binary);
+
+    if(!aIs)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Can not open file for reading: {}", __func__, aSource.stream.string()));
+    }
+
+    aIs.seekg(static_cast<std::streamoff>(aSource.offset));
+}
+
+/**
+ * @brief Compare the raw data of two occurrences chunk wise.
+ */
+bool hasEqualContent(const OOCP::BlobSource& aLhs, const OOCP::BlobSource& aRhs, std::size_t aSize)
+{
+    std::ifstream lhs;
+    std::ifstream rhs;
+
+    openSource(lhs, aLhs);
+    openSource(rhs, aRhs);
+
+    std::vector<char> lhsChunk(std::min(aSize, CmpChunkSize));
+    std::vector<char> rhsChunk(lhsChunk.size());
+
+    for(std::size_t remaining = aSize; remaining > 0U;)
+    {
+        const std::size_t len = std::min(remaining, lhsChunk.size());
+
+        lhs.read(lhsChunk.data(), static_cast<std::streamsize>(len));
+        rhs.read(rhsChunk.data(), static_cast<std::streamsize>(len));
+
+        if(static_cast<std::size_t>(lhs.gcount()) != len || static_cast<std::size_t>(rhs.gcount()) != len)
+        {
+            throw std::runtime_error(fmt::format("{}: Blob data is out of range in {} or {}", __func__,
+                aLhs.stream.string(), aRhs.stream.string()));
+        }
+
+        if(!std::equal(lhsChunk.cbegin(), lhsChunk.cbegin() + len, rhsChunk.cbegin()))
+        {
+            return false;
+        }
+
+        remaining -= len;
+    }
+
+    return true;
+}
+} // namespace
+
+std::size_t OOCP::BlobStore::addContainer(ContainerContext& aCtx)
+{
+    std::size_t newCtr = 0U;
+
+    for(const auto& stream : aCtx.mDb.mStreams)
+    {
+        if(!stream)
+        {
+            continue;
+        }
+
+        const std::string streamLocation = to_string(stream->mCtx.mCfbfStreamLocation);
+
+        for(const auto& ref : stream->mCtx.mBlobRefs)
+        {
+            const BlobSource source{
+                aCtx.mInputCfbfFile.string(), streamLocation, stream->mCtx.mInputStream, ref.offset};
+
+            if(add(ref, source))
+            {
+                ++newCtr;
+            }
+        }
+    }
+
+    aCtx.mLogger.info("Blob store contains {} unique blobs with {} bytes for {} references with {} bytes", getBlobCtr(),
+        getUniqueSize(), getRefCtr(), getTotalSize());
+
+    return newCtr;
+}
+
+bool OOCP::BlobStore::add(const BlobRef& aRef, BlobSource aSource)
+{
+    const std::string sourceKey = getSourceKey(aSource.container, aSource.streamLocation, aSource.offset);
+
+    // Adding the same container twice must not count its blobs twice
+    if(mSourceIdx.count(sourceKey) > 0U)
+    {
+        return false;
+    }
+
+    std::vector<std::size_t>& candidates = mBlobIdx[aRef.hash];
+
+    std::optional<std::size_t> match;
+
+    // Equal hashes only indicate equal blobs, colliding blobs with different content are kept apart
+    for(const std::size_t candidate : candidates)
+    {
+        const BlobEntry& blob = mBlobs[candidate];
+
+        if(blob.kind == aRef.kind && blob.size == aRef.size &&
+            hasEqualContent(blob.sources.front(), aSource, aRef.size))
+        {
+            match = candidate;
+            break;
+        }
+    }
+
+    const bool isNew = !match.has_value();
+
+    if(isNew)
+    {
+        match = mBlobs.size();
+
+        mBlobs.push_back(BlobEntry{
+            aRef.hash, static_cast<uint32_t>(candidates.size()), aRef.kind, aRef.size, aRef.extension, {}});
+
+        candidates.push_back(match.value());
+    }
+
+    mSourceIdx.emplace(sourceKey, match.value());
+    mBlobs[match.value()].sources.push_back(std::move(aSource));
+
+    mTotalSize += aRef.size;
+
+    return isNew;
+}
+
+std::optional<std::size_t> OOCP::BlobStore::find(uint64_t aHash) const
+{
+    const auto it = mBlobIdx.find(aHash);
+
+    if(it == mBlobIdx.cend() || it->second.empty())
+    {
+        return std::nullopt;
+    }
+
+    return it->second.front();
+}
+
+std::optional<std::size_t> OOCP::BlobStore::findBySource(
+    const std::string& aContainer, const std::string& aStreamLocation, std::size_t aOffset) const
+{
+    const auto it = mSourceIdx.find(getSourceKey(aContainer, aStreamLocation, aOffset));
+
+    if(it == mSourceIdx.cend())
+    {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::size_t OOCP::BlobStore::getUniqueSize() const
+{
+    std::size_t size = 0U;
+
+    for(const auto& blob : mBlobs)
+    {
+        size += blob.size;
+    }
+
+    return size;
+}
+
+std::vector<uint8_t> OOCP::BlobStore::loadData(std::size_t aBlob) const
+{
+    const BlobEntry& blob = getBlob(aBlob);
+
+    if(blob.sources.empty())
+    {
+        throw std::runtime_error(fmt::format("{}: Blob {:016x} has no source", __func__, blob.hash));
+    }
+
+    const BlobSource& source = blob.sources.front();
+
+    std::ifstream is{source.stream, std::ios::in | std::ios::binary};
+
+    if(!is)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Can not open file for reading: {}", __func__, source.stream.string()));
+    }
+
+    std::vector<uint8_t> data(blob.size);
+
+    is.seekg(static_cast<std::streamoff>(source.offset));
+    is.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    if(static_cast<std::size_t>(is.gcount()) != data.size())
+    {
+        throw std::runtime_error(fmt::format(
+            "{}: Blob data at offset {} is out of range in {}", __func__, source.offset, source.stream.string()));
+    }
+
+    return data;
+}
+
+std::string OOCP::BlobStore::getManifest() const
+{
+    std::string buf;
+    JsonWriter writer{buf};
+
+    writer.beginObject();
+    writer.field("blobCtr", getBlobCtr());
+    writer.field("refCtr", getRefCtr());
+    writer.field("uniqueSize", getUniqueSize());
+    writer.field("totalSize", getTotalSize());
+
+    writer.key("blobs");
+    writer.beginArray();
+
+    for(const auto& blob : mBlobs)
+    {
+        writer.beginObject();
+        writer.field("hash", fmt::format("{:016x}", blob.hash));
+        writer.field("variant", blob.variant);
+        writer.field("kind", to_string(blob.kind));
+        writer.field("size", blob.size);
+        writer.field("file", blob.getFileName());
+
+        writer.key("sources");
+        writer.beginArray();
+
+        for(const auto& source : blob.sources)
+        {
+            writer.beginObject();
+            writer.field("container", source.container);
+            writer.field("streamLocation", source.streamLocation);
+            writer.field("offset", source.offset);
+            writer.endObject();
+        }
+
+        writer.endArray();
+        writer.endObject();
+    }
+
+    writer.endArray();
+    writer.endObject();
+
+    buf += '\n';
+
+    return buf;
+}
+
+void OOCP::BlobStore::saveManifest(const fs::path& aPath) const
+{
+    std::ofstream os{aPath, std::ios::out | std::ios::binary | std::ios::trunc};
+
+    if(!os)
+    {
+        throw std::runtime_error(fmt::format("{}: Can not open file for writing: {}", __func__, aPath.string()));
+    }
+
+    const std::string manifest = getManifest();
+
+    os.write(manifest.data(), static_cast<std::streamsize>(manifest.size()));
+}
@@ -0,0 +1,191 @@
+#ifndef BLOBSTORE_HPP
+#define BLOBSTORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "ContainerContext.hpp"
+#include "General.hpp"
+#include "StreamContext.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+/**
+ * @brief Occurrence of a blob inside a stream.
+ */
+struct BlobSource
+{
+    std::string container;      //!< Input CFBF container
+    std::string streamLocation; //!< Location of the stream inside the CFBF container
+    fs::path stream;            //!< Extracted stream file, only valid while the container is not destroyed
+    std::size_t offset;         //!< Offset of the raw data inside the stream
+};
+
+/**
+ * @brief Unique binary object, identified by the content hash of its raw data.
+ */
+struct BlobEntry
+{
+    uint64_t hash;
+    uint32_t variant; //!< Distinguishes blobs with colliding hashes but different content, usually 0
+    BlobKind kind;
+    std::size_t size;
+    std::string extension;
+
+    std::vector<BlobSource> sources; //!< All occurrences, the data is read from the first one
+
+    /**
+     * @brief File name of the blob inside the store, e.g. `0123456789abcdef.bmp`.
+     */
+    std::string getFileName() const
+    {
+        if(variant == 0U)
+        {
+            return fmt::format("{:016x}{}", hash, extension);
+        }
+
+        return fmt::format("{:016x}_{}{}", hash, variant, extension);
+    }
+};
+
+/**
+ * @brief Content addressed store of embedded images and OLE objects.
+ *
+ * @note Logos in title blocks are repeated on every page of every design.
+ *       The store keeps one entry per unique raw data and records all of
+ *       its occurrences, s.t. each blob needs to be written only once.
+ *       Blobs with equal 64 bit `ContentHash` are compared byte wise, such
+ *       that colliding blobs get separate entries. The manifest maps blob
+ *       files back to the streams they occur in.
+ */
+class BlobStore
+{
+public:
+    BlobStore()
+        : mBlobs{},
+          mBlobIdx{},
+          mSourceIdx{},
+          mTotalSize{0U}
+    {
+    }
+
+    /**
+     * @brief Add all blobs referenced by the streams of a parsed container.
+     *
+     * @param aCtx Context of the parsed container.
+     * @return std::size_t Number of blobs that were not in the store before.
+     */
+    std::size_t addContainer(ContainerContext& aCtx);
+
+    /**
+     * @brief Add a single occurrence of a blob.
+     *
+     * @note If a blob with the same hash exists, the content of both is read
+     *       from the stream files and compared.
+     *
+     * @return true If the blob was not in the store before.
+     */
+    bool add(const BlobRef& aRef, BlobSource aSource);
+
+    /**
+     * @brief Find a blob by its content hash, the first one in case of colliding hashes.
+     */
+    std::optional<std::size_t> find(uint64_t aHash) const;
+
+    /**
+     * @brief Find the blob that occurs at the given offset inside a stream.
+     */
+    std::optional<std::size_t> findBySource(
+        const std::string& aContainer, const std::string& aStreamLocation, std::size_t aOffset) const;
+
+    const BlobEntry& getBlob(std::size_t aBlob) const
+    {
+        return mBlobs.at(aBlob);
+    }
+
+    const std::vector<BlobEntry>& getBlobs() const
+    {
+        return mBlobs;
+    }
+
+    std::size_t getBlobCtr() const
+    {
+        return mBlobs.size();
+    }
+
+    std::size_t getRefCtr() const
+    {
+        return mSourceIdx.size();
+    }
+
+    /**
+     * @brief Size of all unique blobs, i.e. the size of the store.
+     */
+    std::size_t getUniqueSize() const;
+
+    /**
+     * @brief Size of all occurrences, i.e. the size without deduplication.
+     */
+    std::size_t getTotalSize() const
+    {
+        return mTotalSize;
+    }
+
+    /**
+     * @brief Read the raw data of a blob from its first occurrence.
+     */
+    std::vector<uint8_t> loadData(std::size_t aBlob) const;
+
+    /**
+     * @brief Manifest of all blobs and their occurrences as JSON.
+     */
+    std::string getManifest() const;
+
+    void saveManifest(const fs::path& aPath) const;
+
+private:
+    std::vector<BlobEntry> mBlobs;
+
+    std::unordered_map<uint64_t, std::vector<std::size_t>> mBlobIdx; //!< Hash -> blobs
+
+    std::unordered_map<std::string, std::size_t> mSourceIdx; //!< `<container>:<stream location>@<offset>` -> blob
+
+    std::size_t mTotalSize;
+};
+
+[[maybe_unused]]
+static std::string to_string(const BlobEntry& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}hash      = {:016x}\n", indent(1), aObj.hash);
+    str += fmt::format("{}variant   = {}\n", indent(1), aObj.variant);
+    str += fmt::format("{}kind      = {}\n", indent(1), to_string(aObj.kind));
+    str += fmt::format("{}size      = {}\n", indent(1), aObj.size);
+    str += fmt::format("{}extension = {}\n", indent(1), aObj.extension);
+    str += fmt::format("{}sources   = {}\n", indent(1), aObj.sources.size());
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const BlobEntry& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // BLOBSTORE_HPP
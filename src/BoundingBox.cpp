@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+#include <string>
+#include <vector>
+
+#include "BoundingBox.hpp"
+#include "InstanceTransform.hpp"
+#include "Primitives/Point.hpp"
+#include "Primitives/PrimArc.hpp"
+#include "Primitives/PrimBase.hpp"
+#include "Primitives/PrimBezier.hpp"
+#include "Primitives/PrimBitmap.hpp"
+#include "Primitives/PrimCommentText.hpp"
+#include "Primitives/PrimEllipse.hpp"
+#include "Primitives/PrimLine.hpp"
+#include "Primitives/PrimPolygon.hpp"
+#include "Primitives/PrimPolyline.hpp"
+#include "Primitives/PrimRect.hpp"
+#include "Primitives/PrimSymbolVector.hpp"
+#include "Structures/StructGeneralProperties.hpp"
+#include "Structures/StructGraphicInst.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructSthInPages0.hpp"
+#include "Structures/StructSymbolDisplayProp.hpp"
+#include "Structures/StructSymbolPin.hpp"
+#include "Win32/LOGFONTA.hpp"
+
+namespace
+{
+// Font height used when the font does not specify one
+constexpr int32_t DefaultFontHeight = 10;
+
+// Ratio between average character width and height of typical fonts
+constexpr double AvgCharWidthRatio = 0.6;
+
+void extendFloor(OOCP::BoundingBox& aBBox, double aX, double aY)
+{
+    aBBox.extend(static_cast<int32_t>(std::floor(aX)), static_cast<int32_t>(std::floor(aY)));
+    aBBox.extend(static_cast<int32_t>(std::ceil(aX)), static_cast<int32_t>(std::ceil(aY)));
+}
+
+void extendRect(OOCP::BoundingBox& aBBox, int32_t aX1, int32_t aY1, int32_t aX2, int32_t aY2)
+{
+    aBBox.extend(aX1, aY1);
+    aBBox.extend(aX2, aY2);
+}
+
+void extendPoints(OOCP::BoundingBox& aBBox, const std::vector<OOCP::Point>& aPoints)
+{
+    for(const auto& point : aPoints)
+    {
+        aBBox.extend(point.x, point.y);
+    }
+}
+
+// Roots of the derivative of a cubic bezier curve in [0, 1] for a single axis
+std::vector<double> getBezierExtremaParams(double aP0, double aP1, double aP2, double aP3)
+{
+    // B'(t) / 3 = a * t^2 + b * t + c
+    const double a = -aP0 + 3.0 * aP1 - 3.0 * aP2 + aP3;
+    const double b = 2.0 * (aP0 - 2.0 * aP1 + aP2);
+    const double c = aP1 - aP0;
+
+    const double eps = 1e-12;
+
+    std::vector<double> params;
+
+    const auto addParam = [&params](double t)
+    {
+        if(t > 0.0 && t < 1.0)
+        {
+            params.push_back(t);
+        }
+    };
+
+    if(std::abs(a) < eps)
+    {
+        if(std::abs(b) >= eps)
+        {
+            addParam(-c / b);
+        }
+
+        return params;
+    }
+
+    const double discriminant = b * b - 4.0 * a * c;
+
+    if(discriminant < 0.0)
+    {
+        return params;
+    }
+
+    const double sqrtDiscriminant = std::sqrt(discriminant);
+
+    addParam((-b + sqrtDiscriminant) / (2.0 * a));
+    addParam((-b - sqrtDiscriminant) / (2.0 * a));
+
+    return params;
+}
+
+double evalBezier(double aP0, double aP1, double aP2, double aP3, double aT)
+{
+    const double u = 1.0 - aT;
+
+    return u * u * u * aP0 + 3.0 * u * u * aT * aP1 + 3.0 * u * aT * aT * aP2 + aT * aT * aT * aP3;
+}
+
+OOCP::BoundingBox getBezierBoundingBox(const OOCP::PrimBezier& aBezier)
+{
+    OOCP::BoundingBox bbox;
+
+    const auto& pts = aBezier.points;
+
+    // The control polygon is a valid (but not tight) bounding box for incomplete segments
+    extendPoints(bbox, pts);
+
+    if(pts.size() < 4U)
+    {
+        return bbox;
+    }
+
+    // Consecutive cubic segments share their end points
+    OOCP::BoundingBox tight;
+
+    for(std::size_t i = 0U; i + 3U < pts.size(); i += 3U)
+    {
+        const std::array<double, 4> xs = {static_cast<double>(pts[i].x), static_cast<double>(pts[i + 1U].x),
+            static_cast<double>(pts[i + 2U].x), static_cast<double>(pts[i + 3U].x)};
+        const std::array<double, 4> ys = {static_cast<double>(pts[i].y), static_cast<double>(pts[i + 1U].y),
+            static_cast<double>(pts[i + 2U].y), static_cast<double>(pts[i + 3U].y)};
+
+        tight.extend(pts[i].x, pts[i].y);
+        tight.extend(pts[i + 3U].x, pts[i + 3U].y);
+
+        std::vector<double> params = getBezierExtremaParams(xs[0], xs[1], xs[2], xs[3]);
+        const std::vector<double> paramsY = getBezierExtremaParams(ys[0], ys[1], ys[2], ys[3]);
+        params.insert(params.end(), paramsY.begin(), paramsY.end());
+
+        for(const double t : params)
+        {
+            extendFloor(tight, evalBezier(xs[0], xs[1], xs[2], xs[3], t), evalBezier(ys[0], ys[1], ys[2], ys[3], t));
+        }
+    }
+
+    // Trailing points that do not form a complete segment
+    for(std::size_t i = ((pts.size() - 1U) / 3U) * 3U; i < pts.size(); ++i)
+    {
+        tight.extend(pts[i].x, pts[i].y);
+    }
+
+    return tight;
+}
+
+// Text a display property of a view shows, i.e. the value of the referenced property
+std::string getDisplayedValue(const OOCP::StructLibraryPart& aPart, const std::string& aName)
+{
+    const auto& props = aPart.generalProperties;
+
+    std::string value;
+
+    if(aName == "Value")
+    {
+        value = props.partValue;
+    }
+    else if(aName == "Part Reference")
+    {
+        value = props.refDes;
+    }
+    else if(aName == "Implementation")
+    {
+        value = props.implementation;
+    }
+    else if(aName == "Implementation Path")
+    {
+        value = props.implementationPath;
+    }
+
+    // Values of other properties, e.g. the `PCB Footprint`, are stored in the
+    // package. Those and empty values are estimated by the name.
+    return value.empty() ? aName : value;
+}
+
+OOCP::BoundingBox getArcBoundingBox(const OOCP::PrimArc& aArc)
+{
+    OOCP::BoundingBox bbox;
+
+    // @note The arc is assumed to be drawn counterclockwise, as seen on the page,
+    //       from its start to its end point.
+    const OOCP::PrimArc::EllipticArc arc = aArc.getEllipticArc();
+
+    bbox.extend(aArc.startX, aArc.startY);
+    bbox.extend(aArc.endX, aArc.endY);
+
+    // Extreme points of the ellipse at 0°, 90°, 180° and 270°
+    const std::array<std::array<double, 2>, 4> extrema = {
+        {{arc.centerX + arc.radiusX, arc.centerY},
+         {arc.centerX, arc.centerY - arc.radiusY},
+         {arc.centerX - arc.radiusX, arc.centerY},
+         {arc.centerX, arc.centerY + arc.radiusY}}
+    };
+
+    for(std::size_t i = 0U; i < extrema.size(); ++i)
+    {
+        double delta = i * std::numbers::pi / 2.0 - arc.startAngle;
+
+        if(delta < 0.0)
+        {
+            delta += 2.0 * std::numbers::pi;
+        }
+
+        if(delta <= arc.sweep)
+        {
+            extendFloor(bbox, extrema[i][0], extrema[i][1]);
+        }
+    }
+
+    return bbox;
+}
+} // namespace
+
+OOCP::BoundingBox OOCP::transform(const BoundingBox& aBBox, const InstanceTransform& aTransform)
+{
+    if(aBBox.isEmpty())
+    {
+        return aBBox;
+    }
+
+    std::array<int32_t, 4> xs = {aBBox.x1, aBBox.x2, aBBox.x2, aBBox.x1};
+    std::array<int32_t, 4> ys = {aBBox.y1, aBBox.y1, aBBox.y2, aBBox.y2};
+
+    aTransform.apply(xs.data(), ys.data(), xs.size());
+
+    BoundingBox bbox;
+
+    for(std::size_t i = 0U; i < xs.size(); ++i)
+    {
+        bbox.extend(xs[i], ys[i]);
+    }
+
+    return bbox;
+}
+
+std::vector<OOCP::BoundingBox> OOCP::transform(
+    const std::vector<BoundingBox>& aBBoxes, const std::vector<InstanceTransform>& aTransforms)
+{
+    constexpr std::size_t corners = 4U;
+
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+    std::vector<std::size_t> ranges;
+
+    xs.reserve(corners * aBBoxes.size());
+    ys.reserve(corners * aBBoxes.size());
+    ranges.reserve(aBBoxes.size() + 1U);
+
+    ranges.push_back(0U);
+
+    for(const auto& bbox : aBBoxes)
+    {
+        // Empty bounding boxes contribute no corners and stay empty
+        if(!bbox.isEmpty())
+        {
+            xs.insert(xs.end(), {bbox.x1, bbox.x2, bbox.x2, bbox.x1});
+            ys.insert(ys.end(), {bbox.y1, bbox.y1, bbox.y2, bbox.y2});
+        }
+
+        ranges.push_back(xs.size());
+    }
+
+    transformInstances(aTransforms, ranges, xs, ys);
+
+    std::vector<BoundingBox> bboxes(aBBoxes.size());
+
+    for(std::size_t i = 0U; i < bboxes.size(); ++i)
+    {
+        for(std::size_t j = ranges[i]; j < ranges[i + 1U]; ++j)
+        {
+            bboxes[i].extend(xs[j], ys[j]);
+        }
+    }
+
+    return bboxes;
+}
+
+int32_t OOCP::getTextHeight(const LOGFONTA& aFont)
+{
+    // Negative heights specify the character height, positive ones
+    // the cell height. The difference is negligible for an estimate.
+    return aFont.lfHeight != 0 ? std::abs(aFont.lfHeight) : DefaultFontHeight;
+}
+
+OOCP::BoundingBox OOCP::getTextBoundingBox(
+    const std::string& aText, const LOGFONTA& aFont, int32_t aX, int32_t aY, Rotation aRotation)
+{
+    BoundingBox bbox;
+
+    if(aText.empty())
+    {
+        return bbox;
+    }
+
+    const int32_t height = getTextHeight(aFont);
+
+    const double charWidth = aFont.lfWidth != 0 ? std::abs(aFont.lfWidth) : AvgCharWidthRatio * height;
+
+    const int32_t width = static_cast<int32_t>(std::ceil(charWidth * aText.size()));
+
+    Orientation orientation;
+
+    orientation.rotation = aRotation;
+
+    return transform(BoundingBox{0, -height, width, 0}, InstanceTransform{aX, aY, orientation});
+}
+
+OOCP::BoundingBox OOCP::getBoundingBox(const PrimBase& aPrim)
+{
+    BoundingBox bbox;
+
+    if(const auto* rect = dynamic_cast<const PrimRect*>(&aPrim))
+    {
+        extendRect(bbox, rect->x1, rect->y1, rect->x2, rect->y2);
+    }
+    else if(const auto* line = dynamic_cast<const PrimLine*>(&aPrim))
+    {
+        extendRect(bbox, line->x1, line->y1, line->x2, line->y2);
+    }
+    else if(const auto* arc = dynamic_cast<const PrimArc*>(&aPrim))
+    {
+        bbox = getArcBoundingBox(*arc);
+    }
+    else if(const auto* ellipse = dynamic_cast<const PrimEllipse*>(&aPrim))
+    {
+        // The ellipse is inscribed into the rectangle
+        extendRect(bbox, ellipse->x1, ellipse->y1, ellipse->x2, ellipse->y2);
+    }
+    else if(const auto* polygon = dynamic_cast<const PrimPolygon*>(&aPrim))
+    {
+        extendPoints(bbox, polygon->points);
+    }
+    else if(const auto* polyline = dynamic_cast<const PrimPolyline*>(&aPrim))
+    {
+        extendPoints(bbox, polyline->points);
+    }
+    else if(const auto* bezier = dynamic_cast<const PrimBezier*>(&aPrim))
+    {
+        bbox = getBezierBoundingBox(*bezier);
+    }
+    else if(const auto* commentText = dynamic_cast<const PrimCommentText*>(&aPrim))
+    {
+        // Text box
+        extendRect(bbox, commentText->x1, commentText->y1, commentText->x2, commentText->y2);
+
+        bbox.extend(getTextBoundingBox(
+            commentText->name, commentText->getTextFont(), commentText->locX, commentText->locY));
+    }
+    else if(const auto* bitmap = dynamic_cast<const PrimBitmap*>(&aPrim))
+    {
+        extendRect(bbox, bitmap->x1, bitmap->y1, bitmap->x2, bitmap->y2);
+    }
+    else if(const auto* symbolVector = dynamic_cast<const PrimSymbolVector*>(&aPrim))
+    {
+        BoundingBox localBBox;
+
+        for(const auto& primitive : symbolVector->primitives)
+        {
+            if(primitive)
+            {
+                localBBox.extend(getBoundingBox(*primitive));
+            }
+        }
+
+        bbox = transform(localBBox, InstanceTransform{symbolVector->locX, symbolVector->locY, Orientation{}});
+    }
+
+    return bbox;
+}
+
+OOCP::BoundingBox OOCP::getBoundingBox(const StructSymbolPin& aPin)
+{
+    BoundingBox bbox;
+
+    bbox.extend(aPin.startX, aPin.startY);
+    bbox.extend(aPin.hotptX, aPin.hotptY);
+
+    return bbox;
+}
+
+OOCP::BoundingBox OOCP::getBoundingBox(const StructSymbolDisplayProp& aProp, const std::string& aValue)
+{
+    return getTextBoundingBox(aValue, aProp.getTextFont(), aProp.x, aProp.y, aProp.rotation);
+}
+
+OOCP::BoundingBox OOCP::getBoundingBox(const StructSthInPages0& aObj)
+{
+    BoundingBox bbox;
+
+    for(const auto& primitive : aObj.primitives)
+    {
+        if(primitive)
+        {
+            bbox.extend(getBoundingBox(*primitive));
+        }
+    }
+
+    return bbox;
+}
+
+OOCP::BoundingBox OOCP::getBoundingBox(const StructGraphicInst& aInst)
+{
+    BoundingBox bbox;
+
+    if(aInst.sthInPages0)
+    {
+        bbox = transform(getBoundingBox(*aInst.sthInPages0), InstanceTransform{aInst.locX, aInst.locY, Orientation{}});
+    }
+
+    if(bbox.isEmpty())
+    {
+        bbox.extend(aInst.locX, aInst.locY);
+    }
+
+    return bbox;
+}
+
+OOCP::BoundingBox OOCP::getBoundingBox(const StructLibraryPart& aPart, bool aIncludeText)
+{
+    BoundingBox bbox;
+
+    for(const auto& primitive : aPart.primitives)
+    {
+        if(primitive)
+        {
+            bbox.extend(getBoundingBox(*primitive));
+        }
+    }
+
+    for(const auto& pin : aPart.symbolPins)
+    {
+        if(pin)
+        {
+            bbox.extend(getBoundingBox(*pin));
+        }
+    }
+
+    if(aIncludeText)
+    {
+        for(const auto& prop : aPart.symbolDisplayProps)
+        {
+            if(prop)
+            {
+                bbox.extend(getBoundingBox(*prop, getDisplayedValue(aPart, prop->getName())));
+            }
+        }
+    }
+
+    return bbox;
+}
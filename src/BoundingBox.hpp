@@ -0,0 +1,201 @@
+#ifndef BOUNDINGBOX_HPP
+#define BOUNDINGBOX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "Enums/Rotation.hpp"
+#include "General.hpp"
+#include "InstanceTransform.hpp"
+#include "Win32/LOGFONTA.hpp"
+
+namespace OOCP
+{
+class PrimBase;
+class StructGraphicInst;
+class StructLibraryPart;
+class StructSthInPages0;
+class StructSymbolDisplayProp;
+class StructSymbolPin;
+
+/**
+ * @brief Axis aligned bounding box, (x1, y1) is the minimum and (x2, y2) the maximum corner.
+ * @note A default constructed bounding box is empty and does not contain any point.
+ */
+struct BoundingBox
+{
+    int32_t x1{std::numeric_limits<int32_t>::max()};
+    int32_t y1{std::numeric_limits<int32_t>::max()};
+
+    int32_t x2{std::numeric_limits<int32_t>::min()};
+    int32_t y2{std::numeric_limits<int32_t>::min()};
+
+    bool isEmpty() const
+    {
+        return x1 > x2 || y1 > y2;
+    }
+
+    int32_t getWidth() const
+    {
+        return isEmpty() ? 0 : x2 - x1;
+    }
+
+    int32_t getHeight() const
+    {
+        return isEmpty() ? 0 : y2 - y1;
+    }
+
+    void extend(int32_t aX, int32_t aY)
+    {
+        x1 = std::min(x1, aX);
+        y1 = std::min(y1, aY);
+        x2 = std::max(x2, aX);
+        y2 = std::max(y2, aY);
+    }
+
+    void extend(const BoundingBox& aBBox)
+    {
+        if(!aBBox.isEmpty())
+        {
+            extend(aBBox.x1, aBBox.y1);
+            extend(aBBox.x2, aBBox.y2);
+        }
+    }
+
+    bool contains(int32_t aX, int32_t aY) const
+    {
+        return aX >= x1 && aX <= x2 && aY >= y1 && aY <= y2;
+    }
+
+    bool intersects(const BoundingBox& aBBox) const
+    {
+        return !isEmpty() && !aBBox.isEmpty() && aBBox.x1 <= x2 && aBBox.x2 >= x1 && aBBox.y1 <= y2 &&
+               aBBox.y2 >= y1;
+    }
+
+    bool operator==(const BoundingBox&) const = default;
+};
+
+/**
+ * @brief Transform bounding box into a different coordinate system.
+ *
+ * @param aBBox Bounding box in symbol-local space.
+ * @param aTransform Transformation e.g. of a placed instance.
+ * @return BoundingBox Bounding box in page space.
+ */
+BoundingBox transform(const BoundingBox& aBBox, const InstanceTransform& aTransform);
+
+/**
+ * @brief Transform many bounding boxes at once, see `transformInstances`.
+ *
+ * @param aBBoxes Bounding boxes in symbol-local space.
+ * @param aTransforms Transformation per bounding box, same size as aBBoxes.
+ * @return std::vector<BoundingBox> Bounding boxes in page space.
+ */
+std::vector<BoundingBox> transform(
+    const std::vector<BoundingBox>& aBBoxes, const std::vector<InstanceTransform>& aTransforms);
+
+/**
+ * @brief Get the character height of a font.
+ *
+ * @param aFont Font.
+ * @return int32_t Character height, a default value if the font does not specify one.
+ */
+int32_t getTextHeight(const LOGFONTA& aFont);
+
+/**
+ * @brief Approximate the extents of a text from its font metrics.
+ *
+ * @note The text is anchored at its bottom left corner and rotated
+ *       around the anchor. Character widths are approximated by the
+ *       average character width of the font as no glyph metrics are
+ *       available.
+ *
+ * @param aText Text content.
+ * @param aFont Font used for rendering the text.
+ * @param aX X-coordinate of the anchor.
+ * @param aY Y-coordinate of the anchor.
+ * @param aRotation Text rotation.
+ * @return BoundingBox Approximate text extents.
+ */
+BoundingBox getTextBoundingBox(
+    const std::string& aText, const LOGFONTA& aFont, int32_t aX, int32_t aY, Rotation aRotation = Rotation::Deg_0);
+
+/**
+ * @brief Tight bounding box of a primitive including arc, ellipse and bezier extrema.
+ * @note Line widths are not taken into account.
+ */
+BoundingBox getBoundingBox(const PrimBase& aPrim);
+
+BoundingBox getBoundingBox(const StructSymbolPin& aPin);
+
+/**
+ * @brief Approximate bounding box of a display property.
+ *
+ * @param aProp Display property, only referencing the property by name.
+ * @param aValue Displayed value of the property, taken from the owning object.
+ * @return BoundingBox Bounding box of the displayed text.
+ */
+BoundingBox getBoundingBox(const StructSymbolDisplayProp& aProp, const std::string& aValue);
+
+/**
+ * @brief Bounding box of a primitive collection, e.g. a symbol.
+ *
+ * @param aObj Structure containing the primitives.
+ * @return BoundingBox Bounding box of all primitives.
+ */
+BoundingBox getBoundingBox(const StructSthInPages0& aObj);
+
+/**
+ * @brief Bounding box of a graphic instance on a page, i.e. its
+ *        primitives translated to its location.
+ */
+BoundingBox getBoundingBox(const StructGraphicInst& aInst);
+
+/**
+ * @brief Bounding box of a package view.
+ *
+ * @param aPart Package view, e.g. the `Normal` or `Convert` view.
+ * @param aIncludeText Include the approximate extents of the display properties.
+ * @return BoundingBox Bounding box in symbol-local space.
+ */
+BoundingBox getBoundingBox(const StructLibraryPart& aPart, bool aIncludeText = true);
+
+[[maybe_unused]]
+static std::string to_string(const BoundingBox& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+
+    if(aObj.isEmpty())
+    {
+        str += fmt::format("{}empty\n", indent(1));
+    }
+    else
+    {
+        str += fmt::format("{}x1 = {}\n", indent(1), aObj.x1);
+        str += fmt::format("{}y1 = {}\n", indent(1), aObj.y1);
+        str += fmt::format("{}x2 = {}\n", indent(1), aObj.x2);
+        str += fmt::format("{}y2 = {}\n", indent(1), aObj.y2);
+    }
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const BoundingBox& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // BOUNDINGBOX_HPP
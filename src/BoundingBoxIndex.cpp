@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "BoundingBox.hpp"
+#include "BoundingBoxIndex.hpp"
+#include "CfbfStreamLocation.hpp"
+#include "Database.hpp"
+#include "InstanceTransform.hpp"
+#include "ParallelFor.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Streams/StreamSymbol.hpp"
+#include "Structures/StructERCSymbol.hpp"
+
+namespace
+{
+bool isWithinTolerance(const OOCP::BoundingBox& aLhs, const OOCP::BoundingBox& aRhs, int32_t aTolerance)
+{
+    return std::abs(aLhs.x1 - aRhs.x1) <= aTolerance && std::abs(aLhs.y1 - aRhs.y1) <= aTolerance &&
+           std::abs(aLhs.x2 - aRhs.x2) <= aTolerance && std::abs(aLhs.y2 - aRhs.y2) <= aTolerance;
+}
+} // namespace
+
+void OOCP::BoundingBoxIndex::build(int32_t aTolerance)
+{
+    mViewBBoxes.clear();
+    mSymbolBBoxes.clear();
+    mPages.clear();
+    mMismatches.clear();
+
+    std::vector<std::shared_ptr<StreamPackage>> packages;
+    std::vector<std::shared_ptr<StreamSymbol>> symbols;
+
+    for(auto& stream : mCtx.mDb.mStreams)
+    {
+        if(auto package = std::dynamic_pointer_cast<StreamPackage>(stream))
+        {
+            packages.push_back(package);
+        }
+        else if(auto symbol = std::dynamic_pointer_cast<StreamSymbol>(stream))
+        {
+            symbols.push_back(symbol);
+        }
+        else if(auto page = std::dynamic_pointer_cast<StreamPage>(stream))
+        {
+            PageBBoxes pageBBoxes{};
+            pageBBoxes.page = page;
+            mPages.push_back(std::move(pageBBoxes));
+        }
+    }
+
+    mCtx.mLogger.info("Computing bounding boxes for {} packages, {} symbols and {} pages", packages.size(),
+        symbols.size(), mPages.size());
+
+    // Step 1: Package views and symbols, they are independent of each other
+
+    std::vector<std::vector<std::pair<std::string, BoundingBox>>> viewResults(packages.size());
+
+    parallelFor(mCtx.mCfg.mThreadCount, packages.size(),
+        [&](std::size_t aIdx)
+        {
+            const auto& package = packages[aIdx];
+
+            BoundingBox packageBBox;
+
+            for(const auto& libraryPart : package->libraryParts)
+            {
+                if(libraryPart)
+                {
+                    const BoundingBox viewBBox = getBoundingBox(*libraryPart);
+
+                    viewResults[aIdx].push_back(std::make_pair(libraryPart->name, viewBBox));
+                    packageBBox.extend(viewBBox);
+                }
+            }
+
+            if(package->package)
+            {
+                viewResults[aIdx].push_back(std::make_pair(package->package->name, packageBBox));
+            }
+        });
+
+    std::vector<std::optional<BoundingBox>> symbolResults(symbols.size());
+    std::vector<std::optional<BBoxMismatch>> mismatchResults(symbols.size());
+
+    parallelFor(mCtx.mCfg.mThreadCount, symbols.size(),
+        [&](std::size_t aIdx)
+        {
+            const auto& stream = symbols[aIdx];
+
+            if(!stream->symbol)
+            {
+                return;
+            }
+
+            BoundingBox bbox = getBoundingBox(*stream->symbol);
+
+            for(const auto& pin : stream->symbolPins)
+            {
+                if(pin)
+                {
+                    bbox.extend(getBoundingBox(*pin));
+                }
+            }
+
+            symbolResults[aIdx] = bbox;
+
+            // Cross-check against the bounding box stored in the file
+            const auto ercSymbol = dynamic_cast<const StructERCSymbol*>(stream->symbol.get());
+
+            if(!ercSymbol)
+            {
+                return;
+            }
+
+            const auto& storedBBox = ercSymbol->symbolBBox;
+
+            BoundingBox stored;
+            stored.extend(storedBBox.x1, storedBBox.y1);
+            stored.extend(storedBBox.x2, storedBBox.y2);
+
+            // All zero means the bounding box was not part of the structure
+            const bool isStored = storedBBox.x1 != 0 || storedBBox.y1 != 0 || storedBBox.x2 != 0 || storedBBox.y2 != 0;
+
+            if(isStored && !isWithinTolerance(stored, bbox, aTolerance))
+            {
+                BBoxMismatch mismatch{};
+
+                mismatch.streamLocation = to_string(stream->mCtx.mCfbfStreamLocation);
+                mismatch.name           = stream->symbol->name;
+                mismatch.stored         = stored;
+                mismatch.computed       = bbox;
+
+                mismatchResults[aIdx] = std::move(mismatch);
+            }
+        });
+
+    for(const auto& viewResult : viewResults)
+    {
+        for(const auto& [name, bbox] : viewResult)
+        {
+            // Views are unique by name, packages only add their name if it is not taken yet
+            mViewBBoxes.emplace(name, bbox);
+        }
+    }
+
+    for(std::size_t i = 0U; i < symbols.size(); ++i)
+    {
+        if(symbolResults[i].has_value() && symbols[i]->symbol)
+        {
+            mSymbolBBoxes.emplace(symbols[i]->symbol->name, symbolResults[i].value());
+        }
+
+        if(mismatchResults[i].has_value())
+        {
+            mCtx.mLogger.warn("Stored bounding box of `{}` differs from computed one", mismatchResults[i]->name);
+            mCtx.mLogger.debug(to_string(mismatchResults[i].value()));
+
+            mMismatches.push_back(std::move(mismatchResults[i].value()));
+        }
+    }
+
+    // Step 2: Pages, they only read the package view bounding boxes from step 1
+
+    parallelFor(
+        mCtx.mCfg.mThreadCount, mPages.size(), [this](std::size_t aIdx) { computePageBBoxes(mPages[aIdx]); });
+
+    std::size_t unresolvedInstances = 0U;
+
+    for(const auto& page : mPages)
+    {
+        unresolvedInstances += page.unresolvedInstances;
+    }
+
+    mCtx.mLogger.info("Computed {} view and {} symbol bounding boxes, {} instances could not be resolved and {} "
+                      "mismatches were found",
+        mViewBBoxes.size(), mSymbolBBoxes.size(), unresolvedInstances, mMismatches.size());
+}
+
+std::optional<OOCP::BoundingBox> OOCP::BoundingBoxIndex::getViewBBox(const std::string& aName) const
+{
+    const auto it = mViewBBoxes.find(aName);
+
+    if(it == mViewBBoxes.end())
+    {
+        return std::nullopt;
+    }
+
+    return std::make_optional<BoundingBox>(it->second);
+}
+
+std::optional<OOCP::BoundingBox> OOCP::BoundingBoxIndex::getSymbolBBox(const std::string& aName) const
+{
+    const auto it = mSymbolBBoxes.find(aName);
+
+    if(it == mSymbolBBoxes.end())
+    {
+        return std::nullopt;
+    }
+
+    return std::make_optional<BoundingBox>(it->second);
+}
+
+void OOCP::BoundingBoxIndex::computePageBBoxes(PageBBoxes& aPage) const
+{
+    const auto& page = *aPage.page;
+
+    aPage.bbox = BoundingBox{};
+    aPage.unresolvedInstances = 0U;
+
+    // Collect the symbol-local bounding boxes first s.t. all
+    // instances are transformed in a single batch
+    std::vector<BoundingBox> localBBoxes;
+    std::vector<InstanceTransform> transforms;
+
+    localBBoxes.reserve(page.placedInstances.size());
+    transforms.reserve(page.placedInstances.size());
+
+    for(const auto& inst : page.placedInstances)
+    {
+        BoundingBox localBBox;
+        InstanceTransform instTransform;
+
+        if(inst)
+        {
+            const auto viewBBox = getViewBBox(inst->pkgName);
+
+            if(viewBBox.has_value())
+            {
+                localBBox     = viewBBox.value();
+                instTransform = InstanceTransform::fromPlacedInstance(*inst);
+            }
+            else
+            {
+                // Untransformed, i.e. the location is already in page space
+                localBBox.extend(inst->locX, inst->locY);
+                ++aPage.unresolvedInstances;
+            }
+        }
+
+        localBBoxes.push_back(localBBox);
+        transforms.push_back(instTransform);
+    }
+
+    aPage.placedInstances = transform(localBBoxes, transforms);
+
+    for(const auto& instBBox : aPage.placedInstances)
+    {
+        aPage.bbox.extend(instBBox);
+    }
+
+    for(const auto& wire : page.wires)
+    {
+        if(wire)
+        {
+            aPage.bbox.extend(wire->startX, wire->startY);
+            aPage.bbox.extend(wire->endX, wire->endY);
+        }
+    }
+
+    for(const auto& busEntry : page.busEntries)
+    {
+        if(busEntry)
+        {
+            aPage.bbox.extend(busEntry->startX, busEntry->startY);
+            aPage.bbox.extend(busEntry->endX, busEntry->endY);
+        }
+    }
+
+    const auto extendGraphicInsts = [&aPage](const auto& aInsts)
+    {
+        for(const auto& inst : aInsts)
+        {
+            if(inst)
+            {
+                aPage.bbox.extend(getBoundingBox(*inst));
+            }
+        }
+    };
+
+    extendGraphicInsts(page.titleBlocks);
+    extendGraphicInsts(page.ports);
+    extendGraphicInsts(page.globals);
+    extendGraphicInsts(page.offPageConnectors);
+    extendGraphicInsts(page.graphicInsts);
+}
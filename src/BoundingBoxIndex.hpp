@@ -0,0 +1,156 @@
+#ifndef BOUNDINGBOXINDEX_HPP
+#define BOUNDINGBOXINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "BoundingBox.hpp"
+#include "ContainerContext.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+class StreamPackage;
+class StreamPage;
+class StreamSymbol;
+
+/**
+ * @brief Computed bounding boxes of a page and everything placed on it.
+ */
+struct PageBBoxes
+{
+    std::shared_ptr<StreamPage> page;
+
+    BoundingBox bbox; //!< Union of all objects on the page
+
+    // Same order as `StreamPage::placedInstances`. Instances whose
+    // package view could not be resolved only contain their location.
+    std::vector<BoundingBox> placedInstances;
+
+    std::size_t unresolvedInstances{0U}; //!< Instances without a known package view
+};
+
+/**
+ * @brief Stored bounding box that differs from the one computed from the geometry.
+ */
+struct BBoxMismatch
+{
+    std::string streamLocation; //!< Location of the stream inside the CFBF container
+    std::string name;           //!< Name of the symbol
+
+    BoundingBox stored;
+    BoundingBox computed;
+};
+
+/**
+ * @brief Computes bounding boxes for all package views, symbols, placed instances
+ *        and pages of a parsed database. Viewers and indexes can use them to cull
+ *        objects without touching their geometry.
+ *
+ * @note Package views and pages are processed in parallel with the number of threads
+ *       configured in `ParserConfig`. Each thread only writes into its own result slots
+ *       such that no synchronization is required.
+ */
+class BoundingBoxIndex
+{
+public:
+    BoundingBoxIndex(ContainerContext& aCtx)
+        : mCtx{aCtx},
+          mViewBBoxes{},
+          mSymbolBBoxes{},
+          mPages{},
+          mMismatches{}
+    {
+    }
+
+    /**
+     * @brief Compute all bounding boxes of the database.
+     *
+     * @param aTolerance Allowed deviation between stored and computed bounding
+     *                   box coordinates before it is reported as mismatch.
+     */
+    void build(int32_t aTolerance = 0);
+
+    /**
+     * @brief Get bounding box of a package view.
+     *
+     * @param aName Name of the package view (`StructLibraryPart::name`) or package.
+     * @return std::optional<BoundingBox> Bounding box in symbol-local space.
+     */
+    std::optional<BoundingBox> getViewBBox(const std::string& aName) const;
+
+    /**
+     * @brief Get bounding box of a symbol stored in the `Symbols` storage.
+     *
+     * @param aName Name of the symbol.
+     * @return std::optional<BoundingBox> Bounding box in symbol-local space.
+     */
+    std::optional<BoundingBox> getSymbolBBox(const std::string& aName) const;
+
+    const std::map<std::string, BoundingBox>& getViewBBoxes() const
+    {
+        return mViewBBoxes;
+    }
+
+    const std::map<std::string, BoundingBox>& getSymbolBBoxes() const
+    {
+        return mSymbolBBoxes;
+    }
+
+    const std::vector<PageBBoxes>& getPages() const
+    {
+        return mPages;
+    }
+
+    const std::vector<BBoxMismatch>& getMismatches() const
+    {
+        return mMismatches;
+    }
+
+private:
+    void computePageBBoxes(PageBBoxes& aPage) const;
+
+    ContainerContext& mCtx;
+
+    std::map<std::string, BoundingBox> mViewBBoxes;   //!< Package view and package name -> bounding box
+    std::map<std::string, BoundingBox> mSymbolBBoxes; //!< Symbol name -> bounding box
+
+    std::vector<PageBBoxes> mPages;
+
+    std::vector<BBoxMismatch> mMismatches;
+};
+
+[[maybe_unused]]
+static std::string to_string(const BBoxMismatch& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}streamLocation = {}\n", indent(1), aObj.streamLocation);
+    str += fmt::format("{}name           = {}\n", indent(1), aObj.name);
+    str += fmt::format("{}stored:\n", indent(1));
+    str += indent(to_string(aObj.stored), 2);
+    str += fmt::format("{}computed:\n", indent(1));
+    str += indent(to_string(aObj.computed), 2);
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const BBoxMismatch& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // BOUNDINGBOXINDEX_HPP
@@ -0,0 +1,1119 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <utf.h>
+
+#include "CfbWriter.hpp"
+#include "Stream.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr uint32_t FreeSect   = 0xFFFFFFFFU;
+constexpr uint32_t EndOfChain = 0xFFFFFFFEU;
+constexpr uint32_t FatSect    = 0xFFFFFFFDU;
+constexpr uint32_t DifSect    = 0xFFFFFFFCU;
+constexpr uint32_t NoStream   = 0xFFFFFFFFU;
+
+constexpr std::size_t HeaderSize       = 512U;
+constexpr std::size_t DirEntrySize     = 128U;
+constexpr std::size_t HeaderDifatCount = 109U;
+constexpr std::size_t MaxNameLen       = 31U;
+
+constexpr uint8_t ColorRed   = 0U;
+constexpr uint8_t ColorBlack = 1U;
+
+constexpr uint8_t TypeUnused  = 0U;
+constexpr uint8_t TypeStorage = 1U;
+constexpr uint8_t TypeStream  = 2U;
+constexpr uint8_t TypeRoot    = 5U;
+
+uint16_t readU16(const uint8_t* aData)
+{
+    return static_cast<uint16_t>(aData[0] | (aData[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* aData)
+{
+    return static_cast<uint32_t>(aData[0]) | (static_cast<uint32_t>(aData[1]) << 8) |
+           (static_cast<uint32_t>(aData[2]) << 16) | (static_cast<uint32_t>(aData[3]) << 24);
+}
+
+uint64_t readU64(const uint8_t* aData)
+{
+    return static_cast<uint64_t>(readU32(aData)) | (static_cast<uint64_t>(readU32(aData + 4)) << 32);
+}
+
+void writeU32(uint8_t* aData, uint32_t aVal)
+{
+    for(std::size_t i = 0U; i < 4U; ++i)
+    {
+        aData[i] = static_cast<uint8_t>(aVal >> (8U * i));
+    }
+}
+
+void writeU64(uint8_t* aData, uint64_t aVal)
+{
+    writeU32(aData, static_cast<uint32_t>(aVal));
+    writeU32(aData + 4, static_cast<uint32_t>(aVal >> 32));
+}
+
+std::size_t divCeil(uint64_t aVal, std::size_t aDiv)
+{
+    return static_cast<std::size_t>((aVal + aDiv - 1U) / aDiv);
+}
+
+std::u16string toUtf16(const std::string& aStr)
+{
+    std::u16string str;
+
+    for(std::size_t i = 0U; i < aStr.size();)
+    {
+        const auto byte = static_cast<uint8_t>(aStr[i]);
+
+        const std::size_t len = byte < 0x80U ? 1U : (byte >> 5U) == 0x06U ? 2U : (byte >> 4U) == 0x0EU ? 3U : 4U;
+
+        if(i + len > aStr.size())
+        {
+            throw std::runtime_error(fmt::format("{}: Invalid UTF-8 string {}", __func__, aStr));
+        }
+
+        uint32_t codePoint = len == 1U ? byte : byte & (0x7FU >> len);
+
+        for(std::size_t k = 1U; k < len; ++k)
+        {
+            codePoint = (codePoint << 6U) | (static_cast<uint8_t>(aStr[i + k]) & 0x3FU);
+        }
+
+        if(codePoint >= 0x10000U)
+        {
+            codePoint -= 0x10000U;
+            str.push_back(static_cast<char16_t>(0xD800U + (codePoint >> 10U)));
+            str.push_back(static_cast<char16_t>(0xDC00U + (codePoint & 0x3FFU)));
+        }
+        else
+        {
+            str.push_back(static_cast<char16_t>(codePoint));
+        }
+
+        i += len;
+    }
+
+    return str;
+}
+
+/**
+ * @brief Order of siblings in the directory, shorter names first followed by
+ *        a comparison of the upper case UTF-16 code units.
+ */
+bool isNameLess(const uint8_t* aLhs, const uint8_t* aRhs)
+{
+    const uint16_t lhsLen = readU16(aLhs + 64);
+    const uint16_t rhsLen = readU16(aRhs + 64);
+
+    if(lhsLen != rhsLen)
+    {
+        return lhsLen < rhsLen;
+    }
+
+    const auto toUpper = [](uint16_t aChar) -> uint16_t
+    { return (aChar >= u'a' && aChar <= u'z') ? static_cast<uint16_t>(aChar - (u'a' - u'A')) : aChar; };
+
+    for(std::size_t i = 0U; i + 2U < lhsLen && i < 62U; i += 2U)
+    {
+        const uint16_t lhs = toUpper(readU16(aLhs + i));
+        const uint16_t rhs = toUpper(readU16(aRhs + i));
+
+        if(lhs != rhs)
+        {
+            return lhs < rhs;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Writes sectors sequentially and keeps track of the sector number.
+ */
+class SectorWriter
+{
+public:
+    SectorWriter(std::ofstream& aOs, std::size_t aSectorSize)
+        : mOs{aOs},
+          mSectorSize{aSectorSize},
+          mPadding(aSectorSize, 0U),
+          mSector{0U}
+    {
+    }
+
+    /**
+     * @brief Write data and pad it to full sectors with zeros.
+     */
+    void write(const uint8_t* aData, std::size_t aLen)
+    {
+        if(aLen > 0U)
+        {
+            mOs.write(reinterpret_cast<const char*>(aData), static_cast<std::streamsize>(aLen));
+        }
+
+        const std::size_t rest = aLen % mSectorSize;
+
+        if(rest > 0U)
+        {
+            mOs.write(reinterpret_cast<const char*>(mPadding.data()), static_cast<std::streamsize>(mSectorSize - rest));
+        }
+
+        mSector += divCeil(aLen, mSectorSize);
+    }
+
+    void writeU32s(const std::vector<uint32_t>& aVals)
+    {
+        std::vector<uint8_t> data(aVals.size() * 4U);
+
+        for(std::size_t i = 0U; i < aVals.size(); ++i)
+        {
+            writeU32(data.data() + 4U * i, aVals[i]);
+        }
+
+        write(data.data(), data.size());
+    }
+
+    std::size_t getSector() const
+    {
+        return mSector;
+    }
+
+private:
+    std::ofstream& mOs;
+    std::size_t mSectorSize;
+    std::vector<uint8_t> mPadding;
+    std::size_t mSector;
+};
+} // namespace
+
+OOCP::CfbWriter::CfbWriter(const fs::path& aSource)
+    : mSource{aSource},
+      mBuffer{},
+      mMajorVersion{0U},
+      mSectorSize{0U},
+      mMiniSectorSize{0U},
+      mMiniStreamCutoff{0U},
+      mFat{},
+      mMiniFat{},
+      mDirChain{},
+      mMiniStreamChain{},
+      mEntries{},
+      mParents{},
+      mStorageIds{},
+      mStreamIds{},
+      mReplacements{},
+      mTreeChanged{false}
+{
+    std::ifstream is{mSource, std::ios::in | std::ios::binary};
+
+    if(!is)
+    {
+        throw std::runtime_error(fmt::format("{}: Can not open file for reading: {}", __func__, mSource.string()));
+    }
+
+    mBuffer.resize(static_cast<std::size_t>(fs::file_size(mSource)));
+    is.read(reinterpret_cast<char*>(mBuffer.data()), static_cast<std::streamsize>(mBuffer.size()));
+
+    if(!is)
+    {
+        throw std::runtime_error(fmt::format("{}: Reading file {} failed", __func__, mSource.string()));
+    }
+
+    parse();
+    indexStreams();
+
+    spdlog::debug("{}: Loaded {} with {} streams", __func__, mSource.string(), mStreamIds.size());
+}
+
+void OOCP::CfbWriter::parse()
+{
+    static constexpr std::array<uint8_t, 8U> signature{0xD0, 0xCF, 0x11, 0xE0, 0xA1, 0xB1, 0x1A, 0xE1};
+
+    if(mBuffer.size() < HeaderSize || !std::equal(signature.begin(), signature.end(), mBuffer.begin()))
+    {
+        throw std::runtime_error(fmt::format("{}: {} is not a CFBF container", __func__, mSource.string()));
+    }
+
+    const uint8_t* hdr = mBuffer.data();
+
+    mMajorVersion     = readU16(hdr + 26);
+    mSectorSize       = std::size_t{1U} << readU16(hdr + 30);
+    mMiniSectorSize   = std::size_t{1U} << readU16(hdr + 32);
+    mMiniStreamCutoff = readU32(hdr + 56);
+
+    if(mSectorSize != 512U && mSectorSize != 4096U)
+    {
+        throw std::runtime_error(fmt::format("{}: Unsupported sector size {}", __func__, mSectorSize));
+    }
+
+    // Some writers truncate the last sector, pad it s.t. every sector can be read completely
+    mBuffer.resize(divCeil(mBuffer.size(), mSectorSize) * mSectorSize, 0U);
+    hdr = mBuffer.data();
+
+    const uint32_t numFatSectors  = readU32(hdr + 44);
+    const uint32_t firstDirSector = readU32(hdr + 48);
+    const uint32_t firstMiniFat   = readU32(hdr + 60);
+    const uint32_t firstDifat     = readU32(hdr + 68);
+
+    const std::size_t idsPerSector = mSectorSize / 4U;
+
+    // Collect FAT sectors from the header and the DIFAT chain
+    std::vector<uint32_t> fatSectors;
+
+    for(std::size_t i = 0U; i < std::min<std::size_t>(numFatSectors, HeaderDifatCount); ++i)
+    {
+        fatSectors.push_back(readU32(hdr + 76 + 4U * i));
+    }
+
+    uint32_t difatSector = firstDifat;
+
+    while(fatSectors.size() < numFatSectors && difatSector < DifSect)
+    {
+        const uint8_t* data = mBuffer.data() + getSectorOffset(difatSector);
+
+        for(std::size_t i = 0U; i < idsPerSector - 1U && fatSectors.size() < numFatSectors; ++i)
+        {
+            fatSectors.push_back(readU32(data + 4U * i));
+        }
+
+        difatSector = readU32(data + 4U * (idsPerSector - 1U));
+    }
+
+    mFat.clear();
+    mFat.reserve(fatSectors.size() * idsPerSector);
+
+    for(const auto sector : fatSectors)
+    {
+        const uint8_t* data = mBuffer.data() + getSectorOffset(sector);
+
+        for(std::size_t i = 0U; i < idsPerSector; ++i)
+        {
+            mFat.push_back(readU32(data + 4U * i));
+        }
+    }
+
+    mMiniFat.clear();
+
+    for(const auto sector : getChain(firstMiniFat, mFat))
+    {
+        const uint8_t* data = mBuffer.data() + getSectorOffset(sector);
+
+        for(std::size_t i = 0U; i < idsPerSector; ++i)
+        {
+            mMiniFat.push_back(readU32(data + 4U * i));
+        }
+    }
+
+    mDirChain = getChain(firstDirSector, mFat);
+
+    mEntries.clear();
+
+    for(const auto sector : mDirChain)
+    {
+        const uint8_t* data = mBuffer.data() + getSectorOffset(sector);
+
+        for(std::size_t offset = 0U; offset < mSectorSize; offset += DirEntrySize)
+        {
+            DirEntry entry{};
+
+            std::copy_n(data + offset, DirEntrySize, entry.raw.begin());
+
+            entry.type  = entry.raw[66];
+            entry.left  = readU32(entry.raw.data() + 68);
+            entry.right = readU32(entry.raw.data() + 72);
+            entry.child = readU32(entry.raw.data() + 76);
+            entry.start = readU32(entry.raw.data() + 116);
+            entry.size  = readU64(entry.raw.data() + 120);
+
+            // Version 3 containers may contain garbage in the upper 32 bits
+            if(mMajorVersion == 3U)
+            {
+                entry.size &= 0xFFFFFFFFU;
+            }
+
+            mEntries.push_back(entry);
+        }
+    }
+
+    if(mEntries.empty() || mEntries.front().type != TypeRoot)
+    {
+        throw std::runtime_error(fmt::format("{}: {} does not contain a root entry", __func__, mSource.string()));
+    }
+
+    mMiniStreamChain = getChain(mEntries.front().start, mFat);
+}
+
+void OOCP::CfbWriter::indexStreams()
+{
+    mStreamIds.clear();
+    mStorageIds.clear();
+    mParents.assign(mEntries.size(), NoStream);
+
+    mStorageIds.emplace(std::vector<std::string>{}, 0U);
+
+    std::vector<bool> visited(mEntries.size(), false);
+
+    struct Item
+    {
+        uint32_t id;
+        uint32_t parent;
+        std::vector<std::string> parentLoc;
+    };
+
+    // Siblings form a tree, i.e. traverse without recursion to
+    // not depend on the tree depth
+    std::vector<Item> stack;
+
+    stack.push_back(Item{mEntries.front().child, 0U, {}});
+
+    while(!stack.empty())
+    {
+        Item item = std::move(stack.back());
+        stack.pop_back();
+
+        if(item.id >= mEntries.size() || visited[item.id])
+        {
+            continue;
+        }
+
+        visited[item.id] = true;
+
+        const DirEntry& entry = mEntries[item.id];
+
+        mParents[item.id] = item.parent;
+
+        stack.push_back(Item{entry.left, item.parent, item.parentLoc});
+        stack.push_back(Item{entry.right, item.parent, item.parentLoc});
+
+        std::vector<std::string> location = std::move(item.parentLoc);
+        location.push_back(getName(entry));
+
+        if(entry.type == TypeStream)
+        {
+            mStreamIds.emplace(std::move(location), item.id);
+        }
+        else if(entry.type == TypeStorage)
+        {
+            mStorageIds.emplace(location, item.id);
+            stack.push_back(Item{entry.child, item.id, std::move(location)});
+        }
+    }
+}
+
+std::string OOCP::CfbWriter::getName(const DirEntry& aEntry)
+{
+    std::array<uint16_t, 33U> name{};
+
+    for(std::size_t i = 0U; i < 32U; ++i)
+    {
+        name[i] = readU16(aEntry.raw.data() + 2U * i);
+    }
+
+    return UTF16ToUTF8(name.data());
+}
+
+uint32_t OOCP::CfbWriter::getStreamId(const std::vector<std::string>& aLocation) const
+{
+    const auto it = mStreamIds.find(aLocation);
+
+    if(it == mStreamIds.end())
+    {
+        std::string location;
+
+        for(const auto& part : aLocation)
+        {
+            location += "/" + part;
+        }
+
+        throw std::runtime_error(
+            fmt::format("{}: Stream {} does not exist in {}", __func__, location, mSource.string()));
+    }
+
+    return it->second;
+}
+
+std::vector<uint32_t> OOCP::CfbWriter::getChain(uint32_t aStart, const std::vector<uint32_t>& aFat) const
+{
+    std::vector<uint32_t> chain;
+
+    uint32_t sector = aStart;
+
+    while(sector < DifSect)
+    {
+        if(sector >= aFat.size() || chain.size() >= aFat.size())
+        {
+            throw std::runtime_error(
+                fmt::format("{}: Corrupted sector chain starting at {} in {}", __func__, aStart, mSource.string()));
+        }
+
+        chain.push_back(sector);
+        sector = aFat[sector];
+    }
+
+    return chain;
+}
+
+std::size_t OOCP::CfbWriter::getSectorOffset(uint32_t aSector) const
+{
+    const std::size_t offset = (static_cast<std::size_t>(aSector) + 1U) * mSectorSize;
+
+    if(offset + mSectorSize > mBuffer.size())
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Sector {} is out of bounds in {}", __func__, aSector, mSource.string()));
+    }
+
+    return offset;
+}
+
+std::size_t OOCP::CfbWriter::getMiniSectorOffset(uint32_t aMiniSector) const
+{
+    const std::size_t pos = static_cast<std::size_t>(aMiniSector) * mMiniSectorSize;
+
+    if(pos / mSectorSize >= mMiniStreamChain.size())
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Mini sector {} is out of bounds in {}", __func__, aMiniSector, mSource.string()));
+    }
+
+    return getSectorOffset(mMiniStreamChain[pos / mSectorSize]) + pos % mSectorSize;
+}
+
+std::vector<uint8_t> OOCP::CfbWriter::readEntry(const DirEntry& aEntry) const
+{
+    std::vector<uint8_t> data;
+    data.reserve(static_cast<std::size_t>(aEntry.size));
+
+    const bool mini        = isMini(aEntry.size);
+    const std::size_t unit = mini ? mMiniSectorSize : mSectorSize;
+
+    for(const auto sector : getChain(aEntry.start, mini ? mMiniFat : mFat))
+    {
+        if(data.size() >= aEntry.size)
+        {
+            break;
+        }
+
+        const std::size_t offset = mini ? getMiniSectorOffset(sector) : getSectorOffset(sector);
+        const std::size_t len    = std::min<std::size_t>(unit, static_cast<std::size_t>(aEntry.size) - data.size());
+
+        data.insert(data.end(), mBuffer.begin() + offset, mBuffer.begin() + offset + len);
+    }
+
+    if(data.size() != aEntry.size)
+    {
+        throw std::runtime_error(fmt::format("{}: Stream is truncated in {}", __func__, mSource.string()));
+    }
+
+    return data;
+}
+
+void OOCP::CfbWriter::replaceStream(const std::vector<std::string>& aLocation, std::vector<uint8_t> aData)
+{
+    mReplacements[getStreamId(aLocation)] = std::move(aData);
+}
+
+void OOCP::CfbWriter::replaceStream(const Stream& aStream, std::vector<uint8_t> aData)
+{
+    replaceStream(aStream.mCtx.mCfbfStreamLocation.get_vector(), std::move(aData));
+}
+
+std::vector<uint8_t> OOCP::CfbWriter::readStream(const std::vector<std::string>& aLocation) const
+{
+    const uint32_t id = getStreamId(aLocation);
+
+    const auto it = mReplacements.find(id);
+
+    if(it != mReplacements.end())
+    {
+        return it->second;
+    }
+
+    return readEntry(mEntries[id]);
+}
+
+std::vector<std::vector<std::string>> OOCP::CfbWriter::getStreamLocations() const
+{
+    std::vector<std::vector<std::string>> locations;
+
+    for(const auto& [location, id] : mStreamIds)
+    {
+        locations.push_back(location);
+    }
+
+    return locations;
+}
+
+bool OOCP::CfbWriter::hasStream(const std::vector<std::string>& aLocation) const
+{
+    return mStreamIds.count(aLocation) > 0U;
+}
+
+void OOCP::CfbWriter::addStream(const std::vector<std::string>& aLocation, std::vector<uint8_t> aData)
+{
+    if(aLocation.empty())
+    {
+        throw std::runtime_error(fmt::format("{}: Stream location is empty", __func__));
+    }
+
+    if(hasStream(aLocation))
+    {
+        replaceStream(aLocation, std::move(aData));
+        return;
+    }
+
+    // Create missing storages along the location
+    std::vector<std::string> location;
+    uint32_t parent = 0U;
+
+    for(std::size_t i = 0U; i + 1U < aLocation.size(); ++i)
+    {
+        location.push_back(aLocation[i]);
+
+        const auto it = mStorageIds.find(location);
+
+        if(it != mStorageIds.end())
+        {
+            parent = it->second;
+            continue;
+        }
+
+        if(mStreamIds.count(location) > 0U)
+        {
+            throw std::runtime_error(
+                fmt::format("{}: Storage {} collides with an existing stream", __func__, aLocation[i]));
+        }
+
+        mEntries.push_back(makeEntry(aLocation[i], TypeStorage));
+        mParents.push_back(parent);
+
+        parent = static_cast<uint32_t>(mEntries.size() - 1U);
+        mStorageIds.emplace(location, parent);
+    }
+
+    if(mStorageIds.count(aLocation) > 0U)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Stream {} collides with an existing storage", __func__, aLocation.back()));
+    }
+
+    mEntries.push_back(makeEntry(aLocation.back(), TypeStream));
+    mParents.push_back(parent);
+
+    const auto id = static_cast<uint32_t>(mEntries.size() - 1U);
+
+    mStreamIds.emplace(aLocation, id);
+    mReplacements[id] = std::move(aData);
+
+    mTreeChanged = true;
+}
+
+void OOCP::CfbWriter::removeStream(const std::vector<std::string>& aLocation)
+{
+    const uint32_t id = getStreamId(aLocation);
+
+    mEntries[id].type = TypeUnused;
+
+    mStreamIds.erase(aLocation);
+    mReplacements.erase(id);
+
+    mTreeChanged = true;
+}
+
+OOCP::CfbWriter::DirEntry OOCP::CfbWriter::makeEntry(const std::string& aName, uint8_t aType)
+{
+    const std::u16string name = toUtf16(aName);
+
+    if(name.empty() || name.size() > MaxNameLen)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Name `{}` must have between 1 and {} characters", __func__, aName, MaxNameLen));
+    }
+
+    DirEntry entry{};
+
+    for(std::size_t i = 0U; i < name.size(); ++i)
+    {
+        entry.raw[2U * i]      = static_cast<uint8_t>(name[i] & 0xFFU);
+        entry.raw[2U * i + 1U] = static_cast<uint8_t>(name[i] >> 8U);
+    }
+
+    entry.raw[64] = static_cast<uint8_t>(2U * (name.size() + 1U));
+    entry.raw[66] = aType;
+    entry.raw[67] = ColorBlack;
+
+    writeU32(entry.raw.data() + 68, NoStream);
+    writeU32(entry.raw.data() + 72, NoStream);
+    writeU32(entry.raw.data() + 76, NoStream);
+    writeU32(entry.raw.data() + 116, aType == TypeStream ? EndOfChain : 0U);
+
+    entry.type  = aType;
+    entry.left  = NoStream;
+    entry.right = NoStream;
+    entry.child = NoStream;
+    entry.start = aType == TypeStream ? EndOfChain : 0U;
+    entry.size  = 0U;
+
+    return entry;
+}
+
+std::vector<OOCP::CfbWriter::DirEntry> OOCP::CfbWriter::getOutputEntries(std::vector<uint32_t>& aOrder) const
+{
+    aOrder.clear();
+
+    if(!mTreeChanged)
+    {
+        for(std::size_t id = 0U; id < mEntries.size(); ++id)
+        {
+            aOrder.push_back(static_cast<uint32_t>(id));
+        }
+
+        return mEntries;
+    }
+
+    // Drop unused entries and entries that are not part of the tree
+    std::vector<uint32_t> newIds(mEntries.size(), NoStream);
+    std::vector<DirEntry> entries;
+
+    for(std::size_t id = 0U; id < mEntries.size(); ++id)
+    {
+        const DirEntry& entry = mEntries[id];
+
+        if(id == 0U || (entry.type != TypeUnused && mParents[id] != NoStream))
+        {
+            newIds[id] = static_cast<uint32_t>(aOrder.size());
+            aOrder.push_back(static_cast<uint32_t>(id));
+            entries.push_back(entry);
+        }
+    }
+
+    std::vector<std::vector<uint32_t>> children(entries.size());
+
+    for(std::size_t newId = 1U; newId < entries.size(); ++newId)
+    {
+        children[newIds[mParents[aOrder[newId]]]].push_back(static_cast<uint32_t>(newId));
+    }
+
+    // Siblings are stored as balanced binary tree. All levels except the
+    // deepest one are complete, coloring the deepest one red results in
+    // a valid red-black tree.
+    for(std::size_t newId = 0U; newId < entries.size(); ++newId)
+    {
+        auto& siblings = children[newId];
+
+        std::sort(siblings.begin(), siblings.end(), [&](uint32_t aLhs, uint32_t aRhs)
+            { return isNameLess(entries[aLhs].raw.data(), entries[aRhs].raw.data()); });
+
+        std::size_t completeDepth = 0U;
+
+        while((std::size_t{2U} << completeDepth) - 1U <= siblings.size())
+        {
+            ++completeDepth;
+        }
+
+        const auto build = [&](auto& aSelf, std::size_t aBegin, std::size_t aEnd, std::size_t aDepth) -> uint32_t
+        {
+            if(aBegin >= aEnd)
+            {
+                return NoStream;
+            }
+
+            const std::size_t mid = aBegin + (aEnd - aBegin) / 2U;
+
+            DirEntry& entry = entries[siblings[mid]];
+
+            entry.left  = aSelf(aSelf, aBegin, mid, aDepth + 1U);
+            entry.right = aSelf(aSelf, mid + 1U, aEnd, aDepth + 1U);
+
+            entry.raw[67] = aDepth >= completeDepth ? ColorRed : ColorBlack;
+
+            writeU32(entry.raw.data() + 68, entry.left);
+            writeU32(entry.raw.data() + 72, entry.right);
+
+            return siblings[mid];
+        };
+
+        if(entries[newId].type != TypeStream)
+        {
+            entries[newId].child = build(build, 0U, siblings.size(), 0U);
+            writeU32(entries[newId].raw.data() + 76, entries[newId].child);
+        }
+    }
+
+    // Root entry is black and has no siblings
+    entries.front().raw[67] = ColorBlack;
+
+    return entries;
+}
+
+void OOCP::CfbWriter::write(const fs::path& aOutput) const
+{
+    const std::size_t idsPerSector = mSectorSize / 4U;
+
+    struct Placement
+    {
+        uint64_t size;
+        uint32_t start;
+        bool mini;
+    };
+
+    // Source entry IDs in output order
+    std::vector<uint32_t> order;
+
+    const std::vector<DirEntry> entries = getOutputEntries(order);
+
+    // Lay out all streams, regular streams first followed by the mini stream
+    std::vector<Placement> placements(entries.size(), Placement{0U, EndOfChain, false});
+
+    std::size_t sectorCtr     = 0U;
+    std::size_t miniSectorCtr = 0U;
+
+    for(std::size_t id = 0U; id < entries.size(); ++id)
+    {
+        if(entries[id].type != TypeStream)
+        {
+            continue;
+        }
+
+        const auto it = mReplacements.find(order[id]);
+
+        Placement& placement = placements[id];
+
+        placement.size = it != mReplacements.end() ? it->second.size() : entries[id].size;
+        placement.mini = isMini(placement.size);
+
+        std::size_t& ctr = placement.mini ? miniSectorCtr : sectorCtr;
+
+        if(placement.size > 0U)
+        {
+            placement.start = static_cast<uint32_t>(ctr);
+            ctr += divCeil(placement.size, placement.mini ? mMiniSectorSize : mSectorSize);
+        }
+    }
+
+    const std::size_t dataSectors = sectorCtr;
+
+    const uint64_t miniStreamSize     = static_cast<uint64_t>(miniSectorCtr) * mMiniSectorSize;
+    const std::size_t miniStreamStart = sectorCtr;
+    sectorCtr += divCeil(miniStreamSize, mSectorSize);
+
+    const std::size_t miniFatStart   = sectorCtr;
+    const std::size_t miniFatSectors = divCeil(miniSectorCtr * 4U, mSectorSize);
+    sectorCtr += miniFatSectors;
+
+    const std::size_t dirStart   = sectorCtr;
+    const std::size_t dirSectors = divCeil(entries.size() * DirEntrySize, mSectorSize);
+    sectorCtr += dirSectors;
+
+    // FAT and DIFAT sectors need to be covered by the FAT themselves
+    std::size_t fatSectors   = 0U;
+    std::size_t difatSectors = 0U;
+
+    while(true)
+    {
+        const std::size_t fat   = divCeil(sectorCtr + fatSectors + difatSectors, idsPerSector);
+        const std::size_t difat = fat > HeaderDifatCount ? divCeil(fat - HeaderDifatCount, idsPerSector - 1U) : 0U;
+
+        if(fat == fatSectors && difat == difatSectors)
+        {
+            break;
+        }
+
+        fatSectors   = fat;
+        difatSectors = difat;
+    }
+
+    const std::size_t fatStart   = sectorCtr;
+    const std::size_t difatStart = fatStart + fatSectors;
+
+    // Build FAT and mini FAT, all chains are contiguous
+    std::vector<uint32_t> fat(fatSectors * idsPerSector, FreeSect);
+    std::vector<uint32_t> miniFat(miniFatSectors * idsPerSector, FreeSect);
+
+    const auto addChain = [](std::vector<uint32_t>& aFat, std::size_t aStart, std::size_t aCount)
+    {
+        for(std::size_t i = 0U; i < aCount; ++i)
+        {
+            aFat[aStart + i] = i + 1U < aCount ? static_cast<uint32_t>(aStart + i + 1U) : EndOfChain;
+        }
+    };
+
+    for(const auto& placement : placements)
+    {
+        if(placement.start != EndOfChain)
+        {
+            addChain(placement.mini ? miniFat : fat, placement.start,
+                divCeil(placement.size, placement.mini ? mMiniSectorSize : mSectorSize));
+        }
+    }
+
+    addChain(fat, miniStreamStart, divCeil(miniStreamSize, mSectorSize));
+    addChain(fat, miniFatStart, miniFatSectors);
+    addChain(fat, dirStart, dirSectors);
+
+    std::fill_n(fat.begin() + fatStart, fatSectors, FatSect);
+    std::fill_n(fat.begin() + difatStart, difatSectors, DifSect);
+
+    // Header
+    std::vector<uint8_t> header(mSectorSize, 0U);
+
+    std::copy_n(mBuffer.begin(), 44U, header.begin());
+
+    writeU32(header.data() + 40, mMajorVersion == 3U ? 0U : static_cast<uint32_t>(dirSectors));
+    writeU32(header.data() + 44, static_cast<uint32_t>(fatSectors));
+    writeU32(header.data() + 48, static_cast<uint32_t>(dirStart));
+    writeU32(header.data() + 52, 0U);
+    writeU32(header.data() + 56, mMiniStreamCutoff);
+    writeU32(header.data() + 60, miniFatSectors > 0U ? static_cast<uint32_t>(miniFatStart) : EndOfChain);
+    writeU32(header.data() + 64, static_cast<uint32_t>(miniFatSectors));
+    writeU32(header.data() + 68, difatSectors > 0U ? static_cast<uint32_t>(difatStart) : EndOfChain);
+    writeU32(header.data() + 72, static_cast<uint32_t>(difatSectors));
+
+    std::vector<uint32_t> difat(HeaderDifatCount + difatSectors * (idsPerSector - 1U), FreeSect);
+
+    for(std::size_t i = 0U; i < fatSectors; ++i)
+    {
+        difat[i] = static_cast<uint32_t>(fatStart + i);
+    }
+
+    for(std::size_t i = 0U; i < HeaderDifatCount; ++i)
+    {
+        writeU32(header.data() + 76 + 4U * i, difat[i]);
+    }
+
+    // Directory with updated start sectors and sizes
+    std::vector<uint8_t> dir(dirSectors * mSectorSize, 0U);
+
+    for(std::size_t id = 0U; id < dirSectors * mSectorSize / DirEntrySize; ++id)
+    {
+        uint8_t* data = dir.data() + id * DirEntrySize;
+
+        if(id >= entries.size())
+        {
+            writeU32(data + 68, NoStream);
+            writeU32(data + 72, NoStream);
+            writeU32(data + 76, NoStream);
+            continue;
+        }
+
+        std::copy(entries[id].raw.begin(), entries[id].raw.end(), data);
+
+        if(id == 0U)
+        {
+            writeU32(data + 116, miniStreamSize > 0U ? static_cast<uint32_t>(miniStreamStart) : EndOfChain);
+            writeU64(data + 120, miniStreamSize);
+        }
+        else if(entries[id].type == TypeStream)
+        {
+            writeU32(data + 116, placements[id].start);
+            writeU64(data + 120, placements[id].size);
+        }
+    }
+
+    std::ofstream os;
+
+    // Writing to the source is fine as it was read into memory
+    os.open(aOutput, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if(!os)
+    {
+        throw std::runtime_error(fmt::format("{}: Can not open file for writing: {}", __func__, aOutput.string()));
+    }
+
+    SectorWriter writer{os, mSectorSize};
+
+    writer.write(header.data(), header.size());
+
+    std::vector<uint8_t> miniStream;
+    miniStream.reserve(static_cast<std::size_t>(miniStreamSize));
+
+    for(std::size_t id = 0U; id < entries.size(); ++id)
+    {
+        const Placement& placement = placements[id];
+
+        if(entries[id].type != TypeStream)
+        {
+            continue;
+        }
+
+        const auto it = mReplacements.find(order[id]);
+
+        if(placement.mini)
+        {
+            const std::vector<uint8_t> data = it != mReplacements.end() ? it->second : readEntry(entries[id]);
+
+            miniStream.insert(miniStream.end(), data.begin(), data.end());
+            miniStream.resize(divCeil(miniStream.size(), mMiniSectorSize) * mMiniSectorSize, 0U);
+        }
+        else if(it != mReplacements.end())
+        {
+            writer.write(it->second.data(), it->second.size());
+        }
+        else
+        {
+            // Copy the untouched stream sector by sector
+            uint64_t remaining = entries[id].size;
+
+            for(const auto sector : getChain(entries[id].start, mFat))
+            {
+                if(remaining == 0U)
+                {
+                    break;
+                }
+
+                const std::size_t offset = getSectorOffset(sector);
+                const std::size_t len    = std::min<std::size_t>(mSectorSize, static_cast<std::size_t>(remaining));
+
+                writer.write(mBuffer.data() + offset, len);
+                remaining -= std::min<uint64_t>(remaining, mSectorSize);
+            }
+        }
+    }
+
+    if(writer.getSector() != 1U + dataSectors)
+    {
+        throw std::runtime_error(fmt::format("{}: Stream data is truncated in {}", __func__, mSource.string()));
+    }
+
+    writer.write(miniStream.data(), miniStream.size());
+
+    writer.writeU32s(miniFat);
+
+    writer.write(dir.data(), dir.size());
+
+    writer.writeU32s(fat);
+
+    for(std::size_t i = 0U; i < difatSectors; ++i)
+    {
+        const auto begin = difat.begin() + HeaderDifatCount + i * (idsPerSector - 1U);
+
+        std::vector<uint32_t> sector(begin, begin + (idsPerSector - 1U));
+        sector.push_back(i + 1U < difatSectors ? static_cast<uint32_t>(difatStart + i + 1U) : EndOfChain);
+
+        writer.writeU32s(sector);
+    }
+
+    os.close();
+
+    if(!os)
+    {
+        throw std::runtime_error(fmt::format("{}: Failed to write {}", __func__, aOutput.string()));
+    }
+
+    spdlog::debug("{}: Wrote {} with {} replaced streams", __func__, aOutput.string(), mReplacements.size());
+}
+
+bool OOCP::CfbWriter::writeInPlace()
+{
+    if(mTreeChanged)
+    {
+        spdlog::debug("{}: Streams were added or removed, a rewrite is required", __func__);
+        return false;
+    }
+
+    // Check that all replacements fit into the sectors that are already allocated
+    for(const auto& [id, data] : mReplacements)
+    {
+        const DirEntry& entry = mEntries[id];
+
+        const bool mini        = isMini(entry.size);
+        const std::size_t unit = mini ? mMiniSectorSize : mSectorSize;
+
+        if(mini != isMini(data.size()) || divCeil(entry.size, unit) != divCeil(data.size(), unit))
+        {
+            spdlog::debug("{}: Stream {} changes its sector count, a rewrite is required", __func__, id);
+            return false;
+        }
+    }
+
+    std::fstream file{mSource, std::ios::in | std::ios::out | std::ios::binary};
+
+    if(!file)
+    {
+        throw std::runtime_error(fmt::format("{}: Can not open file for writing: {}", __func__, mSource.string()));
+    }
+
+    // Patch the file and the loaded copy the same way
+    const auto patch = [&](std::size_t aOffset, const uint8_t* aData, std::size_t aLen)
+    {
+        std::copy_n(aData, aLen, mBuffer.begin() + aOffset);
+
+        file.seekp(static_cast<std::streamoff>(aOffset));
+        file.write(reinterpret_cast<const char*>(aData), static_cast<std::streamsize>(aLen));
+    };
+
+    std::size_t sectorCtr = 0U;
+
+    for(const auto& [id, data] : mReplacements)
+    {
+        DirEntry& entry = mEntries[id];
+
+        const bool mini        = isMini(entry.size);
+        const std::size_t unit = mini ? mMiniSectorSize : mSectorSize;
+
+        std::vector<uint8_t> unitData(unit, 0U);
+        std::size_t pos = 0U;
+
+        for(const auto sector : getChain(entry.start, mini ? mMiniFat : mFat))
+        {
+            if(pos >= data.size())
+            {
+                break;
+            }
+
+            const std::size_t len = std::min(unit, data.size() - pos);
+
+            std::fill(unitData.begin(), unitData.end(), 0U);
+            std::copy_n(data.begin() + pos, len, unitData.begin());
+
+            const std::size_t offset = mini ? getMiniSectorOffset(sector) : getSectorOffset(sector);
+
+            patch(offset, unitData.data(), unit);
+
+            pos += len;
+            ++sectorCtr;
+        }
+
+        // Update size in the directory entry
+        entry.size = data.size();
+        writeU64(entry.raw.data() + 120, entry.size);
+
+        const std::size_t entryPos = static_cast<std::size_t>(id) * DirEntrySize;
+
+        patch(getSectorOffset(mDirChain[entryPos / mSectorSize]) + entryPos % mSectorSize + 120U,
+            entry.raw.data() + 120, 8U);
+    }
+
+    file.close();
+
+    if(!file)
+    {
+        throw std::runtime_error(fmt::format("{}: Failed to write {}", __func__, mSource.string()));
+    }
+
+    spdlog::debug("{}: Rewrote {} sectors of {} streams in {}", __func__, sectorCtr, mReplacements.size(),
+        mSource.string());
+
+    mReplacements.clear();
+
+    return true;
+}
@@ -0,0 +1,171 @@
+#ifndef CFBWRITER_HPP
+#define CFBWRITER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+class Stream;
+
+/**
+ * @brief Writes a CFBF container based on an existing one where some streams are replaced.
+ *
+ * @note Streams that were not replaced are copied byte-for-byte from the
+ *       source container without decoding them. The directory tree is kept
+ *       as is unless streams are added or removed.
+ */
+class CfbWriter
+{
+public:
+    CfbWriter() = delete;
+
+    /**
+     * @brief Load the source container.
+     *
+     * @param aSource Path to the CFBF container, e.g. a `.DSN` or `.OLB` file.
+     */
+    CfbWriter(const fs::path& aSource);
+
+    /**
+     * @brief Replace the content of a stream.
+     *
+     * @param aLocation Location of the stream inside the container, e.g. `{"Views", "SCHEMATIC1", "Pages", "PAGE1"}`.
+     * @param aData New content of the stream.
+     * @throws std::runtime_error If the container does not contain the stream.
+     */
+    void replaceStream(const std::vector<std::string>& aLocation, std::vector<uint8_t> aData);
+
+    /**
+     * @brief Replace the content of a parsed stream of the database.
+     */
+    void replaceStream(const Stream& aStream, std::vector<uint8_t> aData);
+
+    /**
+     * @brief Add a new stream, missing storages are created.
+     *
+     * @note Replaces the content if the stream exists already.
+     */
+    void addStream(const std::vector<std::string>& aLocation, std::vector<uint8_t> aData);
+
+    /**
+     * @brief Remove a stream, its storages are kept.
+     *
+     * @throws std::runtime_error If the container does not contain the stream.
+     */
+    void removeStream(const std::vector<std::string>& aLocation);
+
+    bool hasStream(const std::vector<std::string>& aLocation) const;
+
+    /**
+     * @brief Read the current content of a stream, i.e. including replacements.
+     */
+    std::vector<uint8_t> readStream(const std::vector<std::string>& aLocation) const;
+
+    /**
+     * @brief Locations of all streams inside the container.
+     */
+    std::vector<std::vector<std::string>> getStreamLocations() const;
+
+    /**
+     * @brief Write a new container with all replacements.
+     *
+     * @note Data, mini stream, mini FAT, directory and FAT are laid out
+     *       in a single pass and written sequentially.
+     *
+     * @param aOutput Output file, can be the source container itself.
+     */
+    void write(const fs::path& aOutput) const;
+
+    /**
+     * @brief Rewrite only the changed sectors of the source container.
+     *
+     * @note This is only possible if no streams were added or removed and every
+     *       replaced stream occupies the same number of (mini) sectors as before.
+     *       Otherwise nothing is written and `write` needs to be used instead.
+     *
+     * @return true If the replacements were written into the source container.
+     */
+    bool writeInPlace();
+
+    const fs::path& getSourcePath() const
+    {
+        return mSource;
+    }
+
+private:
+    struct DirEntry
+    {
+        std::array<uint8_t, 128U> raw; //!< Entry as stored in the container
+
+        uint8_t type;
+        uint32_t left;
+        uint32_t right;
+        uint32_t child;
+        uint32_t start;
+        uint64_t size;
+    };
+
+    void parse();
+
+    void indexStreams();
+
+    static std::string getName(const DirEntry& aEntry);
+
+    static DirEntry makeEntry(const std::string& aName, uint8_t aType);
+
+    /**
+     * @brief Directory entries to write, the tree is rebuilt if streams were added or removed.
+     *
+     * @param aOrder Source entry ID for every returned entry.
+     */
+    std::vector<DirEntry> getOutputEntries(std::vector<uint32_t>& aOrder) const;
+
+    uint32_t getStreamId(const std::vector<std::string>& aLocation) const;
+
+    std::vector<uint32_t> getChain(uint32_t aStart, const std::vector<uint32_t>& aFat) const;
+
+    std::size_t getSectorOffset(uint32_t aSector) const;
+
+    std::size_t getMiniSectorOffset(uint32_t aMiniSector) const;
+
+    bool isMini(uint64_t aSize) const
+    {
+        return aSize < mMiniStreamCutoff;
+    }
+
+    std::vector<uint8_t> readEntry(const DirEntry& aEntry) const;
+
+    fs::path mSource;
+
+    std::vector<uint8_t> mBuffer; //!< Content of the source container
+
+    uint16_t mMajorVersion;
+    std::size_t mSectorSize;
+    std::size_t mMiniSectorSize;
+    uint32_t mMiniStreamCutoff;
+
+    std::vector<uint32_t> mFat;
+    std::vector<uint32_t> mMiniFat;
+    std::vector<uint32_t> mDirChain;
+    std::vector<uint32_t> mMiniStreamChain; //!< Sectors of the mini stream
+
+    std::vector<DirEntry> mEntries;
+    std::vector<uint32_t> mParents; //!< Storage that contains the entry
+
+    std::map<std::vector<std::string>, uint32_t> mStorageIds; //!< Storage location to directory entry
+    std::map<std::vector<std::string>, uint32_t> mStreamIds;  //!< Stream location to directory entry
+
+    std::map<uint32_t, std::vector<uint8_t>> mReplacements; //!< Directory entry to new content
+
+    bool mTreeChanged; //!< Streams were added or removed
+};
+} // namespace OOCP
+#endif // CFBWRITER_HPP
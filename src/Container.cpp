@@ -33,6 +33,7 @@
 #include "Exception.hpp"
 #include "General.hpp"
 #include "PinShape.hpp"
+#include "PinTable.hpp"
 #include "Stream.hpp"
 #include "StreamFactory.hpp"
 
@@ -43,7 +44,9 @@ OOCP::Container::Container(const fs::path& aCfbfContainer, ParserConfig aCfg)
       mFileCtr{0U},
       mFileErrCtr{0U},
       mCtx{aCfbfContainer, "", aCfg, mDb},
-      mCfg{aCfg}
+      mCfg{aCfg},
+      mBlobStore{},
+      mImageExtractor{}
 {
     // Extract to a unique folder in case two similar named files
     // are extracted at the same time. E.g. in parallel execution.
@@ -65,6 +68,12 @@ OOCP::Container::Container(const fs::path& aCfbfContainer, ParserConfig aCfg)
 
 OOCP::Container::~Container()
 {
+    // Images are read from the extracted streams
+    if(mImageExtractor)
+    {
+        mImageExtractor->wait();
+    }
+
     if(!mCfg.mKeepTmpFiles)
     {
         // Remove temporary extracted files
@@ -93,6 +102,11 @@ void OOCP::Container::parseDatabaseFileThread(std::deque<std::shared_ptr<Stream>
         }
 
         stream->mCtx.mParsedSuccessfully = parsedSuccessfully;
+
+        if(mCtx.mCfg.mStreamParsedCallback)
+        {
+            mCtx.mCfg.mStreamParsedCallback(*stream);
+        }
     }
 }
 
@@ -247,6 +261,16 @@ void OOCP::Container::parseDatabaseFile()
 
     mCtx.mLogger.info(errCtrStr);
 
+    mBlobStore.addContainer(mCtx);
+
+    mDb.mPinTables = buildPinTables(mCtx);
+
+    if(mCtx.mCfg.mExtractImages)
+    {
+        mImageExtractor = std::make_unique<ImageExtractor>(mCtx, mBlobStore);
+        mImageExtractor->start(mCtx.mExtractedCfbfPath.parent_path() / "data");
+    }
+
     // mCtx.mLogger.info(to_string(mLibrary));
 }
 
@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include "BlobStore.hpp"
 #include "ContainerContext.hpp"
 #include "DataStream.hpp"
 #include "Database.hpp"
@@ -17,6 +18,7 @@
 #include "Enums/Structure.hpp"
 #include "FutureData.hpp"
 #include "General.hpp"
+#include "ImageExtractor.hpp"
 #include "Primitives/PrimBase.hpp"
 #include "Stream.hpp"
 
@@ -47,6 +49,14 @@ public:
         return mDb;
     }
 
+    /**
+     * @brief Unique embedded images and OLE objects, filled by `parseDatabaseFile`.
+     */
+    const BlobStore& getBlobStore() const
+    {
+        return mBlobStore;
+    }
+
     /**
      * @brief Extract container.
      *
@@ -96,6 +106,10 @@ private:
     ContainerContext mCtx;
 
     ParserConfig mCfg;
+
+    BlobStore mBlobStore;
+
+    std::unique_ptr<ImageExtractor> mImageExtractor; //!< Writes images in the background after parsing
 };
 } // namespace OOCP
 
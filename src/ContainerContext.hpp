@@ -14,12 +14,14 @@
 
 // #include "Database.hpp"
 #include "General.hpp"
+#include "OutputSink.hpp"
 
 namespace fs = std::filesystem;
 
 namespace OOCP
 {
 class Database;
+class Stream;
 
 struct ParserConfig
 {
@@ -33,6 +35,20 @@ struct ParserConfig
     bool mSkipInvalidStruct{true}; //!< Invalid structures should be skipped during parsing
 
     bool mKeepTmpFiles{true}; //!< Do not delete temporary files after parser completed
+
+    // Images are lazy by default, only their location is recorded and
+    // their data is read from the stream when it is actually needed
+    bool mLoadImages{false};    //!< Load embedded images into memory, otherwise only their location is recorded
+    bool mExtractImages{false}; //!< Write embedded images into files on a background thread after parsing
+
+    /**
+     * @brief Called after each stream was parsed, including streams that failed parsing.
+     *
+     * @note Called concurrently from the parser threads, i.e. it needs to be thread-safe.
+     */
+    std::function<void(Stream&)> mStreamParsedCallback{};
+
+    OutputConfig mOutputCfg{}; //!< Output of the exporters
 };
 
 [[maybe_unused]]
@@ -44,6 +60,9 @@ static std::string to_string(const ParserConfig& aCfg)
     str += fmt::format("mSkipUnknownStruct = {}\n", aCfg.mSkipUnknownStruct);
     str += fmt::format("mSkipInvalidStruct = {}\n", aCfg.mSkipInvalidStruct);
     str += fmt::format("mKeepTmpFiles      = {}\n", aCfg.mKeepTmpFiles);
+    str += fmt::format("mLoadImages        = {}\n", aCfg.mLoadImages);
+    str += fmt::format("mExtractImages     = {}\n", aCfg.mExtractImages);
+    str += fmt::format("mStreamParsedCallback = {}\n", static_cast<bool>(aCfg.mStreamParsedCallback));
 
     return str;
 }
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <memory>
@@ -50,6 +52,18 @@ OOCP::ContainerExtractor::ContainerExtractor(const fs::path& aContainer)
     // mReader->GetFileInfo();
 }
 
+OOCP::ContainerExtractor::ContainerExtractor(const std::vector<uint8_t>& aBuffer, const fs::path& aName)
+{
+    mContainer = aName;
+
+    mBufferLen = aBuffer.size();
+    mBuffer    = std::make_unique<uint8_t[]>(mBufferLen);
+
+    std::copy(aBuffer.cbegin(), aBuffer.cend(), mBuffer.get());
+
+    mReader = std::make_unique<CFB::CompoundFileReader>(mBuffer.get(), mBufferLen);
+}
+
 void OOCP::ContainerExtractor::outputFileInfo() const
 {
     const CFB::COMPOUND_FILE_HDR* hdr = mReader->GetFileInfo();
@@ -179,6 +193,21 @@ std::string OOCP::ContainerExtractor::getInternalPath(const CFB::COMPOUND_FILE_E
     return internalPath;
 }
 
+std::vector<OOCP::CfbEntry> OOCP::ContainerExtractor::getEntries() const
+{
+    std::vector<CfbEntry> entries;
+
+    mReader->EnumFiles(mReader->GetRootEntry(), -1,
+        [&, this](const CFB::COMPOUND_FILE_ENTRY* entry, const CFB::utf16string& /* dir */, int /* level */) -> void
+        {
+            const bool isStream = mReader->IsStream(entry) || mReader->IsPropertyStream(entry);
+
+            entries.push_back(CfbEntry{getInternalPath(entry), static_cast<std::size_t>(entry->size), isStream});
+        });
+
+    return entries;
+}
+
 fs::path OOCP::ContainerExtractor::extract(const fs::path& aOutputDir)
 {
     const fs::path baseOutputDir = aOutputDir / mContainer.filename();
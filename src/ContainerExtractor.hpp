@@ -1,8 +1,11 @@
 #ifndef CONTAINEREXTRACTOR_HPP
 #define CONTAINEREXTRACTOR_HPP
 
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,6 +18,16 @@ namespace fs = std::filesystem;
 
 namespace OOCP
 {
+/**
+ * @brief Entry of a CFBF container.
+ */
+struct CfbEntry
+{
+    std::string path; //!< Path of the entry inside the container
+    std::size_t size; //!< Size in byte
+    bool isStream;    //!< True for streams, false for storages (directories)
+};
+
 class ContainerExtractor
 {
 
@@ -23,6 +36,14 @@ public:
 
     ContainerExtractor(const fs::path& aContainer);
 
+    /**
+     * @brief Read a container from memory, e.g. one that is embedded into a stream.
+     *
+     * @param aBuffer Content of the container.
+     * @param aName Name of the container, used as directory name when extracting it.
+     */
+    ContainerExtractor(const std::vector<uint8_t>& aBuffer, const fs::path& aName);
+
     /**
      * @brief Print file info.
      */
@@ -65,6 +86,11 @@ public:
      */
     std::string getInternalPath(const CFB::COMPOUND_FILE_ENTRY* aEntry) const;
 
+    /**
+     * @brief List all entries of the container without extracting them.
+     */
+    std::vector<CfbEntry> getEntries() const;
+
     /**
      * @brief Extract CFBF container.
      *
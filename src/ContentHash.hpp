@@ -0,0 +1,69 @@
+#ifndef CONTENTHASH_HPP
+#define CONTENTHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include <fmt/core.h>
+
+namespace OOCP
+{
+/**
+ * @brief Incremental 64 bit FNV-1a hash, used to identify content e.g. for caching.
+ *
+ * @note This is not a cryptographic hash. Use it for lookups and deduplication
+ *       candidates, compare the actual content when collisions matter.
+ */
+class ContentHash
+{
+public:
+    ContentHash()
+        : mHash{OffsetBasis}
+    {
+    }
+
+    void add(const void* aData, std::size_t aLen)
+    {
+        const auto* data = static_cast<const uint8_t*>(aData);
+
+        for(std::size_t i = 0U; i < aLen; ++i)
+        {
+            mHash ^= data[i];
+            mHash *= Prime;
+        }
+    }
+
+    template <typename T>
+        requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    void add(T aVal)
+    {
+        add(&aVal, sizeof(aVal));
+    }
+
+    void add(const std::string& aStr)
+    {
+        // Include the length s.t. concatenated strings differ
+        add(static_cast<uint64_t>(aStr.size()));
+        add(aStr.data(), aStr.size());
+    }
+
+    uint64_t getHash() const
+    {
+        return mHash;
+    }
+
+    std::string to_string() const
+    {
+        return fmt::format("{:016x}", mHash);
+    }
+
+private:
+    static constexpr uint64_t OffsetBasis = 0xcbf29ce484222325ULL;
+    static constexpr uint64_t Prime       = 0x00000100000001b3ULL;
+
+    uint64_t mHash;
+};
+} // namespace OOCP
+#endif // CONTENTHASH_HPP
@@ -22,9 +22,11 @@ std::vector<uint8_t> OOCP::DataStream::readBytes(size_t aLen)
     std::vector<uint8_t> data;
     data.resize(aLen);
 
-    for(auto& byte : data)
+    if(aLen > 0U)
     {
-        byte = readUint8();
+        read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(aLen));
+
+        sanitizeNoEoF();
     }
 
     return data;
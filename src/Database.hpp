@@ -6,6 +6,7 @@
 #include <optional>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <fmt/core.h>
@@ -13,6 +14,7 @@
 
 #include "Enums/DirectoryType.hpp"
 #include "Enums/StreamType.hpp"
+#include "PinTable.hpp"
 #include "Stream.hpp"
 
 namespace OOCP
@@ -21,7 +23,8 @@ class Database
 {
 public:
     Database()
-        : mStreams{}
+        : mStreams{},
+          mPinTables{}
     {
     }
 
@@ -36,6 +39,10 @@ public:
 
     // List of streams in the CFBF container
     std::vector<std::shared_ptr<Stream>> mStreams;
+
+    // Pin tables of all packages, built once after parsing.
+    // Package name -> pin table
+    std::unordered_map<std::string, PinTable> mPinTables;
 };
 
 [[maybe_unused]]
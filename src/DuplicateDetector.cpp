@@ -0,0 +1,555 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "BoundingBox.hpp"
+#include "CfbfStreamLocation.hpp"
+#include "ContentHash.hpp"
+#include "Database.hpp"
+#include "DuplicateDetector.hpp"
+#include "ParallelFor.hpp"
+#include "PinShape.hpp"
+#include "PinTable.hpp"
+#include "Primitives/Point.hpp"
+#include "Primitives/PrimArc.hpp"
+#include "Primitives/PrimBase.hpp"
+#include "Primitives/PrimBezier.hpp"
+#include "Primitives/PrimBitmap.hpp"
+#include "Primitives/PrimCommentText.hpp"
+#include "Primitives/PrimEllipse.hpp"
+#include "Primitives/PrimLine.hpp"
+#include "Primitives/PrimPolygon.hpp"
+#include "Primitives/PrimPolyline.hpp"
+#include "Primitives/PrimRect.hpp"
+#include "Primitives/PrimSymbolVector.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamSymbol.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructSthInPages0.hpp"
+#include "Structures/StructSymbolPin.hpp"
+
+namespace
+{
+using PointList = std::vector<std::pair<int32_t, int32_t>>;
+
+// Maps coordinates into the canonical, origin independent space
+class Canonicalizer
+{
+public:
+    Canonicalizer(const OOCP::BoundingBox& aBBox, int32_t aGrid, bool aNear)
+        : mOriginX{aBBox.isEmpty() ? 0 : aBBox.x1},
+          mOriginY{aBBox.isEmpty() ? 0 : aBBox.y1},
+          mGrid{std::max(aGrid, 1)},
+          mNear{aNear}
+    {
+    }
+
+    std::pair<int32_t, int32_t> map(int32_t aX, int32_t aY) const
+    {
+        return std::make_pair(snap(aX - mOriginX), snap(aY - mOriginY));
+    }
+
+    bool isNear() const
+    {
+        return mNear;
+    }
+
+private:
+    int32_t snap(int32_t aVal) const
+    {
+        if(!mNear)
+        {
+            return aVal;
+        }
+
+        return static_cast<int32_t>(std::lround(static_cast<double>(aVal) / mGrid));
+    }
+
+    int32_t mOriginX;
+    int32_t mOriginY;
+
+    int32_t mGrid;
+
+    bool mNear;
+};
+
+void addPoints(OOCP::ContentHash& aHash, const PointList& aPoints)
+{
+    aHash.add(static_cast<uint64_t>(aPoints.size()));
+
+    for(const auto& [x, y] : aPoints)
+    {
+        aHash.add(x);
+        aHash.add(y);
+    }
+}
+
+PointList mapPoints(const std::vector<OOCP::Point>& aPoints, const Canonicalizer& aCanon, int32_t aOffsetX,
+    int32_t aOffsetY)
+{
+    PointList points;
+
+    for(const auto& point : aPoints)
+    {
+        points.push_back(aCanon.map(aOffsetX + point.x, aOffsetY + point.y));
+    }
+
+    return points;
+}
+
+// An open path drawn in reverse looks the same
+PointList canonicalizePath(PointList aPoints)
+{
+    PointList reversed{aPoints.rbegin(), aPoints.rend()};
+
+    return std::min(aPoints, reversed);
+}
+
+// A closed path looks the same independent of its start vertex and direction
+PointList canonicalizeLoop(const PointList& aPoints)
+{
+    if(aPoints.empty())
+    {
+        return aPoints;
+    }
+
+    PointList best;
+
+    for(const PointList& loop : {aPoints, PointList{aPoints.rbegin(), aPoints.rend()}})
+    {
+        const auto minIt = std::min_element(loop.begin(), loop.end());
+
+        PointList rotated{minIt, loop.end()};
+        rotated.insert(rotated.end(), loop.begin(), minIt);
+
+        if(best.empty() || rotated < best)
+        {
+            best = std::move(rotated);
+        }
+    }
+
+    return best;
+}
+
+// Rectangles can be stored with any two opposite corners
+PointList canonicalizeRect(const Canonicalizer& aCanon, int32_t aX1, int32_t aY1, int32_t aX2, int32_t aY2)
+{
+    const auto p1 = aCanon.map(std::min(aX1, aX2), std::min(aY1, aY2));
+    const auto p2 = aCanon.map(std::max(aX1, aX2), std::max(aY1, aY2));
+
+    return PointList{p1, p2};
+}
+
+void hashPrimitive(std::vector<uint64_t>& aHashes, const OOCP::PrimBase& aPrim, const Canonicalizer& aCanon,
+    int32_t aOffsetX = 0, int32_t aOffsetY = 0)
+{
+    OOCP::ContentHash hash;
+
+    hash.add(aPrim.getObjectType());
+
+    const int32_t dx = aOffsetX;
+    const int32_t dy = aOffsetY;
+
+    if(const auto* rect = dynamic_cast<const OOCP::PrimRect*>(&aPrim))
+    {
+        addPoints(hash, canonicalizeRect(aCanon, dx + rect->x1, dy + rect->y1, dx + rect->x2, dy + rect->y2));
+    }
+    else if(const auto* line = dynamic_cast<const OOCP::PrimLine*>(&aPrim))
+    {
+        addPoints(hash,
+            canonicalizePath({aCanon.map(dx + line->x1, dy + line->y1), aCanon.map(dx + line->x2, dy + line->y2)}));
+    }
+    else if(const auto* arc = dynamic_cast<const OOCP::PrimArc*>(&aPrim))
+    {
+        // The direction of an arc matters, keep start and end as they are
+        addPoints(hash, canonicalizeRect(aCanon, dx + arc->x1, dy + arc->y1, dx + arc->x2, dy + arc->y2));
+        addPoints(hash, {aCanon.map(dx + arc->startX, dy + arc->startY), aCanon.map(dx + arc->endX, dy + arc->endY)});
+    }
+    else if(const auto* ellipse = dynamic_cast<const OOCP::PrimEllipse*>(&aPrim))
+    {
+        addPoints(
+            hash, canonicalizeRect(aCanon, dx + ellipse->x1, dy + ellipse->y1, dx + ellipse->x2, dy + ellipse->y2));
+    }
+    else if(const auto* polygon = dynamic_cast<const OOCP::PrimPolygon*>(&aPrim))
+    {
+        addPoints(hash, canonicalizeLoop(mapPoints(polygon->points, aCanon, dx, dy)));
+    }
+    else if(const auto* polyline = dynamic_cast<const OOCP::PrimPolyline*>(&aPrim))
+    {
+        addPoints(hash, canonicalizePath(mapPoints(polyline->points, aCanon, dx, dy)));
+    }
+    else if(const auto* bezier = dynamic_cast<const OOCP::PrimBezier*>(&aPrim))
+    {
+        addPoints(hash, canonicalizePath(mapPoints(bezier->points, aCanon, dx, dy)));
+    }
+    else if(const auto* commentText = dynamic_cast<const OOCP::PrimCommentText*>(&aPrim))
+    {
+        addPoints(hash, {aCanon.map(dx + commentText->locX, dy + commentText->locY)});
+
+        if(!aCanon.isNear())
+        {
+            hash.add(commentText->name);
+        }
+    }
+    else if(const auto* bitmap = dynamic_cast<const OOCP::PrimBitmap*>(&aPrim))
+    {
+        addPoints(hash, canonicalizeRect(aCanon, dx + bitmap->x1, dy + bitmap->y1, dx + bitmap->x2, dy + bitmap->y2));
+
+        if(!aCanon.isNear())
+        {
+            hash.add(bitmap->bmpWidth);
+            hash.add(bitmap->bmpHeight);
+            hash.add(bitmap->getBlobHash());
+        }
+    }
+    else if(const auto* symbolVector = dynamic_cast<const OOCP::PrimSymbolVector*>(&aPrim))
+    {
+        // Flatten nested primitives s.t. grouping them does not change the fingerprint
+        for(const auto& primitive : symbolVector->primitives)
+        {
+            if(primitive)
+            {
+                hashPrimitive(aHashes, *primitive, aCanon, dx + symbolVector->locX, dy + symbolVector->locY);
+            }
+        }
+
+        return;
+    }
+
+    aHashes.push_back(hash.getHash());
+}
+
+uint64_t hashPin(const OOCP::StructSymbolPin& aPin, const Canonicalizer& aCanon)
+{
+    OOCP::ContentHash hash;
+
+    addPoints(hash, {aCanon.map(aPin.startX, aPin.startY), aCanon.map(aPin.hotptX, aPin.hotptY)});
+
+    if(!aCanon.isNear())
+    {
+        hash.add(aPin.name);
+        hash.add(aPin.portType);
+
+        const OOCP::PinShape& shape = aPin.pinShape;
+
+        for(const bool flag : {shape.isLong, shape.isClock, shape.isDot, shape.isLeftPointing, shape.isRightPointing,
+                shape.isNetStyle, shape.isNoConnect, shape.isGlobal, shape.isNumberVisible})
+        {
+            hash.add(flag);
+        }
+    }
+
+    return hash.getHash();
+}
+
+// Origin of the symbol geometry. Texts are excluded as their
+// extents depend on the font which is a cosmetic property.
+OOCP::BoundingBox getGeometryBBox(const std::vector<std::unique_ptr<OOCP::PrimBase>>& aPrimitives,
+    const std::vector<std::unique_ptr<OOCP::StructSymbolPin>>& aPins)
+{
+    OOCP::BoundingBox bbox;
+
+    for(const auto& primitive : aPrimitives)
+    {
+        if(primitive && !dynamic_cast<const OOCP::PrimCommentText*>(primitive.get()))
+        {
+            bbox.extend(OOCP::getBoundingBox(*primitive));
+        }
+    }
+
+    for(const auto& pin : aPins)
+    {
+        if(pin)
+        {
+            bbox.extend(pin->startX, pin->startY);
+            bbox.extend(pin->hotptX, pin->hotptY);
+        }
+    }
+
+    return bbox;
+}
+
+uint64_t hashGeometry(const std::vector<std::unique_ptr<OOCP::PrimBase>>& aPrimitives,
+    const std::vector<std::unique_ptr<OOCP::StructSymbolPin>>& aPins, const Canonicalizer& aCanon)
+{
+    std::vector<uint64_t> primHashes;
+
+    for(const auto& primitive : aPrimitives)
+    {
+        if(primitive)
+        {
+            hashPrimitive(primHashes, *primitive, aCanon);
+        }
+    }
+
+    std::vector<uint64_t> pinHashes;
+
+    for(const auto& pin : aPins)
+    {
+        if(pin)
+        {
+            pinHashes.push_back(hashPin(*pin, aCanon));
+        }
+    }
+
+    // Sorting makes the fingerprint independent of the storage order
+    std::sort(primHashes.begin(), primHashes.end());
+    std::sort(pinHashes.begin(), pinHashes.end());
+
+    OOCP::ContentHash hash;
+
+    hash.add(static_cast<uint64_t>(primHashes.size()));
+
+    for(const uint64_t primHash : primHashes)
+    {
+        hash.add(primHash);
+    }
+
+    hash.add(static_cast<uint64_t>(pinHashes.size()));
+
+    for(const uint64_t pinHash : pinHashes)
+    {
+        hash.add(pinHash);
+    }
+
+    return hash.getHash();
+}
+
+OOCP::SymbolFingerprint getFingerprint(const std::vector<std::unique_ptr<OOCP::PrimBase>>& aPrimitives,
+    const std::vector<std::unique_ptr<OOCP::StructSymbolPin>>& aPins, int32_t aNearGrid)
+{
+    const OOCP::BoundingBox bbox = getGeometryBBox(aPrimitives, aPins);
+
+    OOCP::SymbolFingerprint fingerprint{};
+
+    fingerprint.exact = hashGeometry(aPrimitives, aPins, Canonicalizer{bbox, aNearGrid, false});
+    fingerprint.near  = hashGeometry(aPrimitives, aPins, Canonicalizer{bbox, aNearGrid, true});
+
+    return fingerprint;
+}
+
+std::vector<OOCP::DuplicateGroup> groupBy(const std::vector<OOCP::FingerprintEntry>& aEntries,
+    OOCP::DuplicateKind aKind)
+{
+    const auto getKey = [aKind](const OOCP::FingerprintEntry& aEntry)
+    { return aKind == OOCP::DuplicateKind::Exact ? aEntry.fingerprint.exact : aEntry.fingerprint.near; };
+
+    // Hash-join of all entries on their fingerprint
+    std::unordered_map<uint64_t, std::vector<std::size_t>> buckets;
+
+    for(std::size_t i = 0U; i < aEntries.size(); ++i)
+    {
+        buckets[getKey(aEntries[i])].push_back(i);
+    }
+
+    std::vector<OOCP::DuplicateGroup> groups;
+
+    for(const auto& [key, indices] : buckets)
+    {
+        if(indices.size() < 2U)
+        {
+            continue;
+        }
+
+        if(aKind == OOCP::DuplicateKind::Near)
+        {
+            std::unordered_set<uint64_t> exactFingerprints;
+
+            for(const std::size_t idx : indices)
+            {
+                exactFingerprints.insert(aEntries[idx].fingerprint.exact);
+            }
+
+            if(exactFingerprints.size() < 2U)
+            {
+                continue;
+            }
+        }
+
+        OOCP::DuplicateGroup group{};
+
+        group.kind        = aKind;
+        group.fingerprint = key;
+
+        for(const std::size_t idx : indices)
+        {
+            group.entries.push_back(aEntries[idx]);
+        }
+
+        groups.push_back(std::move(group));
+    }
+
+    return groups;
+}
+} // namespace
+
+OOCP::SymbolFingerprint OOCP::getFingerprint(const StructLibraryPart& aPart, int32_t aNearGrid)
+{
+    return ::getFingerprint(aPart.primitives, aPart.symbolPins, aNearGrid);
+}
+
+OOCP::SymbolFingerprint OOCP::getFingerprint(
+    const StreamPackage& aPackage, const PinTable& aPinTable, int32_t aNearGrid)
+{
+    ContentHash exact;
+    ContentHash near;
+
+    // The view order defines the part order (A, B, ...) and is therefore significant
+    exact.add(static_cast<uint64_t>(aPackage.libraryParts.size()));
+    near.add(static_cast<uint64_t>(aPackage.libraryParts.size()));
+
+    for(const auto& libraryPart : aPackage.libraryParts)
+    {
+        if(libraryPart)
+        {
+            const SymbolFingerprint viewFingerprint = getFingerprint(*libraryPart, aNearGrid);
+
+            exact.add(viewFingerprint.exact);
+            near.add(viewFingerprint.near);
+        }
+    }
+
+    // Pinout and footprint are not geometric, they only affect the exact fingerprint
+    if(aPackage.package)
+    {
+        exact.add(aPackage.package->pcbFootprint);
+
+        std::vector<uint64_t> pinHashes;
+
+        for(std::size_t pin = 0U; pin < aPinTable.getPinCtr(); ++pin)
+        {
+            ContentHash pinHash;
+
+            pinHash.add(static_cast<uint64_t>(aPinTable.getUnit(pin)));
+            pinHash.add(aPinTable.getName(pin));
+            pinHash.add(aPinTable.getNumber(pin));
+            pinHash.add(aPinTable.getPortType(pin));
+            pinHash.add(aPinTable.isIgnored(pin));
+
+            pinHashes.push_back(pinHash.getHash());
+        }
+
+        std::sort(pinHashes.begin(), pinHashes.end());
+
+        exact.add(static_cast<uint64_t>(pinHashes.size()));
+
+        for(const uint64_t pinHash : pinHashes)
+        {
+            exact.add(pinHash);
+        }
+    }
+
+    return SymbolFingerprint{exact.getHash(), near.getHash()};
+}
+
+OOCP::SymbolFingerprint OOCP::getFingerprint(const StreamSymbol& aSymbol, int32_t aNearGrid)
+{
+    static const std::vector<std::unique_ptr<PrimBase>> noPrimitives{};
+
+    const auto& primitives = aSymbol.symbol ? aSymbol.symbol->primitives : noPrimitives;
+
+    return ::getFingerprint(primitives, aSymbol.symbolPins, aNearGrid);
+}
+
+void OOCP::DuplicateDetector::addLibrary(ContainerContext& aCtx)
+{
+    std::vector<std::shared_ptr<Stream>> streams;
+
+    for(auto& stream : aCtx.mDb.mStreams)
+    {
+        if(std::dynamic_pointer_cast<StreamPackage>(stream) || std::dynamic_pointer_cast<StreamSymbol>(stream))
+        {
+            streams.push_back(stream);
+        }
+    }
+
+    aCtx.mLogger.info("Fingerprinting {} packages and symbols of {}", streams.size(), aCtx.mInputCfbfFile.string());
+
+    std::vector<std::optional<FingerprintEntry>> results(streams.size());
+
+    parallelFor(aCtx.mCfg.mThreadCount, streams.size(),
+        [&](std::size_t aIdx)
+        {
+            const auto& stream = streams[aIdx];
+
+            FingerprintEntry entry{};
+
+            entry.library        = aCtx.mInputCfbfFile.string();
+            entry.streamLocation = to_string(stream->mCtx.mCfbfStreamLocation);
+
+            if(const auto package = std::dynamic_pointer_cast<StreamPackage>(stream))
+            {
+                if(!package->package)
+                {
+                    return;
+                }
+
+                // Pin tables are built after parsing, packages that are not part of the database need their own
+                const auto pinTableIt = aCtx.mDb.mPinTables.find(package->package->name);
+
+                entry.name        = package->package->name;
+                entry.fingerprint = pinTableIt != aCtx.mDb.mPinTables.cend()
+                                        ? getFingerprint(*package, pinTableIt->second, mNearGrid)
+                                        : getFingerprint(*package, PinTable{*package}, mNearGrid);
+            }
+            else if(const auto symbol = std::dynamic_pointer_cast<StreamSymbol>(stream))
+            {
+                if(!symbol->symbol)
+                {
+                    return;
+                }
+
+                entry.name        = symbol->symbol->name;
+                entry.fingerprint = getFingerprint(*symbol, mNearGrid);
+            }
+
+            results[aIdx] = std::move(entry);
+        });
+
+    for(auto& result : results)
+    {
+        if(result.has_value())
+        {
+            mEntries.push_back(std::move(result.value()));
+        }
+    }
+}
+
+std::vector<OOCP::DuplicateGroup> OOCP::DuplicateDetector::findDuplicates() const
+{
+    std::vector<DuplicateGroup> groups = groupBy(mEntries, DuplicateKind::Exact);
+
+    std::vector<DuplicateGroup> nearGroups = groupBy(mEntries, DuplicateKind::Near);
+
+    groups.insert(
+        groups.end(), std::make_move_iterator(nearGroups.begin()), std::make_move_iterator(nearGroups.end()));
+
+    // Deterministic order, largest groups first
+    std::sort(groups.begin(), groups.end(),
+        [](const DuplicateGroup& aLhs, const DuplicateGroup& aRhs)
+        {
+            if(aLhs.kind != aRhs.kind)
+            {
+                return aLhs.kind < aRhs.kind;
+            }
+
+            if(aLhs.entries.size() != aRhs.entries.size())
+            {
+                return aLhs.entries.size() > aRhs.entries.size();
+            }
+
+            return aLhs.fingerprint < aRhs.fingerprint;
+        });
+
+    return groups;
+}
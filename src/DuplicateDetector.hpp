@@ -0,0 +1,183 @@
+#ifndef DUPLICATEDETECTOR_HPP
+#define DUPLICATEDETECTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <magic_enum.hpp>
+#include <nameof.hpp>
+
+#include "ContainerContext.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+class PinTable;
+class StreamPackage;
+class StreamSymbol;
+class StructLibraryPart;
+
+/**
+ * @brief Canonical geometric fingerprint of a package or symbol.
+ *
+ * @note Primitives and pins are normalized for their order and for the
+ *       origin of the symbol, i.e. the minimum corner of its geometry.
+ *       Cosmetic fields like line styles, line widths, fill styles,
+ *       colors and fonts are ignored.
+ */
+struct SymbolFingerprint
+{
+    uint64_t exact; //!< Geometry, texts, pins incl. names, types, shapes and numbers and the PCB footprint
+    uint64_t near;  //!< Geometry and pin positions snapped to a grid, names and texts are ignored
+
+    bool operator==(const SymbolFingerprint&) const = default;
+};
+
+/**
+ * @brief Compute fingerprint of a single package view.
+ *
+ * @param aPart Package view.
+ * @param aNearGrid Grid size used for snapping coordinates of the near-duplicate fingerprint.
+ * @return SymbolFingerprint Fingerprint.
+ */
+SymbolFingerprint getFingerprint(const StructLibraryPart& aPart, int32_t aNearGrid);
+
+/**
+ * @brief Compute fingerprint of a package, i.e. of all its views in their stored order.
+ *
+ * @param aPinTable Pin table of the package, contributes the pinout to the exact fingerprint.
+ */
+SymbolFingerprint getFingerprint(const StreamPackage& aPackage, const PinTable& aPinTable, int32_t aNearGrid);
+
+/**
+ * @brief Compute fingerprint of a symbol from the `Symbols` storage, e.g. a power or port symbol.
+ */
+SymbolFingerprint getFingerprint(const StreamSymbol& aSymbol, int32_t aNearGrid);
+
+enum class DuplicateKind
+{
+    Exact, //!< Identical exact fingerprint
+    Near   //!< Identical near-duplicate fingerprint but different exact fingerprints
+};
+
+[[maybe_unused]]
+static std::string to_string(const DuplicateKind& aVal)
+{
+    return std::string{magic_enum::enum_name<decltype(aVal)>(aVal)};
+}
+
+struct FingerprintEntry
+{
+    std::string library;        //!< Path to the library the entry was found in
+    std::string streamLocation; //!< Location of the stream inside the CFBF container
+    std::string name;           //!< Package or symbol name
+
+    SymbolFingerprint fingerprint;
+};
+
+struct DuplicateGroup
+{
+    DuplicateKind kind;
+
+    uint64_t fingerprint; //!< Exact or near fingerprint, depending on `kind`
+
+    std::vector<FingerprintEntry> entries;
+};
+
+/**
+ * @brief Detects duplicate packages and symbols across a corpus of libraries.
+ *
+ * @note Fingerprints are computed when a library is added, such that the parsed
+ *       library can be released afterwards. Only the fingerprints and stream
+ *       locations of the whole corpus are kept in memory.
+ */
+class DuplicateDetector
+{
+public:
+    /**
+     * @param aNearGrid Grid size used for the near-duplicate fingerprint, 10 units
+     *                  equal 0.1 inch which is the default grid in OrCAD.
+     */
+    DuplicateDetector(int32_t aNearGrid = 10)
+        : mNearGrid{aNearGrid},
+          mEntries{}
+    {
+    }
+
+    /**
+     * @brief Fingerprint all packages and symbols of a parsed library.
+     *
+     * @note Streams are hashed in parallel with the number of threads configured in `ParserConfig`.
+     *
+     * @param aCtx Context of the parsed library.
+     */
+    void addLibrary(ContainerContext& aCtx);
+
+    /**
+     * @brief Group all entries added so far by their fingerprints.
+     *
+     * @note Exact groups contain entries with identical exact fingerprints. Near groups
+     *       are only reported if they contain at least two different exact fingerprints,
+     *       otherwise they are already covered by an exact group.
+     *
+     * @return std::vector<DuplicateGroup> Groups with at least two entries.
+     */
+    std::vector<DuplicateGroup> findDuplicates() const;
+
+    const std::vector<FingerprintEntry>& getEntries() const
+    {
+        return mEntries;
+    }
+
+private:
+    int32_t mNearGrid;
+
+    std::vector<FingerprintEntry> mEntries;
+};
+
+[[maybe_unused]]
+static std::string to_string(const FingerprintEntry& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}library        = {}\n", indent(1), aObj.library);
+    str += fmt::format("{}streamLocation = {}\n", indent(1), aObj.streamLocation);
+    str += fmt::format("{}name           = {}\n", indent(1), aObj.name);
+    str += fmt::format("{}exact          = {:016x}\n", indent(1), aObj.fingerprint.exact);
+    str += fmt::format("{}near           = {:016x}\n", indent(1), aObj.fingerprint.near);
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::string to_string(const DuplicateGroup& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}kind        = {}\n", indent(1), to_string(aObj.kind));
+    str += fmt::format("{}fingerprint = {:016x}\n", indent(1), aObj.fingerprint);
+
+    for(std::size_t i = 0U; i < aObj.entries.size(); ++i)
+    {
+        str += fmt::format("{}entry[{}]:\n", indent(1), i);
+        str += indent(to_string(aObj.entries[i]), 2);
+    }
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const DuplicateGroup& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // DUPLICATEDETECTOR_HPP
@@ -0,0 +1,63 @@
+#ifndef ENCODING_HPP
+#define ENCODING_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace OOCP
+{
+/**
+ * @brief Append a CP1252 character as UTF-8.
+ *
+ * @note Strings in OrCAD files are CP1252 encoded while all text based
+ *       output formats (JSON, XML, KiCad, SQLite, Arrow) require UTF-8.
+ */
+[[maybe_unused]]
+static void appendCp1252AsUtf8(std::string& aBuf, unsigned char aChr)
+{
+    // Code points of 0x80 - 0x9f, unassigned characters keep their C1 control code point
+    static constexpr std::array<char16_t, 32U> HighChars = {0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020,
+        0x2021, 0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x017d, 0x008f, 0x0090, 0x2018, 0x2019, 0x201c,
+        0x201d, 0x2022, 0x2013, 0x2014, 0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x017e, 0x0178};
+
+    if(aChr < 0x80U)
+    {
+        aBuf += static_cast<char>(aChr);
+        return;
+    }
+
+    const uint32_t cp = aChr < 0xa0U ? HighChars[aChr - 0x80U] : aChr;
+
+    if(cp < 0x800U)
+    {
+        aBuf += static_cast<char>(0xc0U | (cp >> 6U));
+        aBuf += static_cast<char>(0x80U | (cp & 0x3fU));
+    }
+    else
+    {
+        aBuf += static_cast<char>(0xe0U | (cp >> 12U));
+        aBuf += static_cast<char>(0x80U | ((cp >> 6U) & 0x3fU));
+        aBuf += static_cast<char>(0x80U | (cp & 0x3fU));
+    }
+}
+
+/**
+ * @brief Transcode a CP1252 string to UTF-8.
+ */
+[[maybe_unused]]
+static std::string cp1252ToUtf8(std::string_view aStr)
+{
+    std::string str;
+    str.reserve(aStr.size());
+
+    for(const char c : aStr)
+    {
+        appendCp1252AsUtf8(str, static_cast<unsigned char>(c));
+    }
+
+    return str;
+}
+} // namespace OOCP
+#endif // ENCODING_HPP
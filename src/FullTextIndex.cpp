@@ -0,0 +1,553 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "ContentHash.hpp"
+#include "Database.hpp"
+#include "FullTextIndex.hpp"
+#include "ParallelFor.hpp"
+#include "Primitives/PrimCommentText.hpp"
+#include "PropertyTable.hpp"
+#include "Streams/StreamPage.hpp"
+
+namespace
+{
+// Common BM25 parameters
+constexpr double Bm25K1 = 1.2;
+constexpr double Bm25B  = 0.75;
+
+constexpr uint32_t InvalidDocId = std::numeric_limits<uint32_t>::max();
+
+void appendCommentTexts(const OOCP::StructGraphicInst& aInst, std::vector<std::string>& aTexts)
+{
+    if(!aInst.sthInPages0)
+    {
+        return;
+    }
+
+    for(const auto& prim : aInst.sthInPages0->primitives)
+    {
+        if(const auto* text = dynamic_cast<const OOCP::PrimCommentText*>(prim.get()))
+        {
+            aTexts.push_back(text->name);
+        }
+    }
+}
+
+// Display properties only name the property, the values are properties of the instance
+void appendPropValues(const OOCP::StructPlacedInstance& aInst, const std::string& aStreamLocation,
+    const OOCP::PropertyTable& aPropTable, std::vector<std::string>& aTexts)
+{
+    if(!aInst.propOffset.has_value())
+    {
+        return;
+    }
+
+    const auto object = aPropTable.findObject(aStreamLocation, aInst.propOffset.value());
+
+    if(!object.has_value())
+    {
+        return;
+    }
+
+    for(const std::size_t row : aPropTable.getRows(object.value()))
+    {
+        aTexts.push_back(aPropTable.getValue(row));
+    }
+}
+} // namespace
+
+std::vector<OOCP::TextDocument> OOCP::FullTextIndex::collectDocuments(
+    const std::string& aDesign, const StreamPage& aPage, const PropertyTable& aPropTable)
+{
+    std::vector<TextDocument> docs;
+
+    const std::string streamLocation = to_string(aPage.mCtx.mCfbfStreamLocation);
+
+    const auto addDoc = [&](const std::string& aObject, TextSource aSource, const std::vector<std::string>& aTexts)
+    {
+        std::string text;
+
+        for(const auto& str : aTexts)
+        {
+            if(!str.empty())
+            {
+                text += text.empty() ? str : "\n" + str;
+            }
+        }
+
+        if(!text.empty())
+        {
+            docs.push_back(TextDocument{aDesign, streamLocation, aPage.name, aObject, aSource, std::move(text)});
+        }
+    };
+
+    for(std::size_t i = 0U; i < aPage.titleBlocks.size(); ++i)
+    {
+        if(const auto& inst = aPage.titleBlocks[i])
+        {
+            std::vector<std::string> texts{inst->name};
+
+            appendCommentTexts(*inst, texts);
+
+            addDoc(fmt::format("titleBlocks[{}]", i), TextSource::TitleBlock, texts);
+        }
+    }
+
+    for(std::size_t i = 0U; i < aPage.graphicInsts.size(); ++i)
+    {
+        if(const auto& inst = aPage.graphicInsts[i])
+        {
+            std::vector<std::string> texts;
+
+            appendCommentTexts(*inst, texts);
+
+            addDoc(fmt::format("graphicInsts[{}]", i), TextSource::CommentText, texts);
+        }
+    }
+
+    for(std::size_t i = 0U; i < aPage.placedInstances.size(); ++i)
+    {
+        if(const auto& inst = aPage.placedInstances[i])
+        {
+            std::vector<std::string> texts{inst->reference, inst->pkgName};
+
+            appendPropValues(*inst, streamLocation, aPropTable, texts);
+
+            addDoc(fmt::format("placedInstances[{}]", i), TextSource::Part, texts);
+        }
+    }
+
+    for(std::size_t i = 0U; i < aPage.wires.size(); ++i)
+    {
+        if(const auto& wire = aPage.wires[i])
+        {
+            std::vector<std::string> texts;
+
+            for(const auto& alias : wire->aliases)
+            {
+                if(alias)
+                {
+                    texts.push_back(alias->name);
+                }
+            }
+
+            addDoc(fmt::format("wires[{}]", i), TextSource::Net, texts);
+        }
+    }
+
+    const auto addNetInsts = [&addDoc](const auto& aInsts, const std::string& aMember)
+    {
+        for(std::size_t i = 0U; i < aInsts.size(); ++i)
+        {
+            if(const auto& inst = aInsts[i])
+            {
+                addDoc(fmt::format("{}[{}]", aMember, i), TextSource::Net, {inst->name});
+            }
+        }
+    };
+
+    addNetInsts(aPage.ports, "ports");
+    addNetInsts(aPage.globals, "globals");
+    addNetInsts(aPage.offPageConnectors, "offPageConnectors");
+
+    return docs;
+}
+
+std::size_t OOCP::FullTextIndex::updateDesign(ContainerContext& aCtx)
+{
+    const std::string design = aCtx.mInputCfbfFile.string();
+
+    std::vector<std::shared_ptr<StreamPage>> pages;
+
+    for(const auto& stream : aCtx.mDb.mStreams)
+    {
+        if(const auto page = std::dynamic_pointer_cast<StreamPage>(stream))
+        {
+            pages.push_back(page);
+        }
+    }
+
+    const PropertyTable propTable{aCtx};
+
+    std::vector<std::vector<TextDocument>> pageDocs(pages.size());
+    std::vector<uint64_t> pageHashes(pages.size());
+
+    parallelFor(aCtx.mCfg.mThreadCount, pages.size(),
+        [&](std::size_t aIdx)
+        {
+            pageDocs[aIdx] = collectDocuments(design, *pages[aIdx], propTable);
+
+            ContentHash hash;
+
+            hash.add(pages[aIdx]->name);
+
+            for(const auto& doc : pageDocs[aIdx])
+            {
+                hash.add(doc.object);
+                hash.add(doc.source);
+                hash.add(doc.text);
+            }
+
+            pageHashes[aIdx] = hash.getHash();
+        });
+
+    auto& designPages = mPages[design];
+
+    std::map<std::string, PageEntry> updatedPages;
+
+    std::size_t updatedCtr = 0U;
+
+    for(std::size_t i = 0U; i < pages.size(); ++i)
+    {
+        const std::string streamLocation = to_string(pages[i]->mCtx.mCfbfStreamLocation);
+
+        const auto it = designPages.find(streamLocation);
+
+        if(it != designPages.end())
+        {
+            // Unchanged pages keep their documents
+            if(it->second.contentHash == pageHashes[i])
+            {
+                updatedPages.insert(designPages.extract(it));
+                continue;
+            }
+
+            removeDocuments(it->second.docIds);
+            designPages.erase(it);
+        }
+
+        PageEntry entry{pageHashes[i], {}};
+
+        for(auto& doc : pageDocs[i])
+        {
+            entry.docIds.push_back(static_cast<uint32_t>(mDocs.size()));
+
+            addDocument(std::move(doc));
+        }
+
+        updatedPages.insert_or_assign(streamLocation, std::move(entry));
+
+        ++updatedCtr;
+    }
+
+    // Remaining pages do not exist anymore
+    for(const auto& [streamLocation, entry] : designPages)
+    {
+        removeDocuments(entry.docIds);
+    }
+
+    designPages = std::move(updatedPages);
+
+    if(2U * mAliveCtr < mDocs.size())
+    {
+        compact();
+    }
+
+    aCtx.mLogger.info("Indexed {} of {} pages of {}", updatedCtr, pages.size(), design);
+
+    return updatedCtr;
+}
+
+bool OOCP::FullTextIndex::removeDesign(const std::string& aDesign)
+{
+    const auto it = mPages.find(aDesign);
+
+    if(it == mPages.end())
+    {
+        return false;
+    }
+
+    for(const auto& [streamLocation, entry] : it->second)
+    {
+        removeDocuments(entry.docIds);
+    }
+
+    mPages.erase(it);
+
+    if(2U * mAliveCtr < mDocs.size())
+    {
+        compact();
+    }
+
+    return true;
+}
+
+std::vector<OOCP::TextHit> OOCP::FullTextIndex::search(const std::string& aQuery, std::size_t aLimit) const
+{
+    std::vector<std::string> tokens = tokenize(aQuery);
+
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+    std::vector<TextHit> hits;
+
+    if(tokens.empty() || mAliveCtr == 0U)
+    {
+        return hits;
+    }
+
+    std::vector<std::pair<const std::vector<Posting>*, double>> lists; // Postings and IDF per token
+
+    for(const auto& token : tokens)
+    {
+        const auto it = mTerms.find(token);
+
+        if(it == mTerms.cend() || it->second.docFreq == 0U)
+        {
+            return hits;
+        }
+
+        const double docFreq = static_cast<double>(it->second.docFreq);
+
+        const double idf = std::log(1.0 + (static_cast<double>(mAliveCtr) - docFreq + 0.5) / (docFreq + 0.5));
+
+        lists.emplace_back(&it->second.postings, idf);
+    }
+
+    // Iterate the shortest list and look up the documents in the others
+    std::sort(lists.begin(), lists.end(),
+        [](const auto& aLhs, const auto& aRhs) { return aLhs.first->size() < aRhs.first->size(); });
+
+    const double avgDocLen = static_cast<double>(mAliveTokenCtr) / static_cast<double>(mAliveCtr);
+
+    const auto getScore = [&](uint32_t aDocId, uint32_t aTermFreq, double aIdf)
+    {
+        const double termFreq = static_cast<double>(aTermFreq);
+        const double docLen   = static_cast<double>(mDocLens[aDocId]);
+
+        return aIdf * termFreq * (Bm25K1 + 1.0) /
+               (termFreq + Bm25K1 * (1.0 - Bm25B + Bm25B * docLen / std::max(avgDocLen, 1.0)));
+    };
+
+    for(const Posting& posting : *lists.front().first)
+    {
+        if(!mAlive[posting.docId])
+        {
+            continue;
+        }
+
+        double score = getScore(posting.docId, posting.termFreq, lists.front().second);
+
+        bool isMatch = true;
+
+        for(std::size_t i = 1U; i < lists.size() && isMatch; ++i)
+        {
+            const auto& list = *lists[i].first;
+
+            const auto it = std::lower_bound(list.cbegin(), list.cend(), posting.docId,
+                [](const Posting& aPosting, uint32_t aDocId) { return aPosting.docId < aDocId; });
+
+            isMatch = it != list.cend() && it->docId == posting.docId;
+
+            if(isMatch)
+            {
+                score += getScore(posting.docId, it->termFreq, lists[i].second);
+            }
+        }
+
+        if(isMatch)
+        {
+            hits.push_back(TextHit{posting.docId, score});
+        }
+    }
+
+    // Documents are in index order, i.e. ties keep a deterministic order
+    std::stable_sort(
+        hits.begin(), hits.end(), [](const TextHit& aLhs, const TextHit& aRhs) { return aLhs.score > aRhs.score; });
+
+    if(hits.size() > aLimit)
+    {
+        hits.resize(aLimit);
+    }
+
+    return hits;
+}
+
+std::vector<OOCP::TextPageHit> OOCP::FullTextIndex::searchPages(const std::string& aQuery, std::size_t aLimit) const
+{
+    std::map<std::pair<std::string, std::string>, TextPageHit> pageHits; // Design and stream location -> hit
+
+    for(const TextHit& hit : search(aQuery, std::numeric_limits<std::size_t>::max()))
+    {
+        const TextDocument& doc = getDocument(hit.docId);
+
+        auto& pageHit = pageHits
+                            .try_emplace(std::make_pair(doc.design, doc.streamLocation),
+                                TextPageHit{doc.design, doc.streamLocation, doc.page, 0.0, 0U})
+                            .first->second;
+
+        pageHit.score += hit.score;
+        ++pageHit.documentCtr;
+    }
+
+    std::vector<TextPageHit> hits;
+
+    for(auto& [key, pageHit] : pageHits)
+    {
+        hits.push_back(std::move(pageHit));
+    }
+
+    std::stable_sort(hits.begin(), hits.end(),
+        [](const TextPageHit& aLhs, const TextPageHit& aRhs) { return aLhs.score > aRhs.score; });
+
+    if(hits.size() > aLimit)
+    {
+        hits.resize(aLimit);
+    }
+
+    return hits;
+}
+
+std::vector<std::string> OOCP::FullTextIndex::tokenize(const std::string& aText)
+{
+    std::vector<std::string> tokens;
+
+    std::string token;
+
+    for(const char c : aText)
+    {
+        const unsigned char uc = static_cast<unsigned char>(c);
+
+        // Bytes outside of ASCII are kept s.t. non-English words stay intact
+        if(std::isalnum(uc) || uc >= 0x80U)
+        {
+            token += static_cast<char>(std::tolower(uc));
+        }
+        else if(!token.empty())
+        {
+            tokens.push_back(std::move(token));
+            token.clear();
+        }
+    }
+
+    if(!token.empty())
+    {
+        tokens.push_back(std::move(token));
+    }
+
+    return tokens;
+}
+
+void OOCP::FullTextIndex::addDocument(TextDocument aDoc)
+{
+    const uint32_t docId = static_cast<uint32_t>(mDocs.size());
+
+    const std::vector<std::string> tokens = tokenize(aDoc.text);
+
+    std::unordered_map<std::string, uint32_t> termFreqs;
+
+    for(const auto& token : tokens)
+    {
+        ++termFreqs[token];
+    }
+
+    // Document IDs are ascending, i.e. the postings stay sorted
+    for(const auto& [token, termFreq] : termFreqs)
+    {
+        Term& term = mTerms[token];
+
+        term.postings.push_back(Posting{docId, termFreq});
+        ++term.docFreq;
+    }
+
+    mDocs.push_back(std::move(aDoc));
+    mDocLens.push_back(static_cast<uint32_t>(tokens.size()));
+    mAlive.push_back(true);
+
+    ++mAliveCtr;
+    mAliveTokenCtr += tokens.size();
+}
+
+void OOCP::FullTextIndex::removeDocuments(const std::vector<uint32_t>& aDocIds)
+{
+    for(const uint32_t docId : aDocIds)
+    {
+        if(!mAlive[docId])
+        {
+            continue;
+        }
+
+        mAlive[docId] = false;
+
+        --mAliveCtr;
+        mAliveTokenCtr -= mDocLens[docId];
+
+        std::vector<std::string> tokens = tokenize(mDocs[docId].text);
+
+        std::sort(tokens.begin(), tokens.end());
+        tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+        for(const auto& token : tokens)
+        {
+            --mTerms.at(token).docFreq;
+        }
+
+        // Release the texts, the document itself is dropped on compaction
+        mDocs[docId] = TextDocument{};
+    }
+}
+
+void OOCP::FullTextIndex::compact()
+{
+    std::vector<uint32_t> newDocIds(mDocs.size(), InvalidDocId);
+
+    std::vector<TextDocument> docs;
+    std::vector<uint32_t> docLens;
+
+    for(std::size_t i = 0U; i < mDocs.size(); ++i)
+    {
+        if(mAlive[i])
+        {
+            newDocIds[i] = static_cast<uint32_t>(docs.size());
+
+            docs.push_back(std::move(mDocs[i]));
+            docLens.push_back(mDocLens[i]);
+        }
+    }
+
+    for(auto it = mTerms.begin(); it != mTerms.end();)
+    {
+        auto& postings = it->second.postings;
+
+        std::erase_if(postings,
+            [&newDocIds](const Posting& aPosting) { return newDocIds[aPosting.docId] == InvalidDocId; });
+
+        for(auto& posting : postings)
+        {
+            posting.docId = newDocIds[posting.docId];
+        }
+
+        it->second.docFreq = static_cast<uint32_t>(postings.size());
+
+        it = postings.empty() ? mTerms.erase(it) : std::next(it);
+    }
+
+    for(auto& [design, designPages] : mPages)
+    {
+        for(auto& [streamLocation, entry] : designPages)
+        {
+            for(auto& docId : entry.docIds)
+            {
+                docId = newDocIds[docId];
+            }
+        }
+    }
+
+    mDocs    = std::move(docs);
+    mDocLens = std::move(docLens);
+    mAlive.assign(mDocs.size(), true);
+}
@@ -0,0 +1,208 @@
+#ifndef FULLTEXTINDEX_HPP
+#define FULLTEXTINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <magic_enum.hpp>
+#include <nameof.hpp>
+
+#include "ContainerContext.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+class PropertyTable;
+class StreamPage;
+
+enum class TextSource
+{
+    CommentText, //!< Free text placed on the page
+    TitleBlock,  //!< Name and texts of a title block
+    Part,        //!< Reference, package name and property values of a placed instance
+    Net          //!< Net aliases, ports, globals and off-page connectors
+};
+
+[[maybe_unused]]
+static std::string to_string(const TextSource& aVal)
+{
+    return std::string{magic_enum::enum_name<decltype(aVal)>(aVal)};
+}
+
+/**
+ * @brief Indexed object of a page with all of its texts.
+ */
+struct TextDocument
+{
+    std::string design;         //!< Path to the design
+    std::string streamLocation; //!< Location of the page stream inside the CFBF container
+    std::string page;           //!< Page name
+    std::string object;         //!< Object on the page, e.g. `placedInstances[3]`
+
+    TextSource source;
+
+    std::string text; //!< Texts of the object separated by new lines
+};
+
+struct TextHit
+{
+    uint32_t docId; //!< See `FullTextIndex::getDocument`, valid until the index is modified
+
+    double score; //!< BM25 score
+};
+
+struct TextPageHit
+{
+    std::string design;
+    std::string streamLocation;
+    std::string page;
+
+    double score;            //!< Sum of the scores of all matching objects
+    std::size_t documentCtr; //!< Number of matching objects
+};
+
+/**
+ * @brief Inverted full-text index over the texts of design pages.
+ *
+ * @note Every object on a page, e.g. a comment text, title block or placed
+ *       instance is a document. Pages are re-indexed only if the content hash
+ *       of their texts changed, removed documents are dropped from the postings
+ *       once they make up half of the index.
+ */
+class FullTextIndex
+{
+public:
+    FullTextIndex()
+        : mDocs{},
+          mDocLens{},
+          mAlive{},
+          mAliveCtr{0U},
+          mAliveTokenCtr{0U},
+          mTerms{},
+          mPages{}
+    {
+    }
+
+    /**
+     * @brief Index all pages of a parsed design, pages indexed before are updated.
+     *
+     * @note Texts of the pages are collected in parallel with the number of threads
+     *       configured in `ParserConfig`. Pages that do not exist anymore are removed.
+     *
+     * @param aCtx Context of the parsed design.
+     * @return std::size_t Number of pages that were (re-)indexed.
+     */
+    std::size_t updateDesign(ContainerContext& aCtx);
+
+    /**
+     * @return true If the design was indexed before.
+     */
+    bool removeDesign(const std::string& aDesign);
+
+    /**
+     * @brief Find objects that contain all tokens of the query.
+     *
+     * @return std::vector<TextHit> Hits sorted by their score, best first.
+     */
+    std::vector<TextHit> search(const std::string& aQuery, std::size_t aLimit = 100U) const;
+
+    /**
+     * @brief Find pages with objects that contain all tokens of the query.
+     *
+     * @return std::vector<TextPageHit> Hits sorted by their score, best first.
+     */
+    std::vector<TextPageHit> searchPages(const std::string& aQuery, std::size_t aLimit = 100U) const;
+
+    /**
+     * @brief Split a text into lower case tokens of letters and digits.
+     */
+    static std::vector<std::string> tokenize(const std::string& aText);
+
+    const TextDocument& getDocument(uint32_t aDocId) const
+    {
+        return mDocs.at(aDocId);
+    }
+
+    std::size_t getDocumentCtr() const
+    {
+        return mAliveCtr;
+    }
+
+    std::size_t getTokenCtr() const
+    {
+        return mTerms.size();
+    }
+
+private:
+    struct Posting
+    {
+        uint32_t docId;
+        uint32_t termFreq;
+    };
+
+    struct Term
+    {
+        std::vector<Posting> postings; //!< Sorted by document ID, may contain removed documents
+        uint32_t docFreq;              //!< Number of alive documents that contain the term
+    };
+
+    struct PageEntry
+    {
+        uint64_t contentHash;
+        std::vector<uint32_t> docIds;
+    };
+
+    static std::vector<TextDocument> collectDocuments(
+        const std::string& aDesign, const StreamPage& aPage, const PropertyTable& aPropTable);
+
+    void addDocument(TextDocument aDoc);
+
+    void removeDocuments(const std::vector<uint32_t>& aDocIds);
+
+    /**
+     * @brief Drop removed documents from the postings and renumber the remaining ones.
+     */
+    void compact();
+
+    std::vector<TextDocument> mDocs;
+    std::vector<uint32_t> mDocLens; //!< Number of tokens per document
+    std::vector<bool> mAlive;       //!< Documents that were not removed
+
+    std::size_t mAliveCtr;
+    std::size_t mAliveTokenCtr; //!< Sum of `mDocLens` of all alive documents
+
+    std::unordered_map<std::string, Term> mTerms; //!< Token -> postings and document frequency
+
+    std::map<std::string, std::map<std::string, PageEntry>> mPages; //!< Design -> stream location -> page
+};
+
+[[maybe_unused]]
+static std::string to_string(const TextPageHit& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}design         = {}\n", indent(1), aObj.design);
+    str += fmt::format("{}streamLocation = {}\n", indent(1), aObj.streamLocation);
+    str += fmt::format("{}page           = {}\n", indent(1), aObj.page);
+    str += fmt::format("{}score          = {}\n", indent(1), aObj.score);
+    str += fmt::format("{}documentCtr    = {}\n", indent(1), aObj.documentCtr);
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const TextPageHit& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // FULLTEXTINDEX_HPP
@@ -75,6 +75,9 @@ OOCP::Structure OOCP::GenericParser::auto_read_prefixes(FutureDataLst& aFutureDa
 
     const size_t startOffset = mCtx.mDs.getCurrentOffset();
 
+    // Probing the prefixes must not leave references behind
+    const StreamRefsMark startRefs = mCtx.getRefsMark();
+
     mCtx.mLogger.set_level(spdlog::level::off);
 
     bool failed      = true;
@@ -104,6 +107,7 @@ OOCP::Structure OOCP::GenericParser::auto_read_prefixes(FutureDataLst& aFutureDa
         }
 
         mCtx.mDs.setCurrentOffset(startOffset);
+        mCtx.resetRefs(startRefs);
 
         // Reading the prefixes might read beyond EoF in some cases,
         // because its just a prediction, we do not care. Therefore
@@ -268,6 +272,8 @@ std::pair<OOCP::Structure, uint32_t> OOCP::GenericParser::read_single_prefix_sho
 {
     mCtx.mLogger.debug(getOpeningMsg(getMethodName(this, __func__), mCtx.mDs.getCurrentOffset()));
 
+    const size_t startOffset = mCtx.mDs.getCurrentOffset();
+
     const Structure typeId = ToStructure(mCtx.mDs.readUint8());
 
     const int16_t size = mCtx.mDs.readInt16();
@@ -276,46 +282,21 @@ std::pair<OOCP::Structure, uint32_t> OOCP::GenericParser::read_single_prefix_sho
 
     if(size >= 0)
     {
-        // @todo This vector needs to be stored in the package, therefore return it to caller
-        std::vector<std::pair<uint32_t, uint32_t>> nameValueMapping; //!< .first = Name Index, .second = Value Index
-
+        // Names and values are indices into the string list of the library,
+        // they are kept for the property table and for remapping the indices
         for(int i = 0; i < size; ++i)
         {
-            const uint32_t strLstIdxName  = mCtx.mDs.readUint32();
-            const uint32_t strLstIdxValue = mCtx.mDs.readUint32();
+            NameValueMapping mapping{startOffset, typeId, 0U, 0U};
 
-            nameValueMapping.push_back(std::make_pair(strLstIdxName, strLstIdxValue));
-        }
+            mCtx.mStrLstRefs.push_back(mCtx.mDs.getCurrentOffset());
+            mapping.nameIdx = mCtx.mDs.readUint32();
 
-        for(size_t i = 0u; i < nameValueMapping.size(); ++i)
-        {
-            // try
-            // {
-            //     const auto getStr = [&, this](uint32_t idx) -> std::string
-            //         {
-            //             // int64_t newIdx = static_cast<int64_t>(idx);
-
-            //             // if(mCtx.mDb.getLibrary().has_value())
-            //             // {
-            //             //     const StreamLibrary& lib =
-            //             dynamic_cast<StreamLibrary&>(*mCtx.mDb.getLibrary().value());
-            //             //     return newIdx >= 0 ? lib.strLst.at(newIdx) : "";
-            //             // }
-
-            //             return "";
-            //         };
-
-            //     mCtx.mLogger.debug("  {}: {} <- {}", i, getStr(nameValueMapping.at(i).first),
-            //     getStr(nameValueMapping.at(i).second));
-            // }
-            // catch(const std::exception& e)
-            // {
-            //     const std::string msg = fmt::format("{}: Tried to access strLst out of range!\n{}",
-            //         getMethodName(this, __func__), e.what());
-
-            //     mCtx.mLogger.debug(msg);
-            //     throw std::out_of_range(msg);
-            // }
+            mCtx.mStrLstRefs.push_back(mCtx.mDs.getCurrentOffset());
+            mapping.valueIdx = mCtx.mDs.readUint32();
+
+            mCtx.mLogger.debug("  {}: {} <- {}", i, mapping.nameIdx, mapping.valueIdx);
+
+            mCtx.mNameValueMappings.push_back(mapping);
         }
     }
     else // size < 0
@@ -541,6 +522,7 @@ std::unique_ptr<OOCP::Record> OOCP::GenericParser::readStructure(Structure aStru
 bool OOCP::GenericParser::tryRead(std::function<void(void)> aFunction)
 {
     const auto offsetBeforeTest = mCtx.mDs.getCurrentOffset();
+    const auto refsBeforeTest   = mCtx.getRefsMark();
     bool checkFailed            = false;
 
     try
@@ -553,6 +535,7 @@ bool OOCP::GenericParser::tryRead(std::function<void(void)> aFunction)
     }
 
     mCtx.mDs.setCurrentOffset(offsetBeforeTest);
+    mCtx.resetRefs(refsBeforeTest);
 
     return !checkFailed;
 }
@@ -583,6 +566,7 @@ OOCP::FileFormatVersion OOCP::GenericParser::predictVersion(std::function<void(F
         FileFormatVersion::N, FileFormatVersion::O, FileFormatVersion::P};
 
     const size_t initial_offset = mCtx.mDs.getCurrentOffset();
+    const auto initial_refs     = mCtx.getRefsMark();
 
     // Testing different versions on a try and error basis
     // should not write into log files
@@ -602,6 +586,7 @@ OOCP::FileFormatVersion OOCP::GenericParser::predictVersion(std::function<void(F
         }
 
         mCtx.mDs.setCurrentOffset(initial_offset);
+        mCtx.resetRefs(initial_refs);
 
         if(found)
         {
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "ImageExtractor.hpp"
+#include "Primitives/PrimBitmap.hpp"
+
+OOCP::ImageExtractor::~ImageExtractor()
+{
+    wait();
+}
+
+std::size_t OOCP::ImageExtractor::start(const fs::path& aOutDir)
+{
+    if(mThread.joinable())
+    {
+        throw std::runtime_error(fmt::format("{}: Extraction is already running", __func__));
+    }
+
+    std::vector<std::size_t> blobs;
+
+    for(std::size_t i = 0U; i < mBlobStore.getBlobCtr(); ++i)
+    {
+        if(mBlobStore.getBlob(i).kind == BlobKind::Image)
+        {
+            blobs.push_back(i);
+        }
+    }
+
+    // Group blobs by their stream s.t. each stream file is opened once
+    std::stable_sort(blobs.begin(), blobs.end(),
+        [this](std::size_t aLhs, std::size_t aRhs)
+        {
+            return mBlobStore.getBlob(aLhs).sources.front().stream < mBlobStore.getBlob(aRhs).sources.front().stream;
+        });
+
+    mWrittenFiles.clear();
+    mErrCtr = 0U;
+
+    if(!blobs.empty())
+    {
+        mCtx.mLogger.info("Writing {} unique images to {} in the background", blobs.size(), aOutDir.string());
+
+        mThread = std::thread{&ImageExtractor::run, this, blobs, aOutDir};
+    }
+
+    return blobs.size();
+}
+
+const std::vector<fs::path>& OOCP::ImageExtractor::wait()
+{
+    if(mThread.joinable())
+    {
+        mThread.join();
+
+        mCtx.mLogger.info("Wrote {} images, {} failed", mWrittenFiles.size(), mErrCtr);
+    }
+
+    return mWrittenFiles;
+}
+
+void OOCP::ImageExtractor::run(std::vector<std::size_t> aBlobs, fs::path aOutDir)
+{
+    try
+    {
+        fs::create_directories(aOutDir);
+
+        mBlobStore.saveManifest(aOutDir / "blobs.json");
+    }
+    catch(const std::exception& e)
+    {
+        mCtx.mLogger.error("{}: {}", __func__, e.what());
+
+        mErrCtr += aBlobs.size();
+
+        return;
+    }
+
+    fs::path streamPath;
+    std::ifstream is;
+
+    std::vector<uint8_t> rawImgData;
+
+    for(const std::size_t i : aBlobs)
+    {
+        const BlobEntry& blob    = mBlobStore.getBlob(i);
+        const BlobSource& source = blob.sources.front();
+
+        if(source.stream != streamPath)
+        {
+            is.close();
+            is.clear();
+            is.open(source.stream, std::ios::in | std::ios::binary);
+
+            streamPath = source.stream;
+        }
+
+        if(!is.is_open())
+        {
+            mCtx.mLogger.error("{}: Can not open file for reading: {}", __func__, source.stream.string());
+
+            ++mErrCtr;
+            continue;
+        }
+
+        rawImgData.resize(blob.size);
+
+        is.clear();
+        is.seekg(static_cast<std::streamoff>(source.offset));
+        is.read(reinterpret_cast<char*>(rawImgData.data()), static_cast<std::streamsize>(rawImgData.size()));
+
+        if(static_cast<std::size_t>(is.gcount()) != rawImgData.size())
+        {
+            mCtx.mLogger.error(
+                "{}: Image data at offset {} is out of range in {}", __func__, source.offset, source.stream.string());
+
+            ++mErrCtr;
+            continue;
+        }
+
+        const fs::path imgPath = aOutDir / blob.getFileName();
+
+        const std::vector<uint8_t> imgFileData = PrimBitmap::getImgFileData(rawImgData);
+
+        std::ofstream img{imgPath, std::ios::out | std::ios::binary | std::ios::trunc};
+
+        img.write(reinterpret_cast<const char*>(imgFileData.data()), static_cast<std::streamsize>(imgFileData.size()));
+
+        if(!img)
+        {
+            mCtx.mLogger.error("{}: Failed writing {}", __func__, imgPath.string());
+
+            ++mErrCtr;
+            continue;
+        }
+
+        mWrittenFiles.push_back(imgPath);
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef IMAGEEXTRACTOR_HPP
+#define IMAGEEXTRACTOR_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+#include "BlobStore.hpp"
+#include "ContainerContext.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+/**
+ * @brief Writes the embedded images of a parsed container into files on a background thread.
+ *
+ * @note Images are read from the extracted stream files by the references of the
+ *       blob store, i.e. they do not need to be loaded into memory during parsing.
+ *       Each unique image is written once, named by its content hash, together with
+ *       the manifest `blobs.json` that maps them to their occurrences. The extracted
+ *       stream files need to exist until `wait` returned.
+ */
+class ImageExtractor
+{
+public:
+    ImageExtractor(ContainerContext& aCtx, const BlobStore& aBlobStore)
+        : mCtx{aCtx},
+          mBlobStore{aBlobStore},
+          mThread{},
+          mWrittenFiles{},
+          mErrCtr{0U}
+    {
+    }
+
+    ImageExtractor(const ImageExtractor&) = delete;
+    ImageExtractor& operator=(const ImageExtractor&) = delete;
+
+    ~ImageExtractor();
+
+    /**
+     * @brief Start writing all unique images of the blob store, returns immediately.
+     *
+     * @param aOutDir Output directory, images are named `<hash>.<ext>`.
+     * @return std::size_t Number of images that will be written.
+     */
+    std::size_t start(const fs::path& aOutDir);
+
+    /**
+     * @brief Wait until all images were written.
+     *
+     * @return const std::vector<fs::path>& Paths of the written images.
+     */
+    const std::vector<fs::path>& wait();
+
+    /**
+     * @brief Number of images that could not be written, only valid after `wait`.
+     */
+    std::size_t getErrCtr() const
+    {
+        return mErrCtr;
+    }
+
+private:
+    void run(std::vector<std::size_t> aBlobs, fs::path aOutDir);
+
+    ContainerContext& mCtx;
+
+    const BlobStore& mBlobStore; //!< Must not be modified until `wait` returned
+
+    std::thread mThread;
+
+    std::vector<fs::path> mWrittenFiles; //!< Only accessed by the background thread until it was joined
+    std::size_t mErrCtr;
+};
+} // namespace OOCP
+#endif // IMAGEEXTRACTOR_HPP
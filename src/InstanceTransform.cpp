@@ -0,0 +1,253 @@
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OOCP_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <fmt/core.h>
+
+#include "Enums/Rotation.hpp"
+#include "InstanceTransform.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+
+namespace
+{
+/**
+ * @brief Conditionally negate a value without branching.
+ *
+ * @param aVal Value.
+ * @param aSign 0 to keep the value, -1 to negate it.
+ */
+inline int32_t applySign(int32_t aVal, int32_t aSign)
+{
+    // Calculate in unsigned arithmetic to get wrap-around instead of undefined behavior
+    return static_cast<int32_t>((static_cast<uint32_t>(aVal) ^ static_cast<uint32_t>(aSign)) -
+                                static_cast<uint32_t>(aSign));
+}
+
+/**
+ * @brief Batch kernel computing x' = sx * u + ox and y' = sy * v + oy.
+ *
+ * @note aU and aV are the (possibly swapped) input arrays and may alias with
+ *       the output arrays. Within each iteration all inputs are loaded before
+ *       anything is stored, therefore in-place transformation is safe.
+ */
+void transformKernel(const int32_t* aU, const int32_t* aV, int32_t* aX, int32_t* aY, std::size_t aCount,
+    int32_t aSignX, int32_t aSignY, int32_t aOffsetX, int32_t aOffsetY)
+{
+    std::size_t i = 0U;
+
+#if defined(__AVX2__)
+    {
+        const __m256i signX   = _mm256_set1_epi32(aSignX);
+        const __m256i signY   = _mm256_set1_epi32(aSignY);
+        const __m256i offsetX = _mm256_set1_epi32(aOffsetX);
+        const __m256i offsetY = _mm256_set1_epi32(aOffsetY);
+
+        for(; i + 8U <= aCount; i += 8U)
+        {
+            const __m256i u = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aU + i));
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aV + i));
+
+            const __m256i x = _mm256_add_epi32(_mm256_sub_epi32(_mm256_xor_si256(u, signX), signX), offsetX);
+            const __m256i y = _mm256_add_epi32(_mm256_sub_epi32(_mm256_xor_si256(v, signY), signY), offsetY);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(aX + i), x);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(aY + i), y);
+        }
+    }
+#elif defined(OOCP_TRANSFORM_SSE2)
+    {
+        const __m128i signX   = _mm_set1_epi32(aSignX);
+        const __m128i signY   = _mm_set1_epi32(aSignY);
+        const __m128i offsetX = _mm_set1_epi32(aOffsetX);
+        const __m128i offsetY = _mm_set1_epi32(aOffsetY);
+
+        for(; i + 4U <= aCount; i += 4U)
+        {
+            const __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aU + i));
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aV + i));
+
+            const __m128i x = _mm_add_epi32(_mm_sub_epi32(_mm_xor_si128(u, signX), signX), offsetX);
+            const __m128i y = _mm_add_epi32(_mm_sub_epi32(_mm_xor_si128(v, signY), signY), offsetY);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(aX + i), x);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(aY + i), y);
+        }
+    }
+#endif
+
+    // Scalar fallback and remaining elements
+    for(; i < aCount; ++i)
+    {
+        const int32_t u = aU[i];
+        const int32_t v = aV[i];
+
+        aX[i] = applySign(u, aSignX) + aOffsetX;
+        aY[i] = applySign(v, aSignY) + aOffsetY;
+    }
+}
+} // namespace
+
+OOCP::Orientation OOCP::compose(const Orientation& aOuter, const Orientation& aInner)
+{
+    // Mirroring inverts the direction of all rotations applied before it, i.e.
+    // R(a) * M^m * R(b) * M^n = R(a + (-1)^m * b) * M^(m xor n)
+    const int outerRot = static_cast<int>(aOuter.rotation);
+    const int innerRot = static_cast<int>(aInner.rotation);
+
+    const int rot = (outerRot + (aOuter.mirrored ? 4 - innerRot : innerRot)) % 4;
+
+    Orientation orientation;
+
+    orientation.rotation = ToRotation(static_cast<uint8_t>(rot));
+    orientation.mirrored = aOuter.mirrored != aInner.mirrored;
+
+    return orientation;
+}
+
+OOCP::InstanceTransform::InstanceTransform(int32_t aOffsetX, int32_t aOffsetY, Orientation aOrientation)
+    : mOffsetX{aOffsetX},
+      mOffsetY{aOffsetY},
+      mOrientation{aOrientation},
+      mSwapXY{false},
+      mSignX{0},
+      mSignY{0}
+{
+    // Mirror (x, y) -> (-x, y) followed by a counterclockwise rotation
+    //
+    //           | not mirrored | mirrored
+    // ----------+--------------+----------
+    //   Deg_0   |  ( x,  y)    |  (-x,  y)
+    //   Deg_90  |  ( y, -x)    |  ( y,  x)
+    //   Deg_180 |  (-x, -y)    |  ( x, -y)
+    //   Deg_270 |  (-y,  x)    |  (-y, -x)
+
+    const bool m = mOrientation.mirrored;
+
+    switch(mOrientation.rotation)
+    {
+        case Rotation::Deg_0:
+            mSwapXY = false;
+            mSignX  = m ? -1 : 0;
+            mSignY  = 0;
+            break;
+
+        case Rotation::Deg_90:
+            mSwapXY = true;
+            mSignX  = 0;
+            mSignY  = m ? 0 : -1;
+            break;
+
+        case Rotation::Deg_180:
+            mSwapXY = false;
+            mSignX  = m ? 0 : -1;
+            mSignY  = -1;
+            break;
+
+        case Rotation::Deg_270:
+            mSwapXY = true;
+            mSignX  = -1;
+            mSignY  = m ? -1 : 0;
+            break;
+
+        default:
+            throw std::invalid_argument(
+                fmt::format("Rotation {} is not supported!", static_cast<int>(mOrientation.rotation)));
+    }
+}
+
+OOCP::InstanceTransform OOCP::InstanceTransform::fromPlacedInstance(const StructPlacedInstance& aInst)
+{
+    Orientation orientation;
+
+    orientation.rotation = aInst.rotation;
+    orientation.mirrored = aInst.mirrored;
+
+    return InstanceTransform{aInst.locX, aInst.locY, orientation};
+}
+
+std::pair<int32_t, int32_t> OOCP::InstanceTransform::apply(int32_t aX, int32_t aY) const
+{
+    const int32_t u = mSwapXY ? aY : aX;
+    const int32_t v = mSwapXY ? aX : aY;
+
+    return {applySign(u, mSignX) + mOffsetX, applySign(v, mSignY) + mOffsetY};
+}
+
+void OOCP::InstanceTransform::apply(int32_t* aX, int32_t* aY, std::size_t aCount) const
+{
+    const int32_t* u = mSwapXY ? aY : aX;
+    const int32_t* v = mSwapXY ? aX : aY;
+
+    transformKernel(u, v, aX, aY, aCount, mSignX, mSignY, mOffsetX, mOffsetY);
+}
+
+void OOCP::InstanceTransform::apply(std::vector<int32_t>& aX, std::vector<int32_t>& aY) const
+{
+    if(aX.size() != aY.size())
+    {
+        throw std::invalid_argument(
+            fmt::format("Coordinate arrays differ in size ({} vs. {})!", aX.size(), aY.size()));
+    }
+
+    apply(aX.data(), aY.data(), aX.size());
+}
+
+OOCP::Orientation OOCP::InstanceTransform::apply(Rotation aRotation) const
+{
+    Orientation inner;
+
+    inner.rotation = aRotation;
+    inner.mirrored = false;
+
+    return compose(mOrientation, inner);
+}
+
+void OOCP::transformInstances(const std::vector<InstanceTransform>& aTransforms,
+    const std::vector<std::size_t>& aRanges, std::vector<int32_t>& aX, std::vector<int32_t>& aY)
+{
+    if(aX.size() != aY.size())
+    {
+        throw std::invalid_argument(
+            fmt::format("Coordinate arrays differ in size ({} vs. {})!", aX.size(), aY.size()));
+    }
+
+    if(aRanges.size() != aTransforms.size() + 1U)
+    {
+        throw std::invalid_argument(fmt::format(
+            "Expected {} range entries but got {}!", aTransforms.size() + 1U, aRanges.size()));
+    }
+
+    for(std::size_t i = 0U; i < aTransforms.size(); ++i)
+    {
+        const std::size_t begin = aRanges[i];
+        const std::size_t end   = aRanges[i + 1U];
+
+        if(begin > end || end > aX.size())
+        {
+            throw std::out_of_range(fmt::format("Invalid coordinate range [{}, {}) for instance {}!", begin, end, i));
+        }
+
+        aTransforms[i].apply(aX.data() + begin, aY.data() + begin, end - begin);
+    }
+}
+
+std::string OOCP::getTransformKernelName()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(OOCP_TRANSFORM_SSE2)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+}
@@ -0,0 +1,193 @@
+#ifndef INSTANCETRANSFORM_HPP
+#define INSTANCETRANSFORM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "Enums/Rotation.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+class StructPlacedInstance;
+
+/**
+ * @brief One of the 8 orientations a symbol can be placed with.
+ *
+ * @note Mirroring is applied first along the symbol's Y-axis (x -> -x),
+ *       afterwards the symbol is rotated counterclockwise as seen on
+ *       the page. Keep in mind that the Y-axis points downwards, i.e.
+ *       a rotation by 90° maps (x, y) -> (y, -x).
+ */
+struct Orientation
+{
+    Rotation rotation{Rotation::Deg_0};
+    bool mirrored{false};
+
+    bool operator==(const Orientation&) const = default;
+};
+
+/**
+ * @brief Combine two orientations.
+ *
+ * @param aOuter Orientation applied last, e.g. the one of the placed instance.
+ * @param aInner Orientation applied first, e.g. the one of a display property.
+ * @return Orientation Resulting orientation in page coordinates.
+ */
+Orientation compose(const Orientation& aOuter, const Orientation& aInner);
+
+/**
+ * @brief Affine transformation from symbol-local into page coordinates.
+ *
+ * @note All 8 orientations map a coordinate onto either +/-x or +/-y.
+ *       Therefore the rotation matrix is stored as a swap flag and two
+ *       sign masks, which keeps the batch kernels free of multiplications.
+ */
+class InstanceTransform
+{
+public:
+    InstanceTransform()
+        : InstanceTransform{0, 0, Orientation{}}
+    {
+    }
+
+    InstanceTransform(int32_t aOffsetX, int32_t aOffsetY, Orientation aOrientation);
+
+    /**
+     * @brief Create transformation from the location and orientation of an instance.
+     *
+     * @param aInst Instance placed on a page.
+     * @return InstanceTransform Transformation from symbol into page coordinates.
+     */
+    static InstanceTransform fromPlacedInstance(const StructPlacedInstance& aInst);
+
+    /**
+     * @brief Transform a single coordinate.
+     *
+     * @param aX X-coordinate in symbol-local space.
+     * @param aY Y-coordinate in symbol-local space.
+     * @return std::pair<int32_t, int32_t> Coordinate in page space.
+     */
+    std::pair<int32_t, int32_t> apply(int32_t aX, int32_t aY) const;
+
+    /**
+     * @brief Transform packed coordinates in-place.
+     *
+     * @param aX Array of X-coordinates.
+     * @param aY Array of Y-coordinates, same length as aX.
+     * @param aCount Number of coordinates.
+     */
+    void apply(int32_t* aX, int32_t* aY, std::size_t aCount) const;
+
+    /**
+     * @brief Transform packed coordinates in-place.
+     *
+     * @param aX X-coordinates.
+     * @param aY Y-coordinates, need to have the same size as aX.
+     */
+    void apply(std::vector<int32_t>& aX, std::vector<int32_t>& aY) const;
+
+    /**
+     * @brief Transform a rotation that is specified relative to the symbol,
+     *        e.g. the one of a `StructSymbolDisplayProp`.
+     *
+     * @param aRotation Rotation in symbol-local space.
+     * @return Orientation Orientation in page space.
+     */
+    Orientation apply(Rotation aRotation) const;
+
+    int32_t getOffsetX() const
+    {
+        return mOffsetX;
+    }
+
+    int32_t getOffsetY() const
+    {
+        return mOffsetY;
+    }
+
+    Orientation getOrientation() const
+    {
+        return mOrientation;
+    }
+
+private:
+    int32_t mOffsetX;
+    int32_t mOffsetY;
+
+    Orientation mOrientation;
+
+    bool mSwapXY;    //!< Output x is taken from input y and vice versa
+    int32_t mSignX;  //!< 0 to keep the sign of output x, -1 to negate it
+    int32_t mSignY;  //!< 0 to keep the sign of output y, -1 to negate it
+};
+
+/**
+ * @brief Transform the packed coordinates of many instances at once.
+ *
+ * @param aTransforms Transformation per instance.
+ * @param aRanges Coordinates of instance i are located in [aRanges[i], aRanges[i + 1]).
+ *                Therefore it needs to contain one element more than aTransforms.
+ * @param aX X-coordinates of all instances, transformed in-place.
+ * @param aY Y-coordinates of all instances, transformed in-place.
+ */
+void transformInstances(const std::vector<InstanceTransform>& aTransforms, const std::vector<std::size_t>& aRanges,
+    std::vector<int32_t>& aX, std::vector<int32_t>& aY);
+
+/**
+ * @brief Name of the batch kernel selected at compile time.
+ *
+ * @return std::string One of `AVX2`, `SSE2` or `Scalar`.
+ */
+std::string getTransformKernelName();
+
+[[maybe_unused]]
+static std::string to_string(const Orientation& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}rotation = {}\n", indent(1), to_string(aObj.rotation));
+    str += fmt::format("{}mirrored = {}\n", indent(1), aObj.mirrored);
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const Orientation& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+
+[[maybe_unused]]
+static std::string to_string(const InstanceTransform& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}offsetX = {}\n", indent(1), aObj.getOffsetX());
+    str += fmt::format("{}offsetY = {}\n", indent(1), aObj.getOffsetY());
+    str += fmt::format("{}orientation:\n", indent(1));
+    str += indent(to_string(aObj.getOrientation()), 2);
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const InstanceTransform& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // INSTANCETRANSFORM_HPP
@@ -0,0 +1,736 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "Enums/Color.hpp"
+#include "Enums/FillStyle.hpp"
+#include "Enums/HatchStyle.hpp"
+#include "Enums/ImplementationType.hpp"
+#include "Enums/LineStyle.hpp"
+#include "Enums/LineWidth.hpp"
+#include "Enums/PortType.hpp"
+#include "Enums/Primitive.hpp"
+#include "Enums/Rotation.hpp"
+#include "Enums/StreamType.hpp"
+#include "Database.hpp"
+#include "General.hpp"
+#include "GetStreamHelper.hpp"
+#include "JsonExporter.hpp"
+#include "JsonWriter.hpp"
+#include "Primitives/Point.hpp"
+#include "Primitives/PrimArc.hpp"
+#include "Primitives/PrimBase.hpp"
+#include "Primitives/PrimBezier.hpp"
+#include "Primitives/PrimBitmap.hpp"
+#include "Primitives/PrimCommentText.hpp"
+#include "Primitives/PrimEllipse.hpp"
+#include "Primitives/PrimLine.hpp"
+#include "Primitives/PrimPolygon.hpp"
+#include "Primitives/PrimPolyline.hpp"
+#include "Primitives/PrimRect.hpp"
+#include "Primitives/PrimSymbolVector.hpp"
+#include "Stream.hpp"
+#include "Streams/StreamLibrary.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Streams/StreamSymbol.hpp"
+#include "Structures/StructAlias.hpp"
+#include "Structures/StructDevice.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+#include "Structures/StructSymbol.hpp"
+#include "Structures/StructSymbolDisplayProp.hpp"
+#include "Structures/StructSymbolPin.hpp"
+#include "Structures/StructSymbolPinBus.hpp"
+#include "Structures/StructWire.hpp"
+#include "Structures/StructWireBus.hpp"
+#include "Win32/LOGFONTA.hpp"
+
+namespace
+{
+using OOCP::JsonWriter;
+
+//! Property name -> value of a single object, in file order
+using PropList = std::vector<std::pair<std::string, std::string>>;
+
+const std::string* findProp(const PropList& aProps, const std::string& aName)
+{
+    for(const auto& [name, value] : aProps)
+    {
+        if(name == aName)
+        {
+            return &value;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Resolve the name/value mappings of all structures of a stream.
+ *
+ * @return Offset of the short prefix -> properties of the structure.
+ */
+std::unordered_map<std::size_t, PropList> getMappedProps(const OOCP::StreamContext& aCtx, OOCP::Structure aStructure)
+{
+    std::unordered_map<std::size_t, PropList> props;
+
+    const auto lib = OOCP::getLibraryStreamFromDb(aCtx.mDb);
+
+    if(!lib)
+    {
+        return props;
+    }
+
+    for(const auto& mapping : aCtx.mNameValueMappings)
+    {
+        if(mapping.structure == aStructure && mapping.nameIdx < lib->strLst.size() &&
+            mapping.valueIdx < lib->strLst.size())
+        {
+            props[mapping.offset].emplace_back(lib->strLst[mapping.nameIdx], lib->strLst[mapping.valueIdx]);
+        }
+    }
+
+    return props;
+}
+
+void writeProps(JsonWriter& aWriter, const PropList& aProps)
+{
+    aWriter.key("properties");
+    aWriter.beginObject();
+
+    for(const auto& [name, value] : aProps)
+    {
+        // Keys need to be unique, the first occurrence wins
+        if(findProp(aProps, name) == &value)
+        {
+            aWriter.field(name, value);
+        }
+    }
+
+    aWriter.endObject();
+}
+
+void writePoint(JsonWriter& aWriter, int32_t aX, int32_t aY)
+{
+    aWriter.beginArray();
+    aWriter.value(aX);
+    aWriter.value(aY);
+    aWriter.endArray();
+}
+
+void writePointField(JsonWriter& aWriter, std::string_view aKey, int32_t aX, int32_t aY)
+{
+    aWriter.key(aKey);
+    writePoint(aWriter, aX, aY);
+}
+
+void writeRect(JsonWriter& aWriter, int32_t aX1, int32_t aY1, int32_t aX2, int32_t aY2)
+{
+    writePointField(aWriter, "p1", aX1, aY1);
+    writePointField(aWriter, "p2", aX2, aY2);
+}
+
+void writePoints(JsonWriter& aWriter, const std::vector<OOCP::Point>& aPoints)
+{
+    aWriter.key("points");
+    aWriter.beginArray();
+
+    for(const auto& point : aPoints)
+    {
+        writePoint(aWriter, point.x, point.y);
+    }
+
+    aWriter.endArray();
+}
+
+void writeFont(JsonWriter& aWriter, const OOCP::LOGFONTA& aFont)
+{
+    aWriter.beginObject();
+    aWriter.field("name", std::string{aFont.lfFaceName, strnlen(aFont.lfFaceName, sizeof(aFont.lfFaceName))});
+    aWriter.field("height", aFont.lfHeight);
+    aWriter.field("width", aFont.lfWidth);
+    aWriter.field("escapement", aFont.lfEscapement);
+    aWriter.field("orientation", aFont.lfOrientation);
+    aWriter.field("weight", aFont.lfWeight);
+    aWriter.field("italic", aFont.lfItalic != 0);
+    aWriter.endObject();
+}
+
+template <typename Prim> void writeLineStyle(JsonWriter& aWriter, const Prim& aPrim)
+{
+    aWriter.field("lineStyle", OOCP::to_string(aPrim.getLineStyle()));
+    aWriter.field("lineWidth", OOCP::to_string(aPrim.getLineWidth()));
+}
+
+void writePrimitive(JsonWriter& aWriter, const OOCP::PrimBase& aPrim)
+{
+    aWriter.beginObject();
+    aWriter.field("type", OOCP::to_string(aPrim.getObjectType()));
+
+    if(const auto* arc = dynamic_cast<const OOCP::PrimArc*>(&aPrim))
+    {
+        writeRect(aWriter, arc->x1, arc->y1, arc->x2, arc->y2);
+        writePointField(aWriter, "start", arc->startX, arc->startY);
+        writePointField(aWriter, "end", arc->endX, arc->endY);
+        writeLineStyle(aWriter, *arc);
+    }
+    else if(const auto* bezier = dynamic_cast<const OOCP::PrimBezier*>(&aPrim))
+    {
+        writePoints(aWriter, bezier->points);
+        writeLineStyle(aWriter, *bezier);
+    }
+    else if(const auto* bitmap = dynamic_cast<const OOCP::PrimBitmap*>(&aPrim))
+    {
+        // Image data is not embedded, it refers to the blob store by content hash
+        writePointField(aWriter, "loc", bitmap->locX, bitmap->locY);
+        writeRect(aWriter, bitmap->x1, bitmap->y1, bitmap->x2, bitmap->y2);
+        aWriter.field("width", bitmap->bmpWidth);
+        aWriter.field("height", bitmap->bmpHeight);
+        aWriter.field("dataSize", bitmap->imgDataSize);
+        aWriter.key("blob");
+
+        const uint64_t blobHash = bitmap->getBlobHash();
+
+        if(blobHash != 0U)
+        {
+            aWriter.value(fmt::format("{:016x}", blobHash));
+        }
+        else
+        {
+            aWriter.null();
+        }
+    }
+    else if(const auto* commentText = dynamic_cast<const OOCP::PrimCommentText*>(&aPrim))
+    {
+        writePointField(aWriter, "loc", commentText->locX, commentText->locY);
+        writeRect(aWriter, commentText->x1, commentText->y1, commentText->x2, commentText->y2);
+        aWriter.field("text", commentText->name);
+        aWriter.key("font");
+        writeFont(aWriter, commentText->getTextFont());
+    }
+    else if(const auto* ellipse = dynamic_cast<const OOCP::PrimEllipse*>(&aPrim))
+    {
+        writeRect(aWriter, ellipse->x1, ellipse->y1, ellipse->x2, ellipse->y2);
+        writeLineStyle(aWriter, *ellipse);
+        aWriter.field("fillStyle", OOCP::to_string(ellipse->getFillStyle()));
+        aWriter.field("hatchStyle", OOCP::to_string(ellipse->getHatchStyle()));
+    }
+    else if(const auto* line = dynamic_cast<const OOCP::PrimLine*>(&aPrim))
+    {
+        writeRect(aWriter, line->x1, line->y1, line->x2, line->y2);
+        writeLineStyle(aWriter, *line);
+    }
+    else if(const auto* polygon = dynamic_cast<const OOCP::PrimPolygon*>(&aPrim))
+    {
+        writePoints(aWriter, polygon->points);
+        writeLineStyle(aWriter, *polygon);
+        aWriter.field("fillStyle", OOCP::to_string(polygon->fillStyle));
+        aWriter.field("hatchStyle", OOCP::to_string(polygon->hatchStyle));
+    }
+    else if(const auto* polyline = dynamic_cast<const OOCP::PrimPolyline*>(&aPrim))
+    {
+        writePoints(aWriter, polyline->points);
+        writeLineStyle(aWriter, *polyline);
+    }
+    else if(const auto* rect = dynamic_cast<const OOCP::PrimRect*>(&aPrim))
+    {
+        writeRect(aWriter, rect->x1, rect->y1, rect->x2, rect->y2);
+        writeLineStyle(aWriter, *rect);
+        aWriter.field("fillStyle", OOCP::to_string(rect->fillStyle));
+        aWriter.field("hatchStyle", OOCP::to_string(rect->hatchStyle));
+    }
+    else if(const auto* symbolVector = dynamic_cast<const OOCP::PrimSymbolVector*>(&aPrim))
+    {
+        writePointField(aWriter, "loc", symbolVector->locX, symbolVector->locY);
+        aWriter.field("name", symbolVector->name);
+
+        aWriter.key("primitives");
+        aWriter.beginArray();
+
+        for(const auto& primitive : symbolVector->primitives)
+        {
+            if(primitive)
+            {
+                writePrimitive(aWriter, *primitive);
+            }
+        }
+
+        aWriter.endArray();
+    }
+
+    // Other primitives are written with their type only
+
+    aWriter.endObject();
+}
+
+void writePrimitives(JsonWriter& aWriter, const std::vector<std::unique_ptr<OOCP::PrimBase>>& aPrimitives)
+{
+    aWriter.key("primitives");
+    aWriter.beginArray();
+
+    for(const auto& primitive : aPrimitives)
+    {
+        if(primitive)
+        {
+            writePrimitive(aWriter, *primitive);
+        }
+    }
+
+    aWriter.endArray();
+}
+
+/**
+ * @brief Display properties only reference a property by name, the value is taken from the owning object.
+ */
+void writeDisplayProps(JsonWriter& aWriter,
+    const std::vector<std::unique_ptr<OOCP::StructSymbolDisplayProp>>& aDisplayProps, const PropList& aOwnerProps)
+{
+    aWriter.key("displayProps");
+    aWriter.beginArray();
+
+    for(const auto& prop : aDisplayProps)
+    {
+        if(!prop)
+        {
+            continue;
+        }
+
+        const std::string name = prop->getName();
+
+        aWriter.beginObject();
+        aWriter.field("name", name);
+
+        aWriter.key("value");
+
+        if(const std::string* value = findProp(aOwnerProps, name))
+        {
+            aWriter.value(*value);
+        }
+        else
+        {
+            aWriter.null();
+        }
+
+        writePointField(aWriter, "loc", prop->x, prop->y);
+        aWriter.field("rotation", OOCP::to_string(prop->rotation));
+        aWriter.field("color", OOCP::to_string(prop->propColor));
+        aWriter.field("fontIdx", prop->textFontIdx);
+        aWriter.endObject();
+    }
+
+    aWriter.endArray();
+}
+
+void writePins(JsonWriter& aWriter, const std::vector<std::unique_ptr<OOCP::StructSymbolPin>>& aPins)
+{
+    aWriter.key("pins");
+    aWriter.beginArray();
+
+    for(const auto& pin : aPins)
+    {
+        if(!pin)
+        {
+            continue;
+        }
+
+        const OOCP::PinShape& shape = pin->pinShape;
+
+        aWriter.beginObject();
+        aWriter.field("name", pin->name);
+        aWriter.field("bus", dynamic_cast<const OOCP::StructSymbolPinBus*>(pin.get()) != nullptr);
+        aWriter.field("type", OOCP::to_string(pin->portType));
+        writePointField(aWriter, "start", pin->startX, pin->startY);
+        writePointField(aWriter, "hotpt", pin->hotptX, pin->hotptY);
+
+        aWriter.key("shape");
+        aWriter.beginObject();
+        aWriter.field("isLong", static_cast<bool>(shape.isLong));
+        aWriter.field("isClock", static_cast<bool>(shape.isClock));
+        aWriter.field("isDot", static_cast<bool>(shape.isDot));
+        aWriter.field("isLeftPointing", static_cast<bool>(shape.isLeftPointing));
+        aWriter.field("isRightPointing", static_cast<bool>(shape.isRightPointing));
+        aWriter.field("isNetStyle", static_cast<bool>(shape.isNetStyle));
+        aWriter.field("isNoConnect", static_cast<bool>(shape.isNoConnect));
+        aWriter.field("isGlobal", static_cast<bool>(shape.isGlobal));
+        aWriter.field("isNumberVisible", static_cast<bool>(shape.isNumberVisible));
+        aWriter.endObject();
+
+        writeDisplayProps(aWriter, pin->symbolDisplayProps, PropList{{"Name", pin->name}});
+
+        aWriter.endObject();
+    }
+
+    aWriter.endArray();
+}
+
+void writePackage(JsonWriter& aWriter, const OOCP::StreamPackage& aPackage)
+{
+    aWriter.beginObject();
+
+    if(aPackage.package)
+    {
+        const OOCP::StructPackage& package = *aPackage.package;
+
+        aWriter.field("name", package.name);
+        aWriter.field("refDes", package.refDes);
+        aWriter.field("pcbFootprint", package.pcbFootprint);
+
+        aWriter.key("devices");
+        aWriter.beginArray();
+
+        for(const auto& device : package.devices)
+        {
+            if(!device)
+            {
+                continue;
+            }
+
+            aWriter.beginObject();
+            aWriter.field("unitRef", device->unitRef);
+            aWriter.field("refDes", device->refDes);
+
+            aWriter.key("pins");
+            aWriter.beginArray();
+
+            for(std::size_t i = 0U; i < device->pinMap.size(); ++i)
+            {
+                aWriter.beginObject();
+                aWriter.field("number", device->pinMap[i]);
+
+                if(i < device->pinIgnore.size())
+                {
+                    aWriter.field("ignore", static_cast<bool>(device->pinIgnore[i]));
+                }
+
+                if(i < device->pinGroup.size())
+                {
+                    aWriter.field("group", device->pinGroup[i]);
+                }
+
+                aWriter.endObject();
+            }
+
+            aWriter.endArray();
+            aWriter.endObject();
+        }
+
+        aWriter.endArray();
+    }
+    else
+    {
+        aWriter.key("name");
+        aWriter.null();
+    }
+
+    aWriter.key("views");
+    aWriter.beginArray();
+
+    for(const auto& libraryPart : aPackage.libraryParts)
+    {
+        if(!libraryPart)
+        {
+            continue;
+        }
+
+        const auto& props = libraryPart->generalProperties;
+
+        aWriter.beginObject();
+        aWriter.field("name", libraryPart->name);
+
+        aWriter.key("properties");
+        aWriter.beginObject();
+        aWriter.field("implementationPath", props.implementationPath);
+        aWriter.field("implementation", props.implementation);
+        aWriter.field("implementationType", OOCP::to_string(props.implementationType));
+        aWriter.field("refDes", props.refDes);
+        aWriter.field("partValue", props.partValue);
+        aWriter.field("pinNameVisible", props.pinNameVisible);
+        aWriter.field("pinNameRotate", props.pinNameRotate);
+        aWriter.field("pinNumberVisible", props.pinNumberVisible);
+        aWriter.endObject();
+
+        writePrimitives(aWriter, libraryPart->primitives);
+        writePins(aWriter, libraryPart->symbolPins);
+        PropList viewProps{{"Value", props.partValue}, {"Part Reference", props.refDes},
+            {"Implementation", props.implementation}, {"Implementation Path", props.implementationPath}};
+
+        if(aPackage.package)
+        {
+            viewProps.emplace_back("PCB Footprint", aPackage.package->pcbFootprint);
+        }
+
+        writeDisplayProps(aWriter, libraryPart->symbolDisplayProps, viewProps);
+
+        aWriter.endObject();
+    }
+
+    aWriter.endArray();
+
+    aWriter.endObject();
+}
+
+void writeSymbol(JsonWriter& aWriter, const OOCP::StreamSymbol& aSymbol)
+{
+    aWriter.beginObject();
+
+    if(aSymbol.symbol)
+    {
+        aWriter.field("name", aSymbol.symbol->name);
+        aWriter.field("sourceLibrary", aSymbol.symbol->sourceLibrary);
+        writePrimitives(aWriter, aSymbol.symbol->primitives);
+    }
+    else
+    {
+        aWriter.key("name");
+        aWriter.null();
+    }
+
+    writePins(aWriter, aSymbol.symbolPins);
+    writeDisplayProps(aWriter, aSymbol.symbolDisplayProps,
+        aSymbol.symbol ? PropList{{"Name", aSymbol.symbol->name}} : PropList{});
+
+    aWriter.endObject();
+}
+
+void writePage(JsonWriter& aWriter, const OOCP::StreamPage& aPage)
+{
+    aWriter.beginObject();
+    aWriter.field("name", aPage.name);
+    aWriter.field("pageSize", aPage.pageSize);
+
+    const auto instProps = getMappedProps(aPage.mCtx, OOCP::Structure::PlacedInstance);
+
+    aWriter.key("instances");
+    aWriter.beginArray();
+
+    for(const auto& inst : aPage.placedInstances)
+    {
+        if(!inst)
+        {
+            continue;
+        }
+
+        PropList props;
+
+        if(inst->propOffset.has_value())
+        {
+            if(const auto it = instProps.find(inst->propOffset.value()); it != instProps.cend())
+            {
+                props = it->second;
+            }
+        }
+
+        if(!findProp(props, "Part Reference"))
+        {
+            props.emplace_back("Part Reference", inst->reference);
+        }
+
+        aWriter.beginObject();
+        aWriter.field("dbId", inst->dbId);
+        aWriter.field("pkgName", inst->pkgName);
+        aWriter.field("reference", inst->reference);
+        writePointField(aWriter, "loc", inst->locX, inst->locY);
+        aWriter.field("rotation", OOCP::to_string(inst->rotation));
+        aWriter.field("mirrored", inst->mirrored);
+        writeProps(aWriter, props);
+        writeDisplayProps(aWriter, inst->symbolDisplayProps, props);
+        aWriter.endObject();
+    }
+
+    aWriter.endArray();
+
+    aWriter.key("wires");
+    aWriter.beginArray();
+
+    for(const auto& wire : aPage.wires)
+    {
+        if(!wire)
+        {
+            continue;
+        }
+
+        aWriter.beginObject();
+        aWriter.field("id", wire->id);
+        aWriter.field("bus", dynamic_cast<const OOCP::StructWireBus*>(wire.get()) != nullptr);
+        writePointField(aWriter, "start", wire->startX, wire->startY);
+        writePointField(aWriter, "end", wire->endX, wire->endY);
+        aWriter.field("color", OOCP::to_string(wire->color));
+        aWriter.field("lineStyle", OOCP::to_string(wire->lineStyle));
+        aWriter.field("lineWidth", OOCP::to_string(wire->lineWidth));
+
+        aWriter.key("aliases");
+        aWriter.beginArray();
+
+        for(const auto& alias : wire->aliases)
+        {
+            if(!alias)
+            {
+                continue;
+            }
+
+            aWriter.beginObject();
+            aWriter.field("name", alias->name);
+            writePointField(aWriter, "loc", alias->locX, alias->locY);
+            aWriter.field("rotation", OOCP::to_string(alias->rotation));
+            aWriter.endObject();
+        }
+
+        aWriter.endArray();
+
+        PropList wireProps;
+
+        if(!wire->aliases.empty() && wire->aliases.front())
+        {
+            wireProps.emplace_back("Name", wire->aliases.front()->name);
+        }
+
+        writeDisplayProps(aWriter, wire->symbolDisplayProps, wireProps);
+
+        aWriter.endObject();
+    }
+
+    aWriter.endArray();
+
+    aWriter.endObject();
+}
+
+void writeLibrary(JsonWriter& aWriter, const OOCP::StreamLibrary& aLibrary)
+{
+    aWriter.beginObject();
+    aWriter.field("dbType", aLibrary.mDbType == OOCP::DatabaseType::Design ? "Design" : "Library");
+
+    aWriter.key("textFonts");
+    aWriter.beginArray();
+
+    for(const auto& font : aLibrary.textFonts)
+    {
+        writeFont(aWriter, font);
+    }
+
+    aWriter.endArray();
+
+    aWriter.key("partFields");
+    aWriter.beginArray();
+
+    for(const auto& partField : aLibrary.strLstPartField)
+    {
+        aWriter.value(partField);
+    }
+
+    aWriter.endArray();
+
+    aWriter.endObject();
+}
+} // namespace
+
+void OOCP::JsonExporter::begin()
+{
+    if(mFormat == JsonFormat::Json)
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+
+        mOs << "[\n";
+    }
+}
+
+void OOCP::JsonExporter::writeStream(const Stream& aStream)
+{
+    // Render outside of the lock, this is where the actual work happens
+    const std::string record = toJson(aStream);
+
+    std::lock_guard<std::mutex> lock{mMutex};
+
+    if(mFormat == JsonFormat::Json && mRecordCtr > 0U)
+    {
+        mOs << ",\n";
+    }
+
+    mOs << record;
+
+    if(mFormat == JsonFormat::Ndjson)
+    {
+        mOs << '\n';
+    }
+
+    ++mRecordCtr;
+}
+
+void OOCP::JsonExporter::end()
+{
+    std::lock_guard<std::mutex> lock{mMutex};
+
+    if(mFormat == JsonFormat::Json)
+    {
+        mOs << (mRecordCtr > 0U ? "\n]\n" : "]\n");
+    }
+
+    mOs.flush();
+}
+
+std::string OOCP::JsonExporter::toJson(const Stream& aStream)
+{
+    std::string buf;
+    buf.reserve(1024U);
+
+    JsonWriter writer{buf};
+
+    writer.beginObject();
+    writer.field("schema", fmt::format("{}/{}", SchemaName, SchemaVersion));
+    writer.field("location", OOCP::to_string(aStream.mCtx.mCfbfStreamLocation));
+    writer.field("type", OOCP::to_string(aStream.getStreamType()));
+
+    writer.key("parsed");
+    if(aStream.mCtx.mParsedSuccessfully.has_value())
+    {
+        writer.value(aStream.mCtx.mParsedSuccessfully.value());
+    }
+    else
+    {
+        writer.null();
+    }
+
+    writer.key("data");
+    if(const auto* package = dynamic_cast<const StreamPackage*>(&aStream))
+    {
+        writePackage(writer, *package);
+    }
+    else if(const auto* symbol = dynamic_cast<const StreamSymbol*>(&aStream))
+    {
+        writeSymbol(writer, *symbol);
+    }
+    else if(const auto* page = dynamic_cast<const StreamPage*>(&aStream))
+    {
+        writePage(writer, *page);
+    }
+    else if(const auto* library = dynamic_cast<const StreamLibrary*>(&aStream))
+    {
+        writeLibrary(writer, *library);
+    }
+    else
+    {
+        // Stream content is not part of the schema yet
+        writer.null();
+    }
+
+    writer.endObject();
+
+    return buf;
+}
+
+std::string OOCP::JsonExporter::getFileExtension(JsonFormat aFormat)
+{
+    return aFormat == JsonFormat::Ndjson ? ".ndjson" : ".json";
+}
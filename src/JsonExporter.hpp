@@ -0,0 +1,84 @@
+#ifndef JSONEXPORTER_HPP
+#define JSONEXPORTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace OOCP
+{
+class Stream;
+
+enum class JsonFormat
+{
+    Ndjson, //!< One record per line
+    Json    //!< Records are wrapped into a single JSON array
+};
+
+/**
+ * @brief Exports parsed streams as JSON records, see `doc/json_schema.md`.
+ *
+ * @note Each stream is rendered independently into its own buffer, i.e.
+ *       `writeStream` can be called from the parser threads as soon as a
+ *       stream completed parsing. Only appending the finished record to the
+ *       output is serialized.
+ */
+class JsonExporter
+{
+public:
+    static constexpr uint32_t SchemaVersion = 1U;
+
+    static constexpr std::string_view SchemaName = "oocp.stream";
+
+    JsonExporter(std::ostream& aOs, JsonFormat aFormat = JsonFormat::Ndjson)
+        : mOs{aOs},
+          mFormat{aFormat},
+          mMutex{},
+          mRecordCtr{0U}
+    {
+    }
+
+    /**
+     * @brief Write the document header, required before the first record.
+     */
+    void begin();
+
+    /**
+     * @brief Render and append a single stream. Thread-safe.
+     */
+    void writeStream(const Stream& aStream);
+
+    /**
+     * @brief Write the document trailer and flush the output.
+     */
+    void end();
+
+    std::size_t getRecordCount() const
+    {
+        return mRecordCtr;
+    }
+
+    /**
+     * @brief Render a single stream as compact JSON record without trailing newline.
+     */
+    static std::string toJson(const Stream& aStream);
+
+    /**
+     * @brief File extension used for the given format, including the leading dot.
+     */
+    static std::string getFileExtension(JsonFormat aFormat);
+
+private:
+    std::ostream& mOs;
+
+    JsonFormat mFormat;
+
+    std::mutex mMutex;
+
+    std::size_t mRecordCtr; //!< Number of records written so far
+};
+} // namespace OOCP
+#endif // JSONEXPORTER_HPP
@@ -0,0 +1,236 @@
+#ifndef JSONWRITER_HPP
+#define JSONWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "Encoding.hpp"
+
+namespace OOCP
+{
+/**
+ * @brief Minimal streaming JSON writer that appends compact JSON to a string buffer.
+ *
+ * @note No document tree is built, values are formatted directly into the buffer.
+ *       Only the nesting state (object/array and whether a separator is required)
+ *       is tracked. Strings in OrCAD files are CP1252 encoded, they are
+ *       transcoded to UTF-8 as required by JSON.
+ */
+class JsonWriter
+{
+public:
+    JsonWriter(std::string& aBuf)
+        : mBuf{aBuf},
+          mScopes{},
+          mExpectValue{false}
+    {
+    }
+
+    void beginObject()
+    {
+        prepareValue();
+        mBuf += '{';
+        mScopes.push_back(Scope{true, true});
+    }
+
+    void endObject()
+    {
+        closeScope(true);
+        mBuf += '}';
+    }
+
+    void beginArray()
+    {
+        prepareValue();
+        mBuf += '[';
+        mScopes.push_back(Scope{false, true});
+    }
+
+    void endArray()
+    {
+        closeScope(false);
+        mBuf += ']';
+    }
+
+    void key(std::string_view aKey)
+    {
+        if(mScopes.empty() || !mScopes.back().isObject || mExpectValue)
+        {
+            throw std::logic_error(fmt::format("JsonWriter: Key `{}` written outside of an object", aKey));
+        }
+
+        writeSeparator();
+        writeString(aKey);
+        mBuf += ':';
+
+        mExpectValue = true;
+    }
+
+    void value(std::string_view aVal)
+    {
+        prepareValue();
+        writeString(aVal);
+    }
+
+    void value(const char* aVal)
+    {
+        value(std::string_view{aVal});
+    }
+
+    void value(const std::string& aVal)
+    {
+        value(std::string_view{aVal});
+    }
+
+    void value(bool aVal)
+    {
+        prepareValue();
+        mBuf += aVal ? "true" : "false";
+    }
+
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void value(T aVal)
+    {
+        prepareValue();
+
+        // Print characters as numbers, e.g. `LOGFONTA::lfItalic`
+        if constexpr(sizeof(T) == 1U)
+        {
+            fmt::format_to(std::back_inserter(mBuf), "{}", static_cast<int32_t>(aVal));
+        }
+        else
+        {
+            fmt::format_to(std::back_inserter(mBuf), "{}", aVal);
+        }
+    }
+
+    void null()
+    {
+        prepareValue();
+        mBuf += "null";
+    }
+
+    /**
+     * @brief Shorthand for a key value pair.
+     */
+    template <typename T> void field(std::string_view aKey, const T& aVal)
+    {
+        key(aKey);
+        value(aVal);
+    }
+
+    bool isComplete() const
+    {
+        return mScopes.empty() && !mExpectValue;
+    }
+
+private:
+    struct Scope
+    {
+        bool isObject;
+        bool isEmpty;
+    };
+
+    void writeSeparator()
+    {
+        if(!mScopes.empty())
+        {
+            if(!mScopes.back().isEmpty)
+            {
+                mBuf += ',';
+            }
+
+            mScopes.back().isEmpty = false;
+        }
+    }
+
+    void prepareValue()
+    {
+        if(mExpectValue)
+        {
+            // Separator was already written together with the key
+            mExpectValue = false;
+            return;
+        }
+
+        if(!mScopes.empty() && mScopes.back().isObject)
+        {
+            throw std::logic_error("JsonWriter: Value inside of an object requires a key");
+        }
+
+        writeSeparator();
+    }
+
+    void closeScope(bool aIsObject)
+    {
+        if(mScopes.empty() || mScopes.back().isObject != aIsObject || mExpectValue)
+        {
+            throw std::logic_error("JsonWriter: Unbalanced object or array");
+        }
+
+        mScopes.pop_back();
+    }
+
+    void writeString(std::string_view aStr)
+    {
+        mBuf += '"';
+
+        std::size_t start = 0U;
+
+        for(std::size_t i = 0U; i < aStr.size(); ++i)
+        {
+            const auto c = static_cast<unsigned char>(aStr[i]);
+
+            // Fast path, most characters do not need escaping
+            if(c >= 0x20U && c < 0x80U && c != '"' && c != '\\')
+            {
+                continue;
+            }
+
+            mBuf.append(aStr.data() + start, i - start);
+            start = i + 1U;
+
+            switch(c)
+            {
+                case '"':  mBuf += "\\\""; break;
+                case '\\': mBuf += "\\\\"; break;
+                case '\b': mBuf += "\\b"; break;
+                case '\f': mBuf += "\\f"; break;
+                case '\n': mBuf += "\\n"; break;
+                case '\r': mBuf += "\\r"; break;
+                case '\t': mBuf += "\\t"; break;
+                default:
+                    if(c >= 0x80U)
+                    {
+                        appendCp1252AsUtf8(mBuf, c);
+                    }
+                    else
+                    {
+                        fmt::format_to(std::back_inserter(mBuf), "\\u{:04x}", c);
+                    }
+                    break;
+            }
+        }
+
+        mBuf.append(aStr.data() + start, aStr.size() - start);
+
+        mBuf += '"';
+    }
+
+    std::string& mBuf;
+
+    std::vector<Scope> mScopes;
+
+    bool mExpectValue; //!< A key was written and its value is pending
+};
+} // namespace OOCP
+#endif // JSONWRITER_HPP
@@ -0,0 +1,137 @@
+#ifndef KICADHELPER_HPP
+#define KICADHELPER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <fmt/core.h>
+
+#include "Encoding.hpp"
+#include "Enums/LineStyle.hpp"
+#include "Enums/LineWidth.hpp"
+#include "Enums/Rotation.hpp"
+
+namespace OOCP
+{
+// OrCAD uses 1/100 inch, i.e. a grid of 10 units equals KiCad's 2.54 mm grid
+constexpr double KiCadMmPerUnit = 0.254;
+
+// Default text size in KiCad
+constexpr std::string_view KiCadDefaultTextSize = "1.27";
+
+/**
+ * @brief Convert OrCAD units into a KiCad millimeter value without trailing zeros.
+ */
+[[maybe_unused]]
+static std::string toKiCadMm(double aUnits)
+{
+    std::string str = fmt::format("{:.4f}", aUnits * KiCadMmPerUnit);
+
+    str.erase(str.find_last_not_of('0') + 1U);
+
+    if(str.back() == '.')
+    {
+        str.pop_back();
+    }
+
+    return str == "-0" ? "0" : str;
+}
+
+/**
+ * @brief Quote and escape a UTF-8 string for KiCad's S-expression files.
+ */
+[[maybe_unused]]
+static std::string quoteKiCadString(std::string_view aStr)
+{
+    std::string quoted;
+    quoted.reserve(aStr.size() + 2U);
+
+    quoted += '"';
+
+    for(const char c : aStr)
+    {
+        switch(c)
+        {
+            case '"':  quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\r': break;
+            default:   quoted += c; break;
+        }
+    }
+
+    quoted += '"';
+
+    return quoted;
+}
+
+/**
+ * @brief Quote and escape a CP1252 string of an OrCAD file, KiCad reads its files as UTF-8.
+ */
+[[maybe_unused]]
+static std::string toKiCadString(std::string_view aStr)
+{
+    return quoteKiCadString(cp1252ToUtf8(aStr));
+}
+
+/**
+ * @brief Symbol name that is valid inside a KiCad library identifier.
+ *
+ * @note `:` separates library and symbol name in library identifiers.
+ */
+[[maybe_unused]]
+static std::string toKiCadSymbolName(const std::string& aName)
+{
+    std::string name = aName;
+
+    std::replace(name.begin(), name.end(), ':', '_');
+
+    return name.empty() ? std::string{"unnamed"} : name;
+}
+
+[[maybe_unused]]
+static std::string_view toKiCadStrokeWidth(LineWidth aWidth)
+{
+    switch(aWidth)
+    {
+        case LineWidth::Thin:   return "0.1524";
+        case LineWidth::Medium: return "0.254";
+        case LineWidth::Wide:   return "0.508";
+        default:                return "0";
+    }
+}
+
+[[maybe_unused]]
+static std::string_view toKiCadStrokeType(LineStyle aStyle)
+{
+    switch(aStyle)
+    {
+        case LineStyle::Solid:      return "solid";
+        case LineStyle::Dash:       return "dash";
+        case LineStyle::Dot:        return "dot";
+        case LineStyle::DashDot:    return "dash_dot";
+        case LineStyle::DashDotDot: return "dash_dot_dot";
+        default:                    return "default";
+    }
+}
+
+/**
+ * @brief Counterclockwise angle in degree.
+ */
+[[maybe_unused]]
+static int32_t toKiCadAngle(Rotation aRotation)
+{
+    return 90 * static_cast<int32_t>(aRotation);
+}
+
+[[maybe_unused]]
+static std::string toKiCadFont(double aSize = 0.0)
+{
+    const std::string size = aSize > 0.0 ? toKiCadMm(aSize) : std::string{KiCadDefaultTextSize};
+
+    return fmt::format("(font (size {} {}))", size, size);
+}
+} // namespace OOCP
+#endif // KICADHELPER_HPP
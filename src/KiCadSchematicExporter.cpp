@@ -0,0 +1,742 @@
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "ContentHash.hpp"
+#include "Database.hpp"
+#include "Encoding.hpp"
+#include "InstanceTransform.hpp"
+#include "KiCadHelper.hpp"
+#include "KiCadSchematicExporter.hpp"
+#include "KiCadSymbolExporter.hpp"
+#include "OutputSink.hpp"
+#include "ParallelFor.hpp"
+#include "PinTable.hpp"
+#include "PropertyTable.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Structures/StructAlias.hpp"
+#include "Structures/StructBusEntry.hpp"
+#include "Structures/StructDevice.hpp"
+#include "Structures/StructGlobal.hpp"
+#include "Structures/StructGraphicInst.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructOffPageConnector.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+#include "Structures/StructPort.hpp"
+#include "Structures/StructSymbolDisplayProp.hpp"
+#include "Structures/StructTitleBlock.hpp"
+#include "Structures/StructWire.hpp"
+#include "Structures/StructWireBus.hpp"
+#include "WireJunctions.hpp"
+
+namespace
+{
+constexpr std::string_view FileHeader = "(kicad_sch (version 20230121) (generator \"OpenOrCadParser\")\n";
+
+// Size of the sheet symbols on the root sheet in OrCAD units
+constexpr int32_t SheetWidth   = 200;
+constexpr int32_t SheetHeight  = 100;
+constexpr int32_t SheetSpacing = 50;
+constexpr int32_t SheetsPerRow = 4;
+
+/**
+ * @brief Deterministic UUID s.t. repeated exports result in identical files.
+ */
+std::string makeUuid(std::string_view aSeed, uint64_t aIdx)
+{
+    OOCP::ContentHash hi;
+    hi.add(aSeed.data(), aSeed.size());
+    hi.add(aIdx);
+
+    OOCP::ContentHash lo;
+    lo.add(aIdx);
+    lo.add(aSeed.data(), aSeed.size());
+
+    // Mark as version 4 and variant 1
+    const uint64_t a = (hi.getHash() & 0xffffffffffff0fffULL) | 0x0000000000004000ULL;
+    const uint64_t b = (lo.getHash() & 0x3fffffffffffffffULL) | 0x8000000000000000ULL;
+
+    return fmt::format("{:08x}-{:04x}-{:04x}-{:04x}-{:012x}", a >> 32U, (a >> 16U) & 0xffffU, a & 0xffffU,
+        b >> 48U, b & 0xffffffffffffULL);
+}
+
+std::string toFileName(const std::string& aName)
+{
+    std::string name = aName;
+
+    for(char& c : name)
+    {
+        if(!std::isalnum(static_cast<unsigned char>(c)) && c != '-' && c != '_')
+        {
+            c = '_';
+        }
+    }
+
+    return name;
+}
+
+std::string toPaper(const std::string& aPageSize)
+{
+    std::string size = aPageSize;
+
+    std::transform(size.begin(), size.end(), size.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    static const std::set<std::string> KnownSizes = {"A0", "A1", "A2", "A3", "A4", "A5", "A", "B", "C", "D", "E"};
+
+    if(KnownSizes.count(size) > 0U)
+    {
+        return size;
+    }
+
+    if(size == "LETTER" || size == "USLETTER")
+    {
+        return "USLetter";
+    }
+
+    return "A4";
+}
+
+std::string toMmPoint(int32_t aX, int32_t aY)
+{
+    return fmt::format("{} {}", OOCP::toKiCadMm(aX), OOCP::toKiCadMm(aY));
+}
+
+const OOCP::StructSymbolDisplayProp* findDisplayProp(const OOCP::StructPlacedInstance& aInst, std::string_view aName)
+{
+    for(const auto& prop : aInst.symbolDisplayProps)
+    {
+        if(prop && prop->getName() == aName)
+        {
+            return prop.get();
+        }
+    }
+
+    return nullptr;
+}
+} // namespace
+
+fs::path OOCP::KiCadSchematicExporter::exportSchematic(const fs::path& aOutDir)
+{
+    mProjectName = mCtx.mInputCfbfFile.stem().string();
+    mRootUuid    = makeUuid(mProjectName, 0U);
+
+    std::vector<std::shared_ptr<StreamPage>> pages;
+
+    for(const auto& stream : mCtx.mDb.mStreams)
+    {
+        if(const auto page = std::dynamic_pointer_cast<StreamPage>(stream))
+        {
+            pages.push_back(page);
+        }
+    }
+
+    std::sort(pages.begin(), pages.end(),
+        [](const std::shared_ptr<StreamPage>& aLhs, const std::shared_ptr<StreamPage>& aRhs)
+        {
+            return aLhs->mCtx.mCfbfStreamLocation.get_vector() < aRhs->mCtx.mCfbfStreamLocation.get_vector();
+        });
+
+    if(pages.empty())
+    {
+        mCtx.mLogger.warn("{}: Database does not contain any pages", __func__);
+    }
+
+    collectSymbols();
+
+    mPropTable = std::make_unique<PropertyTable>(mCtx);
+
+    // Location is `Views/<Schematic>/Pages/<Page>`, the schematic is only part
+    // of the sheet name if the design contains more than one
+    std::set<std::string> schematics;
+
+    for(const auto& page : pages)
+    {
+        const auto& location = page->mCtx.mCfbfStreamLocation.get_vector();
+
+        schematics.insert(location.size() > 1U ? location.at(1U) : std::string{});
+    }
+
+    std::vector<Sheet> sheets;
+    std::set<std::string> sheetNames;
+
+    for(const auto& page : pages)
+    {
+        const auto& location = page->mCtx.mCfbfStreamLocation.get_vector();
+
+        const std::string schematic = location.size() > 1U ? location.at(1U) : std::string{};
+
+        std::string name = schematics.size() > 1U ? fmt::format("{}_{}", schematic, page->name) : page->name;
+
+        if(name.empty())
+        {
+            name = "Page";
+        }
+
+        // Sheet names need to be unique
+        const std::string baseName = name;
+
+        for(std::size_t i = 2U; !sheetNames.insert(name).second; ++i)
+        {
+            name = fmt::format("{}_{}", baseName, i);
+        }
+
+        Sheet sheet;
+
+        sheet.page       = page.get();
+        sheet.name       = name;
+        sheet.fileName   = toFileName(fmt::format("{}_{}", mProjectName, name)) + ".kicad_sch";
+        sheet.uuid       = makeUuid(sheet.fileName, 1U);
+        sheet.pageNumber = static_cast<uint32_t>(sheets.size() + 2U);
+
+        sheets.push_back(std::move(sheet));
+    }
+
+    fs::create_directories(aOutDir);
+
+    mCtx.mLogger.info("Exporting {} pages with {} embedded symbols to {}", sheets.size(), mLibSymbols.size(),
+        aOutDir.string());
+
+    // Not `std::vector<bool>` as it is written concurrently
+    std::vector<uint8_t> isWritten(sheets.size(), 0U);
+
+    parallelFor(mCtx.mCfg.mThreadCount, sheets.size(),
+        [&](std::size_t aIdx)
+        {
+            try
+            {
+                writePage(aOutDir / sheets[aIdx].fileName, sheets[aIdx]);
+
+                isWritten[aIdx] = 1U;
+            }
+            catch(const std::exception& e)
+            {
+                mCtx.mLogger.error("{}: Failed to export page {}: {}", __func__, sheets[aIdx].name, e.what());
+            }
+        });
+
+    // The root sheet must not reference files that were not written
+    std::vector<Sheet> writtenSheets;
+
+    for(std::size_t i = 0U; i < sheets.size(); ++i)
+    {
+        if(isWritten[i] != 0U)
+        {
+            writtenSheets.push_back(std::move(sheets[i]));
+        }
+    }
+
+    sheets = std::move(writtenSheets);
+
+    const fs::path rootPath = aOutDir / (mProjectName + ".kicad_sch");
+
+    writeRootSheet(rootPath, sheets);
+
+    return rootPath;
+}
+
+void OOCP::KiCadSchematicExporter::collectSymbols()
+{
+    mSymbolRefs.clear();
+    mLibSymbols.clear();
+
+    std::vector<std::shared_ptr<StreamPackage>> packages;
+
+    for(const auto& stream : mCtx.mDb.mStreams)
+    {
+        if(const auto package = std::dynamic_pointer_cast<StreamPackage>(stream))
+        {
+            if(package->package)
+            {
+                packages.push_back(package);
+            }
+        }
+    }
+
+    std::sort(packages.begin(), packages.end(),
+        [](const std::shared_ptr<StreamPackage>& aLhs, const std::shared_ptr<StreamPackage>& aRhs)
+        {
+            return aLhs->mCtx.mCfbfStreamLocation.get_vector() < aRhs->mCtx.mCfbfStreamLocation.get_vector();
+        });
+
+    // Views are unique by name, packages only add their name if it is not taken yet
+    for(const auto& package : packages)
+    {
+        const auto unitViews = PinTable::getUnitViews(*package);
+
+        const bool isHomogeneous = unitViews.size() == 1U;
+
+        for(std::size_t i = 0U; i < unitViews.size(); ++i)
+        {
+            const int32_t unit = isHomogeneous ? 1 : static_cast<int32_t>(i + 1U);
+
+            mSymbolRefs.emplace(unitViews[i].normalView->name, SymbolRef{package.get(), unit, 1});
+
+            if(unitViews[i].convertView)
+            {
+                mSymbolRefs.emplace(unitViews[i].convertView->name, SymbolRef{package.get(), unit, 2});
+            }
+        }
+    }
+
+    for(const auto& package : packages)
+    {
+        mSymbolRefs.emplace(package->package->name, SymbolRef{package.get(), 1, 1});
+    }
+
+    // Render every symbol that is placed at least once
+    std::unordered_set<const StreamPackage*> usedPackages;
+
+    for(const auto& stream : mCtx.mDb.mStreams)
+    {
+        if(const auto page = std::dynamic_pointer_cast<StreamPage>(stream))
+        {
+            for(const auto& inst : page->placedInstances)
+            {
+                if(const auto symbolRef = inst ? findSymbol(inst->pkgName) : std::nullopt)
+                {
+                    usedPackages.insert(symbolRef->package);
+                }
+            }
+        }
+    }
+
+    std::vector<const StreamPackage*> used{usedPackages.cbegin(), usedPackages.cend()};
+    std::vector<std::string> rendered(used.size());
+
+    const KiCadSymbolExporter symbolExporter{mCtx};
+
+    parallelFor(mCtx.mCfg.mThreadCount, used.size(),
+        [&](std::size_t aIdx) { symbolExporter.writePackage(rendered[aIdx], *used[aIdx], mProjectName); });
+
+    for(std::size_t i = 0U; i < used.size(); ++i)
+    {
+        mLibSymbols.emplace(used[i], std::move(rendered[i]));
+    }
+}
+
+std::optional<OOCP::KiCadSchematicExporter::SymbolRef> OOCP::KiCadSchematicExporter::findSymbol(
+    const std::string& aPkgName) const
+{
+    const auto it = mSymbolRefs.find(aPkgName);
+
+    if(it == mSymbolRefs.end())
+    {
+        return std::nullopt;
+    }
+
+    return std::make_optional<SymbolRef>(it->second);
+}
+
+std::string OOCP::KiCadSchematicExporter::getLibId(const StreamPackage& aPackage) const
+{
+    return fmt::format("{}:{}", mProjectName, cp1252ToUtf8(KiCadSymbolExporter::getSymbolName(aPackage)));
+}
+
+void OOCP::KiCadSchematicExporter::writeRootSheet(const fs::path& aPath, const std::vector<Sheet>& aSheets) const
+{
+    std::string buf;
+
+    auto out = std::back_inserter(buf);
+
+    fmt::format_to(out, "{}", FileHeader);
+    fmt::format_to(out, "  (uuid {})\n  (paper \"A4\")\n", mRootUuid);
+    fmt::format_to(out, "  (title_block (title {}))\n", quoteKiCadString(mProjectName));
+    fmt::format_to(out, "  (lib_symbols)\n");
+
+    const std::string font = toKiCadFont();
+
+    for(std::size_t i = 0U; i < aSheets.size(); ++i)
+    {
+        const Sheet& sheet = aSheets[i];
+
+        const int32_t col = static_cast<int32_t>(i % SheetsPerRow);
+        const int32_t row = static_cast<int32_t>(i / SheetsPerRow);
+
+        const int32_t x = SheetSpacing + col * (SheetWidth + SheetSpacing);
+        const int32_t y = SheetSpacing + row * (SheetHeight + SheetSpacing);
+
+        fmt::format_to(out, "  (sheet (at {}) (size {})\n", toMmPoint(x, y), toMmPoint(SheetWidth, SheetHeight));
+        fmt::format_to(out, "    (stroke (width 0.1524) (type solid))\n    (fill (color 0 0 0 0.0000))\n");
+        fmt::format_to(out, "    (uuid {})\n", sheet.uuid);
+        fmt::format_to(out,
+            "    (property \"Sheetname\" {} (at {} 0)\n      (effects {} (justify left bottom))\n    )\n",
+            toKiCadString(sheet.name), toMmPoint(x, y - 3), font);
+        fmt::format_to(out, "    (property \"Sheetfile\" {} (at {} 0)\n      (effects {} (justify left top))\n    )\n",
+            quoteKiCadString(sheet.fileName), toMmPoint(x, y + SheetHeight + 3), font);
+        fmt::format_to(out, "    (instances\n      (project {}\n        (path \"/{}\" (page \"{}\"))\n      )\n    )\n",
+            quoteKiCadString(mProjectName), mRootUuid, sheet.pageNumber);
+        fmt::format_to(out, "  )\n");
+    }
+
+    fmt::format_to(out, "  (sheet_instances\n    (path \"/\" (page \"1\"))\n  )\n");
+    fmt::format_to(out, ")\n");
+
+    OutputSink sink{aPath};
+
+    sink.getStream() << buf;
+    sink.close();
+}
+
+void OOCP::KiCadSchematicExporter::writePage(const fs::path& aPath, const Sheet& aSheet) const
+{
+    const StreamPage& page = *aSheet.page;
+
+    std::string buf;
+
+    auto out = std::back_inserter(buf);
+
+    // Running index for the UUIDs of the page's items
+    uint64_t itemIdx = 2U;
+
+    const auto nextUuid = [&]() { return makeUuid(aSheet.fileName, itemIdx++); };
+
+    const std::string font = toKiCadFont();
+
+    fmt::format_to(out, "{}", FileHeader);
+    fmt::format_to(out, "  (uuid {})\n", makeUuid(aSheet.fileName, 0U));
+    fmt::format_to(out, "  (paper \"{}\")\n", toPaper(page.pageSize));
+
+    // @todo Title block values are not yet decoded, only the page is named
+    fmt::format_to(out, "  (title_block\n    (title {})\n", toKiCadString(page.name));
+
+    for(std::size_t i = 0U; i < page.titleBlocks.size() && i < 9U; ++i)
+    {
+        if(page.titleBlocks[i])
+        {
+            fmt::format_to(out, "    (comment {} {})\n", i + 1U, toKiCadString(page.titleBlocks[i]->name));
+        }
+    }
+
+    fmt::format_to(out, "  )\n");
+
+    // Embedded symbols, ordered by their library identifier
+    std::map<std::string, const StreamPackage*> libSymbols;
+
+    for(const auto& inst : page.placedInstances)
+    {
+        if(const auto symbolRef = inst ? findSymbol(inst->pkgName) : std::nullopt)
+        {
+            libSymbols.emplace(getLibId(*symbolRef->package), symbolRef->package);
+        }
+    }
+
+    fmt::format_to(out, "  (lib_symbols\n");
+
+    for(const auto& [libId, package] : libSymbols)
+    {
+        const auto it = mLibSymbols.find(package);
+
+        if(it != mLibSymbols.end())
+        {
+            buf += it->second;
+        }
+    }
+
+    fmt::format_to(out, "  )\n");
+
+    // Wires and buses
+
+    // KiCad requires explicit junctions, OrCAD derives them from the wires
+    for(const auto& [x, y] : getJunctions(page))
+    {
+        fmt::format_to(
+            out, "  (junction (at {}) (diameter 0) (color 0 0 0 0)\n    (uuid {})\n  )\n", toMmPoint(x, y), nextUuid());
+    }
+
+    for(const auto& wire : page.wires)
+    {
+        if(!wire)
+        {
+            continue;
+        }
+
+        const bool isBus = dynamic_cast<const StructWireBus*>(wire.get()) != nullptr;
+
+        fmt::format_to(out, "  ({} (pts (xy {}) (xy {}))\n    (stroke (width {}) (type {}))\n    (uuid {})\n  )\n",
+            isBus ? "bus" : "wire", toMmPoint(wire->startX, wire->startY), toMmPoint(wire->endX, wire->endY),
+            toKiCadStrokeWidth(wire->lineWidth), toKiCadStrokeType(wire->lineStyle), nextUuid());
+
+        // Net aliases become local labels
+        for(const auto& alias : wire->aliases)
+        {
+            if(!alias)
+            {
+                continue;
+            }
+
+            fmt::format_to(out,
+                "  (label {} (at {} {})\n    (effects {} (justify left bottom))\n    (uuid {})\n  )\n",
+                toKiCadString(alias->name), toMmPoint(alias->locX, alias->locY), toKiCadAngle(alias->rotation),
+                font, nextUuid());
+        }
+    }
+
+    for(const auto& busEntry : page.busEntries)
+    {
+        if(!busEntry)
+        {
+            continue;
+        }
+
+        fmt::format_to(out,
+            "  (bus_entry (at {}) (size {})\n    (stroke (width 0) (type default))\n    (uuid {})\n  )\n",
+            toMmPoint(busEntry->startX, busEntry->startY),
+            toMmPoint(busEntry->endX - busEntry->startX, busEntry->endY - busEntry->startY), nextUuid());
+    }
+
+    // Globals and off-page connectors connect nets by name across all pages,
+    // ports connect to the parent sheet
+
+    const auto writeLabel = [&](std::string_view aType, const StructGraphicInst& aInst)
+    {
+        fmt::format_to(out,
+            "  ({} {} (shape passive) (at {} 0) (fields_autoplaced)\n    (effects {} (justify left))\n"
+            "    (uuid {})\n  )\n",
+            aType, toKiCadString(aInst.name), toMmPoint(aInst.locX, aInst.locY), font, nextUuid());
+    };
+
+    for(const auto& global : page.globals)
+    {
+        if(global)
+        {
+            writeLabel("global_label", *global);
+        }
+    }
+
+    for(const auto& offPageConnector : page.offPageConnectors)
+    {
+        if(offPageConnector)
+        {
+            writeLabel("global_label", *offPageConnector);
+        }
+    }
+
+    for(const auto& port : page.ports)
+    {
+        if(port)
+        {
+            writeLabel("hierarchical_label", *port);
+        }
+    }
+
+    if(!page.ports.empty())
+    {
+        mCtx.mLogger.warn("{}: {} ports on page {} are exported as hierarchical labels without sheet pins, their "
+                          "nets are not connected to other sheets",
+            __func__, page.ports.size(), page.name);
+    }
+
+    if(!page.graphicInsts.empty())
+    {
+        mCtx.mLogger.debug("{}: {} graphic instances on page {} are not exported", __func__, page.graphicInsts.size(),
+            page.name);
+    }
+
+    std::size_t unresolvedInstances = 0U;
+
+    for(std::size_t i = 0U; i < page.placedInstances.size(); ++i)
+    {
+        const auto& inst = page.placedInstances[i];
+
+        if(!inst)
+        {
+            continue;
+        }
+
+        if(!findSymbol(inst->pkgName).has_value())
+        {
+            ++unresolvedInstances;
+            continue;
+        }
+
+        writeInstance(buf, *inst, aSheet, itemIdx++);
+    }
+
+    if(unresolvedInstances > 0U)
+    {
+        mCtx.mLogger.warn("{}: {} instances on page {} reference unknown packages", __func__, unresolvedInstances,
+            page.name);
+    }
+
+    fmt::format_to(out, ")\n");
+
+    OutputSink sink{aPath};
+
+    sink.getStream() << buf;
+    sink.close();
+}
+
+std::optional<std::size_t> OOCP::KiCadSchematicExporter::findInstanceProps(
+    const StructPlacedInstance& aInst, const Sheet& aSheet) const
+{
+    if(!mPropTable || !aInst.propOffset.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return mPropTable->findObject(to_string(aSheet.page->mCtx.mCfbfStreamLocation), aInst.propOffset.value());
+}
+
+OOCP::KiCadSchematicExporter::PlacedUnit OOCP::KiCadSchematicExporter::getUnit(const StructPlacedInstance& aInst,
+    const SymbolRef& aSymbolRef, const std::optional<std::size_t>& aPropObject) const
+{
+    const StreamPackage& package = *aSymbolRef.package;
+
+    const auto& devices = package.package->devices;
+
+    // Views of heterogeneous packages are unique per unit
+    if(devices.size() < 2U || PinTable::getUnitViews(package).size() != 1U)
+    {
+        return PlacedUnit{aSymbolRef.unit, aInst.reference};
+    }
+
+    const std::optional<std::string> designator =
+        aPropObject.has_value() ? mPropTable->findValue(aPropObject.value(), "Designator") : std::nullopt;
+
+    std::optional<std::size_t> device;
+
+    for(std::size_t i = 0U; i < devices.size(); ++i)
+    {
+        if(!devices[i] || devices[i]->unitRef.empty())
+        {
+            continue;
+        }
+
+        const std::string& unitRef = devices[i]->unitRef;
+
+        if(designator.has_value())
+        {
+            if(designator.value() == unitRef)
+            {
+                device = i;
+                break;
+            }
+
+            continue;
+        }
+
+        const std::string& reference = aInst.reference;
+
+        const bool isSuffix = reference.size() > unitRef.size() &&
+                              reference.compare(reference.size() - unitRef.size(), unitRef.size(), unitRef) == 0;
+
+        // Prefer the longest suffix, e.g. `AA` over `A`
+        if(isSuffix && (!device.has_value() || devices[device.value()]->unitRef.size() < unitRef.size()))
+        {
+            device = i;
+        }
+    }
+
+    if(!device.has_value())
+    {
+        mCtx.mLogger.debug("{}: Unit of instance `{}` could not be resolved, it is placed as unit {}", __func__,
+            aInst.reference, aSymbolRef.unit);
+
+        return PlacedUnit{aSymbolRef.unit, aInst.reference};
+    }
+
+    const int32_t unit = static_cast<int32_t>(device.value() + 1U);
+
+    if(designator.has_value())
+    {
+        return PlacedUnit{unit, aInst.reference};
+    }
+
+    const std::size_t suffixLen = devices[device.value()]->unitRef.size();
+
+    return PlacedUnit{unit, aInst.reference.substr(0U, aInst.reference.size() - suffixLen)};
+}
+
+void OOCP::KiCadSchematicExporter::writeInstance(
+    std::string& aBuf, const StructPlacedInstance& aInst, const Sheet& aSheet, std::size_t aIdx) const
+{
+    const SymbolRef symbolRef = findSymbol(aInst.pkgName).value();
+
+    const StreamPackage& package = *symbolRef.package;
+
+    // OrCAD mirrors before rotating, KiCad rotates before mirroring.
+    // Mirroring along the Y-axis inverts the direction of the rotation.
+    int32_t angle = toKiCadAngle(aInst.rotation);
+
+    if(aInst.mirrored)
+    {
+        angle = (360 - angle) % 360;
+    }
+
+    const std::optional<std::size_t> propObject = findInstanceProps(aInst, aSheet);
+
+    const auto [unit, reference] = getUnit(aInst, symbolRef, propObject);
+
+    // The value is a property of the instance, the library value is only its default
+    std::optional<std::string> value =
+        propObject.has_value() ? mPropTable->findValue(propObject.value(), "Value") : std::nullopt;
+
+    if(!value.has_value())
+    {
+        const auto unitViews = PinTable::getUnitViews(package);
+
+        const StructLibraryPart* view = unitViews.empty() ? nullptr : unitViews.front().normalView;
+
+        value = view && !view->generalProperties.partValue.empty() ? view->generalProperties.partValue
+                                                                   : package.package->name;
+    }
+
+    // Same for the footprint, e.g. when the footprint was changed in the design
+    const std::string footprint =
+        (propObject.has_value() ? mPropTable->findValue(propObject.value(), "PCB Footprint") : std::nullopt)
+            .value_or(package.package->pcbFootprint);
+
+    const InstanceTransform transform = InstanceTransform::fromPlacedInstance(aInst);
+
+    const auto getPropLoc = [&](std::string_view aName) -> std::string
+    {
+        if(const auto* prop = findDisplayProp(aInst, aName))
+        {
+            const auto [x, y] = transform.apply(prop->x, prop->y);
+
+            return toMmPoint(x, y);
+        }
+
+        return toMmPoint(aInst.locX, aInst.locY);
+    };
+
+    const std::string font = toKiCadFont();
+
+    auto out = std::back_inserter(aBuf);
+
+    fmt::format_to(out, "  (symbol (lib_id {}) (at {} {}){} (unit {}){}\n",
+        quoteKiCadString(getLibId(package)), toMmPoint(aInst.locX, aInst.locY), angle,
+        aInst.mirrored ? " (mirror y)" : "", unit,
+        symbolRef.bodyStyle != 1 ? fmt::format(" (convert {})", symbolRef.bodyStyle) : std::string{});
+    fmt::format_to(out, "    (in_bom yes) (on_board yes) (dnp no)\n");
+    fmt::format_to(out, "    (uuid {})\n", makeUuid(aSheet.fileName, aIdx));
+    fmt::format_to(out, "    (property \"Reference\" {} (at {} 0) (id 0)\n      (effects {})\n    )\n",
+        toKiCadString(reference), getPropLoc("Part Reference"), font);
+    fmt::format_to(out, "    (property \"Value\" {} (at {} 0) (id 1)\n      (effects {})\n    )\n",
+        toKiCadString(value.value()), getPropLoc("Value"), font);
+    fmt::format_to(out, "    (property \"Footprint\" {} (at {} 0) (id 2)\n      (effects {} hide)\n    )\n",
+        toKiCadString(footprint), toMmPoint(aInst.locX, aInst.locY), font);
+    fmt::format_to(out,
+        "    (instances\n      (project {}\n        (path \"/{}/{}\"\n          (reference {}) (unit {})\n"
+        "        )\n      )\n    )\n",
+        quoteKiCadString(mProjectName), mRootUuid, aSheet.uuid, toKiCadString(reference), unit);
+    fmt::format_to(out, "  )\n");
+}
@@ -0,0 +1,127 @@
+#ifndef KICADSCHEMATICEXPORTER_HPP
+#define KICADSCHEMATICEXPORTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ContainerContext.hpp"
+#include "PropertyTable.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+class StreamPackage;
+class StreamPage;
+class StructPlacedInstance;
+
+/**
+ * @brief Converts the pages of a parsed design into a KiCad schematic (`.kicad_sch`).
+ *
+ * @note The root sheet contains one sheet symbol per page, each page is written
+ *       into its own file. Symbols are rendered once and embedded into every
+ *       page that uses them. Pages are converted in parallel.
+ *
+ * @note Known limitation, reported as warning during the export: The
+ *       hierarchy is flattened into one sheet per page. Ports become
+ *       hierarchical labels, but the sheet symbols on the root sheet have
+ *       no sheet pins, i.e. nets are not connected through ports.
+ */
+class KiCadSchematicExporter
+{
+public:
+    KiCadSchematicExporter(ContainerContext& aCtx)
+        : mCtx{aCtx},
+          mProjectName{},
+          mRootUuid{},
+          mSymbolRefs{},
+          mLibSymbols{},
+          mPropTable{}
+    {
+    }
+
+    /**
+     * @brief Export all pages.
+     *
+     * @param aOutDir Output directory.
+     * @return fs::path Path to the root sheet, named after the input file.
+     */
+    fs::path exportSchematic(const fs::path& aOutDir);
+
+private:
+    /**
+     * @brief KiCad symbol an instance is placed as.
+     */
+    struct SymbolRef
+    {
+        const StreamPackage* package;
+        int32_t unit;
+        int32_t bodyStyle;
+    };
+
+    struct Sheet
+    {
+        const StreamPage* page;
+        std::string name;
+        std::string fileName;
+        std::string uuid;
+        uint32_t pageNumber;
+    };
+
+    void collectSymbols();
+
+    std::optional<SymbolRef> findSymbol(const std::string& aPkgName) const;
+
+    /**
+     * @return std::string UTF-8 encoded library identifier `<project>:<symbol>`.
+     */
+    std::string getLibId(const StreamPackage& aPackage) const;
+
+    void writeRootSheet(const fs::path& aPath, const std::vector<Sheet>& aSheets) const;
+
+    void writePage(const fs::path& aPath, const Sheet& aSheet) const;
+
+    void writeInstance(std::string& aBuf, const StructPlacedInstance& aInst, const Sheet& aSheet,
+        std::size_t aIdx) const;
+
+    /**
+     * @brief Properties of a placed instance inside the property table.
+     */
+    std::optional<std::size_t> findInstanceProps(const StructPlacedInstance& aInst, const Sheet& aSheet) const;
+
+    struct PlacedUnit
+    {
+        int32_t unit;
+        std::string reference; //!< Reference without the unit suffix, e.g. `U1` of `U1B`
+    };
+
+    /**
+     * @brief Unit the instance is placed as.
+     *
+     * @note Units of homogeneous packages share one view, the unit is
+     *       resolved from the `Designator` property or the suffix of
+     *       the reference, e.g. `U1B` is placed as the second device.
+     *       KiCad appends the unit itself, i.e. the suffix is removed.
+     */
+    PlacedUnit getUnit(const StructPlacedInstance& aInst, const SymbolRef& aSymbolRef,
+        const std::optional<std::size_t>& aPropObject) const;
+
+    ContainerContext& mCtx;
+
+    std::string mProjectName; //!< Stem of the input file, i.e. UTF-8 encoded
+    std::string mRootUuid;
+
+    std::unordered_map<std::string, SymbolRef> mSymbolRefs; //!< View or package name -> symbol
+
+    std::unordered_map<const StreamPackage*, std::string> mLibSymbols; //!< Rendered `lib_symbols` entries
+
+    std::unique_ptr<PropertyTable> mPropTable; //!< Instance properties, e.g. the value
+};
+} // namespace OOCP
+#endif // KICADSCHEMATICEXPORTER_HPP
@@ -0,0 +1,593 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "BoundingBox.hpp"
+#include "CfbfStreamLocation.hpp"
+#include "Database.hpp"
+#include "Encoding.hpp"
+#include "Enums/FillStyle.hpp"
+#include "Enums/LineStyle.hpp"
+#include "Enums/LineWidth.hpp"
+#include "Enums/PortType.hpp"
+#include "KiCadHelper.hpp"
+#include "KiCadSymbolExporter.hpp"
+#include "OutputSink.hpp"
+#include "ParallelFor.hpp"
+#include "PinShape.hpp"
+#include "PinTable.hpp"
+#include "Primitives/Point.hpp"
+#include "Primitives/PrimArc.hpp"
+#include "Primitives/PrimBase.hpp"
+#include "Primitives/PrimBezier.hpp"
+#include "Primitives/PrimBitmap.hpp"
+#include "Primitives/PrimCommentText.hpp"
+#include "Primitives/PrimEllipse.hpp"
+#include "Primitives/PrimLine.hpp"
+#include "Primitives/PrimPolygon.hpp"
+#include "Primitives/PrimPolyline.hpp"
+#include "Primitives/PrimRect.hpp"
+#include "Primitives/PrimSymbolVector.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructSymbolDisplayProp.hpp"
+#include "Structures/StructSymbolPin.hpp"
+#include "Tessellation.hpp"
+#include "Win32/LOGFONTA.hpp"
+
+namespace
+{
+// Maximum deviation of tessellated curves in OrCAD units
+constexpr double CurveTolerance = 0.25;
+
+// Packages rendered per thread before the buffers are written out
+constexpr std::size_t BatchSizePerThread = 16U;
+
+// KiCad's Y axis points up, OrCAD's down
+std::string toMmX(double aX)
+{
+    return OOCP::toKiCadMm(aX);
+}
+
+std::string toMmY(double aY)
+{
+    return OOCP::toKiCadMm(-aY);
+}
+
+// KiCad has no hatch patterns, they are approximated by the background fill
+std::string_view toFillType(OOCP::FillStyle aStyle)
+{
+    switch(aStyle)
+    {
+        case OOCP::FillStyle::Solid:        return "outline";
+        case OOCP::FillStyle::HatchPattern: return "background";
+        default:                            return "none";
+    }
+}
+
+std::string_view toElectricalType(OOCP::PortType aType)
+{
+    switch(aType)
+    {
+        case OOCP::PortType::Input:         return "input";
+        case OOCP::PortType::Bidirectional: return "bidirectional";
+        case OOCP::PortType::Output:        return "output";
+        case OOCP::PortType::OpenCollector: return "open_collector";
+        case OOCP::PortType::Passive:       return "passive";
+        case OOCP::PortType::ThreeState:    return "tri_state";
+        case OOCP::PortType::OpenEmitter:   return "open_emitter";
+        case OOCP::PortType::Power:         return "power_in";
+        default:                            return "unspecified";
+    }
+}
+
+std::string_view toGraphicStyle(const OOCP::PinShape& aShape)
+{
+    if(aShape.isClock && aShape.isDot)
+    {
+        return "inverted_clock";
+    }
+
+    if(aShape.isClock)
+    {
+        return "clock";
+    }
+
+    if(aShape.isDot)
+    {
+        return "inverted";
+    }
+
+    return "line";
+}
+
+template <typename Prim> std::string getStroke(const Prim& aPrim)
+{
+    return fmt::format("(stroke (width {}) (type {}))", OOCP::toKiCadStrokeWidth(aPrim.getLineWidth()),
+        OOCP::toKiCadStrokeType(aPrim.getLineStyle()));
+}
+
+std::string getFill(OOCP::FillStyle aStyle)
+{
+    return fmt::format("(fill (type {}))", toFillType(aStyle));
+}
+
+void writePolyline(std::string& aBuf, const std::vector<double>& aX, const std::vector<double>& aY, double aDx,
+    double aDy, const std::string& aStroke, const std::string& aFill)
+{
+    auto out = std::back_inserter(aBuf);
+
+    fmt::format_to(out, "      (polyline\n        (pts");
+
+    for(std::size_t i = 0U; i < aX.size() && i < aY.size(); ++i)
+    {
+        fmt::format_to(out, " (xy {} {})", toMmX(aX[i] + aDx), toMmY(aY[i] + aDy));
+    }
+
+    fmt::format_to(out, ")\n        {}\n        {}\n      )\n", aStroke, aFill);
+}
+
+void writePoints(std::string& aBuf, const std::vector<OOCP::Point>& aPoints, int32_t aDx, int32_t aDy,
+    const std::string& aStroke, const std::string& aFill, bool aClose)
+{
+    std::vector<double> x;
+    std::vector<double> y;
+
+    for(const auto& point : aPoints)
+    {
+        x.push_back(point.x);
+        y.push_back(point.y);
+    }
+
+    if(aClose && !aPoints.empty() && (x.front() != x.back() || y.front() != y.back()))
+    {
+        x.push_back(aPoints.front().x);
+        y.push_back(aPoints.front().y);
+    }
+
+    writePolyline(aBuf, x, y, aDx, aDy, aStroke, aFill);
+}
+
+const OOCP::StructSymbolDisplayProp* findDisplayProp(const OOCP::StructLibraryPart& aView, std::string_view aName)
+{
+    for(const auto& prop : aView.symbolDisplayProps)
+    {
+        if(prop && prop->getName() == aName)
+        {
+            return prop.get();
+        }
+    }
+
+    return nullptr;
+}
+
+std::string removeSuffix(const std::string& aStr, const std::string& aSuffix)
+{
+    if(aStr.size() >= aSuffix.size() && aStr.compare(aStr.size() - aSuffix.size(), aSuffix.size(), aSuffix) == 0)
+    {
+        return aStr.substr(0U, aStr.size() - aSuffix.size());
+    }
+
+    return aStr;
+}
+} // namespace
+
+fs::path OOCP::KiCadSymbolExporter::exportSymbolLibrary(const fs::path& aOutDir)
+{
+    std::vector<std::shared_ptr<StreamPackage>> packages;
+
+    for(const auto& stream : mCtx.mDb.mStreams)
+    {
+        if(const auto package = std::dynamic_pointer_cast<StreamPackage>(stream))
+        {
+            packages.push_back(package);
+        }
+    }
+
+    // Output should not depend on the order in which the streams were enumerated
+    std::sort(packages.begin(), packages.end(),
+        [](const std::shared_ptr<StreamPackage>& aLhs, const std::shared_ptr<StreamPackage>& aRhs)
+        {
+            return aLhs->mCtx.mCfbfStreamLocation.get_vector() < aRhs->mCtx.mCfbfStreamLocation.get_vector();
+        });
+
+    if(packages.empty())
+    {
+        mCtx.mLogger.warn("{}: Database does not contain any packages", __func__);
+    }
+
+    fs::create_directories(aOutDir);
+
+    const fs::path symPath = aOutDir / (mCtx.mInputCfbfFile.stem().string() + ".kicad_sym");
+
+    OutputSink sink{symPath};
+
+    std::ostream& sym = sink.getStream();
+
+    mCtx.mLogger.info("Exporting {} packages to {}", packages.size(), symPath.string());
+
+    sym << "(kicad_symbol_lib (version 20220914) (generator \"OpenOrCadParser\")\n";
+
+    const std::size_t threadCount = std::max<std::size_t>(mCtx.mCfg.mThreadCount, 1U);
+    const std::size_t batchSize   = threadCount * BatchSizePerThread;
+
+    std::vector<std::string> buffers(batchSize);
+
+    for(std::size_t batchStart = 0U; batchStart < packages.size(); batchStart += batchSize)
+    {
+        const std::size_t count = std::min(batchSize, packages.size() - batchStart);
+
+        parallelFor(threadCount, count,
+            [&](std::size_t aIdx)
+            {
+                try
+                {
+                    writePackage(buffers[aIdx], *packages[batchStart + aIdx]);
+                }
+                catch(const std::exception& e)
+                {
+                    // A single broken package should not abort the whole library
+                    buffers[aIdx].clear();
+
+                    mCtx.mLogger.error("{}: Skipping package {}: {}", __func__,
+                        to_string(packages[batchStart + aIdx]->mCtx.mCfbfStreamLocation), e.what());
+                }
+            });
+
+        // Write in stream order and release the buffers before the next batch
+        for(std::size_t i = 0U; i < count; ++i)
+        {
+            sym << buffers[i];
+            buffers[i].clear();
+            buffers[i].shrink_to_fit();
+        }
+    }
+
+    sym << ")\n";
+
+    sink.close();
+
+    return symPath;
+}
+
+std::string OOCP::KiCadSymbolExporter::getSymbolName(const StreamPackage& aPackage)
+{
+    return toKiCadSymbolName(aPackage.package ? aPackage.package->name : std::string{});
+}
+
+void OOCP::KiCadSymbolExporter::writePackage(
+    std::string& aBuf, const StreamPackage& aPackage, const std::string& aLibName) const
+{
+    if(!aPackage.package)
+    {
+        return;
+    }
+
+    const StructPackage& package = *aPackage.package;
+
+    const std::string name = getSymbolName(aPackage);
+
+    const std::vector<PinTable::UnitViews> cells = PinTable::getUnitViews(aPackage);
+
+    if(cells.empty())
+    {
+        mCtx.mLogger.warn("{}: Package `{}` does not contain any view", __func__, package.name);
+        return;
+    }
+
+    // Homogeneous packages share the graphics between all units, only pin numbers differ
+    const bool isHomogeneous = cells.size() == 1U;
+
+    const int32_t unitCount =
+        static_cast<int32_t>(isHomogeneous ? std::max<std::size_t>(package.devices.size(), 1U) : cells.size());
+
+    const StructLibraryPart& firstView = *cells.front().normalView;
+
+    const auto& props = firstView.generalProperties;
+
+    auto out = std::back_inserter(aBuf);
+
+    // Embedded symbols are referenced by their full library identifier, units only by the symbol name
+    // The library name is a UTF-8 file name, the symbol name CP1252 as all OrCAD strings
+    fmt::format_to(out, "  (symbol {}",
+        aLibName.empty() ? toKiCadString(name) : quoteKiCadString(fmt::format("{}:{}", aLibName, cp1252ToUtf8(name))));
+
+    if(!props.pinNumberVisible)
+    {
+        fmt::format_to(out, " (pin_numbers hide)");
+    }
+
+    fmt::format_to(out, " (pin_names (offset 0.254){})", props.pinNameVisible ? "" : " hide");
+    fmt::format_to(out, " (in_bom yes) (on_board yes)\n");
+
+    writeProperties(aBuf, name, aPackage, &firstView);
+
+    TessellationCache cache{CurveTolerance};
+
+    // Pin tables are built after parsing, packages that are not part of the database need their own
+    std::optional<PinTable> ownPinTable;
+
+    const auto pinTableIt    = mCtx.mDb.mPinTables.find(package.name);
+    const PinTable& pinTable =
+        pinTableIt != mCtx.mDb.mPinTables.cend() ? pinTableIt->second : ownPinTable.emplace(aPackage);
+
+    for(int32_t unit = 1; unit <= unitCount; ++unit)
+    {
+        const std::size_t cellIdx = isHomogeneous ? 0U : static_cast<std::size_t>(unit - 1);
+
+        const auto& [normalView, convertView] = cells[cellIdx];
+
+        if(isHomogeneous && unit == 1)
+        {
+            writeUnit(aBuf, name, 0, 1, *normalView, true, false, pinTable, cache);
+
+            if(convertView)
+            {
+                writeUnit(aBuf, name, 0, 2, *convertView, true, false, pinTable, cache);
+            }
+        }
+
+        writeUnit(aBuf, name, unit, 1, *normalView, !isHomogeneous, true, pinTable, cache);
+
+        if(convertView)
+        {
+            writeUnit(aBuf, name, unit, 2, *convertView, !isHomogeneous, true, pinTable, cache);
+        }
+    }
+
+    fmt::format_to(out, "  )\n");
+}
+
+void OOCP::KiCadSymbolExporter::writeProperties(
+    std::string& aBuf, const std::string& aName, const StreamPackage& aPackage, const StructLibraryPart* aView) const
+{
+    const StructPackage& package = *aPackage.package;
+
+    const BoundingBox bbox = aView ? getBoundingBox(*aView, false) : BoundingBox{};
+
+    // Place reference above and value below the body if no display property is available
+    int32_t refX = 0;
+    int32_t refY = bbox.isEmpty() ? -10 : bbox.y1 - 5;
+    int32_t valX = 0;
+    int32_t valY = bbox.isEmpty() ? 10 : bbox.y2 + 5;
+
+    if(aView)
+    {
+        if(const auto* prop = findDisplayProp(*aView, "Part Reference"))
+        {
+            refX = prop->x;
+            refY = prop->y;
+        }
+
+        if(const auto* prop = findDisplayProp(*aView, "Value"))
+        {
+            valX = prop->x;
+            valY = prop->y;
+        }
+    }
+
+    std::string refDes = removeSuffix(package.refDes, "?");
+
+    if(refDes.empty())
+    {
+        refDes = "U";
+    }
+
+    const std::string value = aView && !aView->generalProperties.partValue.empty()
+                                  ? aView->generalProperties.partValue
+                                  : aName;
+
+    const std::string font = toKiCadFont();
+
+    auto out = std::back_inserter(aBuf);
+
+    fmt::format_to(out, "    (property \"Reference\" {} (at {} {} 0) (id 0)\n      (effects {})\n    )\n",
+        toKiCadString(refDes), toMmX(refX), toMmY(refY), font);
+    fmt::format_to(out, "    (property \"Value\" {} (at {} {} 0) (id 1)\n      (effects {})\n    )\n",
+        toKiCadString(value), toMmX(valX), toMmY(valY), font);
+    fmt::format_to(out, "    (property \"Footprint\" {} (at 0 0 0) (id 2)\n      (effects {} hide)\n    )\n",
+        toKiCadString(package.pcbFootprint), font);
+    fmt::format_to(
+        out, "    (property \"Datasheet\" \"\" (at 0 0 0) (id 3)\n      (effects {} hide)\n    )\n", font);
+}
+
+void OOCP::KiCadSymbolExporter::writeUnit(std::string& aBuf, const std::string& aName, int32_t aUnit,
+    int32_t aBodyStyle, const StructLibraryPart& aView, bool aWriteGraphics, bool aWritePins,
+    const PinTable& aPinTable, TessellationCache& aCache) const
+{
+    auto out = std::back_inserter(aBuf);
+
+    fmt::format_to(out, "    (symbol {}\n", toKiCadString(fmt::format("{}_{}_{}", aName, aUnit, aBodyStyle)));
+
+    if(aWriteGraphics)
+    {
+        for(const auto& primitive : aView.primitives)
+        {
+            if(primitive)
+            {
+                writePrimitive(aBuf, *primitive, 0, 0, aCache);
+            }
+        }
+    }
+
+    if(aWritePins)
+    {
+        for(std::size_t position = 0U; position < aView.symbolPins.size(); ++position)
+        {
+            const auto& pin = aView.symbolPins[position];
+
+            if(!pin)
+            {
+                continue;
+            }
+
+            // Fall back to the pin position if the device does not map it
+            const auto pinIdx = aPinTable.findPin(static_cast<std::size_t>(aUnit - 1), position);
+
+            const bool isMapped = pinIdx.has_value() && !aPinTable.getNumber(pinIdx.value()).empty();
+
+            const std::string number = isMapped ? aPinTable.getNumber(pinIdx.value()) : std::to_string(position + 1U);
+
+            writePin(aBuf, *pin, number);
+        }
+    }
+
+    fmt::format_to(out, "    )\n");
+}
+
+void OOCP::KiCadSymbolExporter::writePrimitive(
+    std::string& aBuf, const PrimBase& aPrim, int32_t aDx, int32_t aDy, TessellationCache& aCache) const
+{
+    auto out = std::back_inserter(aBuf);
+
+    if(const auto* line = dynamic_cast<const PrimLine*>(&aPrim))
+    {
+        writePolyline(aBuf, {static_cast<double>(line->x1), static_cast<double>(line->x2)},
+            {static_cast<double>(line->y1), static_cast<double>(line->y2)}, aDx, aDy, getStroke(*line),
+            getFill(FillStyle::None));
+    }
+    else if(const auto* rect = dynamic_cast<const PrimRect*>(&aPrim))
+    {
+        fmt::format_to(out, "      (rectangle (start {} {}) (end {} {})\n        {}\n        {}\n      )\n",
+            toMmX(rect->x1 + aDx), toMmY(rect->y1 + aDy), toMmX(rect->x2 + aDx), toMmY(rect->y2 + aDy),
+            getStroke(*rect), getFill(rect->fillStyle));
+    }
+    else if(const auto* polygon = dynamic_cast<const PrimPolygon*>(&aPrim))
+    {
+        writePoints(aBuf, polygon->points, aDx, aDy, getStroke(*polygon), getFill(polygon->fillStyle), true);
+    }
+    else if(const auto* polyline = dynamic_cast<const PrimPolyline*>(&aPrim))
+    {
+        writePoints(aBuf, polyline->points, aDx, aDy, getStroke(*polyline), getFill(FillStyle::None), false);
+    }
+    else if(const auto* ellipse = dynamic_cast<const PrimEllipse*>(&aPrim))
+    {
+        const int32_t width  = std::abs(ellipse->x2 - ellipse->x1);
+        const int32_t height = std::abs(ellipse->y2 - ellipse->y1);
+
+        if(width == height)
+        {
+            fmt::format_to(out, "      (circle (center {} {}) (radius {})\n        {}\n        {}\n      )\n",
+                toMmX((ellipse->x1 + ellipse->x2) / 2.0 + aDx), toMmY((ellipse->y1 + ellipse->y2) / 2.0 + aDy),
+                toKiCadMm(width / 2.0), getStroke(*ellipse), getFill(ellipse->getFillStyle()));
+        }
+        else if(const auto curve = aCache.get(aPrim))
+        {
+            // KiCad does not support ellipses
+            writePolyline(aBuf, curve->x, curve->y, aDx, aDy, getStroke(*ellipse), getFill(ellipse->getFillStyle()));
+        }
+    }
+    else if(const auto* arc = dynamic_cast<const PrimArc*>(&aPrim))
+    {
+        const auto curve = aCache.get(aPrim);
+
+        if(!curve || curve->x.size() < 3U)
+        {
+            return;
+        }
+
+        const bool isCircular = std::abs(arc->x2 - arc->x1) == std::abs(arc->y2 - arc->y1);
+
+        if(isCircular)
+        {
+            // Three points on the tessellated curve define the circular arc
+            const std::size_t last = curve->x.size() - 1U;
+            const std::size_t mid  = last / 2U;
+
+            fmt::format_to(out,
+                "      (arc (start {} {}) (mid {} {}) (end {} {})\n        {}\n        {}\n      )\n",
+                toMmX(curve->x[0] + aDx), toMmY(curve->y[0] + aDy), toMmX(curve->x[mid] + aDx),
+                toMmY(curve->y[mid] + aDy), toMmX(curve->x[last] + aDx), toMmY(curve->y[last] + aDy),
+                getStroke(*arc), getFill(FillStyle::None));
+        }
+        else
+        {
+            // KiCad does not support elliptic arcs
+            writePolyline(aBuf, curve->x, curve->y, aDx, aDy, getStroke(*arc), getFill(FillStyle::None));
+        }
+    }
+    else if(const auto* bezier = dynamic_cast<const PrimBezier*>(&aPrim))
+    {
+        // Points are stored as P0 C1 C2 P1 C1 C2 P2 ..., each group of four forms one segment
+        for(std::size_t i = 0U; i + 3U < bezier->points.size(); i += 3U)
+        {
+            fmt::format_to(out, "      (bezier\n        (pts");
+
+            for(std::size_t j = i; j < i + 4U; ++j)
+            {
+                fmt::format_to(
+                    out, " (xy {} {})", toMmX(bezier->points[j].x + aDx), toMmY(bezier->points[j].y + aDy));
+            }
+
+            fmt::format_to(out, ")\n        {}\n        {}\n      )\n", getStroke(*bezier), getFill(FillStyle::None));
+        }
+    }
+    else if(const auto* commentText = dynamic_cast<const PrimCommentText*>(&aPrim))
+    {
+        // Location is the lower left corner of the text
+        fmt::format_to(out, "      (text {} (at {} {} 0)\n        (effects {} (justify left bottom))\n      )\n",
+            toKiCadString(commentText->name), toMmX(commentText->locX + aDx), toMmY(commentText->locY + aDy),
+            toKiCadFont(getTextHeight(commentText->getTextFont())));
+    }
+    else if(const auto* symbolVector = dynamic_cast<const PrimSymbolVector*>(&aPrim))
+    {
+        for(const auto& primitive : symbolVector->primitives)
+        {
+            if(primitive)
+            {
+                writePrimitive(aBuf, *primitive, aDx + symbolVector->locX, aDy + symbolVector->locY, aCache);
+            }
+        }
+    }
+    else if(dynamic_cast<const PrimBitmap*>(&aPrim))
+    {
+        mCtx.mLogger.debug("{}: Bitmaps are not supported in KiCad symbols", __func__);
+    }
+    else
+    {
+        mCtx.mLogger.debug("{}: Primitive {} is not exported", __func__, to_string(aPrim.getObjectType()));
+    }
+}
+
+void OOCP::KiCadSymbolExporter::writePin(
+    std::string& aBuf, const StructSymbolPin& aPin, const std::string& aNumber) const
+{
+    // KiCad places the pin at its connection point and points it towards the body
+    const int32_t dx = aPin.startX - aPin.hotptX;
+    const int32_t dy = aPin.startY - aPin.hotptY;
+
+    const double length = std::sqrt(static_cast<double>(dx) * dx + static_cast<double>(dy) * dy);
+
+    int32_t angle = 0;
+
+    if(std::abs(dx) >= std::abs(dy))
+    {
+        angle = dx >= 0 ? 0 : 180;
+    }
+    else
+    {
+        angle = dy < 0 ? 90 : 270;
+    }
+
+    const std::string font = toKiCadFont();
+
+    fmt::format_to(std::back_inserter(aBuf),
+        "      (pin {} {} (at {} {} {}) (length {})\n"
+        "        (name {} (effects {}))\n"
+        "        (number {} (effects {}))\n"
+        "      )\n",
+        toElectricalType(aPin.portType), toGraphicStyle(aPin.pinShape), toMmX(aPin.hotptX), toMmY(aPin.hotptY),
+        angle, toKiCadMm(length), toKiCadString(aPin.name), font, toKiCadString(aNumber), font);
+}
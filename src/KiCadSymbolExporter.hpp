@@ -0,0 +1,85 @@
+#ifndef KICADSYMBOLEXPORTER_HPP
+#define KICADSYMBOLEXPORTER_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ContainerContext.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+class PinTable;
+class PrimBase;
+class Stream;
+class StreamPackage;
+class StructLibraryPart;
+class StructSymbolPin;
+class TessellationCache;
+
+/**
+ * @brief Converts the packages of a parsed library into a KiCad symbol library (`.kicad_sym`).
+ *
+ * @note Each package becomes one KiCad symbol, each device one unit. Convert views
+ *       are exported as De Morgan body style. Packages are converted in parallel
+ *       batches and written in stream order, i.e. memory usage does not depend on
+ *       the size of the library.
+ */
+class KiCadSymbolExporter
+{
+public:
+    KiCadSymbolExporter(ContainerContext& aCtx)
+        : mCtx{aCtx}
+    {
+    }
+
+    /**
+     * @brief Export all packages into a single symbol library.
+     *
+     * @param aOutDir Output directory.
+     * @return fs::path Path to the symbol library, named after the input file.
+     */
+    fs::path exportSymbolLibrary(const fs::path& aOutDir);
+
+    /**
+     * @brief Convert a single package into a KiCad `symbol` expression.
+     *
+     * @param aBuf Buffer the expression is appended to.
+     * @param aPackage Package to convert.
+     * @param aLibName Library name prefixed to the symbol name, e.g. for symbols embedded into schematics.
+     */
+    void writePackage(std::string& aBuf, const StreamPackage& aPackage, const std::string& aLibName = {}) const;
+
+    /**
+     * @brief Name of the KiCad symbol the package is exported as.
+     */
+    static std::string getSymbolName(const StreamPackage& aPackage);
+
+private:
+    void writeProperties(std::string& aBuf, const std::string& aName, const StreamPackage& aPackage,
+        const StructLibraryPart* aView) const;
+
+    /**
+     * @brief Write a `symbol` sub-unit containing graphics and/or pins.
+     *
+     * @param aUnit Unit number, 0 for graphics shared between all units.
+     * @param aBodyStyle 1 for the normal view, 2 for the convert view.
+     * @param aPinTable Pin table of the package the pin numbers are taken from.
+     */
+    void writeUnit(std::string& aBuf, const std::string& aName, int32_t aUnit, int32_t aBodyStyle,
+        const StructLibraryPart& aView, bool aWriteGraphics, bool aWritePins, const PinTable& aPinTable,
+        TessellationCache& aCache) const;
+
+    void writePrimitive(
+        std::string& aBuf, const PrimBase& aPrim, int32_t aDx, int32_t aDy, TessellationCache& aCache) const;
+
+    void writePin(std::string& aBuf, const StructSymbolPin& aPin, const std::string& aNumber) const;
+
+    ContainerContext& mCtx;
+};
+} // namespace OOCP
+#endif // KICADSYMBOLEXPORTER_HPP
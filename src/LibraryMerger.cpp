@@ -0,0 +1,918 @@
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+
+#include "CfbWriter.hpp"
+#include "Container.hpp"
+#include "ContentHash.hpp"
+#include "GetStreamHelper.hpp"
+#include "LibraryMerger.hpp"
+#include "ParallelFor.hpp"
+#include "Streams/StreamLibrary.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Win32/LOGFONTA.hpp"
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// Storages whose streams are parsed and copied, i.e. `Packages/<name>` and `Symbols/<name>`
+const std::vector<std::string> UnitStorages{"Packages", "Symbols"};
+
+// Storage of the cells of packages, i.e. `Cells/<name>`. They are not parsed but
+// copied as they are, as there are no known indices into the string or font list.
+const std::string CellStorage{"Cells"};
+
+// Directory item data following the name
+constexpr std::size_t DirItemDataLen = 22U;
+
+uint16_t readU16(const uint8_t* aData)
+{
+    return static_cast<uint16_t>(aData[0] | (aData[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* aData)
+{
+    return static_cast<uint32_t>(aData[0]) | (static_cast<uint32_t>(aData[1]) << 8) |
+           (static_cast<uint32_t>(aData[2]) << 16) | (static_cast<uint32_t>(aData[3]) << 24);
+}
+
+void writeUint(std::vector<uint8_t>& aData, uint32_t aVal, std::size_t aLen)
+{
+    for(std::size_t i = 0U; i < aLen; ++i)
+    {
+        aData.push_back(static_cast<uint8_t>(aVal >> (8U * i)));
+    }
+}
+
+// Counterpart of `DataStream::readStringLenZeroTerm`
+void writeStringLenZeroTerm(std::vector<uint8_t>& aData, const std::string& aStr)
+{
+    if(aStr.size() > 0xFFFFU)
+    {
+        throw std::runtime_error(fmt::format("{}: String is too long: {}", __func__, aStr.size()));
+    }
+
+    writeUint(aData, static_cast<uint32_t>(aStr.size()), 2U);
+    aData.insert(aData.end(), aStr.begin(), aStr.end());
+    aData.push_back(0U);
+}
+
+std::string getDirName(const std::string& aStorage)
+{
+    return aStorage + " Directory";
+}
+
+// Directory streams that list packages or symbols
+const std::vector<std::string> DirNames{
+    getDirName("Cells"), getDirName("Packages"), getDirName("Parts"), getDirName("Symbols")};
+
+/**
+ * @brief Name of the package or symbol a directory item belongs to.
+ */
+std::string getOwnerName(const std::string& aDirName, const std::string& aItemName)
+{
+    // Parts are named by their package and view, e.g. `74LS00.Normal`
+    if(aDirName == getDirName("Parts"))
+    {
+        return aItemName.substr(0U, aItemName.rfind('.'));
+    }
+
+    return aItemName;
+}
+
+/**
+ * @brief Directory streams that list a package or symbol of the given storage.
+ */
+std::vector<std::string> getUnitDirNames(const std::string& aStorage)
+{
+    if(aStorage == "Packages")
+    {
+        return {getDirName("Packages"), getDirName("Parts")};
+    }
+
+    return {getDirName(aStorage)};
+}
+
+std::string toFileNamePart(const std::string& aStr)
+{
+    std::string str;
+
+    for(const char c : aStr)
+    {
+        str += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    }
+
+    return str.empty() ? "_" : str;
+}
+} // namespace
+
+OOCP::LibraryMerger::LibraryMerger(const fs::path& aBaseLibrary, const ParserConfig& aCfg)
+    : mBaseLibrary{aBaseLibrary},
+      mCfg{aCfg},
+      mWriter{aBaseLibrary},
+      mLibraryStream{},
+      mStrLstBegin{0U},
+      mStrLstEnd{0U},
+      mStrLstLenSize{0U},
+      mStrLst{},
+      mStrIdx{},
+      mTextFontsBegin{0U},
+      mTextFontsEnd{0U},
+      mFonts{},
+      mPartAliasesEnd{0U},
+      mAliases{},
+      mAliasIdx{},
+      mDirs{},
+      mHashes{},
+      mRefDes{},
+      mAddedCtr{0U},
+      mDuplicateCtr{0U},
+      mConflictCtr{0U}
+{
+    // Indices into the string list can only be remapped if all
+    // records were parsed, i.e. do not skip anything
+    mCfg.mSkipUnknownPrim      = false;
+    mCfg.mSkipInvalidPrim      = false;
+    mCfg.mSkipUnknownStruct    = false;
+    mCfg.mSkipInvalidStruct    = false;
+    mCfg.mStreamParsedCallback = {};
+
+    // Streams are copied as they are, images are not required
+    mCfg.mLoadImages    = false;
+    mCfg.mExtractImages = false;
+
+    const Library base = loadLibrary(mBaseLibrary, mCfg.mThreadCount);
+
+    mLibraryStream  = mWriter.readStream({"Library"});
+    mStrLstBegin    = base.strLstBegin;
+    mStrLstEnd      = base.strLstEnd;
+    mStrLst         = base.strLst;
+    mTextFontsBegin = base.textFontsBegin;
+    mTextFontsEnd   = base.textFontsEnd;
+    mFonts          = base.fonts;
+    mPartAliasesEnd = base.partAliasesEnd;
+    mAliases        = base.aliases;
+
+    if(mTextFontsEnd != mTextFontsBegin + 2U + mFonts.size() * sizeof(LOGFONTA) || mTextFontsEnd > mStrLstBegin ||
+        mPartAliasesEnd < mStrLstEnd || mPartAliasesEnd > mLibraryStream.size())
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Unexpected font or alias list location in {}", __func__, mBaseLibrary.string()));
+    }
+
+    for(const auto& [alias, package] : mAliases)
+    {
+        mAliasIdx.emplace(alias, package);
+    }
+
+    // Length of the string list is either 16 or 32 bit, depending on the version
+    std::size_t strLstLen = 0U;
+
+    for(const auto& str : mStrLst)
+    {
+        strLstLen += str.size() + 3U;
+    }
+
+    if(mStrLstEnd > mLibraryStream.size() || mStrLstEnd < mStrLstBegin + strLstLen)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Unexpected string list location in {}", __func__, mBaseLibrary.string()));
+    }
+
+    mStrLstLenSize = mStrLstEnd - mStrLstBegin - strLstLen;
+
+    if(mStrLstLenSize != 2U && mStrLstLenSize != 4U)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Unexpected string list length size {}", __func__, mStrLstLenSize));
+    }
+
+    for(std::size_t i = 0U; i < mStrLst.size(); ++i)
+    {
+        mStrIdx.emplace(mStrLst[i], static_cast<uint32_t>(i));
+    }
+
+    for(const auto& unit : base.units)
+    {
+        mHashes[unit.location] = getUnitHash(unit, base);
+
+        if(unit.location.front() == "Packages")
+        {
+            mRefDes[unit.location.back()] = unit.refDes;
+        }
+    }
+
+    for(const auto& dirName : DirNames)
+    {
+        if(mWriter.hasStream({dirName}))
+        {
+            mDirs[dirName] = decodeDirectory(mWriter.readStream({dirName}));
+        }
+    }
+}
+
+OOCP::LibraryMerger::Directory OOCP::LibraryMerger::decodeDirectory(const std::vector<uint8_t>& aData)
+{
+    // See `StreamDirectoryStruct::read`
+    Directory dir{};
+
+    if(aData.size() < 6U)
+    {
+        throw std::runtime_error(fmt::format("{}: Directory stream is too short", __func__));
+    }
+
+    dir.lastModifiedDate = readU32(aData.data());
+
+    const std::size_t itemCtr = static_cast<std::size_t>(aData[4] | (aData[5] << 8));
+
+    std::size_t offset = 6U;
+
+    for(std::size_t i = 0U; i < itemCtr; ++i)
+    {
+        if(offset + 2U > aData.size())
+        {
+            throw std::runtime_error(fmt::format("{}: Directory stream is truncated", __func__));
+        }
+
+        const std::size_t nameLen = static_cast<std::size_t>(aData[offset] | (aData[offset + 1U] << 8));
+
+        offset += 2U;
+
+        if(offset + nameLen + 1U + DirItemDataLen > aData.size() || aData[offset + nameLen] != 0U)
+        {
+            throw std::runtime_error(fmt::format("{}: Directory stream is truncated", __func__));
+        }
+
+        DirItem item;
+
+        item.name = std::string{aData.begin() + offset, aData.begin() + offset + nameLen};
+        offset += nameLen + 1U;
+
+        item.data = std::vector<uint8_t>{aData.begin() + offset, aData.begin() + offset + DirItemDataLen};
+        offset += DirItemDataLen;
+
+        dir.items.push_back(std::move(item));
+    }
+
+    if(offset != aData.size())
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Directory stream contains {} unexpected bytes", __func__, aData.size() - offset));
+    }
+
+    return dir;
+}
+
+std::vector<uint8_t> OOCP::LibraryMerger::encodeDirectory(const Directory& aDir)
+{
+    if(aDir.items.size() > 0xFFFFU)
+    {
+        throw std::runtime_error(fmt::format("{}: Too many directory items: {}", __func__, aDir.items.size()));
+    }
+
+    std::vector<uint8_t> data;
+
+    writeUint(data, aDir.lastModifiedDate, 4U);
+    writeUint(data, static_cast<uint32_t>(aDir.items.size()), 2U);
+
+    for(const auto& item : aDir.items)
+    {
+        writeStringLenZeroTerm(data, item.name);
+        data.insert(data.end(), item.data.begin(), item.data.end());
+    }
+
+    return data;
+}
+
+OOCP::LibraryMerger::Library OOCP::LibraryMerger::loadLibrary(
+    const fs::path& aLibrary, std::size_t aThreadCount) const
+{
+    Library lib{};
+
+    lib.path = aLibrary;
+
+    ParserConfig cfg  = mCfg;
+    cfg.mThreadCount = aThreadCount;
+
+    Container container{aLibrary, cfg};
+    container.parseDatabaseFile();
+
+    Database db = container.getDb();
+
+    const auto libStream = getLibraryStreamFromDb(db);
+
+    if(!libStream || libStream->mCtx.mParsedSuccessfully != true)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Library stream of {} could not be parsed", __func__, aLibrary.string()));
+    }
+
+    if(libStream->mDbType != DatabaseType::Library)
+    {
+        throw std::runtime_error(fmt::format("{}: {} is not a library", __func__, aLibrary.string()));
+    }
+
+    lib.strLst         = libStream->strLst;
+    lib.strLstBegin    = libStream->strLstBegin;
+    lib.strLstEnd      = libStream->strLstEnd;
+    lib.textFontsBegin = libStream->textFontsBegin;
+    lib.textFontsEnd   = libStream->textFontsEnd;
+    lib.aliases        = libStream->partAliases;
+    lib.partAliasesEnd = libStream->partAliasesEnd;
+
+    // Fonts are read as raw memory, i.e. copying them back results in the original data
+    for(const auto& font : libStream->textFonts)
+    {
+        std::vector<uint8_t> raw(sizeof(LOGFONTA));
+        std::memcpy(raw.data(), &font, sizeof(LOGFONTA));
+
+        lib.fonts.push_back(std::move(raw));
+    }
+
+    const CfbWriter reader{aLibrary};
+
+    // Directory stream name to owner name to items
+    std::map<std::string, std::map<std::string, std::vector<DirItem>>> dirItems;
+
+    for(const auto& dirName : DirNames)
+    {
+        if(reader.hasStream({dirName}))
+        {
+            for(auto& item : decodeDirectory(reader.readStream({dirName})).items)
+            {
+                const std::string owner = getOwnerName(dirName, item.name);
+                dirItems[dirName][owner].push_back(std::move(item));
+            }
+        }
+    }
+
+    const auto addDirItems = [&dirItems](Unit& aUnit)
+    {
+        for(const auto& dirName : getUnitDirNames(aUnit.location.front()))
+        {
+            const auto it = dirItems[dirName].find(aUnit.location.back());
+
+            if(it != dirItems[dirName].end())
+            {
+                aUnit.dirItems[dirName] = it->second;
+            }
+        }
+    };
+
+    for(const auto& stream : db.mStreams)
+    {
+        const auto& location = stream->mCtx.mCfbfStreamLocation.get_vector();
+
+        if(location.size() != 2U || location.back() == "$Types$" ||
+            std::find(UnitStorages.begin(), UnitStorages.end(), location.front()) == UnitStorages.end())
+        {
+            continue;
+        }
+
+        if(stream->mCtx.mParsedSuccessfully != true)
+        {
+            spdlog::warn("{}: Skipping {}/{} of {} as it could not be parsed", __func__, location.front(),
+                location.back(), aLibrary.string());
+            continue;
+        }
+
+        Unit unit{};
+
+        unit.location   = location;
+        unit.data       = reader.readStream(location);
+        unit.strLstRefs  = stream->mCtx.mStrLstRefs;
+        unit.fontIdxRefs = stream->mCtx.mFontIdxRefs;
+
+        addDirItems(unit);
+
+        const auto package = std::dynamic_pointer_cast<StreamPackage>(stream);
+
+        if(package && package->package)
+        {
+            unit.refDes = package->package->refDes;
+        }
+
+        lib.units.push_back(std::move(unit));
+    }
+
+    for(const auto& location : reader.getStreamLocations())
+    {
+        if(location.size() != 2U || location.front() != CellStorage)
+        {
+            continue;
+        }
+
+        Unit unit{};
+
+        unit.location = location;
+        unit.data     = reader.readStream(location);
+
+        addDirItems(unit);
+
+        lib.units.push_back(std::move(unit));
+    }
+
+    spdlog::debug("{}: Loaded {} packages, symbols and cells from {}", __func__, lib.units.size(), aLibrary.string());
+
+    return lib;
+}
+
+uint32_t OOCP::LibraryMerger::getStrIdx(const std::string& aStr)
+{
+    const auto it = mStrIdx.find(aStr);
+
+    if(it != mStrIdx.end())
+    {
+        return it->second;
+    }
+
+    const auto idx = static_cast<uint32_t>(mStrLst.size());
+
+    mStrLst.push_back(aStr);
+    mStrIdx.emplace(aStr, idx);
+
+    return idx;
+}
+
+uint16_t OOCP::LibraryMerger::getFontIdx(const std::vector<uint8_t>& aFont)
+{
+    auto it = std::find(mFonts.begin(), mFonts.end(), aFont);
+
+    if(it == mFonts.end())
+    {
+        // Display properties store the index in 14 bit
+        if(mFonts.size() + 1U > 0x3FFFU)
+        {
+            throw std::runtime_error(fmt::format("{}: Too many fonts: {}", __func__, mFonts.size() + 1U));
+        }
+
+        it = mFonts.insert(mFonts.end(), aFont);
+    }
+
+    return static_cast<uint16_t>(std::distance(mFonts.begin(), it) + 1);
+}
+
+uint64_t OOCP::LibraryMerger::getUnitHash(const Unit& aUnit, const Library& aLib)
+{
+    // Indices differ between libraries, hash the strings and fonts they refer to instead
+    std::vector<uint8_t> data = aUnit.data;
+
+    ContentHash hash;
+
+    for(const auto offset : aUnit.strLstRefs)
+    {
+        if(offset + 4U > data.size())
+        {
+            continue;
+        }
+
+        const uint32_t idx = readU32(data.data() + offset);
+
+        std::fill_n(data.begin() + offset, 4U, 0U);
+
+        hash.add(static_cast<uint64_t>(offset));
+
+        if(idx < aLib.strLst.size())
+        {
+            hash.add(aLib.strLst[idx]);
+        }
+        else
+        {
+            hash.add(idx);
+        }
+    }
+
+    for(const auto& ref : aUnit.fontIdxRefs)
+    {
+        if(ref.offset + 2U > data.size())
+        {
+            continue;
+        }
+
+        const uint16_t idx = readU16(data.data() + ref.offset) & ref.mask;
+
+        data[ref.offset] &= static_cast<uint8_t>(~ref.mask);
+        data[ref.offset + 1U] &= static_cast<uint8_t>(~(ref.mask >> 8U));
+
+        hash.add(static_cast<uint64_t>(ref.offset));
+
+        // Index 0 is the default font
+        if(idx > 0U && idx - 1U < aLib.fonts.size())
+        {
+            hash.add(aLib.fonts[idx - 1U].data(), aLib.fonts[idx - 1U].size());
+        }
+        else
+        {
+            hash.add(idx);
+        }
+    }
+
+    hash.add(data.data(), data.size());
+
+    return hash.getHash();
+}
+
+void OOCP::LibraryMerger::remapUnit(Unit& aUnit, const Library& aLib)
+{
+    for(const auto offset : aUnit.strLstRefs)
+    {
+        if(offset + 4U > aUnit.data.size())
+        {
+            continue;
+        }
+
+        const uint32_t idx = readU32(aUnit.data.data() + offset);
+
+        if(idx >= aLib.strLst.size())
+        {
+            spdlog::warn("{}: String index {} is out of range in {}/{} of {}", __func__, idx,
+                aUnit.location.front(), aUnit.location.back(), aLib.path.string());
+            continue;
+        }
+
+        std::vector<uint8_t> newIdx;
+        writeUint(newIdx, getStrIdx(aLib.strLst[idx]), 4U);
+
+        std::copy(newIdx.begin(), newIdx.end(), aUnit.data.begin() + offset);
+    }
+
+    for(const auto& ref : aUnit.fontIdxRefs)
+    {
+        if(ref.offset + 2U > aUnit.data.size())
+        {
+            continue;
+        }
+
+        const uint16_t raw = readU16(aUnit.data.data() + ref.offset);
+        const uint16_t idx = raw & ref.mask;
+
+        if(idx == 0U)
+        {
+            continue;
+        }
+
+        if(idx - 1U >= aLib.fonts.size())
+        {
+            spdlog::warn("{}: Font index {} is out of range in {}/{} of {}", __func__, idx, aUnit.location.front(),
+                aUnit.location.back(), aLib.path.string());
+            continue;
+        }
+
+        const uint16_t newIdx = getFontIdx(aLib.fonts[idx - 1U]);
+
+        if((newIdx & ref.mask) != newIdx)
+        {
+            throw std::runtime_error(fmt::format("{}: Font index {} does not fit into {}/{}", __func__, newIdx,
+                aUnit.location.front(), aUnit.location.back()));
+        }
+
+        const uint16_t newRaw = static_cast<uint16_t>((raw & ~ref.mask) | newIdx);
+
+        aUnit.data[ref.offset]      = static_cast<uint8_t>(newRaw);
+        aUnit.data[ref.offset + 1U] = static_cast<uint8_t>(newRaw >> 8U);
+    }
+}
+
+void OOCP::LibraryMerger::addAliases(const std::string& aPackage, const Library& aLib)
+{
+    for(const auto& [alias, package] : aLib.aliases)
+    {
+        if(package != aPackage)
+        {
+            continue;
+        }
+
+        const auto [it, isNew] = mAliasIdx.emplace(alias, package);
+
+        if(isNew)
+        {
+            mAliases.emplace_back(alias, package);
+        }
+        else if(it->second != package)
+        {
+            spdlog::warn("{}: Skipping alias {} of {} from {}, it already refers to {}", __func__, alias, package,
+                aLib.path.string(), it->second);
+        }
+    }
+}
+
+void OOCP::LibraryMerger::merge(const std::vector<fs::path>& aLibraries)
+{
+    std::vector<std::optional<Library>> libs(aLibraries.size());
+
+    // Parsing dominates, run it in parallel with a single thread per library
+    parallelFor(mCfg.mThreadCount, aLibraries.size(),
+        [&](std::size_t aIdx)
+        {
+            try
+            {
+                libs[aIdx] = loadLibrary(aLibraries[aIdx], 1U);
+            }
+            catch(const std::exception& e)
+            {
+                spdlog::error("Skipping library {}: {}", aLibraries[aIdx].string(), e.what());
+            }
+        });
+
+    // Find conflicts before anything is modified, also between the libraries that are merged
+    std::map<std::vector<std::string>, uint64_t> hashes = mHashes;
+    std::vector<std::string> conflicts;
+
+    for(const auto& lib : libs)
+    {
+        if(!lib)
+        {
+            continue;
+        }
+
+        for(const auto& unit : lib->units)
+        {
+            const uint64_t hash = getUnitHash(unit, lib.value());
+
+            const auto [it, isNew] = hashes.emplace(unit.location, hash);
+
+            if(!isNew && it->second != hash)
+            {
+                conflicts.push_back(
+                    fmt::format("{}/{} of {}", unit.location.front(), unit.location.back(), lib->path.string()));
+            }
+        }
+    }
+
+    mConflictCtr = conflicts.size();
+
+    if(!conflicts.empty())
+    {
+        std::string msg = fmt::format("{}: {} packages or symbols have the same name as an existing one but a "
+                                      "different content:",
+            __func__, conflicts.size());
+
+        for(const auto& conflict : conflicts)
+        {
+            msg += "\n  " + conflict;
+        }
+
+        throw std::runtime_error(msg);
+    }
+
+    std::map<std::string, std::set<std::string>> itemNames; //!< Directory stream name to item names
+
+    for(const auto& [dirName, dir] : mDirs)
+    {
+        for(const auto& item : dir.items)
+        {
+            itemNames[dirName].insert(item.name);
+        }
+    }
+
+    for(auto& lib : libs)
+    {
+        if(!lib)
+        {
+            continue;
+        }
+
+        for(auto& unit : lib->units)
+        {
+            const uint64_t hash = getUnitHash(unit, lib.value());
+
+            remapUnit(unit, lib.value());
+
+            const bool isPackage = unit.location.front() == "Packages";
+
+            if(mHashes.count(unit.location) > 0U)
+            {
+                // Equal hashes were checked above, the remapped data needs to be equal as well
+                if(mWriter.readStream(unit.location) != unit.data)
+                {
+                    throw std::runtime_error(fmt::format("{}: {}/{} of {} differs from the existing one", __func__,
+                        unit.location.front(), unit.location.back(), lib->path.string()));
+                }
+
+                if(isPackage)
+                {
+                    addAliases(unit.location.back(), lib.value());
+                }
+
+                ++mDuplicateCtr;
+                continue;
+            }
+
+            mHashes[unit.location] = hash;
+
+            if(isPackage)
+            {
+                mRefDes[unit.location.back()] = unit.refDes;
+
+                addAliases(unit.location.back(), lib.value());
+            }
+
+            for(auto& [dirName, items] : unit.dirItems)
+            {
+                for(auto& item : items)
+                {
+                    if(itemNames[dirName].insert(item.name).second)
+                    {
+                        mDirs[dirName].items.push_back(std::move(item));
+                    }
+                }
+            }
+
+            mWriter.addStream(unit.location, std::move(unit.data));
+
+            ++mAddedCtr;
+        }
+    }
+
+    spdlog::debug("{}: Added {}, duplicates {}, conflicts {}", __func__, mAddedCtr, mDuplicateCtr, mConflictCtr);
+}
+
+std::vector<uint8_t> OOCP::LibraryMerger::encodeLibraryStream(
+    const std::vector<std::pair<std::string, std::string>>& aAliases) const
+{
+    // Rebuild the font, string and alias lists inside the `Library` stream, all other data is kept
+    if(mStrLstLenSize == 2U && mStrLst.size() > 0xFFFFU)
+    {
+        throw std::runtime_error(fmt::format("{}: Too many strings for this library version: {}", __func__,
+            mStrLst.size()));
+    }
+
+    if(mFonts.size() + 1U > 0xFFFFU || aAliases.size() > 0xFFFFU)
+    {
+        throw std::runtime_error(fmt::format("{}: Too many fonts or aliases: {} and {}", __func__, mFonts.size(),
+            aAliases.size()));
+    }
+
+    std::vector<uint8_t> data{mLibraryStream.begin(), mLibraryStream.begin() + mTextFontsBegin};
+
+    // The length includes the default font that is not stored
+    writeUint(data, static_cast<uint32_t>(mFonts.size() + 1U), 2U);
+
+    for(const auto& font : mFonts)
+    {
+        data.insert(data.end(), font.begin(), font.end());
+    }
+
+    data.insert(data.end(), mLibraryStream.begin() + mTextFontsEnd, mLibraryStream.begin() + mStrLstBegin);
+
+    writeUint(data, static_cast<uint32_t>(mStrLst.size()), mStrLstLenSize);
+
+    for(const auto& str : mStrLst)
+    {
+        writeStringLenZeroTerm(data, str);
+    }
+
+    writeUint(data, static_cast<uint32_t>(aAliases.size()), 2U);
+
+    for(const auto& [alias, package] : aAliases)
+    {
+        writeStringLenZeroTerm(data, alias);
+        writeStringLenZeroTerm(data, package);
+    }
+
+    data.insert(data.end(), mLibraryStream.begin() + mPartAliasesEnd, mLibraryStream.end());
+
+    return data;
+}
+
+void OOCP::LibraryMerger::applyChanges()
+{
+    for(const auto& [dirName, dir] : mDirs)
+    {
+        mWriter.replaceStream({dirName}, encodeDirectory(dir));
+    }
+
+    mWriter.replaceStream({"Library"}, encodeLibraryStream(mAliases));
+}
+
+void OOCP::LibraryMerger::write(const fs::path& aOutput)
+{
+    applyChanges();
+
+    mWriter.write(aOutput);
+
+    spdlog::debug("{}: Wrote {}", __func__, aOutput.string());
+}
+
+std::vector<fs::path> OOCP::LibraryMerger::split(const fs::path& aOutDir)
+{
+    applyChanges();
+
+    std::map<std::string, std::set<std::string>> categories; //!< Prefix to packages
+
+    for(const auto& [package, refDes] : mRefDes)
+    {
+        categories[refDes].insert(package);
+    }
+
+    std::vector<std::pair<std::string, std::set<std::string>>> jobs{categories.begin(), categories.end()};
+    std::vector<fs::path> outputs(jobs.size());
+
+    // Different prefixes can result in the same file name, e.g. `` and `_`
+    std::set<std::string> fileNames;
+
+    for(std::size_t i = 0U; i < jobs.size(); ++i)
+    {
+        const std::string namePart = toFileNamePart(jobs[i].first);
+
+        std::string fileName = namePart;
+
+        for(std::size_t ctr = 2U; !fileNames.insert(fileName).second; ++ctr)
+        {
+            fileName = fmt::format("{}_{}", namePart, ctr);
+        }
+
+        outputs[i] = aOutDir / (mBaseLibrary.stem().string() + "_" + fileName + mBaseLibrary.extension().string());
+    }
+    std::vector<std::exception_ptr> errors(jobs.size());
+
+    parallelFor(mCfg.mThreadCount, jobs.size(),
+        [&](std::size_t aIdx)
+        {
+            try
+            {
+                const auto& packages = jobs[aIdx].second;
+
+                CfbWriter writer = mWriter;
+
+                for(const auto& [package, unused] : mRefDes)
+                {
+                    if(packages.count(package) == 0U)
+                    {
+                        writer.removeStream({"Packages", package});
+
+                        if(writer.hasStream({CellStorage, package}))
+                        {
+                            writer.removeStream({CellStorage, package});
+                        }
+                    }
+                }
+
+                // Keep aliases that do not belong to a package of the library, like directory items
+                std::vector<std::pair<std::string, std::string>> aliases;
+
+                for(const auto& alias : mAliases)
+                {
+                    if(mRefDes.count(alias.second) == 0U || packages.count(alias.second) > 0U)
+                    {
+                        aliases.push_back(alias);
+                    }
+                }
+
+                writer.replaceStream({"Library"}, encodeLibraryStream(aliases));
+
+                for(const auto& [dirName, dir] : mDirs)
+                {
+                    Directory filtered{dir.lastModifiedDate, {}};
+
+                    for(const auto& item : dir.items)
+                    {
+                        const std::string owner = getOwnerName(dirName, item.name);
+
+                        // Keep items that do not belong to a package, e.g. symbols
+                        if(mRefDes.count(owner) == 0U || packages.count(owner) > 0U ||
+                            dirName == getDirName("Symbols"))
+                        {
+                            filtered.items.push_back(item);
+                        }
+                    }
+
+                    writer.replaceStream({dirName}, encodeDirectory(filtered));
+                }
+
+                writer.write(outputs[aIdx]);
+            }
+            catch(...)
+            {
+                errors[aIdx] = std::current_exception();
+            }
+        });
+
+    for(const auto& error : errors)
+    {
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return outputs;
+}
@@ -0,0 +1,199 @@
+#ifndef LIBRARYMERGER_HPP
+#define LIBRARYMERGER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "CfbWriter.hpp"
+#include "ContainerContext.hpp"
+#include "StreamContext.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+/**
+ * @brief Merges libraries into a single one and splits libraries into several ones.
+ *
+ * @note Packages, symbols and cells are copied as streams between the containers.
+ *       Only the directory streams and the string, font and part alias
+ *       lists of the `Library` stream are rebuilt, indices into the string
+ *       and font lists are remapped inside of the copied streams.
+ */
+class LibraryMerger
+{
+public:
+    LibraryMerger() = delete;
+
+    /**
+     * @brief Load the library that others are merged into or that is split.
+     *
+     * @param aBaseLibrary Library file, its settings are kept in the merged library.
+     * @param aCfg Parser configuration, skipping of unknown or invalid records and loading of images is disabled.
+     */
+    LibraryMerger(const fs::path& aBaseLibrary, const ParserConfig& aCfg);
+
+    /**
+     * @brief Add the packages and symbols of other libraries.
+     *
+     * @note Libraries are parsed in parallel but added in the given order. A package
+     *       or symbol with the same name and content as an existing one is skipped
+     *       and counted as duplicate. Strings and fonts are compared by value, not
+     *       by their index. Names are stored inside of the streams, i.e. packages
+     *       and symbols can not be renamed. Same named ones with different content
+     *       are conflicts, the merge fails before anything is modified.
+     *
+     * @throws std::runtime_error If there is at least one conflict.
+     */
+    void merge(const std::vector<fs::path>& aLibraries);
+
+    /**
+     * @brief Write the merged library.
+     */
+    void write(const fs::path& aOutput);
+
+    /**
+     * @brief Write one library per reference designator prefix of the packages.
+     *
+     * @note Symbols are kept in all of them, part aliases only in the library of their package.
+     *
+     * @param aOutDir Output directory, files are named `<stem>_<prefix><extension>`. A counter
+     *                is appended to the prefix if it results in the same file name as another one.
+     * @return std::vector<fs::path> Written libraries.
+     */
+    std::vector<fs::path> split(const fs::path& aOutDir);
+
+    std::size_t getAddedCtr() const
+    {
+        return mAddedCtr;
+    }
+
+    std::size_t getDuplicateCtr() const
+    {
+        return mDuplicateCtr;
+    }
+
+    std::size_t getConflictCtr() const
+    {
+        return mConflictCtr;
+    }
+
+private:
+    struct DirItem
+    {
+        std::string name;
+        std::vector<uint8_t> data; //!< Remaining item data following the name
+    };
+
+    struct Directory
+    {
+        uint32_t lastModifiedDate;
+        std::vector<DirItem> items;
+    };
+
+    /**
+     * @brief Package, symbol or cell stream with its directory items.
+     */
+    struct Unit
+    {
+        std::vector<std::string> location;
+        std::vector<uint8_t> data;
+        std::vector<std::size_t> strLstRefs;
+        std::vector<FontIdxRef> fontIdxRefs;
+        std::map<std::string, std::vector<DirItem>> dirItems; //!< Directory stream name to items
+        std::string refDes;
+    };
+
+    struct Library
+    {
+        fs::path path;
+        std::vector<std::string> strLst;
+        std::size_t strLstBegin;
+        std::size_t strLstEnd;
+        std::vector<std::vector<uint8_t>> fonts; //!< Raw `LOGFONTA` of `textFonts`
+        std::size_t textFontsBegin;
+        std::size_t textFontsEnd;
+        std::vector<std::pair<std::string, std::string>> aliases; //!< Alias and package
+        std::size_t partAliasesEnd;
+        std::vector<Unit> units;
+    };
+
+    static Directory decodeDirectory(const std::vector<uint8_t>& aData);
+
+    static std::vector<uint8_t> encodeDirectory(const Directory& aDir);
+
+    Library loadLibrary(const fs::path& aLibrary, std::size_t aThreadCount) const;
+
+    uint32_t getStrIdx(const std::string& aStr);
+
+    /**
+     * @return uint16_t Index of the font in the merged library, 0 is reserved for the default font.
+     */
+    uint16_t getFontIdx(const std::vector<uint8_t>& aFont);
+
+    /**
+     * @brief Content hash that does not depend on the string and font lists of the library.
+     */
+    static uint64_t getUnitHash(const Unit& aUnit, const Library& aLib);
+
+    /**
+     * @brief Remap indices into the string and font lists of the merged library.
+     */
+    void remapUnit(Unit& aUnit, const Library& aLib);
+
+    /**
+     * @brief Add the part aliases of a package.
+     */
+    void addAliases(const std::string& aPackage, const Library& aLib);
+
+    /**
+     * @brief `Library` stream with the current font and string list and the given part aliases.
+     */
+    std::vector<uint8_t> encodeLibraryStream(const std::vector<std::pair<std::string, std::string>>& aAliases) const;
+
+    /**
+     * @brief Update directory streams and the `Library` stream of the writer.
+     */
+    void applyChanges();
+
+    fs::path mBaseLibrary;
+
+    ParserConfig mCfg;
+
+    CfbWriter mWriter;
+
+    std::vector<uint8_t> mLibraryStream;
+    std::size_t mStrLstBegin;
+    std::size_t mStrLstEnd;
+    std::size_t mStrLstLenSize; //!< Size of the string list length in byte
+
+    std::vector<std::string> mStrLst;
+    std::unordered_map<std::string, uint32_t> mStrIdx;
+
+    std::size_t mTextFontsBegin;
+    std::size_t mTextFontsEnd;
+
+    std::vector<std::vector<uint8_t>> mFonts;
+
+    std::size_t mPartAliasesEnd;
+
+    std::vector<std::pair<std::string, std::string>> mAliases;
+    std::map<std::string, std::string> mAliasIdx; //!< Alias to package
+
+    std::map<std::string, Directory> mDirs; //!< Directory stream name to its content
+
+    std::map<std::vector<std::string>, uint64_t> mHashes; //!< Content hash of packages and symbols
+    std::map<std::string, std::string> mRefDes;          //!< Reference designator prefix of packages
+
+    std::size_t mAddedCtr;
+    std::size_t mDuplicateCtr;
+    std::size_t mConflictCtr;
+};
+} // namespace OOCP
+#endif // LIBRARYMERGER_HPP
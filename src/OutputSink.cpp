@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+#include <zlib.h>
+
+#include "OutputSink.hpp"
+
+namespace
+{
+// Uncompressed size of a chunk, large enough that the gzip member overhead
+// and the missing shared dictionary between chunks do not matter
+constexpr std::size_t ChunkSize = 1024U * 1024U;
+
+std::string compressGzip(const std::string& aData, int aLevel)
+{
+    z_stream zs{};
+
+    // Window bits + 16 selects the gzip format
+    if(deflateInit2(&zs, std::clamp(aLevel, 1, 9), Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw std::runtime_error("OutputSink: Failed to initialize compression");
+    }
+
+    std::string compressed(deflateBound(&zs, static_cast<uLong>(aData.size())), '\0');
+
+    zs.next_in   = reinterpret_cast<Bytef*>(const_cast<char*>(aData.data()));
+    zs.avail_in  = static_cast<uInt>(aData.size());
+    zs.next_out  = reinterpret_cast<Bytef*>(compressed.data());
+    zs.avail_out = static_cast<uInt>(compressed.size());
+
+    const int rc = deflate(&zs, Z_FINISH);
+
+    compressed.resize(zs.total_out);
+
+    deflateEnd(&zs);
+
+    if(rc != Z_STREAM_END)
+    {
+        throw std::runtime_error(fmt::format("OutputSink: Compression failed with code {}", rc));
+    }
+
+    return compressed;
+}
+} // namespace
+
+/**
+ * @brief Stream buffer that collects chunks and compresses them on worker threads.
+ *
+ * @note Workers write their chunk as soon as all previous chunks were written,
+ *       i.e. the output order equals the input order.
+ */
+class OOCP::OutputSink::CompressingBuf : public std::streambuf
+{
+public:
+    CompressingBuf(std::ostream& aTarget, const OutputConfig& aCfg)
+        : mTarget{aTarget},
+          mLevel{aCfg.mLevel},
+          mMaxInFlight{2U * std::max<std::size_t>(aCfg.mThreadCount, 1U) + 1U},
+          mChunk(ChunkSize, '\0'),
+          mMutex{},
+          mChanged{},
+          mQueue{},
+          mNextSeq{0U},
+          mNextWrite{0U},
+          mInFlight{0U},
+          mClosing{false},
+          mError{},
+          mWorkers{}
+    {
+        setp(mChunk.data(), mChunk.data() + mChunk.size());
+
+        for(std::size_t i = 0U; i < std::max<std::size_t>(aCfg.mThreadCount, 1U); ++i)
+        {
+            mWorkers.emplace_back(&CompressingBuf::runWorker, this);
+        }
+    }
+
+    ~CompressingBuf() override
+    {
+        try
+        {
+            finish();
+        }
+        catch(...)
+        {
+        }
+    }
+
+    /**
+     * @brief Compress the remaining data and wait for all workers.
+     */
+    void finish()
+    {
+        if(mWorkers.empty())
+        {
+            return;
+        }
+
+        std::exception_ptr submitError;
+
+        // An empty output still needs to be a valid gzip file
+        try
+        {
+            if(pptr() != pbase() || mNextSeq == 0U)
+            {
+                submit();
+            }
+        }
+        catch(...)
+        {
+            submitError = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+            mClosing = true;
+        }
+
+        mChanged.notify_all();
+
+        for(auto& worker : mWorkers)
+        {
+            worker.join();
+        }
+
+        mWorkers.clear();
+
+        if(mError)
+        {
+            std::rethrow_exception(mError);
+        }
+
+        if(submitError)
+        {
+            std::rethrow_exception(submitError);
+        }
+    }
+
+protected:
+    int_type overflow(int_type aCh) override
+    {
+        submit();
+
+        if(!traits_type::eq_int_type(aCh, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(aCh);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(aCh);
+    }
+
+private:
+    struct Chunk
+    {
+        std::size_t seq;
+        std::string data;
+    };
+
+    void submit()
+    {
+        std::string data{pbase(), static_cast<std::size_t>(pptr() - pbase())};
+
+        setp(mChunk.data(), mChunk.data() + mChunk.size());
+
+        std::unique_lock<std::mutex> lock{mMutex};
+
+        mChanged.wait(lock, [this]() { return mInFlight < mMaxInFlight || mError; });
+
+        if(mError)
+        {
+            std::rethrow_exception(mError);
+        }
+
+        mQueue.push_back(Chunk{mNextSeq++, std::move(data)});
+        ++mInFlight;
+
+        lock.unlock();
+        mChanged.notify_all();
+    }
+
+    void runWorker()
+    {
+        while(true)
+        {
+            Chunk chunk;
+
+            {
+                std::unique_lock<std::mutex> lock{mMutex};
+
+                mChanged.wait(lock, [this]() { return !mQueue.empty() || mClosing || mError; });
+
+                if(mQueue.empty() || mError)
+                {
+                    return;
+                }
+
+                chunk = std::move(mQueue.front());
+                mQueue.pop_front();
+            }
+
+            std::string compressed;
+
+            try
+            {
+                compressed = compressGzip(chunk.data, mLevel);
+            }
+            catch(...)
+            {
+                setError(std::current_exception());
+                return;
+            }
+
+            std::unique_lock<std::mutex> lock{mMutex};
+
+            mChanged.wait(lock, [&]() { return mNextWrite == chunk.seq || mError; });
+
+            if(mError)
+            {
+                return;
+            }
+
+            mTarget.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+
+            if(!mTarget)
+            {
+                lock.unlock();
+                setError(std::make_exception_ptr(std::runtime_error("OutputSink: Failed to write the output")));
+                return;
+            }
+
+            ++mNextWrite;
+            --mInFlight;
+
+            lock.unlock();
+            mChanged.notify_all();
+        }
+    }
+
+    void setError(std::exception_ptr aError)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+
+            if(!mError)
+            {
+                mError = aError;
+            }
+        }
+
+        mChanged.notify_all();
+    }
+
+    std::ostream& mTarget;
+
+    int mLevel;
+
+    std::size_t mMaxInFlight;
+
+    std::string mChunk; //!< Put area
+
+    std::mutex mMutex;
+    std::condition_variable mChanged;
+    std::deque<Chunk> mQueue;
+    std::size_t mNextSeq;
+    std::size_t mNextWrite;
+    std::size_t mInFlight;
+    bool mClosing;
+    std::exception_ptr mError;
+
+    std::vector<std::thread> mWorkers;
+};
+
+OOCP::OutputSink::OutputSink(const fs::path& aPath, const OutputConfig& aCfg)
+    : mPath{aPath},
+      mFile{},
+      mBuf{},
+      mCompressedOs{},
+      mOs{nullptr},
+      mTarget{nullptr},
+      mClosed{false}
+{
+    if(isStdout(aPath))
+    {
+        mTarget = &std::cout;
+    }
+    else
+    {
+        mPath += getFileExtension(aCfg.mCompression);
+
+        mFile.open(mPath, std::ios::out | std::ios::binary);
+
+        if(!mFile)
+        {
+            throw std::runtime_error(fmt::format("OutputSink: Can not open file for writing: {}", mPath.string()));
+        }
+
+        mTarget = &mFile;
+    }
+
+    if(aCfg.mCompression == Compression::None)
+    {
+        mOs = mTarget;
+    }
+    else
+    {
+        mBuf          = std::make_unique<CompressingBuf>(*mTarget, aCfg);
+        mCompressedOs = std::make_unique<std::ostream>(mBuf.get());
+        mOs           = mCompressedOs.get();
+    }
+}
+
+OOCP::OutputSink::~OutputSink()
+{
+    try
+    {
+        close();
+    }
+    catch(...)
+    {
+    }
+}
+
+void OOCP::OutputSink::close()
+{
+    if(mClosed)
+    {
+        return;
+    }
+
+    mClosed = true;
+
+    const bool isGood = static_cast<bool>(*mOs);
+
+    if(mBuf)
+    {
+        mBuf->finish();
+    }
+
+    mTarget->flush();
+
+    const bool isWritten = isGood && static_cast<bool>(*mTarget);
+
+    if(mFile.is_open())
+    {
+        mFile.close();
+    }
+
+    if(!isWritten)
+    {
+        throw std::runtime_error(fmt::format("OutputSink: Failed to write {}", mPath.string()));
+    }
+}
+
+std::string OOCP::OutputSink::getFileExtension(Compression aCompression)
+{
+    switch(aCompression)
+    {
+        case Compression::Gzip: return ".gz";
+        default:                return "";
+    }
+}
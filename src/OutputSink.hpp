@@ -0,0 +1,107 @@
+#ifndef OUTPUTSINK_HPP
+#define OUTPUTSINK_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+enum class Compression
+{
+    None,
+    Gzip
+};
+
+struct OutputConfig
+{
+    Compression mCompression{Compression::None}; //!< Compression of exported files
+
+    int mLevel{6}; //!< Compression level from 1 (fastest) to 9 (smallest)
+
+    std::size_t mThreadCount{1U}; //!< Number of threads compressing in parallel
+};
+
+/**
+ * @brief Output of an exporter, either a file or stdout, optionally compressed.
+ *
+ * @note Compressed output is split into chunks that are compressed on separate
+ *       threads as independent gzip members. Their concatenation is a valid
+ *       gzip file. The number of chunks in flight is limited, i.e. writing blocks
+ *       when compression can not keep up and memory usage stays bounded.
+ */
+class OutputSink
+{
+public:
+    //! Path that selects stdout instead of a file
+    static constexpr std::string_view StdoutPath = "-";
+
+    /**
+     * @brief Open the output.
+     *
+     * @param aPath Output file without compression extension or `StdoutPath`.
+     * @param aCfg Output configuration, the compression extension is appended to file names.
+     */
+    OutputSink(const fs::path& aPath, const OutputConfig& aCfg = {});
+
+    /**
+     * @brief Closes the output if not done yet, errors are ignored.
+     */
+    ~OutputSink();
+
+    OutputSink(const OutputSink&)            = delete;
+    OutputSink& operator=(const OutputSink&) = delete;
+
+    std::ostream& getStream()
+    {
+        return *mOs;
+    }
+
+    /**
+     * @brief Actual output path, including the compression extension.
+     */
+    const fs::path& getPath() const
+    {
+        return mPath;
+    }
+
+    /**
+     * @brief Flush all data, wait for pending compression and close the output.
+     *
+     * @throws std::runtime_error If writing or compressing failed.
+     */
+    void close();
+
+    static bool isStdout(const fs::path& aPath)
+    {
+        return aPath == fs::path{StdoutPath};
+    }
+
+    /**
+     * @brief File extension appended for the compression, including the leading dot.
+     */
+    static std::string getFileExtension(Compression aCompression);
+
+private:
+    class CompressingBuf;
+
+    fs::path mPath;
+
+    std::ofstream mFile;
+
+    std::unique_ptr<CompressingBuf> mBuf;
+    std::unique_ptr<std::ostream> mCompressedOs;
+
+    std::ostream* mOs; //!< Stream the exporter writes into
+    std::ostream* mTarget; //!< File or stdout
+
+    bool mClosed;
+};
+} // namespace OOCP
+#endif // OUTPUTSINK_HPP
@@ -0,0 +1,637 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BoundingBox.hpp"
+#include "BoundingBoxIndex.hpp"
+#include "ContentHash.hpp"
+#include "Enums/Structure.hpp"
+#include "GetStreamHelper.hpp"
+#include "InstanceTransform.hpp"
+#include "PageLod.hpp"
+#include "ParallelFor.hpp"
+#include "Primitives/PrimCommentText.hpp"
+#include "Streams/StreamLibrary.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Structures/StructAlias.hpp"
+#include "Structures/StructGraphicInst.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+#include "Structures/StructSthInPages0.hpp"
+#include "Structures/StructSymbolDisplayProp.hpp"
+#include "Structures/StructWire.hpp"
+#include "WireJunctions.hpp"
+
+namespace
+{
+// Font height used for aliases as they do not reference a font
+constexpr int32_t DefaultAliasHeight = 10;
+
+struct Interval
+{
+    int32_t start;
+    int32_t end;
+};
+
+// Horizontal wires grouped by their Y-coordinate and vertical ones by their X-coordinate
+struct AxisAlignedWires
+{
+    std::map<int32_t, std::vector<Interval>> horizontal;
+    std::map<int32_t, std::vector<Interval>> vertical;
+
+    std::vector<OOCP::LodSegment> other;
+};
+
+AxisAlignedWires groupWires(const OOCP::StreamPage& aPage)
+{
+    AxisAlignedWires wires;
+
+    for(const auto& wire : aPage.wires)
+    {
+        if(!wire)
+        {
+            continue;
+        }
+
+        if(wire->startY == wire->endY)
+        {
+            wires.horizontal[wire->startY].push_back(
+                Interval{std::min(wire->startX, wire->endX), std::max(wire->startX, wire->endX)});
+        }
+        else if(wire->startX == wire->endX)
+        {
+            wires.vertical[wire->startX].push_back(
+                Interval{std::min(wire->startY, wire->endY), std::max(wire->startY, wire->endY)});
+        }
+        else
+        {
+            wires.other.push_back(OOCP::LodSegment{wire->startX, wire->startY, wire->endX, wire->endY});
+        }
+    }
+
+    return wires;
+}
+
+// Merge overlapping intervals and intervals separated by at most aGap
+std::vector<Interval> mergeIntervals(std::vector<Interval> aIntervals, int32_t aGap)
+{
+    std::sort(aIntervals.begin(), aIntervals.end(),
+        [](const Interval& aLhs, const Interval& aRhs) { return aLhs.start < aRhs.start; });
+
+    std::vector<Interval> merged;
+
+    for(const auto& interval : aIntervals)
+    {
+        if(!merged.empty() && interval.start <= merged.back().end + aGap)
+        {
+            merged.back().end = std::max(merged.back().end, interval.end);
+        }
+        else
+        {
+            merged.push_back(interval);
+        }
+    }
+
+    return merged;
+}
+
+int32_t toPageUnits(double aPx, double aScale)
+{
+    return static_cast<int32_t>(std::floor(aPx / aScale));
+}
+
+// Offset of an instance inside the page stream -> property name -> value
+using InstanceProps = std::unordered_map<std::size_t, std::unordered_map<std::string, std::string>>;
+
+InstanceProps getInstanceProps(const OOCP::StreamPage& aPage)
+{
+    InstanceProps props;
+
+    const auto lib = OOCP::getLibraryStreamFromDb(aPage.mCtx.mDb);
+
+    if(!lib)
+    {
+        return props;
+    }
+
+    for(const auto& mapping : aPage.mCtx.mNameValueMappings)
+    {
+        if(mapping.structure == OOCP::Structure::PlacedInstance && mapping.nameIdx < lib->strLst.size() &&
+            mapping.valueIdx < lib->strLst.size())
+        {
+            props[mapping.offset].emplace(lib->strLst[mapping.nameIdx], lib->strLst[mapping.valueIdx]);
+        }
+    }
+
+    return props;
+}
+
+// Text a display property of an instance shows, i.e. the value of the referenced property
+std::string getDisplayedValue(
+    const InstanceProps& aProps, const OOCP::StructPlacedInstance& aInst, const OOCP::StructSymbolDisplayProp& aProp)
+{
+    const std::string name = aProp.getName();
+
+    if(aInst.propOffset.has_value())
+    {
+        const auto instIt = aProps.find(aInst.propOffset.value());
+
+        if(instIt != aProps.cend())
+        {
+            const auto valueIt = instIt->second.find(name);
+
+            if(valueIt != instIt->second.cend())
+            {
+                return valueIt->second;
+            }
+        }
+    }
+
+    if(name == "Part Reference")
+    {
+        return aInst.reference;
+    }
+
+    // Unresolved values are estimated by the name
+    return name;
+}
+
+// Disjoint-set forest over cluster indices
+std::size_t findRoot(std::vector<std::size_t>& aParents, std::size_t aIdx)
+{
+    while(aParents[aIdx] != aIdx)
+    {
+        aParents[aIdx] = aParents[aParents[aIdx]];
+        aIdx           = aParents[aIdx];
+    }
+
+    return aIdx;
+}
+} // namespace
+
+std::shared_ptr<const OOCP::PageLod> OOCP::LodBuilder::build(const PageBBoxes& aPage)
+{
+    if(!aPage.page)
+    {
+        return std::make_shared<const PageLod>(PageLod{0U, {}});
+    }
+
+    const uint64_t contentHash = getContentHash(aPage);
+
+    {
+        const std::lock_guard<std::mutex> lock{mMutex};
+
+        const auto it = mCache.find(contentHash);
+
+        if(it != mCache.end())
+        {
+            return it->second;
+        }
+    }
+
+    mCtx.mLogger.debug("Building {} level of detail(s) for page {}", mCfg.mScales.size(), aPage.page->name);
+
+    const std::vector<LodText> texts         = collectTexts(*aPage.page);
+    const std::vector<LodJunction> junctions = collectJunctions(*aPage.page);
+
+    auto lod = std::make_shared<PageLod>();
+
+    lod->contentHash = contentHash;
+    lod->levels.resize(mCfg.mScales.size());
+
+    // Levels are independent of each other, each job writes only its own slot
+    parallelFor(mCtx.mCfg.mThreadCount, mCfg.mScales.size(),
+        [&](std::size_t aIdx) { lod->levels[aIdx] = buildLevel(aPage, texts, junctions, mCfg.mScales[aIdx]); });
+
+    const std::lock_guard<std::mutex> lock{mMutex};
+
+    // Another thread might have built the same content in the meantime
+    const auto [it, inserted] = mCache.emplace(contentHash, std::move(lod));
+
+    return it->second;
+}
+
+std::vector<std::shared_ptr<const OOCP::PageLod>> OOCP::LodBuilder::buildAll()
+{
+    std::vector<std::shared_ptr<const PageLod>> lods;
+
+    for(const auto& page : mBBoxIndex.getPages())
+    {
+        lods.push_back(build(page));
+    }
+
+    return lods;
+}
+
+uint64_t OOCP::LodBuilder::getContentHash(const PageBBoxes& aPage) const
+{
+    ContentHash hash;
+
+    // The configuration influences the result as well
+    for(const double scale : mCfg.mScales)
+    {
+        hash.add(scale);
+    }
+
+    hash.add(mCfg.mMinSymbolPx);
+    hash.add(mCfg.mMinTextPx);
+    hash.add(mCfg.mJunctionClusterPx);
+
+    if(!aPage.page)
+    {
+        return hash.getHash();
+    }
+
+    const StreamPage& page = *aPage.page;
+
+    const InstanceProps instProps = getInstanceProps(page);
+
+    // The displayed value is hashed, s.t. modified property values invalidate the cache
+    const auto addDisplayProps =
+        [&hash, &instProps](
+            const std::vector<std::unique_ptr<StructSymbolDisplayProp>>& aProps, const StructPlacedInstance* aInst)
+    {
+        hash.add(static_cast<uint64_t>(aProps.size()));
+
+        for(const auto& prop : aProps)
+        {
+            if(prop)
+            {
+                hash.add(aInst ? getDisplayedValue(instProps, *aInst, *prop) : prop->getName());
+                hash.add(prop->x);
+                hash.add(prop->y);
+                hash.add(prop->rotation);
+                hash.add(getTextHeight(prop->getTextFont()));
+            }
+        }
+    };
+
+    hash.add(static_cast<uint64_t>(page.wires.size()));
+
+    for(const auto& wire : page.wires)
+    {
+        if(!wire)
+        {
+            continue;
+        }
+
+        hash.add(wire->startX);
+        hash.add(wire->startY);
+        hash.add(wire->endX);
+        hash.add(wire->endY);
+
+        addDisplayProps(wire->symbolDisplayProps, nullptr);
+
+        hash.add(static_cast<uint64_t>(wire->aliases.size()));
+
+        for(const auto& alias : wire->aliases)
+        {
+            if(alias)
+            {
+                hash.add(alias->name);
+                hash.add(alias->locX);
+                hash.add(alias->locY);
+                hash.add(alias->rotation);
+            }
+        }
+    }
+
+    hash.add(static_cast<uint64_t>(page.placedInstances.size()));
+
+    for(const auto& inst : page.placedInstances)
+    {
+        if(!inst)
+        {
+            continue;
+        }
+
+        hash.add(inst->pkgName);
+        hash.add(inst->locX);
+        hash.add(inst->locY);
+        hash.add(inst->rotation);
+        hash.add(inst->mirrored);
+
+        addDisplayProps(inst->symbolDisplayProps, inst.get());
+    }
+
+    // Instance geometry is represented by its bounding box
+    for(const auto& bbox : aPage.placedInstances)
+    {
+        hash.add(bbox.x1);
+        hash.add(bbox.y1);
+        hash.add(bbox.x2);
+        hash.add(bbox.y2);
+    }
+
+    hash.add(static_cast<uint64_t>(page.graphicInsts.size()));
+
+    for(const auto& inst : page.graphicInsts)
+    {
+        if(!inst || !inst->sthInPages0)
+        {
+            continue;
+        }
+
+        hash.add(inst->locX);
+        hash.add(inst->locY);
+
+        for(const auto& prim : inst->sthInPages0->primitives)
+        {
+            if(const auto* text = dynamic_cast<const PrimCommentText*>(prim.get()))
+            {
+                hash.add(text->name);
+                hash.add(text->locX);
+                hash.add(text->locY);
+                hash.add(getTextHeight(text->getTextFont()));
+            }
+        }
+    }
+
+    return hash.getHash();
+}
+
+std::size_t OOCP::LodBuilder::getCacheSize() const
+{
+    const std::lock_guard<std::mutex> lock{mMutex};
+
+    return mCache.size();
+}
+
+void OOCP::LodBuilder::clearCache()
+{
+    const std::lock_guard<std::mutex> lock{mMutex};
+
+    mCache.clear();
+}
+
+OOCP::LodLevel OOCP::LodBuilder::buildLevel(const PageBBoxes& aPage, const std::vector<LodText>& aTexts,
+    const std::vector<LodJunction>& aJunctions, double aScale) const
+{
+    LodLevel level{};
+
+    level.scale = aScale;
+
+    // Wires
+
+    // Gaps below one pixel are not visible, close them s.t. fewer segments are drawn
+    const int32_t gap = toPageUnits(1.0, aScale);
+
+    const AxisAlignedWires wires = groupWires(*aPage.page);
+
+    for(const auto& [y, intervals] : wires.horizontal)
+    {
+        for(const auto& interval : mergeIntervals(intervals, gap))
+        {
+            level.wires.push_back(LodSegment{interval.start, y, interval.end, y});
+        }
+    }
+
+    for(const auto& [x, intervals] : wires.vertical)
+    {
+        for(const auto& interval : mergeIntervals(intervals, gap))
+        {
+            level.wires.push_back(LodSegment{x, interval.start, x, interval.end});
+        }
+    }
+
+    level.wires.insert(level.wires.end(), wires.other.begin(), wires.other.end());
+
+    // Instances
+
+    for(std::size_t i = 0U; i < aPage.placedInstances.size(); ++i)
+    {
+        const BoundingBox& bbox = aPage.placedInstances[i];
+
+        const double sizePx = std::max(bbox.getWidth(), bbox.getHeight()) * aScale;
+
+        if(sizePx < mCfg.mMinSymbolPx)
+        {
+            level.instanceBoxes.push_back(bbox);
+        }
+        else
+        {
+            level.detailedInstances.push_back(i);
+        }
+    }
+
+    // Texts
+
+    std::copy_if(aTexts.begin(), aTexts.end(), std::back_inserter(level.texts),
+        [this, aScale](const LodText& aText) { return aText.height * aScale >= mCfg.mMinTextPx; });
+
+    // Junctions
+
+    const double cellSize = std::max(mCfg.mJunctionClusterPx / aScale, 1.0);
+
+    struct Cluster
+    {
+        int64_t sumX;
+        int64_t sumY;
+        std::size_t points;
+        std::size_t count;
+    };
+
+    // Cell -> index in `clusters`
+    std::map<std::pair<int64_t, int64_t>, std::size_t> cells;
+    std::vector<Cluster> clusters;
+
+    for(const auto& junction : aJunctions)
+    {
+        const auto key = std::make_pair(static_cast<int64_t>(std::floor(junction.x / cellSize)),
+            static_cast<int64_t>(std::floor(junction.y / cellSize)));
+
+        const auto [it, isNew] = cells.emplace(key, clusters.size());
+
+        if(isNew)
+        {
+            clusters.push_back(Cluster{});
+        }
+
+        Cluster& cluster = clusters[it->second];
+
+        cluster.sumX += junction.x;
+        cluster.sumY += junction.y;
+        cluster.points++;
+        cluster.count += junction.count;
+    }
+
+    // Junctions close to each other can end up in neighbouring cells. Merge
+    // neighbouring cells whose centroids are within the cluster distance.
+    std::vector<std::size_t> parents(clusters.size());
+    std::iota(parents.begin(), parents.end(), std::size_t{0U});
+
+    const auto getCentroid = [](const Cluster& aCluster)
+    {
+        const auto points = static_cast<double>(aCluster.points);
+
+        return std::make_pair(aCluster.sumX / points, aCluster.sumY / points);
+    };
+
+    for(const auto& [key, idx] : cells)
+    {
+        const auto [x, y] = getCentroid(clusters[idx]);
+
+        // Only check the neighbours that are sorted after the current cell
+        for(const auto& [dx, dy] : {std::make_pair(0, 1), std::make_pair(1, -1), std::make_pair(1, 0),
+                 std::make_pair(1, 1)})
+        {
+            const auto it = cells.find(std::make_pair(key.first + dx, key.second + dy));
+
+            if(it == cells.end())
+            {
+                continue;
+            }
+
+            const auto [neighbourX, neighbourY] = getCentroid(clusters[it->second]);
+
+            if(std::hypot(neighbourX - x, neighbourY - y) <= cellSize)
+            {
+                parents[findRoot(parents, it->second)] = findRoot(parents, idx);
+            }
+        }
+    }
+
+    for(std::size_t i = 0U; i < clusters.size(); ++i)
+    {
+        const std::size_t root = findRoot(parents, i);
+
+        if(root != i)
+        {
+            clusters[root].sumX += clusters[i].sumX;
+            clusters[root].sumY += clusters[i].sumY;
+            clusters[root].points += clusters[i].points;
+            clusters[root].count += clusters[i].count;
+        }
+    }
+
+    for(const auto& [key, idx] : cells)
+    {
+        if(findRoot(parents, idx) != idx)
+        {
+            continue;
+        }
+
+        const Cluster& cluster = clusters[idx];
+
+        const auto points = static_cast<int64_t>(cluster.points);
+
+        level.junctions.push_back(LodJunction{static_cast<int32_t>(cluster.sumX / points),
+            static_cast<int32_t>(cluster.sumY / points), cluster.count});
+    }
+
+    return level;
+}
+
+std::vector<OOCP::LodText> OOCP::LodBuilder::collectTexts(const StreamPage& aPage) const
+{
+    std::vector<LodText> texts;
+
+    const InstanceProps instProps = getInstanceProps(aPage);
+
+    // Display properties of instances are collected first and
+    // transformed in a single batch into page coordinates
+    std::vector<InstanceTransform> transforms;
+    std::vector<std::size_t> ranges{0U};
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+
+    for(const auto& inst : aPage.placedInstances)
+    {
+        if(!inst)
+        {
+            continue;
+        }
+
+        const InstanceTransform transform = InstanceTransform::fromPlacedInstance(*inst);
+
+        for(const auto& prop : inst->symbolDisplayProps)
+        {
+            if(!prop)
+            {
+                continue;
+            }
+
+            xs.push_back(prop->x);
+            ys.push_back(prop->y);
+
+            texts.push_back(LodText{0, 0, getTextHeight(prop->getTextFont()), transform.apply(prop->rotation).rotation,
+                getDisplayedValue(instProps, *inst, *prop)});
+        }
+
+        transforms.push_back(transform);
+        ranges.push_back(xs.size());
+    }
+
+    transformInstances(transforms, ranges, xs, ys);
+
+    for(std::size_t i = 0U; i < xs.size(); ++i)
+    {
+        texts[i].x = xs[i];
+        texts[i].y = ys[i];
+    }
+
+    for(const auto& wire : aPage.wires)
+    {
+        if(!wire)
+        {
+            continue;
+        }
+
+        for(const auto& prop : wire->symbolDisplayProps)
+        {
+            if(prop)
+            {
+                texts.push_back(LodText{
+                    prop->x, prop->y, getTextHeight(prop->getTextFont()), prop->rotation, prop->getName()});
+            }
+        }
+
+        for(const auto& alias : wire->aliases)
+        {
+            if(alias)
+            {
+                texts.push_back(LodText{alias->locX, alias->locY, DefaultAliasHeight, alias->rotation, alias->name});
+            }
+        }
+    }
+
+    for(const auto& inst : aPage.graphicInsts)
+    {
+        if(!inst || !inst->sthInPages0)
+        {
+            continue;
+        }
+
+        for(const auto& prim : inst->sthInPages0->primitives)
+        {
+            if(const auto* text = dynamic_cast<const PrimCommentText*>(prim.get()))
+            {
+                texts.push_back(LodText{inst->locX + text->locX, inst->locY + text->locY,
+                    getTextHeight(text->getTextFont()), Rotation::Deg_0, text->name});
+            }
+        }
+    }
+
+    return texts;
+}
+
+std::vector<OOCP::LodJunction> OOCP::LodBuilder::collectJunctions(const StreamPage& aPage) const
+{
+    std::vector<LodJunction> junctions;
+
+    for(const auto& [x, y] : getJunctions(aPage))
+    {
+        junctions.push_back(LodJunction{x, y, 1U});
+    }
+
+    return junctions;
+}
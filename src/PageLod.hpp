@@ -0,0 +1,174 @@
+#ifndef PAGELOD_HPP
+#define PAGELOD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "BoundingBox.hpp"
+#include "BoundingBoxIndex.hpp"
+#include "ContainerContext.hpp"
+#include "Enums/Rotation.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+class StreamPage;
+
+struct LodConfig
+{
+    // Zoom levels in pixel per page unit, the first one is the most detailed
+    std::vector<double> mScales{1.0, 0.5, 0.25, 0.125, 0.0625};
+
+    double mMinSymbolPx{8.0};        //!< Smaller instances are replaced by their bounding box
+    double mMinTextPx{1.0};          //!< Texts with a smaller height are dropped
+    double mJunctionClusterPx{4.0};  //!< Junctions within this distance are merged into one
+};
+
+struct LodSegment
+{
+    int32_t x1;
+    int32_t y1;
+    int32_t x2;
+    int32_t y2;
+};
+
+struct LodText
+{
+    int32_t x;
+    int32_t y;
+
+    int32_t height;
+
+    Rotation rotation;
+
+    std::string text;
+};
+
+struct LodJunction
+{
+    int32_t x;
+    int32_t y;
+
+    std::size_t count; //!< Number of junctions merged into this one
+};
+
+/**
+ * @brief Simplified page geometry for a single zoom level.
+ */
+struct LodLevel
+{
+    double scale; //!< Pixel per page unit
+
+    std::vector<LodSegment> wires; //!< Collinear segments are merged
+
+    std::vector<std::size_t> detailedInstances; //!< Indices into `StreamPage::placedInstances`
+    std::vector<BoundingBox> instanceBoxes;     //!< Instances too small to be drawn in detail
+
+    std::vector<LodText> texts; //!< Texts with a visible size
+
+    std::vector<LodJunction> junctions;
+};
+
+struct PageLod
+{
+    uint64_t contentHash;
+
+    std::vector<LodLevel> levels; //!< Same order as `LodConfig::mScales`
+};
+
+/**
+ * @brief Builds simplified page geometry for zoomed-out views.
+ *
+ * @note All levels of a page are built in parallel. Results are cached by the
+ *       content hash of the page geometry, i.e. pages with identical content
+ *       share their levels and a modified page is rebuilt.
+ */
+class LodBuilder
+{
+public:
+    LodBuilder(ContainerContext& aCtx, const BoundingBoxIndex& aBBoxIndex, LodConfig aCfg = LodConfig{})
+        : mCtx{aCtx},
+          mBBoxIndex{aBBoxIndex},
+          mCfg{aCfg},
+          mMutex{},
+          mCache{}
+    {
+    }
+
+    /**
+     * @brief Get all levels of a page, build them if they are not cached yet.
+     *
+     * @param aPage Page with its bounding boxes from the `BoundingBoxIndex`.
+     * @return std::shared_ptr<const PageLod> Levels of the page.
+     */
+    std::shared_ptr<const PageLod> build(const PageBBoxes& aPage);
+
+    /**
+     * @brief Build levels of all pages in the `BoundingBoxIndex`.
+     *
+     * @return std::vector<std::shared_ptr<const PageLod>> Levels in the same order as the pages.
+     */
+    std::vector<std::shared_ptr<const PageLod>> buildAll();
+
+    /**
+     * @brief Hash of everything that contributes to the simplified page geometry.
+     */
+    uint64_t getContentHash(const PageBBoxes& aPage) const;
+
+    std::size_t getCacheSize() const;
+
+    void clearCache();
+
+private:
+    LodLevel buildLevel(const PageBBoxes& aPage, const std::vector<LodText>& aTexts,
+        const std::vector<LodJunction>& aJunctions, double aScale) const;
+
+    std::vector<LodText> collectTexts(const StreamPage& aPage) const;
+
+    std::vector<LodJunction> collectJunctions(const StreamPage& aPage) const;
+
+    ContainerContext& mCtx;
+
+    const BoundingBoxIndex& mBBoxIndex;
+
+    LodConfig mCfg;
+
+    mutable std::mutex mMutex;
+
+    std::unordered_map<uint64_t, std::shared_ptr<const PageLod>> mCache; //!< Content hash -> levels
+};
+
+[[maybe_unused]]
+static std::string to_string(const LodLevel& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}scale             = {}\n", indent(1), aObj.scale);
+    str += fmt::format("{}wires             = {}\n", indent(1), aObj.wires.size());
+    str += fmt::format("{}detailedInstances = {}\n", indent(1), aObj.detailedInstances.size());
+    str += fmt::format("{}instanceBoxes     = {}\n", indent(1), aObj.instanceBoxes.size());
+    str += fmt::format("{}texts             = {}\n", indent(1), aObj.texts.size());
+    str += fmt::format("{}junctions         = {}\n", indent(1), aObj.junctions.size());
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const LodLevel& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // PAGELOD_HPP
@@ -0,0 +1,87 @@
+#ifndef PARALLELFOR_HPP
+#define PARALLELFOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace OOCP
+{
+/**
+ * @brief Run aFunc for all indices [0, aCount) distributed among threads.
+ *
+ * @note Indices are distributed round-robin, similar to the stream distribution
+ *       in `Container::parseDatabaseFile`. The calling thread takes its share
+ *       as well. Jobs must not write to shared state without synchronization.
+ *       If a job throws, the remaining jobs are skipped, all threads are
+ *       joined and the exception of the lowest thread index is rethrown.
+ *
+ * @param aThreadCount Maximum number of threads.
+ * @param aCount Number of jobs.
+ * @param aFunc Job function with signature void(std::size_t aIdx).
+ */
+template <typename TFunc> void parallelFor(std::size_t aThreadCount, std::size_t aCount, TFunc aFunc)
+{
+    const std::size_t threadCount = std::clamp<std::size_t>(aThreadCount, 1U, std::max<std::size_t>(aCount, 1U));
+
+    std::vector<std::exception_ptr> errList(threadCount);
+    std::atomic<bool> failed{false};
+
+    const auto job = [&aFunc, &errList, &failed, aCount, threadCount](std::size_t aThreadIdx)
+    {
+        try
+        {
+            for(std::size_t i = aThreadIdx; i < aCount && !failed.load(); i += threadCount)
+            {
+                aFunc(i);
+            }
+        }
+        catch(...)
+        {
+            errList[aThreadIdx] = std::current_exception();
+            failed.store(true);
+        }
+    };
+
+    std::vector<std::thread> threadList;
+
+    const auto joinAll = [&threadList]()
+    {
+        for(auto& thread : threadList)
+        {
+            thread.join();
+        }
+    };
+
+    try
+    {
+        for(std::size_t i = 1U; i < threadCount; ++i)
+        {
+            threadList.push_back(std::thread{job, i});
+        }
+    }
+    catch(...)
+    {
+        // Threads that are already running must be joined before leaving
+        failed.store(true);
+        joinAll();
+        throw;
+    }
+
+    job(0U);
+
+    joinAll();
+
+    for(const auto& err : errList)
+    {
+        if(err)
+        {
+            std::rethrow_exception(err);
+        }
+    }
+}
+} // namespace OOCP
+#endif // PARALLELFOR_HPP
@@ -0,0 +1,678 @@
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "Database.hpp"
+#include "GetStreamHelper.hpp"
+#include "PartSearchIndex.hpp"
+#include "Streams/StreamPackage.hpp"
+
+namespace
+{
+constexpr std::size_t TermBlockSize = 16U;
+
+constexpr uint32_t FieldBits = 2U;
+
+constexpr std::size_t MaxPartCtr = std::size_t{1U} << (32U - FieldBits);
+
+std::string normalize(const std::string& aText)
+{
+    std::string text;
+
+    text.reserve(aText.size());
+
+    for(const char c : aText)
+    {
+        text += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    const std::size_t begin = text.find_first_not_of(' ');
+
+    if(begin == std::string::npos)
+    {
+        return std::string{};
+    }
+
+    return text.substr(begin, text.find_last_not_of(' ') - begin + 1U);
+}
+
+// E.g. `U?` or `U12` -> `u`
+std::string getRefDesPrefix(const std::string& aRefDes)
+{
+    std::string prefix = normalize(aRefDes);
+
+    while(!prefix.empty() && (std::isdigit(static_cast<unsigned char>(prefix.back())) || prefix.back() == '?'))
+    {
+        prefix.pop_back();
+    }
+
+    return prefix;
+}
+
+void appendVarint(std::vector<uint8_t>& aData, std::size_t aVal)
+{
+    while(aVal >= 0x80U)
+    {
+        aData.push_back(static_cast<uint8_t>(aVal | 0x80U));
+        aVal >>= 7U;
+    }
+
+    aData.push_back(static_cast<uint8_t>(aVal));
+}
+
+std::size_t readVarint(const std::vector<uint8_t>& aData, std::size_t& aOffset)
+{
+    std::size_t val   = 0U;
+    std::size_t shift = 0U;
+
+    while(true)
+    {
+        const uint8_t byte = aData[aOffset++];
+
+        val |= static_cast<std::size_t>(byte & 0x7FU) << shift;
+
+        if((byte & 0x80U) == 0U)
+        {
+            return val;
+        }
+
+        shift += 7U;
+    }
+}
+
+/**
+ * @brief Distinct trigrams of a text.
+ *
+ * @param aPadded Pad the text with spaces as used for similarity, s.t. short texts
+ *                and their beginning and end are weighted. Plain trigrams are used
+ *                for substring matching, they are a subset of the padded ones.
+ */
+std::vector<uint32_t> getTrigrams(const std::string& aText, bool aPadded)
+{
+    const std::string text = aPadded ? "  " + aText + " " : aText;
+
+    std::vector<uint32_t> trigrams;
+
+    for(std::size_t i = 0U; i + 3U <= text.size(); ++i)
+    {
+        trigrams.push_back(static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << 16U |
+                           static_cast<uint32_t>(static_cast<uint8_t>(text[i + 1U])) << 8U |
+                           static_cast<uint32_t>(static_cast<uint8_t>(text[i + 2U])));
+    }
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    return trigrams;
+}
+
+/**
+ * @brief Sequential decoder of the front coded terms, starting at the beginning of a block.
+ */
+class TermDecoder
+{
+public:
+    TermDecoder(const OOCP::PartSearchSegment& aSegment, std::size_t aBlock)
+        : mSegment{aSegment},
+          mNextId{aBlock * TermBlockSize},
+          mOffset{aBlock < aSegment.blockOffsets.size() ? aSegment.blockOffsets[aBlock] : aSegment.termData.size()},
+          mTerm{}
+    {
+    }
+
+    /**
+     * @return false If all terms were decoded.
+     */
+    bool next()
+    {
+        if(mNextId >= mSegment.termCtr)
+        {
+            return false;
+        }
+
+        const std::size_t shared    = readVarint(mSegment.termData, mOffset);
+        const std::size_t suffixLen = readVarint(mSegment.termData, mOffset);
+
+        mTerm.resize(shared);
+        mTerm.append(reinterpret_cast<const char*>(mSegment.termData.data() + mOffset), suffixLen);
+
+        mOffset += suffixLen;
+        ++mNextId;
+
+        return true;
+    }
+
+    uint32_t getTermId() const
+    {
+        return static_cast<uint32_t>(mNextId - 1U);
+    }
+
+    const std::string& getTerm() const
+    {
+        return mTerm;
+    }
+
+private:
+    const OOCP::PartSearchSegment& mSegment;
+
+    std::size_t mNextId;
+    std::size_t mOffset;
+
+    std::string mTerm;
+};
+
+std::string getTerm(const OOCP::PartSearchSegment& aSegment, uint32_t aTermId)
+{
+    TermDecoder decoder{aSegment, aTermId / TermBlockSize};
+
+    while(decoder.next() && decoder.getTermId() < aTermId)
+    {
+    }
+
+    return decoder.getTerm();
+}
+
+/**
+ * @brief Build a segment from pairs of normalized terms and postings.
+ */
+void buildTerms(OOCP::PartSearchSegment& aSegment, std::vector<std::pair<std::string, uint32_t>>& aTermPostings)
+{
+    std::sort(aTermPostings.begin(), aTermPostings.end());
+    aTermPostings.erase(std::unique(aTermPostings.begin(), aTermPostings.end()), aTermPostings.end());
+
+    aSegment.termCtr = 0U;
+
+    std::string prevTerm;
+
+    for(std::size_t i = 0U; i < aTermPostings.size(); ++i)
+    {
+        const std::string& term = aTermPostings[i].first;
+
+        if(i == 0U || term != prevTerm)
+        {
+            const uint32_t termId = static_cast<uint32_t>(aSegment.termCtr++);
+
+            std::size_t shared = 0U;
+
+            if(termId % TermBlockSize == 0U)
+            {
+                aSegment.blockOffsets.push_back(static_cast<uint32_t>(aSegment.termData.size()));
+            }
+            else
+            {
+                const auto mismatch = std::mismatch(term.begin(), term.end(), prevTerm.begin(), prevTerm.end());
+
+                shared = static_cast<std::size_t>(mismatch.first - term.begin());
+            }
+
+            appendVarint(aSegment.termData, shared);
+            appendVarint(aSegment.termData, term.size() - shared);
+            aSegment.termData.insert(aSegment.termData.end(), term.begin() + shared, term.end());
+
+            aSegment.postingOffsets.push_back(static_cast<uint32_t>(aSegment.postings.size()));
+
+            const std::vector<uint32_t> trigrams = getTrigrams(term, true);
+
+            // Term IDs are ascending, i.e. the trigram postings stay sorted
+            for(const uint32_t trigram : trigrams)
+            {
+                aSegment.trigrams[trigram].push_back(termId);
+            }
+
+            aSegment.trigramCtrs.push_back(static_cast<uint16_t>(std::min<std::size_t>(trigrams.size(), 0xFFFFU)));
+
+            prevTerm = term;
+        }
+
+        aSegment.postings.push_back(aTermPostings[i].second);
+    }
+
+    aSegment.postingOffsets.push_back(static_cast<uint32_t>(aSegment.postings.size()));
+}
+
+/**
+ * @brief Visit all terms of a segment that start with the given prefix in sorted order.
+ *
+ * @param aFunc Returns false to stop visiting.
+ */
+template <typename F>
+void forEachPrefixTerm(const OOCP::PartSearchSegment& aSegment, const std::string& aPrefix, F aFunc)
+{
+    // Find the last block whose first term is not greater than the prefix
+    std::size_t lo = 0U;
+    std::size_t hi = aSegment.blockOffsets.size();
+
+    while(lo < hi)
+    {
+        const std::size_t mid = lo + (hi - lo) / 2U;
+
+        TermDecoder decoder{aSegment, mid};
+        decoder.next();
+
+        if(decoder.getTerm() <= aPrefix)
+        {
+            lo = mid + 1U;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    TermDecoder decoder{aSegment, lo == 0U ? 0U : lo - 1U};
+
+    while(decoder.next())
+    {
+        const std::string& term = decoder.getTerm();
+
+        if(term.compare(0U, aPrefix.size(), aPrefix) == 0)
+        {
+            if(!aFunc(decoder.getTermId(), term))
+            {
+                return;
+            }
+        }
+        else if(term > aPrefix)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Term IDs of a segment that contain all given trigrams.
+ */
+std::vector<uint32_t> intersectTrigrams(const OOCP::PartSearchSegment& aSegment, const std::vector<uint32_t>& aTrigrams)
+{
+    std::vector<const std::vector<uint32_t>*> lists;
+
+    for(const uint32_t trigram : aTrigrams)
+    {
+        const auto it = aSegment.trigrams.find(trigram);
+
+        if(it == aSegment.trigrams.cend())
+        {
+            return std::vector<uint32_t>{};
+        }
+
+        lists.push_back(&it->second);
+    }
+
+    if(lists.empty())
+    {
+        return std::vector<uint32_t>{};
+    }
+
+    // Start with the shortest list to keep the intermediate results small
+    std::sort(lists.begin(), lists.end(),
+        [](const auto* aLhs, const auto* aRhs) { return aLhs->size() < aRhs->size(); });
+
+    std::vector<uint32_t> result = *lists.front();
+
+    for(std::size_t i = 1U; i < lists.size() && !result.empty(); ++i)
+    {
+        std::vector<uint32_t> intersection;
+
+        std::set_intersection(
+            result.cbegin(), result.cend(), lists[i]->cbegin(), lists[i]->cend(), std::back_inserter(intersection));
+
+        result = std::move(intersection);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Collects hits of a query, each part is reported once.
+ */
+class HitCollector
+{
+public:
+    HitCollector(std::size_t aLimit)
+        : mLimit{aLimit},
+          mHits{},
+          mLibrary{},
+          mSegment{nullptr},
+          mSeenParts{}
+    {
+    }
+
+    void beginSegment(const std::string& aLibrary, const OOCP::PartSearchSegment& aSegment)
+    {
+        mLibrary = aLibrary;
+        mSegment = &aSegment;
+        mSeenParts.clear();
+    }
+
+    void add(uint32_t aTermId, const std::string& aTerm, double aScore)
+    {
+        for(uint32_t i = mSegment->postingOffsets[aTermId]; i < mSegment->postingOffsets[aTermId + 1U]; ++i)
+        {
+            const uint32_t posting = mSegment->postings[i];
+            const uint32_t partIdx = posting >> FieldBits;
+
+            if(isFull() || !mSeenParts.insert(partIdx).second)
+            {
+                continue;
+            }
+
+            OOCP::PartSearchHit hit{};
+
+            hit.library        = mLibrary;
+            hit.streamLocation = mSegment->streamLocations[partIdx];
+            hit.package        = mSegment->packages[partIdx];
+            hit.field          = static_cast<OOCP::PartSearchField>(posting & ((1U << FieldBits) - 1U));
+            hit.term           = aTerm;
+            hit.score          = aScore;
+
+            mHits.push_back(std::move(hit));
+        }
+    }
+
+    bool isFull() const
+    {
+        return mHits.size() >= mLimit;
+    }
+
+    std::vector<OOCP::PartSearchHit>& getHits()
+    {
+        return mHits;
+    }
+
+private:
+    std::size_t mLimit;
+
+    std::vector<OOCP::PartSearchHit> mHits;
+
+    std::string mLibrary;
+    const OOCP::PartSearchSegment* mSegment;
+    std::unordered_set<uint32_t> mSeenParts; //!< Part indices of the current segment
+};
+} // namespace
+
+void OOCP::PartSearchIndex::addLibrary(ContainerContext& aCtx)
+{
+    const std::string library = aCtx.mInputCfbfFile.string();
+
+    PartSearchSegment segment{};
+
+    std::vector<std::pair<std::string, uint32_t>> termPostings;
+
+    const auto libraryStream = getLibraryStreamFromDb(aCtx.mDb);
+
+    const auto addTerm = [&termPostings](const std::string& aText, uint32_t aPartIdx, PartSearchField aField)
+    {
+        std::string term = normalize(aText);
+
+        if(!term.empty())
+        {
+            termPostings.emplace_back(std::move(term), aPartIdx << FieldBits | static_cast<uint32_t>(aField));
+        }
+    };
+
+    for(const auto& stream : aCtx.mDb.mStreams)
+    {
+        const auto package = std::dynamic_pointer_cast<StreamPackage>(stream);
+
+        if(!package || !package->package)
+        {
+            continue;
+        }
+
+        if(segment.packages.size() >= MaxPartCtr)
+        {
+            throw std::runtime_error(fmt::format("{}: Too many packages in {}", __func__, library));
+        }
+
+        const uint32_t partIdx = static_cast<uint32_t>(segment.packages.size());
+
+        segment.packages.push_back(package->package->name);
+        segment.streamLocations.push_back(to_string(stream->mCtx.mCfbfStreamLocation));
+
+        addTerm(package->package->name, partIdx, PartSearchField::Name);
+        addTerm(getRefDesPrefix(package->package->refDes), partIdx, PartSearchField::RefDes);
+        addTerm(package->package->pcbFootprint, partIdx, PartSearchField::Property);
+
+        for(const auto& device : package->package->devices)
+        {
+            if(device)
+            {
+                addTerm(getRefDesPrefix(device->refDes), partIdx, PartSearchField::RefDes);
+            }
+        }
+
+        for(const auto& libraryPart : package->libraryParts)
+        {
+            if(libraryPart)
+            {
+                addTerm(libraryPart->name, partIdx, PartSearchField::Name);
+                addTerm(libraryPart->generalProperties.partValue, partIdx, PartSearchField::Property);
+                addTerm(libraryPart->generalProperties.implementation, partIdx, PartSearchField::Property);
+            }
+        }
+
+        if(libraryStream)
+        {
+            for(const auto& alias : libraryStream->getAliasesOfPackage(package->package->name))
+            {
+                addTerm(alias, partIdx, PartSearchField::Alias);
+            }
+        }
+    }
+
+    buildTerms(segment, termPostings);
+
+    aCtx.mLogger.info("Indexed {} parts with {} terms of {}", segment.packages.size(), segment.termCtr, library);
+
+    mSegments.insert_or_assign(library, std::move(segment));
+}
+
+bool OOCP::PartSearchIndex::removeLibrary(const std::string& aLibrary)
+{
+    return mSegments.erase(aLibrary) > 0U;
+}
+
+std::vector<OOCP::PartSearchHit> OOCP::PartSearchIndex::findPrefix(const std::string& aPrefix, std::size_t aLimit) const
+{
+    const std::string prefix = normalize(aPrefix);
+
+    HitCollector collector{aLimit};
+
+    for(const auto& [library, segment] : mSegments)
+    {
+        if(collector.isFull())
+        {
+            break;
+        }
+
+        collector.beginSegment(library, segment);
+
+        forEachPrefixTerm(segment, prefix,
+            [&collector](uint32_t aTermId, const std::string& aTerm)
+            {
+                collector.add(aTermId, aTerm, 1.0);
+
+                return !collector.isFull();
+            });
+    }
+
+    return std::move(collector.getHits());
+}
+
+std::vector<OOCP::PartSearchHit> OOCP::PartSearchIndex::findSubstring(
+    const std::string& aText, std::size_t aLimit) const
+{
+    const std::string text = normalize(aText);
+
+    HitCollector collector{aLimit};
+
+    if(text.empty())
+    {
+        return std::move(collector.getHits());
+    }
+
+    for(const auto& [library, segment] : mSegments)
+    {
+        if(collector.isFull())
+        {
+            break;
+        }
+
+        collector.beginSegment(library, segment);
+
+        // Texts shorter than a trigram can not use the postings
+        if(text.size() < 3U)
+        {
+            TermDecoder decoder{segment, 0U};
+
+            while(decoder.next() && !collector.isFull())
+            {
+                if(decoder.getTerm().find(text) != std::string::npos)
+                {
+                    collector.add(decoder.getTermId(), decoder.getTerm(), 1.0);
+                }
+            }
+
+            continue;
+        }
+
+        // Trigrams are candidates only, they do not guarantee the order
+        for(const uint32_t termId : intersectTrigrams(segment, getTrigrams(text, false)))
+        {
+            if(collector.isFull())
+            {
+                break;
+            }
+
+            const std::string term = getTerm(segment, termId);
+
+            if(term.find(text) != std::string::npos)
+            {
+                collector.add(termId, term, 1.0);
+            }
+        }
+    }
+
+    return std::move(collector.getHits());
+}
+
+std::vector<OOCP::PartSearchHit> OOCP::PartSearchIndex::findFuzzy(
+    const std::string& aText, std::size_t aLimit, double aMinSimilarity) const
+{
+    const std::string text = normalize(aText);
+
+    std::vector<PartSearchHit> hits;
+
+    if(text.empty())
+    {
+        return hits;
+    }
+
+    const std::vector<uint32_t> trigrams = getTrigrams(text, true);
+
+    for(const auto& [library, segment] : mSegments)
+    {
+        // Dense counters are faster than a hash map for the common trigrams
+        std::vector<uint16_t> sharedCtrs(segment.termCtr, 0U); // Term ID -> shared trigrams
+        std::vector<uint32_t> touchedTermIds;
+
+        for(const uint32_t trigram : trigrams)
+        {
+            const auto it = segment.trigrams.find(trigram);
+
+            if(it != segment.trigrams.cend())
+            {
+                for(const uint32_t termId : it->second)
+                {
+                    if(sharedCtrs[termId]++ == 0U)
+                    {
+                        touchedTermIds.push_back(termId);
+                    }
+                }
+            }
+        }
+
+        std::vector<std::pair<double, uint32_t>> candidates;
+
+        for(const uint32_t termId : touchedTermIds)
+        {
+            const std::size_t sharedCtr = sharedCtrs[termId];
+
+            const double similarity = static_cast<double>(sharedCtr) /
+                                      static_cast<double>(trigrams.size() + segment.trigramCtrs[termId] - sharedCtr);
+
+            if(similarity >= aMinSimilarity)
+            {
+                candidates.emplace_back(similarity, termId);
+            }
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+            [](const auto& aLhs, const auto& aRhs)
+            { return aLhs.first != aRhs.first ? aLhs.first > aRhs.first : aLhs.second < aRhs.second; });
+
+        // The best hits of all libraries are a subset of the best hits per library
+        HitCollector collector{aLimit};
+
+        collector.beginSegment(library, segment);
+
+        for(const auto& [similarity, termId] : candidates)
+        {
+            if(collector.isFull())
+            {
+                break;
+            }
+
+            collector.add(termId, getTerm(segment, termId), similarity);
+        }
+
+        hits.insert(hits.end(), std::make_move_iterator(collector.getHits().begin()),
+            std::make_move_iterator(collector.getHits().end()));
+    }
+
+    std::stable_sort(hits.begin(), hits.end(),
+        [](const PartSearchHit& aLhs, const PartSearchHit& aRhs) { return aLhs.score > aRhs.score; });
+
+    if(hits.size() > aLimit)
+    {
+        hits.resize(aLimit);
+    }
+
+    return hits;
+}
+
+std::size_t OOCP::PartSearchIndex::getPartCtr() const
+{
+    std::size_t ctr = 0U;
+
+    for(const auto& [library, segment] : mSegments)
+    {
+        ctr += segment.packages.size();
+    }
+
+    return ctr;
+}
+
+std::size_t OOCP::PartSearchIndex::getTermCtr() const
+{
+    std::size_t ctr = 0U;
+
+    for(const auto& [library, segment] : mSegments)
+    {
+        ctr += segment.termCtr;
+    }
+
+    return ctr;
+}
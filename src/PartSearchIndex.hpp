@@ -0,0 +1,155 @@
+#ifndef PARTSEARCHINDEX_HPP
+#define PARTSEARCHINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <magic_enum.hpp>
+#include <nameof.hpp>
+
+#include "ContainerContext.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+enum class PartSearchField
+{
+    Name,    //!< Package name or name of a package view
+    Alias,   //!< Part alias from the `Library` stream
+    RefDes,  //!< Reference designator prefix, e.g. `U` or `R`
+    Property //!< Property value, e.g. PCB footprint, part value or implementation
+};
+
+[[maybe_unused]]
+static std::string to_string(const PartSearchField& aVal)
+{
+    return std::string{magic_enum::enum_name<decltype(aVal)>(aVal)};
+}
+
+struct PartSearchHit
+{
+    std::string library;        //!< Path to the library the part was found in
+    std::string streamLocation; //!< Location of the package stream inside the CFBF container
+    std::string package;        //!< Package name
+
+    PartSearchField field; //!< Field of the matched term
+    std::string term;      //!< Matched term in lower case
+
+    double score; //!< 1 for prefix and substring matches, trigram similarity for fuzzy matches
+};
+
+/**
+ * @brief Index of a single library, it is immutable once built.
+ *
+ * @note Terms are sorted and front coded in blocks, i.e. each term only stores
+ *       the suffix that differs from its predecessor. Prefix queries binary search
+ *       the first term of each block and decode from there.
+ */
+struct PartSearchSegment
+{
+    std::vector<std::string> streamLocations; //!< Part index -> stream location
+    std::vector<std::string> packages;        //!< Part index -> package name
+
+    std::vector<uint8_t> termData;      //!< Front coded terms
+    std::vector<uint32_t> blockOffsets; //!< Offset into `termData` of each block
+    std::size_t termCtr{0U};
+
+    std::vector<uint32_t> postingOffsets; //!< Term ID -> range in `postings`
+    std::vector<uint32_t> postings;       //!< Part index and `PartSearchField` packed into 30 and 2 bit
+
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams; //!< Trigram -> sorted term IDs
+    std::vector<uint16_t> trigramCtrs;                            //!< Term ID -> number of distinct trigrams
+};
+
+/**
+ * @brief Search index for parts across a collection of libraries.
+ *
+ * @note Every library is indexed into its own segment such that adding, replacing
+ *       or removing a library does not touch the others. Prefix queries use the
+ *       front coded term dictionary, substring and fuzzy queries use trigram
+ *       postings. All terms are matched case-insensitive. Hits are reported once
+ *       per part, with the first or best matching term.
+ */
+class PartSearchIndex
+{
+public:
+    PartSearchIndex()
+        : mSegments{}
+    {
+    }
+
+    /**
+     * @brief Index all packages of a parsed library, a previous index of the same library is replaced.
+     *
+     * @param aCtx Context of the parsed library.
+     */
+    void addLibrary(ContainerContext& aCtx);
+
+    /**
+     * @return true If the library was indexed before.
+     */
+    bool removeLibrary(const std::string& aLibrary);
+
+    /**
+     * @brief Find parts with a term starting with the given prefix.
+     */
+    std::vector<PartSearchHit> findPrefix(const std::string& aPrefix, std::size_t aLimit = 100U) const;
+
+    /**
+     * @brief Find parts with a term containing the given text.
+     */
+    std::vector<PartSearchHit> findSubstring(const std::string& aText, std::size_t aLimit = 100U) const;
+
+    /**
+     * @brief Find parts with a term that is similar to the given one, e.g. a misspelled name.
+     *
+     * @param aMinSimilarity Minimum Jaccard similarity of the trigrams in the range of 0 to 1.
+     * @return std::vector<PartSearchHit> Hits sorted by their score, best first.
+     */
+    std::vector<PartSearchHit> findFuzzy(
+        const std::string& aText, std::size_t aLimit = 100U, double aMinSimilarity = 0.3) const;
+
+    std::size_t getLibraryCtr() const
+    {
+        return mSegments.size();
+    }
+
+    std::size_t getPartCtr() const;
+
+    std::size_t getTermCtr() const;
+
+private:
+    std::map<std::string, PartSearchSegment> mSegments; //!< Library path -> segment
+};
+
+[[maybe_unused]]
+static std::string to_string(const PartSearchHit& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}library        = {}\n", indent(1), aObj.library);
+    str += fmt::format("{}streamLocation = {}\n", indent(1), aObj.streamLocation);
+    str += fmt::format("{}package        = {}\n", indent(1), aObj.package);
+    str += fmt::format("{}field          = {}\n", indent(1), to_string(aObj.field));
+    str += fmt::format("{}term           = {}\n", indent(1), aObj.term);
+    str += fmt::format("{}score          = {}\n", indent(1), aObj.score);
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const PartSearchHit& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // PARTSEARCHINDEX_HPP
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "Database.hpp"
+#include "ParallelFor.hpp"
+#include "PinTable.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Structures/StructDevice.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructPartCell.hpp"
+#include "Structures/StructSymbolPin.hpp"
+
+OOCP::PinTable::PinTable(const StreamPackage& aPackage)
+    : PinTable{}
+{
+    // Index 0 is reserved for unmapped pin numbers
+    intern(std::string{});
+
+    if(!aPackage.package)
+    {
+        return;
+    }
+
+    const StructPackage& package = *aPackage.package;
+
+    mPackage = package.name;
+
+    const std::vector<UnitViews> views = getUnitViews(aPackage);
+
+    if(views.empty())
+    {
+        return;
+    }
+
+    const bool isHomogeneous = views.size() == 1U;
+
+    mUnitCtr = isHomogeneous ? std::max<std::size_t>(package.devices.size(), 1U) : views.size();
+
+    if(mUnitCtr > UINT16_MAX)
+    {
+        throw std::runtime_error(fmt::format("{}: Too many units in package `{}`", __func__, mPackage));
+    }
+
+    for(std::size_t unit = 0U; unit < mUnitCtr; ++unit)
+    {
+        const StructLibraryPart& view = *views[isHomogeneous ? 0U : unit].normalView;
+
+        const StructDevice* device = unit < package.devices.size() ? package.devices[unit].get() : nullptr;
+
+        if(view.symbolPins.size() > UINT16_MAX)
+        {
+            throw std::runtime_error(fmt::format("{}: Too many pins in view `{}`", __func__, view.name));
+        }
+
+        for(std::size_t position = 0U; position < view.symbolPins.size(); ++position)
+        {
+            const auto& pin = view.symbolPins[position];
+
+            if(!pin)
+            {
+                continue;
+            }
+
+            const uint32_t pinIdx = static_cast<uint32_t>(mUnits.size());
+
+            const bool isIgnored = device && position < device->pinIgnore.size() && device->pinIgnore[position];
+
+            mUnits.push_back(static_cast<uint16_t>(unit));
+            mPositions.push_back(static_cast<uint16_t>(position));
+            mNumbers.push_back(device && position < device->pinMap.size() ? intern(device->pinMap[position]) : 0U);
+            mNames.push_back(intern(pin->name));
+            mGroups.push_back(device && position < device->pinGroup.size() ? device->pinGroup[position] : NoGroup);
+            mIgnores.push_back(isIgnored);
+            mPortTypes.push_back(pin->portType);
+
+            mPinByPosition.emplace(static_cast<uint32_t>(unit << 16U | position), pinIdx);
+            mPinByName.emplace(static_cast<uint64_t>(unit) << 32U | mNames.back(), pinIdx);
+
+            if(mNumbers.back() != 0U)
+            {
+                const auto [it, isNew] = mPinByNumber.emplace(mNumbers.back(), pinIdx);
+
+                // Prefer pins that are not ignored, i.e. the visible one of shared pins
+                if(!isNew && mIgnores[it->second] && !isIgnored)
+                {
+                    it->second = pinIdx;
+                }
+            }
+        }
+    }
+}
+
+std::vector<OOCP::PinTable::UnitViews> OOCP::PinTable::getUnitViews(const StreamPackage& aPackage)
+{
+    const auto findView = [&aPackage](const std::string& aViewName) -> const StructLibraryPart*
+    {
+        for(const auto& libraryPart : aPackage.libraryParts)
+        {
+            if(libraryPart && !aViewName.empty() && libraryPart->name == aViewName)
+            {
+                return libraryPart.get();
+            }
+        }
+
+        return nullptr;
+    };
+
+    std::vector<UnitViews> cells;
+
+    for(const auto& partCell : aPackage.partCells)
+    {
+        if(partCell && findView(partCell->normalName))
+        {
+            cells.push_back(UnitViews{findView(partCell->normalName), findView(partCell->convertName)});
+        }
+    }
+
+    if(cells.empty())
+    {
+        for(const auto& libraryPart : aPackage.libraryParts)
+        {
+            if(libraryPart)
+            {
+                cells.push_back(UnitViews{libraryPart.get(), nullptr});
+                break;
+            }
+        }
+    }
+
+    return cells;
+}
+
+uint32_t OOCP::PinTable::intern(const std::string& aStr)
+{
+    const auto [it, isNew] = mStrIdx.emplace(aStr, static_cast<uint32_t>(mStrings.size()));
+
+    if(isNew)
+    {
+        mStrings.push_back(aStr);
+    }
+
+    return it->second;
+}
+
+std::optional<std::size_t> OOCP::PinTable::findPin(std::size_t aUnit, std::size_t aPosition) const
+{
+    if(aUnit > UINT16_MAX || aPosition > UINT16_MAX)
+    {
+        return std::nullopt;
+    }
+
+    const auto it = mPinByPosition.find(static_cast<uint32_t>(aUnit << 16U | aPosition));
+
+    if(it == mPinByPosition.cend())
+    {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::optional<std::size_t> OOCP::PinTable::findPinByNumber(const std::string& aNumber) const
+{
+    const auto strIt = mStrIdx.find(aNumber);
+
+    if(strIt == mStrIdx.cend())
+    {
+        return std::nullopt;
+    }
+
+    const auto it = mPinByNumber.find(strIt->second);
+
+    if(it == mPinByNumber.cend())
+    {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::optional<std::size_t> OOCP::PinTable::findPinByName(std::size_t aUnit, const std::string& aName) const
+{
+    const auto strIt = mStrIdx.find(aName);
+
+    if(strIt == mStrIdx.cend())
+    {
+        return std::nullopt;
+    }
+
+    const auto it = mPinByName.find(static_cast<uint64_t>(aUnit) << 32U | strIt->second);
+
+    if(it == mPinByName.cend())
+    {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::unordered_map<std::string, OOCP::PinTable> OOCP::buildPinTables(ContainerContext& aCtx)
+{
+    std::vector<std::shared_ptr<StreamPackage>> packages;
+
+    for(const auto& stream : aCtx.mDb.mStreams)
+    {
+        if(auto package = std::dynamic_pointer_cast<StreamPackage>(stream))
+        {
+            packages.push_back(std::move(package));
+        }
+    }
+
+    std::vector<PinTable> tables(packages.size());
+
+    parallelFor(aCtx.mCfg.mThreadCount, packages.size(),
+        [&](std::size_t aIdx) { tables[aIdx] = PinTable{*packages[aIdx]}; });
+
+    std::unordered_map<std::string, PinTable> tableByPackage;
+
+    tableByPackage.reserve(tables.size());
+
+    for(auto& table : tables)
+    {
+        if(table.getPackage().empty())
+        {
+            continue;
+        }
+
+        const std::string package = table.getPackage();
+
+        if(!tableByPackage.emplace(package, std::move(table)).second)
+        {
+            aCtx.mLogger.warn("{}: Package `{}` exists multiple times, keeping the first one", __func__, package);
+        }
+    }
+
+    aCtx.mLogger.info("Built pin tables of {} packages", tableByPackage.size());
+
+    return tableByPackage;
+}
@@ -0,0 +1,213 @@
+#ifndef PINTABLE_HPP
+#define PINTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "ContainerContext.hpp"
+#include "Enums/PortType.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+class StreamPackage;
+class StructLibraryPart;
+
+/**
+ * @brief Pin number, pin name and unit mapping of a single package.
+ *
+ * @note Combines the devices of `StructPackage`, the part cells and the pins
+ *       of the package views into flat arrays with one entry per pin and unit.
+ *       Names and numbers are interned, i.e. stored once per package.
+ *       Homogeneous packages, i.e. with a single view, share the view between
+ *       all devices. Heterogeneous packages have one unit per part cell.
+ */
+class PinTable
+{
+public:
+    static constexpr uint8_t NoGroup = UINT8_MAX; //!< Pin is not part of a swap group
+
+    PinTable()
+        : mPackage{},
+          mUnitCtr{0U},
+          mUnits{},
+          mPositions{},
+          mNumbers{},
+          mNames{},
+          mGroups{},
+          mIgnores{},
+          mPortTypes{},
+          mStrings{},
+          mStrIdx{},
+          mPinByPosition{},
+          mPinByNumber{},
+          mPinByName{}
+    {
+    }
+
+    explicit PinTable(const StreamPackage& aPackage);
+
+    /**
+     * @brief Normal and convert view of a unit, the convert view is optional.
+     */
+    struct UnitViews
+    {
+        const StructLibraryPart* normalView;
+        const StructLibraryPart* convertView;
+    };
+
+    /**
+     * @brief Views of the package in unit order, i.e. index 0 belongs to unit 1.
+     *
+     * @note Homogeneous packages return a single entry that is shared by all units.
+     */
+    static std::vector<UnitViews> getUnitViews(const StreamPackage& aPackage);
+
+    const std::string& getPackage() const
+    {
+        return mPackage;
+    }
+
+    std::size_t getUnitCtr() const
+    {
+        return mUnitCtr;
+    }
+
+    std::size_t getPinCtr() const
+    {
+        return mUnits.size();
+    }
+
+    /**
+     * @brief Pin at the given position of the view of a unit.
+     *
+     * @param aUnit Unit index, starting at 0.
+     */
+    std::optional<std::size_t> findPin(std::size_t aUnit, std::size_t aPosition) const;
+
+    /**
+     * @brief Pin with the given number.
+     *
+     * @note Pins that are shared between units have the same number, in this
+     *       case the first one that is not ignored is returned.
+     */
+    std::optional<std::size_t> findPinByNumber(const std::string& aNumber) const;
+
+    /**
+     * @brief Pin with the given name in a unit, the first one if the name is used multiple times.
+     *
+     * @param aUnit Unit index, starting at 0.
+     */
+    std::optional<std::size_t> findPinByName(std::size_t aUnit, const std::string& aName) const;
+
+    std::size_t getUnit(std::size_t aPin) const
+    {
+        return mUnits.at(aPin);
+    }
+
+    std::size_t getPosition(std::size_t aPin) const
+    {
+        return mPositions.at(aPin);
+    }
+
+    /**
+     * @return const std::string& Pin number, empty if the device does not map the pin.
+     */
+    const std::string& getNumber(std::size_t aPin) const
+    {
+        return mStrings.at(mNumbers.at(aPin));
+    }
+
+    const std::string& getName(std::size_t aPin) const
+    {
+        return mStrings.at(mNames.at(aPin));
+    }
+
+    uint8_t getGroup(std::size_t aPin) const
+    {
+        return mGroups.at(aPin);
+    }
+
+    bool isIgnored(std::size_t aPin) const
+    {
+        return mIgnores.at(aPin);
+    }
+
+    PortType getPortType(std::size_t aPin) const
+    {
+        return mPortTypes.at(aPin);
+    }
+
+private:
+    uint32_t intern(const std::string& aStr);
+
+    std::string mPackage;
+
+    std::size_t mUnitCtr;
+
+    // Pin index -> property
+    std::vector<uint16_t> mUnits;
+    std::vector<uint16_t> mPositions; //!< Position of the pin in the view
+    std::vector<uint32_t> mNumbers;   //!< Index into `mStrings`
+    std::vector<uint32_t> mNames;     //!< Index into `mStrings`
+    std::vector<uint8_t> mGroups;
+    std::vector<bool> mIgnores;
+    std::vector<PortType> mPortTypes;
+
+    std::vector<std::string> mStrings; //!< Interned names and numbers, index 0 is the empty string
+    std::unordered_map<std::string, uint32_t> mStrIdx;
+
+    std::unordered_map<uint32_t, uint32_t> mPinByPosition; //!< Unit and position packed into 16 bit each -> pin
+    std::unordered_map<uint32_t, uint32_t> mPinByNumber;   //!< Number -> pin
+    std::unordered_map<uint64_t, uint32_t> mPinByName;     //!< Unit and name packed into 32 bit each -> pin
+};
+
+/**
+ * @brief Build the pin tables of all packages of a parsed library or design cache.
+ *
+ * @note Packages are processed in parallel with the number of threads configured in `ParserConfig`.
+ *
+ * @param aCtx Context of the parsed library.
+ * @return std::unordered_map<std::string, PinTable> Package name -> pin table.
+ */
+std::unordered_map<std::string, PinTable> buildPinTables(ContainerContext& aCtx);
+
+[[maybe_unused]]
+static std::string to_string(const PinTable& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}package = {}\n", indent(1), aObj.getPackage());
+    str += fmt::format("{}unitCtr = {}\n", indent(1), aObj.getUnitCtr());
+
+    str += fmt::format("{}pins:\n", indent(1));
+    for(std::size_t i = 0U; i < aObj.getPinCtr(); ++i)
+    {
+        str += indent(fmt::format("[{}]: unit = {}, position = {}, number = {}, name = {}, group = {}, "
+                                  "ignore = {}, portType = {}\n",
+                          i, aObj.getUnit(i), aObj.getPosition(i), aObj.getNumber(i), aObj.getName(i),
+                          aObj.getGroup(i), aObj.isIgnored(i), to_string(aObj.getPortType(i))),
+            2);
+    }
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const PinTable& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // PINTABLE_HPP
@@ -1,4 +1,6 @@
+#include <cmath>
 #include <cstdint>
+#include <numbers>
 #include <ostream>
 #include <string>
 
@@ -10,6 +12,49 @@
 #include "GenericParser.hpp"
 #include "Primitives/PrimArc.hpp"
 
+namespace
+{
+// Parametric angle of a point on the ellipse in [0, 2 * pi)
+double getEllipseAngle(double aX, double aY, double aCenterX, double aCenterY, double aRadiusX, double aRadiusY)
+{
+    const double nx = aRadiusX > 0.0 ? (aX - aCenterX) / aRadiusX : 0.0;
+    const double ny = aRadiusY > 0.0 ? (aCenterY - aY) / aRadiusY : 0.0;
+
+    double angle = std::atan2(ny, nx);
+
+    if(angle < 0.0)
+    {
+        angle += 2.0 * std::numbers::pi;
+    }
+
+    return angle;
+}
+} // namespace
+
+OOCP::PrimArc::EllipticArc OOCP::PrimArc::getEllipticArc() const
+{
+    EllipticArc arc{};
+
+    arc.centerX = (x1 + x2) / 2.0;
+    arc.centerY = (y1 + y2) / 2.0;
+    arc.radiusX = std::abs(x2 - x1) / 2.0;
+    arc.radiusY = std::abs(y2 - y1) / 2.0;
+
+    arc.startAngle = getEllipseAngle(startX, startY, arc.centerX, arc.centerY, arc.radiusX, arc.radiusY);
+
+    const double endAngle = getEllipseAngle(endX, endY, arc.centerX, arc.centerY, arc.radiusX, arc.radiusY);
+
+    arc.sweep = endAngle - arc.startAngle;
+
+    if(arc.sweep <= 0.0)
+    {
+        // Start equals end represents a full ellipse
+        arc.sweep += 2.0 * std::numbers::pi;
+    }
+
+    return arc;
+}
+
 size_t OOCP::PrimArc::getExpectedStructSize(FileFormatVersion aVersion)
 {
     size_t expectedByteLength;
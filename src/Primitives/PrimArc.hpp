@@ -51,6 +51,25 @@ public:
 
     static size_t getExpectedStructSize(FileFormatVersion aVersion);
 
+    /**
+     * @brief Parametric form of the elliptic arc.
+     *
+     * @note Angles are counterclockwise as seen on the page, i.e. with the
+     *       Y-axis pointing downwards. The arc is drawn from its start to its
+     *       end point, both at the same location represent a full ellipse.
+     */
+    struct EllipticArc
+    {
+        double centerX;
+        double centerY;
+        double radiusX;
+        double radiusY;
+        double startAngle; //!< Parametric angle of the start point in [0, 2 * pi)
+        double sweep;      //!< Angle from start to end point in (0, 2 * pi]
+    };
+
+    EllipticArc getEllipticArc() const;
+
     void setLineStyle(const LineStyle& aVal)
     {
         mLineStyle = std::make_optional<LineStyle>(aVal);
@@ -2,17 +2,20 @@
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <optional>
 #include <ostream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <fmt/core.h>
 #include <nameof.hpp>
 #include <spdlog/spdlog.h>
 
+#include "ContentHash.hpp"
 #include "General.hpp"
 #include "GenericParser.hpp"
 #include "Primitives/PrimBitmap.hpp"
@@ -58,22 +61,36 @@ void OOCP::PrimBitmap::read(FileFormatVersion /* aVersion */)
 
     mCtx.mLogger.trace("dataSize = {}", dataSize);
 
+    imgDataOffset = ds.getCurrentOffset();
+    imgDataSize   = dataSize;
+
     rawImgData.clear();
-    rawImgData.reserve(dataSize);
 
-    for(size_t i = 0U; i < dataSize; ++i)
+    // Lazy images only record their location, the data is neither copied nor hashed
+    if(!mCtx.mCfg.mLoadImages && !mCtx.mCfg.mExtractImages)
     {
-        rawImgData.push_back(ds.readUint8());
+        ds.discardBytes(dataSize);
     }
+    else
+    {
+        std::vector<uint8_t> imgData = ds.readBytes(dataSize);
 
-    fs::path filename = mCtx.mExtractedCfbfPath.parent_path() / "data" /
-                        fmt::format("{}_img_{}.bmp", mCtx.mInputStream.stem().string(), mCtx.mImgCtr);
+        ContentHash hash{};
+        hash.add(imgData.data(), imgData.size());
 
-    filename = writeImgToFile(filename);
+        blobHash = hash.getHash();
 
-    mCtx.mLogger.info("{}: Wrote bitmap file to {}", __func__, filename.string());
+        mCtx.mLogger.trace("blobHash = {}", hash.to_string());
 
-    ++mCtx.mImgCtr;
+        // Images are written after parsing s.t. the parser does not wait for file I/O
+        mCtx.mBlobRefs.push_back(
+            BlobRef{BlobKind::Image, imgDataOffset, imgDataSize, blobHash, getImgFileExtension(imgData)});
+
+        if(mCtx.mCfg.mLoadImages)
+        {
+            rawImgData = std::move(imgData);
+        }
+    }
 
     if(ds.getCurrentOffset() != startOffset + byteLength)
     {
@@ -91,22 +108,8 @@ void OOCP::PrimBitmap::read(FileFormatVersion /* aVersion */)
     mCtx.mLogger.trace(to_string());
 }
 
-// Returns path to the written image file
-fs::path OOCP::PrimBitmap::writeBmpFile(fs::path aFilePath, const std::vector<uint8_t>& aRawImgData) const
+std::vector<uint8_t> OOCP::PrimBitmap::getBmpFileData(const std::vector<uint8_t>& aRawImgData)
 {
-    aFilePath.replace_extension(".bmp");
-
-    fs::create_directories(aFilePath.parent_path());
-    std::ofstream img{aFilePath, std::ios::out | std::ios::binary};
-
-    if(!img)
-    {
-        const std::string msg = fmt::format("{}: Can not open file for writing: {}", __func__, aFilePath.string());
-
-        mCtx.mLogger.error(msg);
-        throw std::runtime_error(msg);
-    }
-
     // Reconstruct header information that was not stored in the file container
     // See https://en.wikipedia.org/wiki/BMP_file_format#Bitmap_file_header
     // for further details on the meaning of each configuration value.
@@ -124,36 +127,59 @@ fs::path OOCP::PrimBitmap::writeBmpFile(fs::path aFilePath, const std::vector<ui
 
     header.bmpSize = aRawImgData.size() + headerSize;
 
-    // Start writing the file
-    img.write(reinterpret_cast<const char*>(&header.magicBytes), sizeof(header.magicBytes));
-    img.write(reinterpret_cast<const char*>(&header.bmpSize), sizeof(header.bmpSize));
-    img.write(reinterpret_cast<const char*>(&header.reserved), sizeof(header.reserved));
-    img.write(reinterpret_cast<const char*>(&header.offset), sizeof(header.offset));
+    std::vector<uint8_t> data;
+    data.reserve(header.bmpSize);
+
+    const auto append = [&data](const auto& aVal)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&aVal);
+        data.insert(data.end(), bytes, bytes + sizeof(aVal));
+    };
+
+    append(header.magicBytes);
+    append(header.bmpSize);
+    append(header.reserved);
+    append(header.offset);
+
+    data.insert(data.end(), aRawImgData.begin(), aRawImgData.end());
+
+    return data;
+}
+
+// Returns path to the written image file
+fs::path OOCP::PrimBitmap::writeBmpFile(fs::path aFilePath, const std::vector<uint8_t>& aRawImgData) const
+{
+    aFilePath.replace_extension(".bmp");
 
-    mCtx.mLogger.debug("Writing header is done");
+    fs::create_directories(aFilePath.parent_path());
+    std::ofstream img{aFilePath, std::ios::out | std::ios::binary};
 
-    for(const auto& data : aRawImgData)
+    if(!img)
     {
-        img.write(reinterpret_cast<const char*>(&data), sizeof(data));
+        const std::string msg = fmt::format("{}: Can not open file for writing: {}", __func__, aFilePath.string());
+
+        mCtx.mLogger.error(msg);
+        throw std::runtime_error(msg);
     }
 
+    const std::vector<uint8_t> bmpFileData = getBmpFileData(aRawImgData);
+
+    img.write(reinterpret_cast<const char*>(bmpFileData.data()), bmpFileData.size());
+
     img.close();
 
     return aFilePath;
 }
 
-// aFilePath is the requested path to the image file, but the function will change the file
-// extension, depending on the corresponding file type that was found.
-// Returns path to the actually written image file
-fs::path OOCP::PrimBitmap::writeDifferentImageFile(fs::path aFilePath, const std::vector<uint8_t>& aRawImgData) const
-{
-    // Discard the header for non BMP images. After that, they start
-    // with a complete image, e.g. PNG or JPG
-    const size_t startOffset = 0xbb;
+// Discard the header for non BMP images. After that, they start
+// with a complete image, e.g. PNG or JPG
+static constexpr size_t IMG_HEADER_LEN = 0xbb;
 
-    if(startOffset >= aRawImgData.size())
+std::string OOCP::PrimBitmap::getImgFileExtension(const std::vector<uint8_t>& aRawImgData)
+{
+    if(isBmpImage(aRawImgData))
     {
-        throw std::runtime_error("Invalid function usage");
+        return ".bmp";
     }
 
     struct ImageFileType
@@ -171,33 +197,94 @@ fs::path OOCP::PrimBitmap::writeDifferentImageFile(fs::path aFilePath, const std
         {"PNG", ".png", {0x89, 0x50, 0x4e, 0x47}}
     };
 
-    std::optional<ImageFileType> foundFileType;
-
     for(const auto& fileType : fileTypes)
     {
-        size_t minCmpLen = std::min(fileType.magicBytes.size(), aRawImgData.size() - startOffset);
-
-        if(minCmpLen < fileType.magicBytes.size())
+        if(aRawImgData.size() - IMG_HEADER_LEN < fileType.magicBytes.size())
         {
             continue;
         }
 
-        bool isType = 0 == std::memcmp(fileType.magicBytes.data(), aRawImgData.data() + startOffset, minCmpLen);
+        const bool isType = 0 == std::memcmp(fileType.magicBytes.data(), aRawImgData.data() + IMG_HEADER_LEN,
+                                     fileType.magicBytes.size());
 
         if(isType)
         {
-            foundFileType = fileType;
-            break;
+            return fileType.extension;
         }
     }
 
-    if(foundFileType.has_value())
+    return ".unknown";
+}
+
+std::vector<uint8_t> OOCP::PrimBitmap::getImgFileData(const std::vector<uint8_t>& aRawImgData)
+{
+    if(isBmpImage(aRawImgData))
     {
-        aFilePath.replace_extension(foundFileType.value().extension);
+        return getBmpFileData(aRawImgData);
     }
-    else
+
+    return std::vector<uint8_t>{aRawImgData.cbegin() + IMG_HEADER_LEN, aRawImgData.cend()};
+}
+
+std::vector<uint8_t> OOCP::PrimBitmap::loadImgData() const
+{
+    if(rawImgData.size() == imgDataSize)
+    {
+        return rawImgData;
+    }
+
+    std::ifstream is{mCtx.mInputStream, std::ios::in | std::ios::binary};
+
+    if(!is)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Can not open file for reading: {}", __func__, mCtx.mInputStream.string()));
+    }
+
+    std::vector<uint8_t> data(imgDataSize);
+
+    is.seekg(static_cast<std::streamoff>(imgDataOffset));
+    is.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    if(static_cast<std::size_t>(is.gcount()) != data.size())
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Image data at offset {} is out of range in {}", __func__, imgDataOffset,
+                mCtx.mInputStream.string()));
+    }
+
+    return data;
+}
+
+uint64_t OOCP::PrimBitmap::getBlobHash() const
+{
+    if(blobHash != 0U || imgDataSize == 0U)
+    {
+        return blobHash;
+    }
+
+    const std::vector<uint8_t> imgData = loadImgData();
+
+    ContentHash hash{};
+    hash.add(imgData.data(), imgData.size());
+
+    return hash.getHash();
+}
+
+// aFilePath is the requested path to the image file, but the function will change the file
+// extension, depending on the corresponding file type that was found.
+// Returns path to the actually written image file
+fs::path OOCP::PrimBitmap::writeDifferentImageFile(fs::path aFilePath, const std::vector<uint8_t>& aRawImgData) const
+{
+    if(IMG_HEADER_LEN >= aRawImgData.size())
+    {
+        throw std::runtime_error("Invalid function usage");
+    }
+
+    aFilePath.replace_extension(getImgFileExtension(aRawImgData));
+
+    if(aFilePath.extension() == ".unknown")
     {
-        aFilePath.replace_extension(".unknown");
         mCtx.mLogger.warn("Unknown image file format");
     }
 
@@ -212,7 +299,9 @@ fs::path OOCP::PrimBitmap::writeDifferentImageFile(fs::path aFilePath, const std
         throw std::runtime_error(msg);
     }
 
-    img.write(reinterpret_cast<const char*>(aRawImgData.data() + startOffset), aRawImgData.size() - startOffset);
+    const std::vector<uint8_t> imgFileData = getImgFileData(aRawImgData);
+
+    img.write(reinterpret_cast<const char*>(imgFileData.data()), imgFileData.size());
 
     img.close();
 
@@ -222,7 +311,7 @@ fs::path OOCP::PrimBitmap::writeDifferentImageFile(fs::path aFilePath, const std
 // The images are not always bitmaps where we need to prepend its header
 // but its also possible that they are PNG, JPG and probably other formats
 // that have some header that needs to be trimmed away.
-bool OOCP::PrimBitmap::isBmpImage(const std::vector<uint8_t>& aRawImgData) const
+bool OOCP::PrimBitmap::isBmpImage(const std::vector<uint8_t>& aRawImgData)
 {
     bool hasMagicId = false;
 
@@ -232,7 +321,7 @@ bool OOCP::PrimBitmap::isBmpImage(const std::vector<uint8_t>& aRawImgData) const
     const size_t MAGIC_ID_OFFSET          = 0xaa;
     const std::array<uint8_t, 8> MAGIC_ID = {'C', 'I', '_', 'I', 'M', 'A', 'G', 'E'};
 
-    if(aRawImgData.size() >= 0xbb)
+    if(aRawImgData.size() >= IMG_HEADER_LEN)
     {
         hasMagicId = 0 == std::memcmp(MAGIC_ID.data(), aRawImgData.data() + MAGIC_ID_OFFSET,
                               std::min(MAGIC_ID.size(), aRawImgData.size() - MAGIC_ID_OFFSET));
@@ -249,18 +338,20 @@ fs::path OOCP::PrimBitmap::writeImgToFile(fs::path aFilePath) const
     //       to discard. It would be nice seeing a bitmap image that is
     //       provided with the long header to support this theory. Then
     //       we can simplify this logic by just checking the file format version.
-    if(isBmpImage(rawImgData))
+    const std::vector<uint8_t> imgData = loadImgData();
+
+    if(isBmpImage(imgData))
     {
         mCtx.mLogger.info("{}: Detected BMP file", getMethodName(this, __func__));
 
-        aFilePath = writeBmpFile(aFilePath, rawImgData);
+        aFilePath = writeBmpFile(aFilePath, imgData);
     }
     else
     {
         mCtx.mLogger.info("{}: Detected some non BMP file", getMethodName(this, __func__));
 
-        aFilePath = writeDifferentImageFile(aFilePath, rawImgData);
+        aFilePath = writeDifferentImageFile(aFilePath, imgData);
     }
 
     return aFilePath;
-}
\ No newline at end of file
+}
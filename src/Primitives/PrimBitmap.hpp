@@ -5,6 +5,7 @@
 #include <filesystem>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include <fmt/core.h>
 #include <nameof.hpp>
@@ -28,7 +29,11 @@ public:
           x2{0},
           y2{0},
           bmpWidth{0},
-          bmpHeight{0}
+          bmpHeight{0},
+          imgDataOffset{0U},
+          imgDataSize{0U},
+          blobHash{0U},
+          rawImgData{}
     {
     }
 
@@ -46,9 +51,40 @@ public:
         return Primitive::Bitmap;
     }
 
+    /**
+     * @brief Prepend the bitmap file header that is not stored in the container.
+     *
+     * @param aRawImgData Raw BMP image data without file header.
+     * @return std::vector<uint8_t> Content of a BMP file.
+     */
+    static std::vector<uint8_t> getBmpFileData(const std::vector<uint8_t>& aRawImgData);
+
+    /**
+     * @brief File extension of the image type, e.g. `.bmp` or `.png`, `.unknown` for unknown types.
+     */
+    static std::string getImgFileExtension(const std::vector<uint8_t>& aRawImgData);
+
+    /**
+     * @brief Content of the image file, i.e. BMP data with prepended header or other formats without their header.
+     */
+    static std::vector<uint8_t> getImgFileData(const std::vector<uint8_t>& aRawImgData);
+
+    static bool isBmpImage(const std::vector<uint8_t>& aRawImgData);
+
+    /**
+     * @brief Raw image data, read from the stream file if it was not loaded during parsing.
+     *
+     * @note Requires the extracted stream file if `ParserConfig::mLoadImages` was disabled.
+     */
+    std::vector<uint8_t> loadImgData() const;
+
+    /**
+     * @brief Content hash of the raw image data, computed from the stream file if it was not loaded during parsing.
+     */
+    uint64_t getBlobHash() const;
+
     fs::path writeBmpFile(fs::path aFilePath, const std::vector<uint8_t>& aRawImgData) const;
     fs::path writeDifferentImageFile(fs::path aFilePath, const std::vector<uint8_t>& aRawImgData) const;
-    bool isBmpImage(const std::vector<uint8_t>& aRawImgData) const;
 
     fs::path writeImgToFile(fs::path aFilePath) const;
 
@@ -63,10 +99,16 @@ public:
     uint32_t bmpWidth;
     uint32_t bmpHeight;
 
+    size_t imgDataOffset; //!< Offset of the raw image data inside the stream
+    uint32_t imgDataSize;
+    // Content hash of the raw image data, 0 if images are neither
+    // loaded nor extracted. Use `getBlobHash` to compute it lazily.
+    uint64_t blobHash;
+
     // @note Looks like the XSD uses Base64 encoding for the data, but I was not
     //       able to extract the correct content from there. Are there some parameters
     //       to adjust in the decoding? https://cryptii.com/pipes/base64-to-binary
-    std::vector<uint8_t> rawImgData; // @todo called val in the XSD file
+    std::vector<uint8_t> rawImgData; // @todo called val in the XSD file, empty if images are not loaded
 };
 
 [[maybe_unused]]
@@ -83,6 +125,9 @@ static std::string to_string(const PrimBitmap& aObj)
     str += fmt::format("{}y2   = {}\n", indent(1), aObj.y2);
     str += fmt::format("{}bmpWidth  = {}\n", indent(1), aObj.bmpWidth);
     str += fmt::format("{}bmpHeight = {}\n", indent(1), aObj.bmpHeight);
+    str += fmt::format("{}imgDataOffset = {}\n", indent(1), aObj.imgDataOffset);
+    str += fmt::format("{}imgDataSize   = {}\n", indent(1), aObj.imgDataSize);
+    str += fmt::format("{}blobHash      = {:016x}\n", indent(1), aObj.blobHash);
 
     // @todo Should we print rawImgData somehow? As ASCII image?
 
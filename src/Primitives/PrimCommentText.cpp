@@ -52,6 +52,8 @@ void OOCP::PrimCommentText::read(FileFormatVersion /* aVersion */)
     mCtx.mLogger.trace("y1 = {}", y1);
 
     // @todo Check if fontIdx with 4 byte fits. I.e. are the following 2 Byte all 0?
+    mCtx.mFontIdxRefs.push_back(FontIdxRef{ds.getCurrentOffset(), 0xffff});
+
     textFontIdx = ds.readUint16();
 
     mCtx.mLogger.trace("textFontIdx = {}", textFontIdx);
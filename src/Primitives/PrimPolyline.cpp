@@ -39,6 +39,9 @@ void OOCP::PrimPolyline::read(FileFormatVersion aVersion)
         aVersion                  = parser.predictVersion(predictionFunc);
     }
 
+    // Failed attempts of the version prediction already added points
+    points.clear();
+
     const size_t startOffset = ds.getCurrentOffset();
 
     const uint32_t byteLength = ds.readUint32();
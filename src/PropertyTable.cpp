@@ -0,0 +1,275 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "Database.hpp"
+#include "Enums/ImplementationType.hpp"
+#include "GetStreamHelper.hpp"
+#include "PropertyTable.hpp"
+#include "Streams/StreamLibrary.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Structures/StructGeneralProperties.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+
+OOCP::PropertyTable::PropertyTable(ContainerContext& aCtx)
+    : mObjectStreams{},
+      mObjectSources{},
+      mObjectStructures{},
+      mObjectOffsets{},
+      mObjectNames{},
+      mObjectRows{},
+      mRowObjects{},
+      mRowKeys{},
+      mRowValues{},
+      mStrings{},
+      mStrIdx{},
+      mObjectByOffset{},
+      mRowByObjectKey{},
+      mRowsByKey{}
+{
+    intern(std::string{});
+
+    const auto lib = getLibraryStreamFromDb(aCtx.mDb);
+
+    std::size_t unresolvedCtr = 0U;
+
+    for(const auto& stream : aCtx.mDb.mStreams)
+    {
+        if(!stream)
+        {
+            continue;
+        }
+
+        const std::string streamLocation = to_string(stream->mCtx.mCfbfStreamLocation);
+
+        std::optional<std::size_t> lastOffset;
+        uint32_t object = 0U;
+
+        for(const auto& mapping : stream->mCtx.mNameValueMappings)
+        {
+            if(!lib || mapping.nameIdx >= lib->strLst.size() || mapping.valueIdx >= lib->strLst.size())
+            {
+                ++unresolvedCtr;
+                continue;
+            }
+
+            // Mappings of the same structure are stored consecutively
+            if(lastOffset != mapping.offset)
+            {
+                object = addObject(streamLocation, PropertySource::NameValue, mapping.structure, mapping.offset, {});
+
+                lastOffset = mapping.offset;
+            }
+
+            addRow(object, lib->strLst[mapping.nameIdx], lib->strLst[mapping.valueIdx]);
+        }
+
+        const auto package = std::dynamic_pointer_cast<StreamPackage>(stream);
+
+        if(!package)
+        {
+            continue;
+        }
+
+        if(package->package)
+        {
+            const StructPackage& pkg = *package->package;
+
+            const uint32_t pkgObject =
+                addObject(streamLocation, PropertySource::Package, Structure::Package, NoOffset, pkg.name);
+
+            addRow(pkgObject, "PCB Footprint", pkg.pcbFootprint);
+            addRow(pkgObject, "Part Reference Prefix", pkg.refDes);
+        }
+
+        for(const auto& libraryPart : package->libraryParts)
+        {
+            if(!libraryPart)
+            {
+                continue;
+            }
+
+            const auto& props = libraryPart->generalProperties;
+
+            const uint32_t viewObject = addObject(
+                streamLocation, PropertySource::GeneralProperties, Structure::LibraryPart, NoOffset, libraryPart->name);
+
+            addRow(viewObject, "Implementation Path", props.implementationPath);
+            addRow(viewObject, "Implementation", props.implementation);
+            addRow(viewObject, "Part Reference Prefix", props.refDes);
+            addRow(viewObject, "Value", props.partValue);
+
+            if(props.implementationType != ImplementationType::None)
+            {
+                addRow(viewObject, "Implementation Type", to_string(props.implementationType));
+            }
+        }
+    }
+
+    if(unresolvedCtr > 0U)
+    {
+        aCtx.mLogger.warn("{}: {} name/value mappings could not be resolved against the string list", __func__,
+            unresolvedCtr);
+    }
+
+    aCtx.mLogger.info("Built property table with {} rows of {} objects", getRowCtr(), getObjectCtr());
+}
+
+uint32_t OOCP::PropertyTable::intern(const std::string& aStr)
+{
+    const auto [it, isNew] = mStrIdx.emplace(aStr, static_cast<uint32_t>(mStrings.size()));
+
+    if(isNew)
+    {
+        mStrings.push_back(aStr);
+    }
+
+    return it->second;
+}
+
+uint32_t OOCP::PropertyTable::addObject(const std::string& aStreamLocation, PropertySource aSource,
+    Structure aStructure, std::size_t aOffset, const std::string& aName)
+{
+    const uint32_t object = static_cast<uint32_t>(mObjectStreams.size());
+    const uint32_t stream = intern(aStreamLocation);
+
+    mObjectStreams.push_back(stream);
+    mObjectSources.push_back(aSource);
+    mObjectStructures.push_back(aStructure);
+    mObjectOffsets.push_back(aOffset);
+    mObjectNames.push_back(intern(aName));
+    mObjectRows.push_back(static_cast<uint32_t>(mRowObjects.size()));
+
+    if(aOffset != NoOffset)
+    {
+        if(aOffset > UINT32_MAX)
+        {
+            throw std::runtime_error(
+                fmt::format("{}: Offset {} is out of range in {}", __func__, aOffset, aStreamLocation));
+        }
+
+        mObjectByOffset.emplace(static_cast<uint64_t>(stream) << 32U | aOffset, object);
+    }
+
+    return object;
+}
+
+void OOCP::PropertyTable::addRow(uint32_t aObject, const std::string& aKey, const std::string& aValue)
+{
+    if(aValue.empty())
+    {
+        return;
+    }
+
+    const uint32_t row = static_cast<uint32_t>(mRowObjects.size());
+    const uint32_t key = intern(aKey);
+
+    mRowObjects.push_back(aObject);
+    mRowKeys.push_back(key);
+    mRowValues.push_back(intern(aValue));
+
+    mRowByObjectKey.emplace(static_cast<uint64_t>(aObject) << 32U | key, row);
+    mRowsByKey[key].push_back(row);
+}
+
+std::optional<std::size_t> OOCP::PropertyTable::findObject(
+    const std::string& aStreamLocation, std::size_t aOffset) const
+{
+    const auto strIt = mStrIdx.find(aStreamLocation);
+
+    if(strIt == mStrIdx.cend() || aOffset > UINT32_MAX)
+    {
+        return std::nullopt;
+    }
+
+    const auto it = mObjectByOffset.find(static_cast<uint64_t>(strIt->second) << 32U | aOffset);
+
+    if(it == mObjectByOffset.cend())
+    {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::optional<std::string> OOCP::PropertyTable::findValue(std::size_t aObject, const std::string& aKey) const
+{
+    const auto strIt = mStrIdx.find(aKey);
+
+    if(strIt == mStrIdx.cend())
+    {
+        return std::nullopt;
+    }
+
+    const auto it = mRowByObjectKey.find(static_cast<uint64_t>(aObject) << 32U | strIt->second);
+
+    if(it == mRowByObjectKey.cend())
+    {
+        return std::nullopt;
+    }
+
+    return getValue(it->second);
+}
+
+std::vector<std::size_t> OOCP::PropertyTable::getRows(std::size_t aObject) const
+{
+    const std::size_t begin = mObjectRows.at(aObject);
+    const std::size_t end   = aObject + 1U < mObjectRows.size() ? mObjectRows[aObject + 1U] : getRowCtr();
+
+    std::vector<std::size_t> rows(end - begin);
+
+    std::iota(rows.begin(), rows.end(), begin);
+
+    return rows;
+}
+
+std::vector<std::size_t> OOCP::PropertyTable::findRows(const std::string& aKey) const
+{
+    const auto strIt = mStrIdx.find(aKey);
+
+    if(strIt == mStrIdx.cend())
+    {
+        return {};
+    }
+
+    const auto it = mRowsByKey.find(strIt->second);
+
+    if(it == mRowsByKey.cend())
+    {
+        return {};
+    }
+
+    return std::vector<std::size_t>(it->second.cbegin(), it->second.cend());
+}
+
+std::vector<std::size_t> OOCP::PropertyTable::findRows(const std::string& aKey, const std::string& aValue) const
+{
+    const auto valueIt = mStrIdx.find(aValue);
+
+    if(valueIt == mStrIdx.cend())
+    {
+        return {};
+    }
+
+    std::vector<std::size_t> rows;
+
+    for(const std::size_t row : findRows(aKey))
+    {
+        if(mRowValues[row] == valueIt->second)
+        {
+            rows.push_back(row);
+        }
+    }
+
+    return rows;
+}
@@ -0,0 +1,189 @@
+#ifndef PROPERTYTABLE_HPP
+#define PROPERTYTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <magic_enum.hpp>
+#include <nameof.hpp>
+
+#include "ContainerContext.hpp"
+#include "Enums/Structure.hpp"
+#include "General.hpp"
+
+namespace OOCP
+{
+enum class PropertySource
+{
+    NameValue,        //!< Name/value mapping from the short prefix of a structure
+    Package,          //!< Field of `StructPackage`, e.g. the PCB footprint
+    GeneralProperties //!< Field of `StructGeneralProperties` of a package view
+};
+
+[[maybe_unused]]
+static std::string to_string(const PropertySource& aVal)
+{
+    return std::string{magic_enum::enum_name<decltype(aVal)>(aVal)};
+}
+
+/**
+ * @brief Columnar table of all properties of a parsed library or design, one row per (object, key, value).
+ *
+ * @note Keys and values of name/value mappings are resolved against the string
+ *       list of the `Library` stream. All strings are interned, i.e. each row
+ *       only stores indices. Objects are identified by their stream and by the
+ *       offset of their short prefix inside the stream. Package properties use
+ *       the package or view name instead, as they are not mapped.
+ */
+class PropertyTable
+{
+public:
+    static constexpr std::size_t NoOffset = SIZE_MAX; //!< Object is not identified by an offset
+
+    explicit PropertyTable(ContainerContext& aCtx);
+
+    std::size_t getObjectCtr() const
+    {
+        return mObjectStreams.size();
+    }
+
+    std::size_t getRowCtr() const
+    {
+        return mRowObjects.size();
+    }
+
+    /**
+     * @brief Object of a name/value mapping.
+     *
+     * @param aStreamLocation Location of the stream inside the CFBF container.
+     * @param aOffset Offset of the short prefix of the structure inside the stream.
+     */
+    std::optional<std::size_t> findObject(const std::string& aStreamLocation, std::size_t aOffset) const;
+
+    /**
+     * @brief Value of a property of an object, the first one if the key is used multiple times.
+     */
+    std::optional<std::string> findValue(std::size_t aObject, const std::string& aKey) const;
+
+    /**
+     * @brief All rows of an object, in table order.
+     */
+    std::vector<std::size_t> getRows(std::size_t aObject) const;
+
+    /**
+     * @brief All rows with the given key, in table order.
+     */
+    std::vector<std::size_t> findRows(const std::string& aKey) const;
+
+    /**
+     * @brief All rows with the given key and value, in table order.
+     */
+    std::vector<std::size_t> findRows(const std::string& aKey, const std::string& aValue) const;
+
+    std::size_t getObject(std::size_t aRow) const
+    {
+        return mRowObjects.at(aRow);
+    }
+
+    const std::string& getKey(std::size_t aRow) const
+    {
+        return mStrings.at(mRowKeys.at(aRow));
+    }
+
+    const std::string& getValue(std::size_t aRow) const
+    {
+        return mStrings.at(mRowValues.at(aRow));
+    }
+
+    const std::string& getStreamLocation(std::size_t aObject) const
+    {
+        return mStrings.at(mObjectStreams.at(aObject));
+    }
+
+    PropertySource getSource(std::size_t aObject) const
+    {
+        return mObjectSources.at(aObject);
+    }
+
+    Structure getStructure(std::size_t aObject) const
+    {
+        return mObjectStructures.at(aObject);
+    }
+
+    std::size_t getOffset(std::size_t aObject) const
+    {
+        return mObjectOffsets.at(aObject);
+    }
+
+    /**
+     * @return const std::string& Package or view name, empty for name/value mappings.
+     */
+    const std::string& getName(std::size_t aObject) const
+    {
+        return mStrings.at(mObjectNames.at(aObject));
+    }
+
+private:
+    uint32_t intern(const std::string& aStr);
+
+    uint32_t addObject(const std::string& aStreamLocation, PropertySource aSource, Structure aStructure,
+        std::size_t aOffset, const std::string& aName);
+
+    void addRow(uint32_t aObject, const std::string& aKey, const std::string& aValue);
+
+    // Object index -> property
+    std::vector<uint32_t> mObjectStreams; //!< Index into `mStrings`
+    std::vector<PropertySource> mObjectSources;
+    std::vector<Structure> mObjectStructures;
+    std::vector<std::size_t> mObjectOffsets;
+    std::vector<uint32_t> mObjectNames; //!< Index into `mStrings`
+    std::vector<uint32_t> mObjectRows;  //!< First row, rows of an object are consecutive
+
+    // Row index -> property
+    std::vector<uint32_t> mRowObjects;
+    std::vector<uint32_t> mRowKeys;   //!< Index into `mStrings`
+    std::vector<uint32_t> mRowValues; //!< Index into `mStrings`
+
+    std::vector<std::string> mStrings;
+    std::unordered_map<std::string, uint32_t> mStrIdx;
+
+    std::unordered_map<uint64_t, uint32_t> mObjectByOffset; //!< Stream location and offset packed into 32 bit each
+    std::unordered_map<uint64_t, uint32_t> mRowByObjectKey; //!< Object and key packed into 32 bit each -> row
+    std::unordered_map<uint32_t, std::vector<uint32_t>> mRowsByKey;
+};
+
+[[maybe_unused]]
+static std::string to_string(const PropertyTable& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+
+    for(std::size_t i = 0U; i < aObj.getRowCtr(); ++i)
+    {
+        const std::size_t object = aObj.getObject(i);
+
+        str += indent(fmt::format("[{}]: {} ({}, {}) {} = {}\n", i, aObj.getStreamLocation(object),
+                          to_string(aObj.getStructure(object)), aObj.getName(object), aObj.getKey(i),
+                          aObj.getValue(i)),
+            1);
+    }
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const PropertyTable& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // PROPERTYTABLE_HPP
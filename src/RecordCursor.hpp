@@ -0,0 +1,197 @@
+#ifndef RECORDCURSOR_HPP
+#define RECORDCURSOR_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "StreamContext.hpp"
+
+namespace OOCP
+{
+/**
+ * @brief Pull-based cursor that decodes the records of a stream one at a time.
+ *
+ * @note Only the current record is kept in memory, it is released before the
+ *       next one is decoded. The cursor reads the stream file through its own
+ *       view of the stream context that shares the logger of the stream, i.e.
+ *       the stream object is neither modified nor needs to be parsed beforehand.
+ *       The extracted stream file needs to exist as long as the cursor is advanced.
+ *       References recorded in the context, e.g. `StreamContext::mStrLstRefs`,
+ *       are dropped with each advance.
+ *
+ * @code
+ * for(const auto& wire : page.iterWires())
+ * {
+ *     ...
+ * }
+ * @endcode
+ */
+template <typename T>
+class RecordCursor
+{
+public:
+    /**
+     * @brief Decode the next record into the given storage.
+     *
+     * @note The storage may be left empty for records that were skipped by the parser.
+     *
+     * @return false If there are no more records.
+     */
+    using ReadFunc = std::function<bool(StreamContext&, std::unique_ptr<T>&)>;
+
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = T*;
+        using reference         = T&;
+
+        Iterator()
+            : mCursor{nullptr}
+        {
+        }
+
+        explicit Iterator(RecordCursor* aCursor)
+            : mCursor{aCursor}
+        {
+        }
+
+        T& operator*() const
+        {
+            return *mCursor->mCurrent;
+        }
+
+        T* operator->() const
+        {
+            return mCursor->mCurrent.get();
+        }
+
+        Iterator& operator++()
+        {
+            mCursor->next();
+
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            mCursor->next();
+        }
+
+        bool operator==(std::default_sentinel_t) const
+        {
+            return mCursor == nullptr || mCursor->mDone;
+        }
+
+    private:
+        RecordCursor* mCursor;
+    };
+
+    RecordCursor(std::unique_ptr<StreamContext> aCtx, ReadFunc aReadNext)
+        : mCtx{std::move(aCtx)},
+          mReadNext{std::move(aReadNext)},
+          mCurrent{},
+          mCtr{0U},
+          mDone{false}
+    {
+    }
+
+    RecordCursor(const RecordCursor&) = delete;
+    RecordCursor& operator=(const RecordCursor&) = delete;
+
+    RecordCursor(RecordCursor&&) = default;
+    RecordCursor& operator=(RecordCursor&&) = default;
+
+    /**
+     * @brief Advance to the next record, the previous one is released.
+     *
+     * @return false If all records were visited.
+     */
+    bool next()
+    {
+        mCurrent.reset();
+
+        // References are only required when copying whole streams, drop the
+        // ones of the previous record s.t. memory does not grow with the stream
+        mCtx->resetRefs(StreamRefsMark{});
+
+        while(!mDone && !mCurrent)
+        {
+            mDone = !mReadNext(*mCtx, mCurrent);
+        }
+
+        if(mDone)
+        {
+            return false;
+        }
+
+        ++mCtr;
+
+        return true;
+    }
+
+    /**
+     * @brief Current record, only valid after `next` returned true.
+     */
+    T& get() const
+    {
+        return *mCurrent;
+    }
+
+    /**
+     * @brief Move the current record out of the cursor to keep it beyond the next advance.
+     */
+    std::unique_ptr<T> release()
+    {
+        return std::move(mCurrent);
+    }
+
+    /**
+     * @brief Sizes of the reference lists, they only cover the current record.
+     */
+    StreamRefsMark getRefsMark() const
+    {
+        return mCtx->getRefsMark();
+    }
+
+    /**
+     * @brief Number of records that were visited so far.
+     */
+    std::size_t getCtr() const
+    {
+        return mCtr;
+    }
+
+    Iterator begin()
+    {
+        if(!mCurrent && !mDone)
+        {
+            next();
+        }
+
+        return Iterator{this};
+    }
+
+    std::default_sentinel_t end() const
+    {
+        return std::default_sentinel;
+    }
+
+private:
+    std::unique_ptr<StreamContext> mCtx;
+
+    ReadFunc mReadNext;
+
+    std::unique_ptr<T> mCurrent; //!< Storage of the current record
+
+    std::size_t mCtr;
+
+    bool mDone;
+};
+} // namespace OOCP
+#endif // RECORDCURSOR_HPP
@@ -0,0 +1,700 @@
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <fmt/core.h>
+#include <sqlite3.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "Encoding.hpp"
+#include "Enums/PortType.hpp"
+#include "SqliteExporter.hpp"
+#include "Stream.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Structures/StructAlias.hpp"
+#include "Structures/StructGlobal.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructOffPageConnector.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+#include "Structures/StructSymbolPin.hpp"
+#include "Structures/StructWire.hpp"
+#include "Structures/StructWireBus.hpp"
+
+namespace
+{
+// Maximum number of converted streams waiting for the writer
+constexpr std::size_t QueueCapacity = 256U;
+
+// Rows inserted per transaction
+constexpr std::size_t RowsPerTransaction = 100000U;
+
+constexpr std::string_view SchemaSql = R"(
+CREATE TABLE IF NOT EXISTS libraries (
+    id INTEGER PRIMARY KEY, name TEXT NOT NULL, path TEXT NOT NULL, type TEXT NOT NULL);
+CREATE TABLE IF NOT EXISTS packages (
+    id INTEGER PRIMARY KEY, library_id INTEGER NOT NULL REFERENCES libraries(id), name TEXT NOT NULL,
+    ref_des TEXT, pcb_footprint TEXT);
+CREATE TABLE IF NOT EXISTS parts (
+    id INTEGER PRIMARY KEY, package_id INTEGER NOT NULL REFERENCES packages(id), name TEXT NOT NULL);
+CREATE TABLE IF NOT EXISTS pins (
+    id INTEGER PRIMARY KEY, part_id INTEGER NOT NULL REFERENCES parts(id), position INTEGER NOT NULL,
+    name TEXT, port_type TEXT, start_x INTEGER, start_y INTEGER, hotpt_x INTEGER, hotpt_y INTEGER);
+CREATE TABLE IF NOT EXISTS properties (
+    owner_type TEXT NOT NULL, owner_id INTEGER NOT NULL, name TEXT NOT NULL, value TEXT);
+CREATE TABLE IF NOT EXISTS pages (
+    id INTEGER PRIMARY KEY, library_id INTEGER NOT NULL REFERENCES libraries(id), schematic TEXT,
+    name TEXT NOT NULL, page_size TEXT);
+CREATE TABLE IF NOT EXISTS instances (
+    id INTEGER PRIMARY KEY, page_id INTEGER NOT NULL REFERENCES pages(id), db_id INTEGER, reference TEXT,
+    package TEXT, loc_x INTEGER, loc_y INTEGER, rotation INTEGER, mirrored INTEGER);
+CREATE TABLE IF NOT EXISTS nets (
+    id INTEGER PRIMARY KEY, library_id INTEGER NOT NULL REFERENCES libraries(id), schematic TEXT,
+    name TEXT NOT NULL);
+CREATE TABLE IF NOT EXISTS page_nets (
+    page_id INTEGER NOT NULL REFERENCES pages(id), net_id INTEGER NOT NULL REFERENCES nets(id));
+CREATE TABLE IF NOT EXISTS wires (
+    id INTEGER PRIMARY KEY, page_id INTEGER NOT NULL REFERENCES pages(id), net_id INTEGER REFERENCES nets(id),
+    db_id INTEGER, bus INTEGER, start_x INTEGER, start_y INTEGER, end_x INTEGER, end_y INTEGER);
+)";
+
+// Created after loading, maintaining them during the inserts is considerably slower
+constexpr std::string_view IndexSql = R"(
+CREATE INDEX IF NOT EXISTS packages_library_name ON packages (library_id, name);
+CREATE INDEX IF NOT EXISTS parts_package ON parts (package_id);
+CREATE INDEX IF NOT EXISTS parts_name ON parts (name);
+CREATE INDEX IF NOT EXISTS pins_part ON pins (part_id);
+CREATE INDEX IF NOT EXISTS properties_owner ON properties (owner_type, owner_id);
+CREATE INDEX IF NOT EXISTS properties_name_value ON properties (name, value);
+CREATE INDEX IF NOT EXISTS pages_library ON pages (library_id);
+CREATE INDEX IF NOT EXISTS instances_page ON instances (page_id);
+CREATE INDEX IF NOT EXISTS instances_package ON instances (package);
+CREATE INDEX IF NOT EXISTS nets_library_name ON nets (library_id, schematic, name);
+CREATE INDEX IF NOT EXISTS page_nets_page ON page_nets (page_id);
+CREATE INDEX IF NOT EXISTS page_nets_net ON page_nets (net_id);
+CREATE INDEX IF NOT EXISTS wires_page ON wires (page_id);
+CREATE INDEX IF NOT EXISTS wires_net ON wires (net_id);
+)";
+
+// Dropped before loading into an existing database, they are created again by `end`
+constexpr std::string_view DropIndexSql = R"(
+DROP INDEX IF EXISTS packages_library_name;
+DROP INDEX IF EXISTS parts_package;
+DROP INDEX IF EXISTS parts_name;
+DROP INDEX IF EXISTS pins_part;
+DROP INDEX IF EXISTS properties_owner;
+DROP INDEX IF EXISTS properties_name_value;
+DROP INDEX IF EXISTS pages_library;
+DROP INDEX IF EXISTS instances_page;
+DROP INDEX IF EXISTS instances_package;
+DROP INDEX IF EXISTS nets_library_name;
+DROP INDEX IF EXISTS page_nets_page;
+DROP INDEX IF EXISTS page_nets_net;
+DROP INDEX IF EXISTS wires_page;
+DROP INDEX IF EXISTS wires_net;
+)";
+
+void check(int aRc, sqlite3* aDb, std::string_view aWhat)
+{
+    if(aRc != SQLITE_OK && aRc != SQLITE_DONE && aRc != SQLITE_ROW)
+    {
+        throw std::runtime_error(fmt::format("SqliteExporter: {} failed: {}", aWhat,
+            aDb ? sqlite3_errmsg(aDb) : sqlite3_errstr(aRc)));
+    }
+}
+
+/**
+ * @brief Prepared statement that is reused for all rows.
+ */
+class Statement
+{
+public:
+    Statement(sqlite3* aDb, const char* aSql)
+        : mDb{aDb},
+          mStmt{nullptr}
+    {
+        check(sqlite3_prepare_v3(aDb, aSql, -1, SQLITE_PREPARE_PERSISTENT, &mStmt, nullptr), aDb, aSql);
+    }
+
+    ~Statement()
+    {
+        sqlite3_finalize(mStmt);
+    }
+
+    Statement(const Statement&)            = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    /**
+     * @brief Bind the values in parameter order and execute the statement.
+     *
+     * @return int64_t Row ID of the inserted row.
+     */
+    template <typename... Args> int64_t run(const Args&... aArgs)
+    {
+        int idx = 1;
+
+        (bind(idx++, aArgs), ...);
+
+        const int rc = sqlite3_step(mStmt);
+
+        sqlite3_reset(mStmt);
+
+        check(rc, mDb, sqlite3_sql(mStmt));
+
+        return sqlite3_last_insert_rowid(mDb);
+    }
+
+private:
+    template <typename T> void bind(int aIdx, const T& aVal)
+    {
+        if constexpr(std::is_same_v<T, std::nullptr_t>)
+        {
+            check(sqlite3_bind_null(mStmt, aIdx), mDb, "Bind");
+        }
+        else if constexpr(std::is_arithmetic_v<T>)
+        {
+            check(sqlite3_bind_int64(mStmt, aIdx, static_cast<sqlite3_int64>(aVal)), mDb, "Bind");
+        }
+        else
+        {
+            // Values outlive the statement execution
+            const std::string_view str{aVal};
+
+            check(sqlite3_bind_text(mStmt, aIdx, str.data(), static_cast<int>(str.size()), SQLITE_STATIC), mDb,
+                "Bind");
+        }
+    }
+
+    sqlite3* mDb;
+    sqlite3_stmt* mStmt;
+};
+
+struct PinRow
+{
+    std::size_t position;
+    std::string name;
+    std::string portType;
+    int32_t startX;
+    int32_t startY;
+    int32_t hotptX;
+    int32_t hotptY;
+};
+
+struct PropertyRow
+{
+    std::string name;
+    std::string value;
+};
+
+struct PartRow
+{
+    std::string name;
+    std::vector<PropertyRow> properties;
+    std::vector<PinRow> pins;
+};
+
+struct PackageRow
+{
+    std::string name;
+    std::string refDes;
+    std::string pcbFootprint;
+    std::vector<PartRow> parts;
+};
+
+struct InstanceRow
+{
+    uint32_t dbId;
+    std::string reference;
+    std::string package;
+    int32_t locX;
+    int32_t locY;
+    int32_t rotation;
+    bool mirrored;
+};
+
+struct WireRow
+{
+    uint32_t dbId;
+    bool isBus;
+    int32_t startX;
+    int32_t startY;
+    int32_t endX;
+    int32_t endY;
+    std::string net; //!< Empty if the wire has no alias
+};
+
+struct PageRow
+{
+    std::string schematic;
+    std::string name;
+    std::string pageSize;
+    std::vector<InstanceRow> instances;
+    std::vector<std::string> nets;
+    std::vector<WireRow> wires;
+};
+
+// Strings of OrCAD files are CP1252 encoded, SQLite expects UTF-8 for TEXT values
+PackageRow toPackageRow(const OOCP::StreamPackage& aPackage)
+{
+    PackageRow row{};
+
+    if(aPackage.package)
+    {
+        row.name         = OOCP::cp1252ToUtf8(aPackage.package->name);
+        row.refDes       = OOCP::cp1252ToUtf8(aPackage.package->refDes);
+        row.pcbFootprint = OOCP::cp1252ToUtf8(aPackage.package->pcbFootprint);
+    }
+
+    for(const auto& libraryPart : aPackage.libraryParts)
+    {
+        if(!libraryPart)
+        {
+            continue;
+        }
+
+        const auto& props = libraryPart->generalProperties;
+
+        PartRow part{};
+
+        part.name       = OOCP::cp1252ToUtf8(libraryPart->name);
+        part.properties = {
+            {"Implementation",      OOCP::cp1252ToUtf8(props.implementation)    },
+            {"Implementation Path", OOCP::cp1252ToUtf8(props.implementationPath)},
+            {"Reference",           OOCP::cp1252ToUtf8(props.refDes)            },
+            {"Value",               OOCP::cp1252ToUtf8(props.partValue)         },
+        };
+
+        for(std::size_t i = 0U; i < libraryPart->symbolPins.size(); ++i)
+        {
+            const auto& pin = libraryPart->symbolPins[i];
+
+            if(pin)
+            {
+                part.pins.push_back(PinRow{i, OOCP::cp1252ToUtf8(pin->name), OOCP::to_string(pin->portType),
+                    pin->startX, pin->startY, pin->hotptX, pin->hotptY});
+            }
+        }
+
+        row.parts.push_back(std::move(part));
+    }
+
+    return row;
+}
+
+PageRow toPageRow(const OOCP::StreamPage& aPage)
+{
+    PageRow row{};
+
+    // Location is `Views/<Schematic>/Pages/<Page>`
+    const auto& location = aPage.mCtx.mCfbfStreamLocation.get_vector();
+
+    row.schematic = location.size() > 1U ? location.at(1U) : std::string{};
+    row.name      = OOCP::cp1252ToUtf8(aPage.name);
+    row.pageSize  = OOCP::cp1252ToUtf8(aPage.pageSize);
+
+    for(const auto& inst : aPage.placedInstances)
+    {
+        if(inst)
+        {
+            row.instances.push_back(InstanceRow{inst->dbId, OOCP::cp1252ToUtf8(inst->reference),
+                OOCP::cp1252ToUtf8(inst->pkgName), inst->locX, inst->locY, 90 * static_cast<int32_t>(inst->rotation),
+                inst->mirrored});
+        }
+    }
+
+    // Nets are named by aliases, globals and off-page connectors
+    std::unordered_set<std::string> netNames;
+
+    const auto addNet = [&](const std::string& aName)
+    {
+        if(!aName.empty() && netNames.insert(aName).second)
+        {
+            row.nets.push_back(aName);
+        }
+    };
+
+    for(const auto& wire : aPage.wires)
+    {
+        if(!wire)
+        {
+            continue;
+        }
+
+        std::string net;
+
+        for(const auto& alias : wire->aliases)
+        {
+            if(alias && !alias->name.empty())
+            {
+                net = OOCP::cp1252ToUtf8(alias->name);
+                addNet(net);
+                break;
+            }
+        }
+
+        const bool isBus = dynamic_cast<const OOCP::StructWireBus*>(wire.get()) != nullptr;
+
+        row.wires.push_back(WireRow{wire->id, isBus, wire->startX, wire->startY, wire->endX, wire->endY, net});
+    }
+
+    for(const auto& global : aPage.globals)
+    {
+        if(global)
+        {
+            addNet(OOCP::cp1252ToUtf8(global->name));
+        }
+    }
+
+    for(const auto& offPageConnector : aPage.offPageConnectors)
+    {
+        if(offPageConnector)
+        {
+            addNet(OOCP::cp1252ToUtf8(offPageConnector->name));
+        }
+    }
+
+    return row;
+}
+
+std::string getDatabaseType(const fs::path& aInputFile)
+{
+    std::string extension = aInputFile.extension().string();
+
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+
+    return extension == ".DSN" || extension == ".DBK" ? "Design" : "Library";
+}
+} // namespace
+
+struct OOCP::SqliteExporter::Record
+{
+    std::variant<PackageRow, PageRow> data;
+};
+
+struct OOCP::SqliteExporter::Statements
+{
+    explicit Statements(sqlite3* aDb)
+        : insertLibrary{aDb, "INSERT INTO libraries (name, path, type) VALUES (?, ?, ?)"},
+          insertPackage{aDb, "INSERT INTO packages (library_id, name, ref_des, pcb_footprint) VALUES (?, ?, ?, ?)"},
+          insertPart{aDb, "INSERT INTO parts (package_id, name) VALUES (?, ?)"},
+          insertPin{aDb, "INSERT INTO pins (part_id, position, name, port_type, start_x, start_y, hotpt_x, hotpt_y) "
+                         "VALUES (?, ?, ?, ?, ?, ?, ?, ?)"},
+          insertProperty{aDb, "INSERT INTO properties (owner_type, owner_id, name, value) VALUES (?, ?, ?, ?)"},
+          insertPage{aDb, "INSERT INTO pages (library_id, schematic, name, page_size) VALUES (?, ?, ?, ?)"},
+          insertInstance{aDb, "INSERT INTO instances (page_id, db_id, reference, package, loc_x, loc_y, rotation, "
+                              "mirrored) VALUES (?, ?, ?, ?, ?, ?, ?, ?)"},
+          insertNet{aDb, "INSERT INTO nets (library_id, schematic, name) VALUES (?, ?, ?)"},
+          insertPageNet{aDb, "INSERT INTO page_nets (page_id, net_id) VALUES (?, ?)"},
+          insertWire{aDb, "INSERT INTO wires (page_id, net_id, db_id, bus, start_x, start_y, end_x, end_y) "
+                          "VALUES (?, ?, ?, ?, ?, ?, ?, ?)"}
+    {
+    }
+
+    Statement insertLibrary;
+    Statement insertPackage;
+    Statement insertPart;
+    Statement insertPin;
+    Statement insertProperty;
+    Statement insertPage;
+    Statement insertInstance;
+    Statement insertNet;
+    Statement insertPageNet;
+    Statement insertWire;
+};
+
+OOCP::SqliteExporter::SqliteExporter(const fs::path& aDbPath, const fs::path& aInputFile)
+    : mDbPath{aDbPath},
+      mInputFile{aInputFile},
+      mDb{nullptr},
+      mStatements{},
+      mLibraryId{0},
+      mNetIds{},
+      mWriter{},
+      mMutex{},
+      mNotEmpty{},
+      mNotFull{},
+      mQueue{},
+      mDone{false},
+      mFailed{false},
+      mError{},
+      mRowCtr{0U}
+{
+}
+
+OOCP::SqliteExporter::~SqliteExporter()
+{
+    if(mWriter.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock{mMutex};
+            mDone = true;
+        }
+
+        mNotEmpty.notify_all();
+        mWriter.join();
+    }
+
+    // Statements need to be finalized before closing the database
+    mStatements.reset();
+
+    sqlite3_close(mDb);
+}
+
+void OOCP::SqliteExporter::begin()
+{
+    check(sqlite3_open_v2(mDbPath.string().c_str(), &mDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr), mDb,
+        "Open");
+
+    // Durability is not required for a bulk load, a failed load is simply repeated
+    execute("PRAGMA journal_mode = WAL;"
+            "PRAGMA synchronous = OFF;"
+            "PRAGMA temp_store = MEMORY;"
+            "PRAGMA cache_size = -262144;");
+
+    execute(std::string{SchemaSql});
+    execute(std::string{DropIndexSql});
+
+    mStatements = std::make_unique<Statements>(mDb);
+
+    mLibraryId = mStatements->insertLibrary.run(
+        mInputFile.filename().string(), mInputFile.string(), getDatabaseType(mInputFile));
+
+    mWriter = std::thread{&SqliteExporter::runWriter, this};
+}
+
+void OOCP::SqliteExporter::writeStream(const Stream& aStream)
+{
+    if(!aStream.mCtx.mParsedSuccessfully)
+    {
+        return;
+    }
+
+    std::unique_ptr<Record> record;
+
+    if(const auto* package = dynamic_cast<const StreamPackage*>(&aStream))
+    {
+        record = std::make_unique<Record>(Record{toPackageRow(*package)});
+    }
+    else if(const auto* page = dynamic_cast<const StreamPage*>(&aStream))
+    {
+        record = std::make_unique<Record>(Record{toPageRow(*page)});
+    }
+    else
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock{mMutex};
+
+    mNotFull.wait(lock, [this]() { return mQueue.size() < QueueCapacity || mFailed; });
+
+    // The error is reported by `end`
+    if(mFailed)
+    {
+        return;
+    }
+
+    mQueue.push_back(std::move(record));
+
+    lock.unlock();
+    mNotEmpty.notify_one();
+}
+
+void OOCP::SqliteExporter::end()
+{
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+        mDone = true;
+    }
+
+    mNotEmpty.notify_all();
+
+    if(mWriter.joinable())
+    {
+        mWriter.join();
+    }
+
+    if(mError)
+    {
+        std::rethrow_exception(mError);
+    }
+
+    execute(std::string{IndexSql});
+    execute("PRAGMA optimize;");
+
+    mStatements.reset();
+
+    check(sqlite3_close(mDb), mDb, "Close");
+    mDb = nullptr;
+}
+
+void OOCP::SqliteExporter::runWriter()
+{
+    try
+    {
+        std::size_t rowsInTransaction = 0U;
+
+        execute("BEGIN");
+
+        while(true)
+        {
+            std::unique_ptr<Record> record;
+
+            {
+                std::unique_lock<std::mutex> lock{mMutex};
+
+                mNotEmpty.wait(lock, [this]() { return !mQueue.empty() || mDone; });
+
+                if(mQueue.empty())
+                {
+                    break;
+                }
+
+                record = std::move(mQueue.front());
+                mQueue.pop_front();
+            }
+
+            mNotFull.notify_one();
+
+            rowsInTransaction += insert(*record);
+
+            if(rowsInTransaction >= RowsPerTransaction)
+            {
+                execute("COMMIT; BEGIN");
+                rowsInTransaction = 0U;
+            }
+        }
+
+        execute("COMMIT");
+    }
+    catch(...)
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+
+        mError  = std::current_exception();
+        mFailed = true;
+        mQueue.clear();
+
+        mNotFull.notify_all();
+    }
+}
+
+std::size_t OOCP::SqliteExporter::insert(const Record& aRecord)
+{
+    Statements& stmts = *mStatements;
+
+    std::size_t rowCtr = 0U;
+
+    if(const auto* package = std::get_if<PackageRow>(&aRecord.data))
+    {
+        const int64_t packageId =
+            stmts.insertPackage.run(mLibraryId, package->name, package->refDes, package->pcbFootprint);
+        ++rowCtr;
+
+        for(const auto& part : package->parts)
+        {
+            const int64_t partId = stmts.insertPart.run(packageId, part.name);
+            ++rowCtr;
+
+            for(const auto& property : part.properties)
+            {
+                stmts.insertProperty.run("part", partId, property.name, property.value);
+                ++rowCtr;
+            }
+
+            for(const auto& pin : part.pins)
+            {
+                stmts.insertPin.run(partId, pin.position, pin.name, pin.portType, pin.startX, pin.startY, pin.hotptX,
+                    pin.hotptY);
+                ++rowCtr;
+            }
+        }
+    }
+    else if(const auto* page = std::get_if<PageRow>(&aRecord.data))
+    {
+        const int64_t pageId = stmts.insertPage.run(mLibraryId, page->schematic, page->name, page->pageSize);
+        ++rowCtr;
+
+        for(const auto& inst : page->instances)
+        {
+            stmts.insertInstance.run(pageId, inst.dbId, inst.reference, inst.package, inst.locX, inst.locY,
+                inst.rotation, inst.mirrored);
+            ++rowCtr;
+        }
+
+        // Nets with the same name on different pages of a schematic are the same net
+        std::unordered_map<std::string, int64_t> netIds;
+
+        for(const auto& net : page->nets)
+        {
+            auto it = mNetIds.find({page->schematic, net});
+
+            if(it == mNetIds.end())
+            {
+                it = mNetIds.emplace(std::make_pair(page->schematic, net),
+                                stmts.insertNet.run(mLibraryId, page->schematic, net))
+                         .first;
+                ++rowCtr;
+            }
+
+            netIds.emplace(net, it->second);
+
+            stmts.insertPageNet.run(pageId, it->second);
+            ++rowCtr;
+        }
+
+        for(const auto& wire : page->wires)
+        {
+            const auto it = netIds.find(wire.net);
+
+            if(it != netIds.end())
+            {
+                stmts.insertWire.run(pageId, it->second, wire.dbId, wire.isBus, wire.startX, wire.startY, wire.endX,
+                    wire.endY);
+            }
+            else
+            {
+                stmts.insertWire.run(pageId, nullptr, wire.dbId, wire.isBus, wire.startX, wire.startY, wire.endX,
+                    wire.endY);
+            }
+
+            ++rowCtr;
+        }
+    }
+
+    mRowCtr += rowCtr;
+
+    return rowCtr;
+}
+
+void OOCP::SqliteExporter::execute(const std::string& aSql)
+{
+    char* errMsg = nullptr;
+
+    const int rc = sqlite3_exec(mDb, aSql.c_str(), nullptr, nullptr, &errMsg);
+
+    if(rc != SQLITE_OK)
+    {
+        const std::string msg = fmt::format("SqliteExporter: Executing `{}` failed: {}", aSql, errMsg ? errMsg : "");
+
+        sqlite3_free(errMsg);
+        throw std::runtime_error(msg);
+    }
+}
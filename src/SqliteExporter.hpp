@@ -0,0 +1,102 @@
+#ifndef SQLITEEXPORTER_HPP
+#define SQLITEEXPORTER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+struct sqlite3;
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+class Stream;
+
+/**
+ * @brief Loads parsed streams into a normalized SQLite database, see `doc/sqlite_schema.md`.
+ *
+ * @note `writeStream` converts a stream into rows in the calling thread, i.e. in
+ *       the parser threads. Converted rows are queued and inserted by a single
+ *       writer thread with prepared statements in large transactions. Indices
+ *       are created after all rows were inserted. Multiple libraries and designs
+ *       can be loaded into the same database one after another.
+ */
+class SqliteExporter
+{
+public:
+    SqliteExporter(const fs::path& aDbPath, const fs::path& aInputFile);
+
+    ~SqliteExporter();
+
+    SqliteExporter(const SqliteExporter&)            = delete;
+    SqliteExporter& operator=(const SqliteExporter&) = delete;
+
+    /**
+     * @brief Create the tables, insert the library and start the writer thread.
+     */
+    void begin();
+
+    /**
+     * @brief Convert a single stream and queue it for insertion. Thread-safe.
+     *
+     * @note Blocks while the queue is full s.t. memory usage stays bounded
+     *       when parsing is faster than inserting.
+     */
+    void writeStream(const Stream& aStream);
+
+    /**
+     * @brief Insert all queued streams, create the indices and close the database.
+     */
+    void end();
+
+    std::size_t getRowCount() const
+    {
+        return mRowCtr;
+    }
+
+private:
+    struct Record;
+    struct Statements;
+
+    void runWriter();
+
+    std::size_t insert(const Record& aRecord);
+
+    void execute(const std::string& aSql);
+
+    fs::path mDbPath;
+    fs::path mInputFile;
+
+    sqlite3* mDb;
+
+    std::unique_ptr<Statements> mStatements;
+
+    int64_t mLibraryId;
+
+    //! (Schematic, net name) -> `nets.id` of the current library, only accessed by the writer thread
+    std::map<std::pair<std::string, std::string>, int64_t> mNetIds;
+
+    std::thread mWriter;
+
+    std::mutex mMutex;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+    std::deque<std::unique_ptr<Record>> mQueue;
+    bool mDone;
+    bool mFailed;
+    std::exception_ptr mError;
+
+    std::size_t mRowCtr;
+};
+} // namespace OOCP
+#endif // SQLITEEXPORTER_HPP
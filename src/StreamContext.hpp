@@ -10,9 +10,12 @@
 #include <string>
 #include <vector>
 
+#include <magic_enum.hpp>
+
 #include "CfbfStreamLocation.hpp"
 #include "ContainerContext.hpp"
 #include "DataStream.hpp"
+#include "Enums/Structure.hpp"
 #include "General.hpp"
 // #include "Stream.hpp"
 
@@ -22,6 +25,62 @@ namespace OOCP
 {
 class Stream;
 
+/**
+ * @brief Property of a structure, stored in its short prefix as pair of indices into `StreamLibrary::strLst`.
+ */
+struct NameValueMapping
+{
+    size_t offset;       //!< Offset of the short prefix inside the stream, identifies the structure
+    Structure structure; //!< Structure the prefix belongs to
+
+    uint32_t nameIdx;
+    uint32_t valueIdx;
+};
+
+enum class BlobKind
+{
+    Image, //!< Raw data of `PrimBitmap`
+    Ole    //!< Payload of `StructGraphicOleEmbedInst`
+};
+
+[[maybe_unused]]
+static std::string to_string(const BlobKind& aVal)
+{
+    return std::string{magic_enum::enum_name<decltype(aVal)>(aVal)};
+}
+
+/**
+ * @brief Location and content hash of an embedded binary object inside the stream.
+ */
+struct BlobRef
+{
+    BlobKind kind;
+    size_t offset;
+    size_t size;
+    uint64_t hash;         //!< `ContentHash` of the raw data, identifies equal blobs
+    std::string extension; //!< File extension of the blob, e.g. `.bmp`
+};
+
+/**
+ * @brief Location of an index into `StreamLibrary::textFonts` inside the stream.
+ */
+struct FontIdxRef
+{
+    size_t offset; //!< Offset of the little endian uint16 that contains the index
+    uint16_t mask; //!< Bits of the index, the remaining bits belong to other fields
+};
+
+/**
+ * @brief Sizes of the reference lists in `StreamContext`, used to roll back speculative reads.
+ */
+struct StreamRefsMark
+{
+    size_t strLstRefs;
+    size_t fontIdxRefs;
+    size_t nameValueMappings;
+    size_t blobRefs;
+};
+
 class StreamContext : public ContainerContext
 {
 public:
@@ -31,7 +90,10 @@ public:
           mCfbfStreamLocation{mInputStream, mExtractedCfbfPath},
           mDs{aInputStream, *this}
     {
-        mImgCtr             = 0U;
+        mBlobRefs           = {};
+        mStrLstRefs         = {};
+        mFontIdxRefs        = {};
+        mNameValueMappings  = {};
         mAttemptedParsing   = false;
         mParsedSuccessfully = std::nullopt;
 
@@ -41,13 +103,67 @@ public:
         configureLogger(logPath);
     }
 
+    /**
+     * @brief Additional view of the same stream, e.g. for record cursors.
+     *
+     * @note The stream file is opened again s.t. both views read independently.
+     *       The logger is shared instead of opening the log file a second time.
+     */
+    explicit StreamContext(const StreamContext& aCtx)
+        : ContainerContext{aCtx},
+          mInputStream{aCtx.mInputStream},
+          mCfbfStreamLocation{aCtx.mCfbfStreamLocation},
+          mDs{mInputStream, *this}
+    {
+        mBlobRefs           = {};
+        mStrLstRefs         = {};
+        mFontIdxRefs        = {};
+        mNameValueMappings  = {};
+        mAttemptedParsing   = false;
+        mParsedSuccessfully = std::nullopt;
+
+        mLogger = aCtx.mLogger;
+    }
+
     fs::path mInputStream; //!< Input CFBF stream as file in the file system
 
     CfbfStreamLocation mCfbfStreamLocation; //!< Location of the stream inside the CFBF container
 
     DataStream mDs;
 
-    size_t mImgCtr; //!< Counts images per stream
+    /**
+     * @brief Current sizes of the reference lists.
+     */
+    StreamRefsMark getRefsMark() const
+    {
+        return StreamRefsMark{mStrLstRefs.size(), mFontIdxRefs.size(), mNameValueMappings.size(), mBlobRefs.size()};
+    }
+
+    /**
+     * @brief Drop all references that were added after the mark was taken.
+     */
+    void resetRefs(const StreamRefsMark& aMark)
+    {
+        mStrLstRefs.resize(aMark.strLstRefs);
+        mFontIdxRefs.resize(aMark.fontIdxRefs);
+        mNameValueMappings.resize(aMark.nameValueMappings);
+        mBlobRefs.resize(aMark.blobRefs);
+    }
+
+    // Embedded binary objects of this stream, in stream order.
+    std::vector<BlobRef> mBlobRefs;
+
+    // Offsets of all uint32 indices into `StreamLibrary::strLst` inside
+    // this stream, required to remap them when copying the stream into
+    // another library.
+    std::vector<size_t> mStrLstRefs;
+
+    // Indices into `StreamLibrary::textFonts` inside this stream, required
+    // to remap them when copying the stream into another library.
+    std::vector<FontIdxRef> mFontIdxRefs;
+
+    // Name/value mappings of all structures in this stream, in stream order.
+    std::vector<NameValueMapping> mNameValueMappings;
 
     // True, iff the parser was run on this stream. It is
     // not important wether the parser was successful or not
@@ -1,14 +1,123 @@
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <filesystem>
 #include <string>
+#include <vector>
 
 #include <nameof.hpp>
 #include <spdlog/spdlog.h>
 
+#include "DataStream.hpp"
 #include "Enums/Structure.hpp"
 #include "General.hpp"
 #include "GenericParser.hpp"
 #include "Streams/StreamCache.hpp"
 
+namespace
+{
+// See `DataStream::readStringZeroTerm`, longer strings are rejected
+constexpr std::size_t MaxStrLen = 3500U;
+
+// Bytes buffered ahead of the parser, must hold the longest string
+constexpr std::size_t WindowSize = 65536U;
+
+/**
+ * @brief Bounded read-ahead window for making framing decisions without parsing.
+ */
+class LookAhead
+{
+public:
+    LookAhead(OOCP::DataStream& aDs, std::size_t aEndOffset)
+        : mDs{aDs},
+          mEndOffset{aEndOffset},
+          mWindow{},
+          mWindowOffset{0U}
+    {
+    }
+
+    std::size_t getRemaining()
+    {
+        const std::size_t offset = mDs.getCurrentOffset();
+
+        return offset < mEndOffset ? mEndOffset - offset : 0U;
+    }
+
+    /**
+     * @brief Bytes relative to the current offset, the data is valid until the next call.
+     *
+     * @return const uint8_t* nullptr if the stream ends before.
+     */
+    const uint8_t* get(std::size_t aOffset, std::size_t aLen)
+    {
+        const std::size_t offset = mDs.getCurrentOffset();
+        const std::size_t begin  = offset + aOffset;
+
+        if(begin > mEndOffset || mEndOffset - begin < aLen)
+        {
+            return nullptr;
+        }
+
+        if(begin < mWindowOffset || begin + aLen > mWindowOffset + mWindow.size())
+        {
+            mWindow.resize(std::min(std::max(aLen, WindowSize), mEndOffset - begin));
+            mWindowOffset = begin;
+
+            mDs.setCurrentOffset(begin);
+            mDs.read(reinterpret_cast<char*>(mWindow.data()), static_cast<std::streamsize>(mWindow.size()));
+            mDs.setCurrentOffset(offset);
+        }
+
+        return mWindow.data() + (begin - mWindowOffset);
+    }
+
+private:
+    OOCP::DataStream& mDs;
+
+    const std::size_t mEndOffset;
+
+    std::vector<uint8_t> mWindow;
+    std::size_t mWindowOffset; //!< Stream offset of the first byte in `mWindow`
+};
+
+/**
+ * @brief Check without reading whether `DataStream::readStringLenZeroTerm` would succeed at the offset.
+ */
+bool hasStrLenZeroTerm(LookAhead& aLookAhead, std::size_t aOffset)
+{
+    const uint8_t* lenData = aLookAhead.get(aOffset, 2U);
+
+    if(lenData == nullptr)
+    {
+        return false;
+    }
+
+    // Little endian uint16
+    const std::size_t len = lenData[0] | static_cast<std::size_t>(lenData[1]) << 8U;
+
+    if(len >= MaxStrLen)
+    {
+        return false;
+    }
+
+    // The zero termination must be located inside the stream
+    const uint8_t* str = aLookAhead.get(aOffset + 2U, len + 1U);
+
+    return str != nullptr && std::memchr(str, '\0', len) == nullptr && str[len] == 0U;
+}
+
+/**
+ * @brief Check whether the two uint32 IDs at the offset are equal.
+ */
+bool hasEqualIds(LookAhead& aLookAhead, std::size_t aOffset)
+{
+    const uint8_t* ids = aLookAhead.get(aOffset, 8U);
+
+    return ids != nullptr && std::memcmp(ids, ids + 4U, 4U) == 0;
+}
+} // namespace
+
 void OOCP::StreamCache::read(FileFormatVersion /* aVersion */)
 {
     auto& ds = mCtx.mDs;
@@ -16,34 +125,15 @@ void OOCP::StreamCache::read(FileFormatVersion /* aVersion */)
 
     mCtx.mLogger.debug(getOpeningMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
 
-    const auto hasStrAfter0Byte = [&]() -> bool
-    {
-        return parser.tryRead(
-            [&]()
-            {
-                ds.readBytes(0U);
-                ds.readStringLenZeroTerm();
-            });
-    };
-    const auto hasStrAfter8Byte = [&]() -> bool
-    {
-        return parser.tryRead(
-            [&]()
-            {
-                ds.readBytes(8U);
-                ds.readStringLenZeroTerm();
-            });
-    };
-
-    // Early out for empty caches
-    if(parser.tryRead(
-           [&]()
-           {
-               ds.readBytes(10U);
-               ds.sanitizeEoF();
-           }))
+    // The framing is decided by inspecting the bytes ahead instead of speculatively
+    // parsing and rolling back, i.e. every byte of the stream is parsed exactly once.
+    LookAhead lookAhead{ds, static_cast<std::size_t>(fs::file_size(mCtx.mInputStream))};
+
+    const auto isEoF = [&]() -> bool { return lookAhead.getRemaining() == 0U; };
+
+    // Empty caches consist of 10 zero bytes
+    if(lookAhead.getRemaining() == 10U)
     {
-        // 10 zero bytes
         ds.assumeData({0, 0, 0, 0, 0, 0, 0, 0, 0, 0}, getMethodName(this, __func__) + ": 0");
     }
     else
@@ -52,13 +142,13 @@ void OOCP::StreamCache::read(FileFormatVersion /* aVersion */)
         ds.printUnknownData(2, getMethodName(this, __func__) + ": 1.1");
 
         std::size_t i{0U};
-        for(i = 0U; !ds.isEoF(); ++i)
+        for(i = 0U; !isEoF(); ++i)
         {
             mCtx.mLogger.trace("iteration i = {}", i);
 
-            if(!hasStrAfter0Byte())
+            if(!hasStrLenZeroTerm(lookAhead, 0U))
             {
-                if(hasStrAfter8Byte())
+                if(hasStrLenZeroTerm(lookAhead, 8U))
                 {
                     ds.printUnknownData(2U, getMethodName(this, __func__) + ": 11");
 
@@ -73,11 +163,7 @@ void OOCP::StreamCache::read(FileFormatVersion /* aVersion */)
             const std::string name = ds.readStringLenZeroTerm();
             mCtx.mLogger.trace("name = {}", name);
 
-            const auto ids = ds.peek(8U);
-            const std::vector<uint8_t> id0{ids.cbegin(), ids.cbegin() + 4U};
-            const std::vector<uint8_t> id1{ids.cbegin() + 4U, ids.cend()};
-
-            if(id0 != id1)
+            if(!hasEqualIds(lookAhead, 0U))
             {
                 std::size_t j{0U};
                 uint16_t someVal;
@@ -95,25 +181,18 @@ void OOCP::StreamCache::read(FileFormatVersion /* aVersion */)
 
                     mCtx.mLogger.trace("someVal[{}][{}] = {}", i, j, someVal);
 
-                    if(ds.isEoF())
+                    if(isEoF())
                     {
                         break;
                     }
 
-                    if(parser.tryRead(
-                           [&]()
-                           {
-                               ds.readBytes(1U);
-                               ds.sanitizeEoF();
-                           }))
+                    if(lookAhead.getRemaining() == 1U)
                     {
                         ds.printUnknownData(1U, "Unknown Byte before end");
                         break;
                     }
 
-                    const bool hasMysterious2Byte = !parser.tryRead([&]() { ds.readStringLenZeroTerm(); });
-
-                    if(hasMysterious2Byte)
+                    if(!hasStrLenZeroTerm(lookAhead, 0U))
                     {
                         ds.printUnknownData(2U, fmt::format("Encountered weird values for someVal = {}", someVal));
                     }
@@ -125,7 +204,7 @@ void OOCP::StreamCache::read(FileFormatVersion /* aVersion */)
                     j++;
                 } while(someVal == 0x0U);
 
-                if(ds.isEoF())
+                if(isEoF())
                 {
                     break;
                 }
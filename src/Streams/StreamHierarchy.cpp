@@ -21,6 +21,14 @@ void OOCP::StreamHierarchy::read(FileFormatVersion aVersion)
         aVersion                  = parser.predictVersion(predictionFunc);
     }
 
+    // Failed attempts of the version prediction already added structures
+    sthInHierarchy2s.clear();
+    netDbIdMappings.clear();
+    sthInHierarchy3s.clear();
+    t0x5bs.clear();
+    sthInHierarchy1s.clear();
+    someHierarchyBases.clear();
+
     ds.printUnknownData(9, getMethodName(this, __func__) + ": 0");
 
     const std::string schematicName = ds.readStringLenZeroTerm();
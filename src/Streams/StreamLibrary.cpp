@@ -1,4 +1,7 @@
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <filesystem>
 #include <fstream>
@@ -29,6 +32,13 @@ void OOCP::StreamLibrary::read(FileFormatVersion aVersion)
         aVersion                  = parser.predictVersion(predictionFunc);
     }
 
+    // Failed attempts of the version prediction already filled the lists
+    textFonts.clear();
+    defaultFontIdxs.clear();
+    strLstPartField.clear();
+    strLst.clear();
+    partAliases.clear();
+
     size_t startOffset = ds.getCurrentOffset();
 
     introduction = ds.readStringZeroTerm();
@@ -81,6 +91,8 @@ void OOCP::StreamLibrary::read(FileFormatVersion aVersion)
     // @todo the GUI specifies 15 fonts under
     //       `Options` -> `Design Templates...` -> `Fonts`
     //       is there some correlation?
+    textFontsBegin = ds.getCurrentOffset();
+
     const uint16_t textFontLen = ds.readUint16();
 
     mCtx.mLogger.trace("textFontLen = {}", textFontLen);
@@ -97,24 +109,26 @@ void OOCP::StreamLibrary::read(FileFormatVersion aVersion)
         textFonts.push_back(font);
     }
 
+    textFontsEnd = ds.getCurrentOffset();
+
     // @todo Always has length = 24, but why?
-    const uint16_t someLen = ds.readUint16();
+    const uint16_t defaultFontLen = ds.readUint16();
 
-    if(someLen != 24U)
+    if(defaultFontLen != 24U)
     {
-        const std::string msg = fmt::format("Expected length of 24 but got {}", someLen);
+        const std::string msg = fmt::format("Expected length of 24 but got {}", defaultFontLen);
         mCtx.mLogger.error(msg);
         throw std::runtime_error(msg);
     }
 
-    mCtx.mLogger.trace("someLen = {}", someLen);
+    mCtx.mLogger.trace("defaultFontLen = {}", defaultFontLen);
 
-    for(int i = 0; i < someLen; ++i)
+    for(int i = 0; i < defaultFontLen; ++i)
     {
-        const uint16_t someData = ds.readUint16();
-
         // Has value in range [0, 1, 2, 3, 4, 5, 6] and extremely rarely [13]
-        mCtx.mLogger.trace("someData [{}] = {}", i, someData);
+        defaultFontIdxs.push_back(ds.readUint16());
+
+        mCtx.mLogger.trace("defaultFontIdxs[{}] = {}", i, defaultFontIdxs.back());
     }
 
     // Always has value [00 00 00 00] or [01 00 00 00]
@@ -136,6 +150,8 @@ void OOCP::StreamLibrary::read(FileFormatVersion aVersion)
 
     pageSettings.read();
 
+    strLstBegin = ds.getCurrentOffset();
+
     uint32_t strLstLen = 0U;
 
     // @todo Versions were chosen randomly
@@ -157,6 +173,8 @@ void OOCP::StreamLibrary::read(FileFormatVersion aVersion)
         mCtx.mLogger.trace("strLst[{}] = {}", i, strLst.back());
     }
 
+    strLstEnd = ds.getCurrentOffset();
+
     const uint16_t aliasLstLen = ds.readUint16();
 
     mCtx.mLogger.trace("aliasLstLen = {}", aliasLstLen);
@@ -170,6 +188,8 @@ void OOCP::StreamLibrary::read(FileFormatVersion aVersion)
         mCtx.mLogger.trace("partAliases[{}] = (alias = {}, package = {})", i, alias, package);
     }
 
+    partAliasesEnd = ds.getCurrentOffset();
+
     if(mDbType == DatabaseType::Design)
     {
         ds.assumeData({0x00, 0x00, 0x00, 0x00}, getMethodName(this, __func__) + ": 5.0");
@@ -188,6 +208,54 @@ void OOCP::StreamLibrary::read(FileFormatVersion aVersion)
 
     ds.sanitizeEoF();
 
+    buildIndices();
+
     mCtx.mLogger.debug(getClosingMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
     mCtx.mLogger.info(to_string());
+}
+
+void OOCP::StreamLibrary::buildIndices()
+{
+    mPackageAliasIdx.clear();
+
+    for(std::size_t i = 0U; i < partAliases.size(); ++i)
+    {
+        mPackageAliasIdx[partAliases[i].second].push_back(i);
+    }
+}
+
+OOCP::LOGFONTA OOCP::StreamLibrary::getDefaultFont(std::size_t aSlot) const
+{
+    const uint16_t fontIdx = defaultFontIdxs.at(aSlot);
+
+    if(fontIdx == 0U)
+    {
+        // Not stored in the library, values are taken from OrCAD's XML export
+        LOGFONTA font{};
+
+        font.lfHeight = 8;
+        font.lfWeight = 400;
+        std::strncpy(font.lfFaceName, "Arial", sizeof(font.lfFaceName) - 1U);
+
+        return font;
+    }
+
+    return textFonts.at(fontIdx - 1U);
+}
+
+std::vector<std::string> OOCP::StreamLibrary::getAliasesOfPackage(const std::string& aPackage) const
+{
+    std::vector<std::string> aliases;
+
+    const auto it = mPackageAliasIdx.find(aPackage);
+
+    if(it != mPackageAliasIdx.cend())
+    {
+        for(const std::size_t idx : it->second)
+        {
+            aliases.push_back(partAliases.at(idx).first);
+        }
+    }
+
+    return aliases;
 }
\ No newline at end of file
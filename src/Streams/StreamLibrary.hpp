@@ -1,10 +1,12 @@
 #ifndef STREAMSYMBOLSLIBRARY_HPP
 #define STREAMSYMBOLSLIBRARY_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -28,10 +30,17 @@ public:
           createDate{0},
           modifyDate{0},
           textFonts{},
+          textFontsBegin{0U},
+          textFontsEnd{0U},
+          defaultFontIdxs{},
           strLstPartField{},
           pageSettings{mCtx},
           strLst{},
-          partAliases{}
+          strLstBegin{0U},
+          strLstEnd{0U},
+          partAliases{},
+          partAliasesEnd{0U},
+          mPackageAliasIdx{}
     {
     }
 
@@ -49,6 +58,23 @@ public:
         return StreamType::Library;
     }
 
+    /**
+     * @brief Build the lookup index of `partAliases`, called at the end of `read`.
+     *
+     * @note Needs to be called again when `partAliases` is modified.
+     */
+    void buildIndices();
+
+    /**
+     * @brief All aliases of a package in the order of `partAliases`.
+     */
+    std::vector<std::string> getAliasesOfPackage(const std::string& aPackage) const;
+
+    /**
+     * @brief Font of a default font slot, resolved by `defaultFontIdxs`.
+     */
+    LOGFONTA getDefaultFont(std::size_t aSlot) const;
+
     // Specifies whether the database is a design or library.
     // The file extension in contrast is not relevant.
     std::string introduction;
@@ -60,14 +86,34 @@ public:
 
     std::vector<LOGFONTA> textFonts;
 
+    // Byte range of `textFonts` inside the stream, including its preceding
+    // length. Indices into `textFonts` are listed in `StreamContext::mFontIdxRefs`.
+    std::size_t textFontsBegin;
+    std::size_t textFontsEnd;
+
+    // Font per default font slot, index 0 refers to a built-in
+    // font and all others are 1-based indices into `textFonts`.
+    std::vector<uint16_t> defaultFontIdxs;
+
     std::vector<std::string> strLstPartField;
 
     PageSettings pageSettings;
 
     std::vector<std::string> strLst;
 
+    // Byte range of `strLst` inside the stream, including its preceding
+    // length. Indices into `strLst` are listed in `StreamContext::mStrLstRefs`.
+    std::size_t strLstBegin;
+    std::size_t strLstEnd;
+
     // See OrCAD: 'Package Properties' -> 'Part Aliases'
     std::vector<std::pair<std::string, std::string>> partAliases; //!< .first = Alias, .second = Package
+
+    // End of `partAliases` inside the stream, the list starts at `strLstEnd`
+    std::size_t partAliasesEnd;
+
+private:
+    std::unordered_map<std::string, std::vector<std::size_t>> mPackageAliasIdx; //!< Package -> alias indices
 };
 
 [[maybe_unused]]
@@ -1,13 +1,101 @@
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 
 #include <nameof.hpp>
 #include <spdlog/spdlog.h>
 
 #include "General.hpp"
+#include "FutureData.hpp"
 #include "GenericParser.hpp"
+#include "RecordCursor.hpp"
 #include "Streams/StreamPackage.hpp"
 
+namespace
+{
+/**
+ * @brief Position of a primitive cursor inside the nested lists of a package stream.
+ */
+struct PrimitiveCursorState
+{
+    std::optional<std::size_t> remainingPartCells;
+    std::size_t remainingLibraryParts{0U};
+    std::size_t remainingPrimitives{0U};
+
+    std::unique_ptr<OOCP::StructLibraryPart> libraryPart;
+    std::unique_ptr<OOCP::FutureDataLst> localFutureLst;
+    std::size_t nextCheckpointPos{0U};
+};
+
+// Mirrors the layout in `StreamPackage::read` and `StructLibraryPart::read`
+bool readNextPrimitive(
+    PrimitiveCursorState& aState, OOCP::StreamContext& aCtx, std::unique_ptr<OOCP::PrimBase>& aPrimitive)
+{
+    auto& ds = aCtx.mDs;
+    OOCP::GenericParser parser{aCtx};
+
+    if(!aState.remainingPartCells.has_value())
+    {
+        aState.remainingPartCells = ds.readUint16();
+    }
+
+    while(true)
+    {
+        if(aState.libraryPart && aState.remainingPrimitives > 0U)
+        {
+            --aState.remainingPrimitives;
+
+            aPrimitive = aState.libraryPart->readNextPrimitive(aState.nextCheckpointPos);
+
+            return true;
+        }
+
+        if(aState.libraryPart)
+        {
+            aState.libraryPart->readTail(*aState.localFutureLst, aState.nextCheckpointPos);
+
+            aState.libraryPart.reset();
+            aState.localFutureLst.reset();
+        }
+
+        if(aState.remainingLibraryParts > 0U)
+        {
+            --aState.remainingLibraryParts;
+
+            // Other structures are handled by the parser as usual
+            if(OOCP::ToStructure(ds.peek(1)[0]) != OOCP::Structure::LibraryPart)
+            {
+                parser.readStructure();
+                continue;
+            }
+
+            aState.libraryPart    = std::make_unique<OOCP::StructLibraryPart>(aCtx);
+            aState.localFutureLst = std::make_unique<OOCP::FutureDataLst>(aCtx);
+
+            aState.remainingPrimitives = aState.libraryPart->readHead(*aState.localFutureLst);
+            aState.nextCheckpointPos   = aState.localFutureLst->getNextCheckpointPos().value_or(0U);
+
+            continue;
+        }
+
+        if(aState.remainingPartCells.value() > 0U)
+        {
+            --aState.remainingPartCells.value();
+
+            parser.readStructure(); // partCell
+
+            aState.remainingLibraryParts = ds.readUint16();
+
+            continue;
+        }
+
+        return false;
+    }
+}
+} // namespace
+
 void OOCP::StreamPackage::read(FileFormatVersion /* aVersion */)
 {
     auto& ds = mCtx.mDs;
@@ -39,4 +127,13 @@ void OOCP::StreamPackage::read(FileFormatVersion /* aVersion */)
 
     mCtx.mLogger.debug(getClosingMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
     mCtx.mLogger.info(to_string());
-}
\ No newline at end of file
+}
+
+OOCP::RecordCursor<OOCP::PrimBase> OOCP::StreamPackage::iterPrimitives() const
+{
+    const auto state = std::make_shared<PrimitiveCursorState>();
+
+    return RecordCursor<PrimBase>{std::make_unique<StreamContext>(mCtx),
+        [state](StreamContext& aCtx, std::unique_ptr<PrimBase>& aPrimitive)
+        { return readNextPrimitive(*state, aCtx, aPrimitive); }};
+}
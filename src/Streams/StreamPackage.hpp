@@ -10,6 +10,8 @@
 #include <fmt/core.h>
 #include <nameof.hpp>
 
+#include "Primitives/PrimBase.hpp"
+#include "RecordCursor.hpp"
 #include "Stream.hpp"
 #include "Structures/StructDevice.hpp"
 #include "Structures/StructLibraryPart.hpp"
@@ -33,6 +35,14 @@ public:
 
     void read(FileFormatVersion aVersion = FileFormatVersion::Unknown) override;
 
+    /**
+     * @brief Decode the primitives of all library parts one at a time instead of reading the whole package.
+     *
+     * @note Other records are decoded and dropped. Unlike `read`, invalid library
+     *       parts are not skipped, the cursor throws instead.
+     */
+    RecordCursor<PrimBase> iterPrimitives() const;
+
     // void accept(Visitor& aVisitor) const override
     // {
     //     aVisitor.visit(*this);
@@ -1,5 +1,12 @@
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 #include <nameof.hpp>
 #include <spdlog/spdlog.h>
@@ -7,64 +14,83 @@
 #include "General.hpp"
 #include "GenericParser.hpp"
 #include "PageSettings.hpp"
+#include "RecordCursor.hpp"
 #include "Streams/StreamPage.hpp"
 
-void OOCP::StreamPage::read(FileFormatVersion /* aVersion */)
+namespace
 {
-    auto& ds = mCtx.mDs;
-    GenericParser parser{mCtx};
-
-    mCtx.mLogger.debug(getOpeningMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
+/**
+ * @brief Decode a list of structures that is prefixed by its length.
+ *
+ * @param aStructs Destination of the structures, they are dropped if null.
+ */
+template <typename T>
+void readStructures(
+    OOCP::StreamContext& aCtx, std::string_view aLenName, std::vector<std::unique_ptr<T>>* aStructs)
+{
+    OOCP::GenericParser parser{aCtx};
 
-    FutureDataLst localFutureLst{mCtx};
+    const uint16_t len = aCtx.mDs.readUint16();
 
-    // @todo Extract in separate structure parser
-    parser.auto_read_prefixes(Structure::Page, localFutureLst);
+    aCtx.mLogger.trace("{} = {}", aLenName, len);
 
-    parser.readPreamble();
+    for(size_t i = 0u; i < len; ++i)
+    {
+        auto structure = OOCP::dynamic_pointer_cast<T>(parser.readStructure());
 
-    localFutureLst.checkpoint();
+        if(aStructs != nullptr)
+        {
+            aStructs->push_back(std::move(structure));
+        }
+    }
+}
+
+/**
+ * @brief Read the page up to the length of its wires.
+ *
+ * @note Shared by `StreamPage::read` and the record cursors s.t. the layout is only defined once.
+ *
+ * @param aPage Destination of the decoded data, it is dropped if null.
+ */
+void readUntilWires(OOCP::StreamContext& aCtx, OOCP::FutureDataLst& aFutureLst, OOCP::StreamPage* aPage)
+{
+    auto& ds = aCtx.mDs;
+    OOCP::GenericParser parser{aCtx};
 
-    name = ds.readStringLenZeroTerm();
+    // @todo Extract in separate structure parser
+    parser.auto_read_prefixes(OOCP::Structure::Page, aFutureLst);
 
-    mCtx.mLogger.trace("name = {}", name);
+    parser.readPreamble();
 
-    pageSize = ds.readStringLenZeroTerm();
+    aFutureLst.checkpoint();
 
-    mCtx.mLogger.trace("pageSize = {}", pageSize);
+    const std::string name = ds.readStringLenZeroTerm();
 
-    pageSettings.read();
+    aCtx.mLogger.trace("name = {}", name);
 
-    const uint16_t lenTitleBlocks = ds.readUint16();
+    const std::string pageSize = ds.readStringLenZeroTerm();
 
-    mCtx.mLogger.trace("lenTitleBlocks = {}", lenTitleBlocks);
+    aCtx.mLogger.trace("pageSize = {}", pageSize);
 
-    for(size_t i = 0u; i < lenTitleBlocks; ++i)
+    if(aPage != nullptr)
     {
-        titleBlocks.push_back(dynamic_pointer_cast<StructTitleBlock>(parser.readStructure()));
-    }
+        aPage->name     = name;
+        aPage->pageSize = pageSize;
 
-    const uint16_t lenT0x34s = ds.readUint16();
-
-    mCtx.mLogger.trace("lenT0x34s = {}", lenT0x34s);
-
-    for(size_t i = 0u; i < lenT0x34s; ++i)
-    {
-        t0x34s.push_back(dynamic_pointer_cast<StructT0x34>(parser.readStructure()));
+        aPage->pageSettings.read();
     }
-
-    const uint16_t lenT0x35s = ds.readUint16();
-
-    mCtx.mLogger.trace("lenT0x35s = {}", lenT0x35s);
-
-    for(size_t i = 0u; i < lenT0x35s; ++i)
+    else
     {
-        t0x35s.push_back(dynamic_pointer_cast<StructT0x35>(parser.readStructure()));
+        OOCP::PageSettings{aCtx}.read();
     }
 
+    readStructures(aCtx, "lenTitleBlocks", aPage != nullptr ? &aPage->titleBlocks : nullptr);
+    readStructures(aCtx, "lenT0x34s", aPage != nullptr ? &aPage->t0x34s : nullptr);
+    readStructures(aCtx, "lenT0x35s", aPage != nullptr ? &aPage->t0x35s : nullptr);
+
     const uint16_t lenB = ds.readUint16();
 
-    mCtx.mLogger.trace("lenB = {}", lenB);
+    aCtx.mLogger.trace("lenB = {}", lenB);
 
     for(size_t i = 0; i < lenB; ++i)
     {
@@ -72,18 +98,75 @@ void OOCP::StreamPage::read(FileFormatVersion /* aVersion */)
         const std::string net = ds.readStringLenZeroTerm();
         const uint32_t id     = ds.readUint32();
 
-        mCtx.mLogger.trace("net = {}", net);
-        mCtx.mLogger.trace("id  = {}", id);
+        aCtx.mLogger.trace("net = {}", net);
+        aCtx.mLogger.trace("id  = {}", id);
     }
+}
 
-    const uint16_t lenWires = ds.readUint16();
+void seekWires(OOCP::StreamContext& aCtx)
+{
+    OOCP::FutureDataLst localFutureLst{aCtx};
 
-    mCtx.mLogger.trace("lenWires = {}", lenWires);
+    readUntilWires(aCtx, localFutureLst, nullptr);
+}
 
-    for(size_t i = 0u; i < lenWires; ++i)
+void seekPlacedInstances(OOCP::StreamContext& aCtx)
+{
+    seekWires(aCtx);
+
+    readStructures<OOCP::StructWire>(aCtx, "lenWires", nullptr);
+}
+
+/**
+ * @brief Cursor over a list of structures that is prefixed by its length.
+ *
+ * @param aSeek Moves the stream to the length of the list.
+ */
+template <typename T>
+OOCP::RecordCursor<T> makeListCursor(
+    const OOCP::StreamContext& aCtx, std::function<void(OOCP::StreamContext&)> aSeek)
+{
+    // Seeking is deferred until the first record is requested
+    const auto readNext = [aSeek, remaining = std::optional<std::size_t>{}](
+                              OOCP::StreamContext& aCursorCtx, std::unique_ptr<T>& aRecord) mutable -> bool
     {
-        wires.push_back(dynamic_pointer_cast<StructWire>(parser.readStructure()));
-    }
+        if(!remaining.has_value())
+        {
+            aSeek(aCursorCtx);
+
+            remaining = aCursorCtx.mDs.readUint16();
+        }
+
+        if(remaining.value() == 0U)
+        {
+            return false;
+        }
+
+        --remaining.value();
+
+        OOCP::GenericParser parser{aCursorCtx};
+
+        aRecord = OOCP::dynamic_pointer_cast<T>(parser.readStructure());
+
+        return true;
+    };
+
+    return OOCP::RecordCursor<T>{std::make_unique<OOCP::StreamContext>(aCtx), readNext};
+}
+} // namespace
+
+void OOCP::StreamPage::read(FileFormatVersion /* aVersion */)
+{
+    auto& ds = mCtx.mDs;
+    GenericParser parser{mCtx};
+
+    mCtx.mLogger.debug(getOpeningMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
+
+    FutureDataLst localFutureLst{mCtx};
+
+    readUntilWires(mCtx, localFutureLst, this);
+
+    readStructures(mCtx, "lenWires", &wires);
 
     const uint16_t lenPlacedInstances = ds.readUint16();
 
@@ -188,4 +271,14 @@ void OOCP::StreamPage::read(FileFormatVersion /* aVersion */)
 
     mCtx.mLogger.debug(getClosingMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
     mCtx.mLogger.info(to_string());
-}
\ No newline at end of file
+}
+
+OOCP::RecordCursor<OOCP::StructWire> OOCP::StreamPage::iterWires() const
+{
+    return makeListCursor<StructWire>(mCtx, seekWires);
+}
+
+OOCP::RecordCursor<OOCP::StructPlacedInstance> OOCP::StreamPage::iterPlacedInstances() const
+{
+    return makeListCursor<StructPlacedInstance>(mCtx, seekPlacedInstances);
+}
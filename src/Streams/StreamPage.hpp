@@ -10,6 +10,7 @@
 
 #include "General.hpp"
 #include "PageSettings.hpp"
+#include "RecordCursor.hpp"
 #include "Stream.hpp"
 #include "Structures/StructBusEntry.hpp"
 #include "Structures/StructERCObject.hpp"
@@ -51,6 +52,18 @@ public:
 
     void read(FileFormatVersion aVersion = FileFormatVersion::Unknown) override;
 
+    /**
+     * @brief Decode the wires one at a time instead of reading the whole page.
+     *
+     * @note Preceding records are decoded and dropped to reach the wires.
+     */
+    RecordCursor<StructWire> iterWires() const;
+
+    /**
+     * @brief Decode the placed instances one at a time instead of reading the whole page.
+     */
+    RecordCursor<StructPlacedInstance> iterPlacedInstances() const;
+
     // void accept(Visitor& aVisitor) const override
     // {
     //     aVisitor.visit(*this);
@@ -39,6 +39,9 @@ void OOCP::StructAlias::read(FileFormatVersion /* aVersion */)
 
     mCtx.mLogger.trace("rotation = {}", OOCP::to_string(rotation));
 
+    // Upper half is always zero for the observed font counts
+    mCtx.mFontIdxRefs.push_back(FontIdxRef{ds.getCurrentOffset(), 0xffff});
+
     uint32_t textFontIdx = ds.readUint32();
 
     mCtx.mLogger.trace("Alias fontIdx = {}", textFontIdx);
@@ -1,14 +1,32 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <fstream>
+#include <optional>
 #include <ostream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include <fmt/core.h>
 #include <nameof.hpp>
 
+#include "ContainerExtractor.hpp"
+#include "ContentHash.hpp"
 #include "Enums/Structure.hpp"
 #include "General.hpp"
 #include "GenericParser.hpp"
 #include "Structures/StructGraphicOleEmbedInst.hpp"
 
+namespace
+{
+// Embedded objects are hashed and copied in chunks s.t. they are never loaded at once
+constexpr std::size_t PayloadChunkSize = 65536U;
+
+constexpr std::array<uint8_t, 8U> CfbMagicBytes = {0xd0, 0xcf, 0x11, 0xe0, 0xa1, 0xb1, 0x1a, 0xe1};
+} // namespace
+
 void OOCP::StructGraphicOleEmbedInst::read(FileFormatVersion /* aVersion */)
 {
     auto& ds = mCtx.mDs;
@@ -22,8 +40,123 @@ void OOCP::StructGraphicOleEmbedInst::read(FileFormatVersion /* aVersion */)
 
     StructGraphicInst::read(localFutureLst);
 
+    // The embedded object follows the graphic instance until the end of the structure
+    const std::optional<size_t> payloadEnd = localFutureLst.getNextCheckpointPos();
+
+    if(payloadEnd.has_value())
+    {
+        readPayload(payloadEnd.value());
+
+        localFutureLst.checkpoint();
+    }
+
     localFutureLst.sanitizeCheckpoints();
 
     mCtx.mLogger.debug(getClosingMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
     mCtx.mLogger.trace(to_string());
-}
\ No newline at end of file
+}
+
+void OOCP::StructGraphicOleEmbedInst::readPayload(size_t aEndOffset)
+{
+    auto& ds = mCtx.mDs;
+
+    payloadOffset = ds.getCurrentOffset();
+    payloadSize   = aEndOffset - payloadOffset;
+
+    ContentHash hash{};
+
+    for(size_t remaining = payloadSize; remaining > 0U;)
+    {
+        const size_t len = std::min(remaining, PayloadChunkSize);
+
+        const std::vector<uint8_t> chunk = ds.readBytes(len);
+        hash.add(chunk.data(), chunk.size());
+
+        remaining -= len;
+    }
+
+    blobHash = hash.getHash();
+
+    mCtx.mLogger.trace("payloadOffset = {}", payloadOffset);
+    mCtx.mLogger.trace("payloadSize   = {}", payloadSize);
+    mCtx.mLogger.trace("blobHash      = {}", hash.to_string());
+
+    mCtx.mBlobRefs.push_back(BlobRef{BlobKind::Ole, payloadOffset, payloadSize, blobHash, ".ole"});
+}
+
+std::vector<uint8_t> OOCP::StructGraphicOleEmbedInst::loadPayload() const
+{
+    std::ifstream is{mCtx.mInputStream, std::ios::in | std::ios::binary};
+
+    if(!is)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Can not open file for reading: {}", __func__, mCtx.mInputStream.string()));
+    }
+
+    std::vector<uint8_t> data(payloadSize);
+
+    is.seekg(static_cast<std::streamoff>(payloadOffset));
+    is.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    if(static_cast<std::size_t>(is.gcount()) != data.size())
+    {
+        throw std::runtime_error(fmt::format("{}: Payload at offset {} is out of range in {}", __func__,
+            payloadOffset, mCtx.mInputStream.string()));
+    }
+
+    return data;
+}
+
+void OOCP::StructGraphicOleEmbedInst::copyPayload(std::ostream& aOs) const
+{
+    std::ifstream is{mCtx.mInputStream, std::ios::in | std::ios::binary};
+
+    if(!is)
+    {
+        throw std::runtime_error(
+            fmt::format("{}: Can not open file for reading: {}", __func__, mCtx.mInputStream.string()));
+    }
+
+    is.seekg(static_cast<std::streamoff>(payloadOffset));
+
+    std::vector<char> chunk(std::min(payloadSize, PayloadChunkSize));
+
+    for(size_t remaining = payloadSize; remaining > 0U;)
+    {
+        const size_t len = std::min(remaining, chunk.size());
+
+        is.read(chunk.data(), static_cast<std::streamsize>(len));
+
+        if(static_cast<std::size_t>(is.gcount()) != len)
+        {
+            throw std::runtime_error(fmt::format("{}: Payload at offset {} is out of range in {}", __func__,
+                payloadOffset, mCtx.mInputStream.string()));
+        }
+
+        aOs.write(chunk.data(), static_cast<std::streamsize>(len));
+
+        remaining -= len;
+    }
+}
+
+std::vector<OOCP::CfbEntry> OOCP::StructGraphicOleEmbedInst::getPayloadEntries() const
+{
+    std::vector<uint8_t> payload = loadPayload();
+
+    // OLE objects are stored with some leading header, the container starts at its magic bytes
+    const auto it = std::search(payload.cbegin(), payload.cend(), CfbMagicBytes.cbegin(), CfbMagicBytes.cend());
+
+    if(it == payload.cend())
+    {
+        mCtx.mLogger.debug("{}: No CFBF container found in payload of `{}`", getMethodName(this, __func__), name);
+
+        return {};
+    }
+
+    payload.erase(payload.cbegin(), it);
+
+    const ContainerExtractor extractor{payload, fmt::format("{}_{}", mCtx.mInputStream.stem().string(), dbId)};
+
+    return extractor.getEntries();
+}
@@ -1,15 +1,18 @@
 #ifndef STRUCTGRAPHICOLEEMBEDINST_HPP
 #define STRUCTGRAPHICOLEEMBEDINST_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include <fmt/core.h>
 #include <nameof.hpp>
 
+#include "ContainerExtractor.hpp"
 #include "General.hpp"
 #include "Structures/StructGraphicInst.hpp"
 
@@ -19,7 +22,10 @@ class StructGraphicOleEmbedInst : public StructGraphicInst
 {
 public:
     StructGraphicOleEmbedInst(StreamContext& aCtx)
-        : StructGraphicInst{aCtx}
+        : StructGraphicInst{aCtx},
+          payloadOffset{0U},
+          payloadSize{0U},
+          blobHash{0U}
     {
     }
 
@@ -36,6 +42,32 @@ public:
     {
         return Structure::GraphicOleEmbedInst;
     }
+
+    /**
+     * @brief Read the embedded object from the stream file.
+     *
+     * @note The payload is not kept in memory after parsing, this requires the extracted stream file.
+     */
+    std::vector<uint8_t> loadPayload() const;
+
+    /**
+     * @brief Copy the embedded object from the stream file without loading it at once.
+     */
+    void copyPayload(std::ostream& aOs) const;
+
+    /**
+     * @brief List the streams of the embedded object, if it contains a CFBF container.
+     *
+     * @return std::vector<CfbEntry> Empty if no container was found in the payload.
+     */
+    std::vector<CfbEntry> getPayloadEntries() const;
+
+    size_t payloadOffset; //!< Offset of the embedded object inside the stream
+    size_t payloadSize;   //!< Size of the embedded object in byte, 0 if there is none
+    uint64_t blobHash;    //!< Content hash of the embedded object
+
+private:
+    void readPayload(size_t aEndOffset);
 };
 
 [[maybe_unused]]
@@ -52,6 +84,10 @@ inline std::string StructGraphicOleEmbedInst::to_string() const
 
     str += StructGraphicInst::to_string();
 
+    str += fmt::format("{}payloadOffset = {}\n", indent(1), payloadOffset);
+    str += fmt::format("{}payloadSize   = {}\n", indent(1), payloadSize);
+    str += fmt::format("{}blobHash      = {:016x}\n", indent(1), blobHash);
+
     return str;
 }
 
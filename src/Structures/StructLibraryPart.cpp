@@ -1,4 +1,6 @@
+#include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -14,19 +16,33 @@
 #include "Structures/StructLibraryPart.hpp"
 
 void OOCP::StructLibraryPart::read(FileFormatVersion /* aVersion */)
+{
+    FutureDataLst localFutureLst{mCtx};
+
+    const uint16_t len0 = readHead(localFutureLst);
+
+    const size_t nextCheckpointPos = localFutureLst.getNextCheckpointPos().value_or(0U);
+
+    for(size_t i = 0u; i < len0; ++i)
+    {
+        primitives.push_back(readNextPrimitive(nextCheckpointPos));
+    }
+
+    readTail(localFutureLst, nextCheckpointPos);
+}
+
+uint16_t OOCP::StructLibraryPart::readHead(FutureDataLst& aLocalFutureLst)
 {
     auto& ds = mCtx.mDs;
     GenericParser parser{mCtx};
 
     mCtx.mLogger.debug(getOpeningMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
 
-    FutureDataLst localFutureLst{mCtx};
-
-    parser.auto_read_prefixes(localFutureLst);
+    parser.auto_read_prefixes(aLocalFutureLst);
 
     parser.readPreamble();
 
-    localFutureLst.checkpoint();
+    aLocalFutureLst.checkpoint();
 
     name = ds.readStringLenZeroTerm();
 
@@ -37,67 +53,93 @@ void OOCP::StructLibraryPart::read(FileFormatVersion /* aVersion */)
 
     mCtx.mLogger.trace("sourceLibrary = {}", sourceLibrary);
 
-    localFutureLst.checkpoint();
+    aLocalFutureLst.checkpoint();
 
     ds.printUnknownData(4, fmt::format("{}: 2", getMethodName(this, __func__)));
 
     const uint16_t len0 = ds.readUint16();
 
-    const size_t nextCheckpointPos = localFutureLst.getNextCheckpointPos().value_or(0U);
-
     mCtx.mLogger.trace("len0 = {}", len0);
 
-    for(size_t i = 0u; i < len0; ++i)
+    return len0;
+}
+
+std::unique_ptr<OOCP::PrimBase> OOCP::StructLibraryPart::readNextPrimitive(size_t aNextCheckpointPos)
+{
+    auto& ds = mCtx.mDs;
+    GenericParser parser{mCtx};
+
+    const Primitive primitive = parser.readPrefixPrimitive();
+
+    // @todo Hack to get SymbolVector working
+    if(primitive == Primitive::SymbolVector)
+    {
+        ds.setCurrentOffset(ds.getCurrentOffset() - 1U);
+    }
+
+    std::unique_ptr<PrimBase> prim = parser.readPrimitive(primitive);
+
+    // @todo Sometimes there is trailing data after the primitives
+    //       but I don't know how many bytes, therefore discard them
+    //       until the next primitive occurs. There might be rare
+    //       false positives
+    int discard_ctr = 0;
+    for(discard_ctr = 0; discard_ctr < 64 && ds.getCurrentOffset() < aNextCheckpointPos; ++discard_ctr)
     {
-        const Primitive primitive = parser.readPrefixPrimitive();
+        const auto prefix = ds.peek(2);
 
-        // @todo Hack to get SymbolVector working
-        if(primitive == Primitive::SymbolVector)
+        bool isPrimValid = true;
+
+        try
         {
-            ds.setCurrentOffset(ds.getCurrentOffset() - 1U);
+            ToPrimitive(prefix[0]);
+        }
+        catch(...)
+        {
+            isPrimValid = false;
         }
 
-        primitives.push_back(parser.readPrimitive(primitive));
-
-        // @todo Sometimes there is trailing data after the primitives
-        //       but I don't know how many bytes, therefore discard them
-        //       until the next primitive occurs. There might be rare
-        //       false positives
-        int discard_ctr = 0;
-        for(discard_ctr = 0; discard_ctr < 64 && ds.getCurrentOffset() < nextCheckpointPos; ++discard_ctr)
+        if(prefix[0] == prefix[1] && isPrimValid)
         {
-            const auto prefix = ds.peek(2);
+            break;
+        }
 
-            bool isPrimValid = true;
+        ds.discardBytes(1U);
+    }
 
-            try
-            {
-                ToPrimitive(prefix[0]);
-            }
-            catch(...)
-            {
-                isPrimValid = false;
-            }
+    ds.setCurrentOffset(ds.getCurrentOffset() - discard_ctr);
+    ds.printUnknownData(discard_ctr, getMethodName(this, __func__) + ": Mysterious Content");
 
-            if(prefix[0] == prefix[1] && isPrimValid)
-            {
-                break;
-            }
+    return prim;
+}
 
-            ds.discardBytes(1U);
-        }
+void OOCP::StructLibraryPart::readTail(FutureDataLst& aLocalFutureLst, size_t aNextCheckpointPos)
+{
+    auto& ds = mCtx.mDs;
+    GenericParser parser{mCtx};
 
-        ds.setCurrentOffset(ds.getCurrentOffset() - discard_ctr);
-        ds.printUnknownData(discard_ctr, getMethodName(this, __func__) + ": Mysterious Content");
-    }
+    // The symbol bounding box directly precedes the checkpoint
+    const std::size_t bboxSize = 4U * sizeof(int16_t);
 
     // @todo Parts of it probably belong to the upper trailing data
-    if(ds.getCurrentOffset() < nextCheckpointPos)
+    if(ds.getCurrentOffset() + bboxSize <= aNextCheckpointPos)
+    {
+        ds.printUnknownData(aNextCheckpointPos - bboxSize - ds.getCurrentOffset(),
+            getMethodName(this, __func__) + ": Trailing data");
+
+        bboxX1 = ds.readInt16();
+        bboxY1 = ds.readInt16();
+        bboxX2 = ds.readInt16();
+        bboxY2 = ds.readInt16();
+
+        mCtx.mLogger.trace("bbox = ({}, {}) - ({}, {})", bboxX1, bboxY1, bboxX2, bboxY2);
+    }
+    else if(ds.getCurrentOffset() < aNextCheckpointPos)
     {
-        localFutureLst.readUntilNextFutureData("See FuturData of StructLibraryPart");
+        aLocalFutureLst.readUntilNextFutureData("See FuturData of StructLibraryPart");
     }
 
-    localFutureLst.checkpoint();
+    aLocalFutureLst.checkpoint();
 
     const uint16_t lenSymbolPins = ds.readUint16();
 
@@ -131,22 +173,22 @@ void OOCP::StructLibraryPart::read(FileFormatVersion /* aVersion */)
         symbolDisplayProps.push_back(dynamic_pointer_cast<StructSymbolDisplayProp>(parser.readStructure()));
     }
 
-    localFutureLst.checkpoint();
+    aLocalFutureLst.checkpoint();
 
-    if(!localFutureLst.empty())
+    if(!aLocalFutureLst.empty())
     {
-        mCtx.mLogger.debug("Checking {} vs {}", localFutureLst.cbegin()->getStopOffset(), ds.getCurrentOffset());
-        if(localFutureLst.cbegin()->getStopOffset() > ds.getCurrentOffset())
+        mCtx.mLogger.debug("Checking {} vs {}", aLocalFutureLst.cbegin()->getStopOffset(), ds.getCurrentOffset());
+        if(aLocalFutureLst.cbegin()->getStopOffset() > ds.getCurrentOffset())
         {
             parser.readPreamble();
 
             generalProperties.read();
 
-            localFutureLst.checkpoint();
+            aLocalFutureLst.checkpoint();
         }
     }
 
-    localFutureLst.sanitizeCheckpoints();
+    aLocalFutureLst.sanitizeCheckpoints();
 
     mCtx.mLogger.debug(getClosingMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
     mCtx.mLogger.trace(to_string());
@@ -1,6 +1,7 @@
 #ifndef STRUCTLIBRARYPART_HPP
 #define STRUCTLIBRARYPART_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <ostream>
@@ -10,6 +11,7 @@
 #include <fmt/core.h>
 #include <nameof.hpp>
 
+#include "FutureData.hpp"
 #include "Primitives/PrimBase.hpp"
 #include "Record.hpp"
 #include "Structures/StructGeneralProperties.hpp"
@@ -24,6 +26,10 @@ public:
     StructLibraryPart(StreamContext& aCtx)
         : Record{aCtx},
           name{},
+          bboxX1{0},
+          bboxY1{0},
+          bboxX2{0},
+          bboxY2{0},
           symbolPins{},
           symbolDisplayProps{},
           generalProperties{aCtx}
@@ -34,6 +40,26 @@ public:
 
     void read(FileFormatVersion aVersion = FileFormatVersion::Unknown) override;
 
+    // `read` is split into the following steps such that primitives
+    // can be decoded one at a time without keeping them.
+
+    /**
+     * @brief Read the part up to its primitives.
+     *
+     * @return uint16_t Number of primitives that follow.
+     */
+    uint16_t readHead(FutureDataLst& aLocalFutureLst);
+
+    /**
+     * @param aNextCheckpointPos Checkpoint following the primitives, determined right after `readHead`.
+     */
+    std::unique_ptr<PrimBase> readNextPrimitive(std::size_t aNextCheckpointPos);
+
+    /**
+     * @brief Read the rest of the part following its primitives.
+     */
+    void readTail(FutureDataLst& aLocalFutureLst, std::size_t aNextCheckpointPos);
+
     // void accept(Visitor& aVisitor) const override
     // {
     //     aVisitor.visit(*this);
@@ -46,6 +72,13 @@ public:
 
     std::string name;
 
+    // Symbol bounding box as stored by OrCAD, see `getBoundingBox` for
+    // the bounding box calculated from the primitives.
+    int32_t bboxX1;
+    int32_t bboxY1;
+    int32_t bboxX2;
+    int32_t bboxY2;
+
     std::vector<std::unique_ptr<PrimBase>> primitives;
     std::vector<std::unique_ptr<StructSymbolPin>> symbolPins;
     std::vector<std::unique_ptr<StructSymbolDisplayProp>> symbolDisplayProps;
@@ -60,6 +93,10 @@ static std::string to_string(const StructLibraryPart& aObj)
 
     str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
     str += fmt::format("{}name = {}\n", indent(1), aObj.name);
+    str += fmt::format("{}bboxX1 = {}\n", indent(1), aObj.bboxX1);
+    str += fmt::format("{}bboxY1 = {}\n", indent(1), aObj.bboxY1);
+    str += fmt::format("{}bboxX2 = {}\n", indent(1), aObj.bboxX2);
+    str += fmt::format("{}bboxY2 = {}\n", indent(1), aObj.bboxY2);
 
     str += fmt::format("{}primitives:\n", indent(1));
     for(size_t i = 0u; i < aObj.primitives.size(); ++i)
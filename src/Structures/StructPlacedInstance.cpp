@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <cstdint>
 #include <ostream>
 #include <string>
@@ -8,6 +9,7 @@
 #include "Enums/Color.hpp"
 #include "Enums/LineStyle.hpp"
 #include "Enums/LineWidth.hpp"
+#include "Enums/Rotation.hpp"
 #include "Enums/Structure.hpp"
 #include "FutureData.hpp"
 #include "General.hpp"
@@ -23,31 +25,55 @@ void OOCP::StructPlacedInstance::read(FileFormatVersion /* aVersion */)
 
     FutureDataLst localFutureLst{mCtx};
 
+    const size_t mappingStart = mCtx.mNameValueMappings.size();
+
     parser.auto_read_prefixes(Structure::PlacedInstance, localFutureLst);
 
+    // Instance properties like `Value` are name/value mappings of the short prefix
+    for(size_t i = mappingStart; i < mCtx.mNameValueMappings.size(); ++i)
+    {
+        if(mCtx.mNameValueMappings[i].structure == Structure::PlacedInstance)
+        {
+            propOffset = mCtx.mNameValueMappings[i].offset;
+        }
+    }
+
+    mCtx.mLogger.trace("propOffset = {}", propOffset.has_value() ? std::to_string(propOffset.value()) : "-");
+
     parser.readPreamble();
 
     localFutureLst.checkpoint();
 
     ds.printUnknownData(8, getMethodName(this, __func__) + ": 0");
 
-    const std::string pkgName = ds.readStringLenZeroTerm();
+    pkgName = ds.readStringLenZeroTerm();
 
     mCtx.mLogger.trace("pkgName = {}", pkgName);
 
-    const uint32_t dbId = ds.readUint32();
+    dbId = ds.readUint32();
 
     mCtx.mLogger.trace("dbId = {}", dbId);
 
     ds.printUnknownData(8, getMethodName(this, __func__) + ": 1");
 
-    const int16_t locX = ds.readInt16();
-    const int16_t locY = ds.readInt16();
+    locX = ds.readInt16();
+    locY = ds.readInt16();
 
     mCtx.mLogger.trace("locX = {}", locX);
     mCtx.mLogger.trace("locY = {}", locY);
 
-    ds.printUnknownData(4, getMethodName(this, __func__) + ": 2");
+    // @todo Educated guess, needs verification with designs that contain rotated
+    //       and mirrored instances. The orientation is assumed to be packed like
+    //       in OrCAD's XML export, i.e. the rotation in 90° steps and a mirror flag.
+    const uint16_t orientation = ds.readUint16();
+
+    rotation = ToRotation(static_cast<uint8_t>(orientation & 0x3U));
+    mirrored = (orientation & 0x4U) != 0U;
+
+    mCtx.mLogger.trace("rotation = {}", OOCP::to_string(rotation));
+    mCtx.mLogger.trace("mirrored = {}", mirrored);
+
+    ds.printUnknownData(2, getMethodName(this, __func__) + ": 2");
 
     const uint16_t lenSymbolDisplayProps = ds.readUint16();
 
@@ -62,7 +88,7 @@ void OOCP::StructPlacedInstance::read(FileFormatVersion /* aVersion */)
 
     localFutureLst.checkpoint();
 
-    const std::string reference = ds.readStringLenZeroTerm();
+    reference = ds.readStringLenZeroTerm();
 
     mCtx.mLogger.trace("reference = {}", reference);
 
@@ -79,9 +105,9 @@ void OOCP::StructPlacedInstance::read(FileFormatVersion /* aVersion */)
 
     localFutureLst.checkpoint();
 
-    const std::string source_package = ds.readStringLenZeroTerm(); // @todo needs verification
+    sourcePackage = ds.readStringLenZeroTerm(); // @todo needs verification
 
-    mCtx.mLogger.trace("source_package = {}", source_package);
+    mCtx.mLogger.trace("sourcePackage = {}", sourcePackage);
 
     ds.printUnknownData(2, getMethodName(this, __func__) + ": 5");
 
@@ -11,6 +11,7 @@
 #include <fmt/core.h>
 #include <nameof.hpp>
 
+#include "Enums/Rotation.hpp"
 #include "General.hpp"
 #include "Record.hpp"
 #include "Structures/StructSymbolDisplayProp.hpp"
@@ -23,8 +24,17 @@ class StructPlacedInstance : public Record
 public:
     StructPlacedInstance(StreamContext& aCtx)
         : Record{aCtx},
+          propOffset{},
+          pkgName{},
+          dbId{0},
+          locX{0},
+          locY{0},
+          rotation{Rotation::Deg_0},
+          mirrored{false},
           symbolDisplayProps{},
-          t0x10s{}
+          reference{},
+          t0x10s{},
+          sourcePackage{}
     {
     }
 
@@ -42,8 +52,28 @@ public:
         return Structure::PlacedInstance;
     }
 
+    //! Offset of the short prefix holding the instance properties, see `PropertyTable::findObject`.
+    //! Not set if the instance has no properties.
+    std::optional<size_t> propOffset;
+
+    std::string pkgName;
+
+    uint32_t dbId;
+
+    int16_t locX;
+    int16_t locY;
+
+    // @todo Location of rotation and mirroring inside the structure needs verification
+    Rotation rotation;
+    bool mirrored;
+
     std::vector<std::unique_ptr<StructSymbolDisplayProp>> symbolDisplayProps;
+
+    std::string reference;
+
     std::vector<std::unique_ptr<StructT0x10>> t0x10s;
+
+    std::string sourcePackage; // @todo needs verification
 };
 
 [[maybe_unused]]
@@ -52,6 +82,14 @@ static std::string to_string(const StructPlacedInstance& aObj)
     std::string str;
 
     str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}propOffset = {}\n", indent(1),
+        aObj.propOffset.has_value() ? std::to_string(aObj.propOffset.value()) : std::string{"-"});
+    str += fmt::format("{}pkgName  = {}\n", indent(1), aObj.pkgName);
+    str += fmt::format("{}dbId     = {}\n", indent(1), aObj.dbId);
+    str += fmt::format("{}locX     = {}\n", indent(1), aObj.locX);
+    str += fmt::format("{}locY     = {}\n", indent(1), aObj.locY);
+    str += fmt::format("{}rotation = {}\n", indent(1), to_string(aObj.rotation));
+    str += fmt::format("{}mirrored = {}\n", indent(1), aObj.mirrored);
 
     str += fmt::format("{}symbolDisplayProps:\n", indent(1));
     for(size_t i = 0u; i < aObj.symbolDisplayProps.size(); ++i)
@@ -62,6 +100,8 @@ static std::string to_string(const StructPlacedInstance& aObj)
         }
     }
 
+    str += fmt::format("{}reference = {}\n", indent(1), aObj.reference);
+
     str += fmt::format("{}t0x10s:\n", indent(1));
     for(size_t i = 0u; i < aObj.t0x10s.size(); ++i)
     {
@@ -71,6 +111,8 @@ static std::string to_string(const StructPlacedInstance& aObj)
         }
     }
 
+    str += fmt::format("{}sourcePackage = {}\n", indent(1), aObj.sourcePackage);
+
     return str;
 }
 
@@ -10,6 +10,7 @@
 #include "GenericParser.hpp"
 #include "GetStreamHelper.hpp"
 #include "Structures/StructSymbolDisplayProp.hpp"
+#include "Win32/LOGFONTA.hpp"
 
 void OOCP::StructSymbolDisplayProp::read(FileFormatVersion /* aVersion */)
 {
@@ -28,6 +29,8 @@ void OOCP::StructSymbolDisplayProp::read(FileFormatVersion /* aVersion */)
 
     localFutureLst.checkpoint();
 
+    mCtx.mStrLstRefs.push_back(ds.getCurrentOffset());
+
     nameIdx = ds.readUint32();
 
     // @todo move to left shift operator
@@ -61,6 +64,8 @@ void OOCP::StructSymbolDisplayProp::read(FileFormatVersion /* aVersion */)
         uint16_t rotation : 2;     // 15 downto 14
     };
 
+    mCtx.mFontIdxRefs.push_back(FontIdxRef{ds.getCurrentOffset(), 0x3fff});
+
     const RotFontIdBitField rotFontIdBitField{ds.readUint16()};
 
     textFontIdx = rotFontIdBitField.textFontIdx;
@@ -103,4 +108,50 @@ void OOCP::StructSymbolDisplayProp::read(FileFormatVersion /* aVersion */)
 
     mCtx.mLogger.debug(getClosingMsg(getMethodName(this, __func__), ds.getCurrentOffset()));
     mCtx.mLogger.trace(to_string());
+}
+
+std::string OOCP::StructSymbolDisplayProp::getName() const
+{
+    const auto lib = getLibraryStreamFromDb(mCtx.mDb);
+
+    if(lib && nameIdx < lib->strLst.size())
+    {
+        return lib->strLst.at(nameIdx);
+    }
+
+    return std::string{};
+}
+
+OOCP::LOGFONTA OOCP::StructSymbolDisplayProp::getTextFont() const
+{
+    const auto lib = getLibraryStreamFromDb(mCtx.mDb);
+
+    const int64_t idx = static_cast<int64_t>(textFontIdx) - 1;
+
+    LOGFONTA textFont{};
+
+    if(idx >= 0)
+    {
+        // Retrieve font from `Library`
+        if(lib)
+        {
+            if(static_cast<std::size_t>(idx) < lib->textFonts.size())
+            {
+                textFont = lib->textFonts.at(idx);
+            }
+            else
+            {
+                mCtx.mLogger.warn("Index is out-of-range: {} vs {}", idx, lib->textFonts.size());
+            }
+        }
+    }
+    else if(lib && !lib->defaultFontIdxs.empty())
+    {
+        // idx == -1 refers to the first default font, OrCAD's XML
+        // export lists it without a face name
+        textFont               = lib->getDefaultFont(0U);
+        textFont.lfFaceName[0] = '\0';
+    }
+
+    return textFont;
 }
\ No newline at end of file
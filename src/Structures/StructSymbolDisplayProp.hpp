@@ -11,6 +11,7 @@
 #include "Enums/Color.hpp"
 #include "Enums/Rotation.hpp"
 #include "Record.hpp"
+#include "Win32/LOGFONTA.hpp"
 
 namespace OOCP
 {
@@ -42,6 +43,15 @@ public:
         return Structure::SymbolDisplayProp;
     }
 
+    /**
+     * @brief Get name of the property from the `Library` string list.
+     *
+     * @return std::string Property name or an empty string if it could not be resolved.
+     */
+    std::string getName() const;
+
+    LOGFONTA getTextFont() const;
+
     uint32_t nameIdx;
     uint16_t textFontIdx;
 
@@ -53,8 +63,6 @@ public:
     Color propColor;
 };
 
-// @todo implement getter methods for name and textFont
-
 [[maybe_unused]]
 static std::string to_string(const StructSymbolDisplayProp& aObj)
 {
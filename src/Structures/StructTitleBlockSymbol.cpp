@@ -22,6 +22,10 @@ void OOCP::StructTitleBlockSymbol::read(FileFormatVersion aVersion)
         aVersion                  = parser.predictVersion(predictionFunc);
     }
 
+    // Failed attempts of the version prediction already added pins and properties
+    symbolPins.clear();
+    symbolDisplayProps.clear();
+
     FutureDataLst localFutureLst{mCtx};
 
     parser.auto_read_prefixes(Structure::TitleBlockSymbol, localFutureLst);
@@ -0,0 +1,474 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <utility>
+#include <vector>
+
+#include "Primitives/PrimArc.hpp"
+#include "Primitives/PrimBase.hpp"
+#include "Primitives/PrimBezier.hpp"
+#include "Primitives/PrimEllipse.hpp"
+#include "Tessellation.hpp"
+
+namespace
+{
+// Number of curves that are processed side by side. Keeping independent
+// curves in separate lanes breaks the dependency chain of the recurrences
+// and allows the compiler to vectorize the inner loops.
+constexpr std::size_t LaneCount = 4U;
+
+// Upper limit of segments per curve, protects against tiny tolerances
+constexpr std::size_t MaxSegmentCount = 4096U;
+
+constexpr double TwoPi = 2.0 * std::numbers::pi;
+
+// Reserve output space for aCounts[i] + 1 points per curve
+std::size_t appendRanges(const std::vector<std::size_t>& aSegmentCounts, OOCP::PolylineBatch& aOut)
+{
+    const std::size_t firstPoint = aOut.ranges.back();
+
+    for(const auto segmentCount : aSegmentCounts)
+    {
+        aOut.ranges.push_back(aOut.ranges.back() + segmentCount + 1U);
+    }
+
+    aOut.x.resize(aOut.ranges.back());
+    aOut.y.resize(aOut.ranges.back());
+
+    return firstPoint;
+}
+} // namespace
+
+void OOCP::EllipticArcBatch::add(
+    double aCenterX, double aCenterY, double aRadiusX, double aRadiusY, double aStartAngle, double aSweep)
+{
+    centerX.push_back(aCenterX);
+    centerY.push_back(aCenterY);
+    radiusX.push_back(aRadiusX);
+    radiusY.push_back(aRadiusY);
+    startAngle.push_back(aStartAngle);
+    sweep.push_back(aSweep);
+}
+
+void OOCP::EllipticArcBatch::add(const PrimArc& aArc)
+{
+    const PrimArc::EllipticArc arc = aArc.getEllipticArc();
+
+    add(arc.centerX, arc.centerY, arc.radiusX, arc.radiusY, arc.startAngle, arc.sweep);
+}
+
+void OOCP::EllipticArcBatch::add(const PrimEllipse& aEllipse)
+{
+    const double cx = (aEllipse.x1 + aEllipse.x2) / 2.0;
+    const double cy = (aEllipse.y1 + aEllipse.y2) / 2.0;
+    const double rx = std::abs(aEllipse.x2 - aEllipse.x1) / 2.0;
+    const double ry = std::abs(aEllipse.y2 - aEllipse.y1) / 2.0;
+
+    add(cx, cy, rx, ry, 0.0, TwoPi);
+}
+
+void OOCP::BezierBatch::add(
+    double aX0, double aY0, double aX1, double aY1, double aX2, double aY2, double aX3, double aY3)
+{
+    x0.push_back(aX0);
+    y0.push_back(aY0);
+    x1.push_back(aX1);
+    y1.push_back(aY1);
+    x2.push_back(aX2);
+    y2.push_back(aY2);
+    x3.push_back(aX3);
+    y3.push_back(aY3);
+}
+
+std::size_t OOCP::BezierBatch::add(const PrimBezier& aBezier)
+{
+    const auto& pts = aBezier.points;
+
+    std::size_t segmentCount = 0U;
+
+    for(std::size_t i = 0U; i + 3U < pts.size(); i += 3U)
+    {
+        add(pts[i].x, pts[i].y, pts[i + 1U].x, pts[i + 1U].y, pts[i + 2U].x, pts[i + 2U].y, pts[i + 3U].x,
+            pts[i + 3U].y);
+
+        ++segmentCount;
+    }
+
+    return segmentCount;
+}
+
+std::size_t OOCP::getArcSegmentCount(double aRadiusX, double aRadiusY, double aSweep, double aTolerance)
+{
+    const double radius = std::max(aRadiusX, aRadiusY);
+
+    if(radius <= 0.0 || aSweep <= 0.0)
+    {
+        return 1U;
+    }
+
+    // An ellipse is the affine image of the unit circle. Scaling a chord's
+    // deviation of 1 - cos(step / 2) on the unit circle by the larger radius
+    // bounds the deviation on the ellipse.
+    const double ratio = std::clamp(aTolerance / radius, 0.0, 1.0);
+
+    double step = 2.0 * std::acos(1.0 - ratio);
+
+    // Keep at least 4 segments for a full ellipse, even for huge tolerances
+    step = std::min(step, std::numbers::pi / 2.0);
+
+    if(step <= 0.0)
+    {
+        return MaxSegmentCount;
+    }
+
+    const double segmentCount = std::ceil(aSweep / step);
+
+    return std::clamp<std::size_t>(static_cast<std::size_t>(segmentCount), 1U, MaxSegmentCount);
+}
+
+std::size_t OOCP::getBezierSegmentCount(
+    double aX0, double aY0, double aX1, double aY1, double aX2, double aY2, double aX3, double aY3, double aTolerance)
+{
+    // The deviation of a uniform flattening with n segments is bounded by
+    // max|B''| / (8 * n^2) where max|B''| <= 6 * max(|P0 - 2P1 + P2|, |P1 - 2P2 + P3|)
+    const double d0 = std::hypot(aX0 - 2.0 * aX1 + aX2, aY0 - 2.0 * aY1 + aY2);
+    const double d1 = std::hypot(aX1 - 2.0 * aX2 + aX3, aY1 - 2.0 * aY2 + aY3);
+
+    const double d = std::max(d0, d1);
+
+    if(d <= 0.0)
+    {
+        // Straight line
+        return 1U;
+    }
+
+    if(aTolerance <= 0.0)
+    {
+        return MaxSegmentCount;
+    }
+
+    const double segmentCount = std::ceil(std::sqrt(0.75 * d / aTolerance));
+
+    return std::clamp<std::size_t>(static_cast<std::size_t>(segmentCount), 1U, MaxSegmentCount);
+}
+
+void OOCP::tessellate(const EllipticArcBatch& aArcs, double aTolerance, PolylineBatch& aOut)
+{
+    const std::size_t count = aArcs.size();
+
+    std::vector<std::size_t> segmentCounts(count);
+
+    for(std::size_t i = 0U; i < count; ++i)
+    {
+        segmentCounts[i] = getArcSegmentCount(aArcs.radiusX[i], aArcs.radiusY[i], aArcs.sweep[i], aTolerance);
+    }
+
+    const std::size_t firstRange = aOut.ranges.size() - 1U;
+
+    appendRanges(segmentCounts, aOut);
+
+    for(std::size_t group = 0U; group < count; group += LaneCount)
+    {
+        const std::size_t lanes = std::min(LaneCount, count - group);
+
+        // Unused lanes are zero initialized and never written to the output
+        std::array<double, LaneCount> cx{}, cy{}, rx{}, ry{};
+        std::array<double, LaneCount> c{}, s{}, stepC{}, stepS{};
+        std::array<std::size_t, LaneCount> n{}, offset{};
+
+        std::size_t maxN = 0U;
+
+        for(std::size_t l = 0U; l < lanes; ++l)
+        {
+            const std::size_t i = group + l;
+
+            cx[l] = aArcs.centerX[i];
+            cy[l] = aArcs.centerY[i];
+            rx[l] = aArcs.radiusX[i];
+            ry[l] = aArcs.radiusY[i];
+
+            n[l]      = segmentCounts[i];
+            offset[l] = aOut.ranges[firstRange + i];
+
+            const double step = aArcs.sweep[i] / n[l];
+
+            c[l]     = std::cos(aArcs.startAngle[i]);
+            s[l]     = std::sin(aArcs.startAngle[i]);
+            stepC[l] = std::cos(step);
+            stepS[l] = std::sin(step);
+
+            maxN = std::max(maxN, n[l]);
+        }
+
+        for(std::size_t k = 0U; k <= maxN; ++k)
+        {
+            std::array<double, LaneCount> px, py;
+
+            for(std::size_t l = 0U; l < LaneCount; ++l)
+            {
+                px[l] = cx[l] + rx[l] * c[l];
+                py[l] = cy[l] - ry[l] * s[l];
+
+                // Rotate by the step angle
+                const double nextC = c[l] * stepC[l] - s[l] * stepS[l];
+                const double nextS = s[l] * stepC[l] + c[l] * stepS[l];
+
+                c[l] = nextC;
+                s[l] = nextS;
+            }
+
+            for(std::size_t l = 0U; l < lanes; ++l)
+            {
+                if(k <= n[l])
+                {
+                    aOut.x[offset[l] + k] = px[l];
+                    aOut.y[offset[l] + k] = py[l];
+                }
+            }
+        }
+
+        // Place end points exactly to avoid accumulated rounding errors
+        for(std::size_t l = 0U; l < lanes; ++l)
+        {
+            const std::size_t i   = group + l;
+            const double endAngle = aArcs.startAngle[i] + aArcs.sweep[i];
+
+            aOut.x[offset[l] + n[l]] = cx[l] + rx[l] * std::cos(endAngle);
+            aOut.y[offset[l] + n[l]] = cy[l] - ry[l] * std::sin(endAngle);
+        }
+    }
+}
+
+void OOCP::tessellate(const BezierBatch& aBeziers, double aTolerance, PolylineBatch& aOut)
+{
+    const std::size_t count = aBeziers.size();
+
+    std::vector<std::size_t> segmentCounts(count);
+
+    for(std::size_t i = 0U; i < count; ++i)
+    {
+        segmentCounts[i] = getBezierSegmentCount(aBeziers.x0[i], aBeziers.y0[i], aBeziers.x1[i], aBeziers.y1[i],
+            aBeziers.x2[i], aBeziers.y2[i], aBeziers.x3[i], aBeziers.y3[i], aTolerance);
+    }
+
+    const std::size_t firstRange = aOut.ranges.size() - 1U;
+
+    appendRanges(segmentCounts, aOut);
+
+    for(std::size_t group = 0U; group < count; group += LaneCount)
+    {
+        const std::size_t lanes = std::min(LaneCount, count - group);
+
+        // Forward differences of B(t) = a * t^3 + b * t^2 + c * t + d
+        std::array<double, LaneCount> fx{}, dfx{}, ddfx{}, dddfx{};
+        std::array<double, LaneCount> fy{}, dfy{}, ddfy{}, dddfy{};
+        std::array<std::size_t, LaneCount> n{}, offset{};
+
+        std::size_t maxN = 0U;
+
+        for(std::size_t l = 0U; l < lanes; ++l)
+        {
+            const std::size_t i = group + l;
+
+            n[l]      = segmentCounts[i];
+            offset[l] = aOut.ranges[firstRange + i];
+
+            const double h  = 1.0 / n[l];
+            const double h2 = h * h;
+            const double h3 = h2 * h;
+
+            const auto init = [&](double p0, double p1, double p2, double p3, double& f, double& df, double& ddf,
+                                  double& dddf)
+            {
+                const double a = -p0 + 3.0 * p1 - 3.0 * p2 + p3;
+                const double b = 3.0 * p0 - 6.0 * p1 + 3.0 * p2;
+                const double c = -3.0 * p0 + 3.0 * p1;
+
+                f    = p0;
+                df   = a * h3 + b * h2 + c * h;
+                ddf  = 6.0 * a * h3 + 2.0 * b * h2;
+                dddf = 6.0 * a * h3;
+            };
+
+            init(aBeziers.x0[i], aBeziers.x1[i], aBeziers.x2[i], aBeziers.x3[i], fx[l], dfx[l], ddfx[l], dddfx[l]);
+            init(aBeziers.y0[i], aBeziers.y1[i], aBeziers.y2[i], aBeziers.y3[i], fy[l], dfy[l], ddfy[l], dddfy[l]);
+
+            maxN = std::max(maxN, n[l]);
+        }
+
+        for(std::size_t k = 0U; k <= maxN; ++k)
+        {
+            std::array<double, LaneCount> px, py;
+
+            for(std::size_t l = 0U; l < LaneCount; ++l)
+            {
+                px[l] = fx[l];
+                py[l] = fy[l];
+
+                fx[l] += dfx[l];
+                dfx[l] += ddfx[l];
+                ddfx[l] += dddfx[l];
+
+                fy[l] += dfy[l];
+                dfy[l] += ddfy[l];
+                ddfy[l] += dddfy[l];
+            }
+
+            for(std::size_t l = 0U; l < lanes; ++l)
+            {
+                if(k <= n[l])
+                {
+                    aOut.x[offset[l] + k] = px[l];
+                    aOut.y[offset[l] + k] = py[l];
+                }
+            }
+        }
+
+        // Place end points exactly to avoid accumulated rounding errors
+        for(std::size_t l = 0U; l < lanes; ++l)
+        {
+            const std::size_t i = group + l;
+
+            aOut.x[offset[l] + n[l]] = aBeziers.x3[i];
+            aOut.y[offset[l] + n[l]] = aBeziers.y3[i];
+        }
+    }
+}
+
+void OOCP::TessellationCache::prepare(const std::vector<const PrimBase*>& aPrims)
+{
+    std::vector<const PrimBase*> arcPrims;
+    std::vector<const PrimBezier*> bezierPrims;
+
+    EllipticArcBatch arcs;
+    BezierBatch beziers;
+
+    std::vector<std::size_t> bezierSegmentCounts;
+
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+
+        for(const auto prim : aPrims)
+        {
+            if(!prim || mCache.count(prim) > 0U)
+            {
+                continue;
+            }
+
+            if(const auto arc = dynamic_cast<const PrimArc*>(prim))
+            {
+                arcPrims.push_back(prim);
+                arcs.add(*arc);
+            }
+            else if(const auto ellipse = dynamic_cast<const PrimEllipse*>(prim))
+            {
+                arcPrims.push_back(prim);
+                arcs.add(*ellipse);
+            }
+            else if(const auto bezier = dynamic_cast<const PrimBezier*>(prim))
+            {
+                bezierPrims.push_back(bezier);
+                bezierSegmentCounts.push_back(beziers.add(*bezier));
+            }
+        }
+    }
+
+    // Tessellate without holding the lock
+    PolylineBatch arcLines;
+    PolylineBatch bezierLines;
+
+    tessellate(arcs, mTolerance, arcLines);
+    tessellate(beziers, mTolerance, bezierLines);
+
+    std::vector<std::pair<const PrimBase*, std::shared_ptr<const Polyline>>> results;
+
+    for(std::size_t i = 0U; i < arcPrims.size(); ++i)
+    {
+        auto polyline = std::make_shared<Polyline>();
+
+        const auto begin = arcLines.ranges[i];
+        const auto end   = arcLines.ranges[i + 1U];
+
+        polyline->x.assign(arcLines.x.begin() + begin, arcLines.x.begin() + end);
+        polyline->y.assign(arcLines.y.begin() + begin, arcLines.y.begin() + end);
+
+        results.push_back(std::make_pair(arcPrims[i], std::move(polyline)));
+    }
+
+    std::size_t segmentIdx = 0U;
+
+    for(std::size_t i = 0U; i < bezierPrims.size(); ++i)
+    {
+        auto polyline = std::make_shared<Polyline>();
+
+        if(bezierSegmentCounts[i] == 0U)
+        {
+            // Not a complete segment, use the control polygon
+            for(const auto& point : bezierPrims[i]->points)
+            {
+                polyline->x.push_back(point.x);
+                polyline->y.push_back(point.y);
+            }
+        }
+
+        for(std::size_t j = 0U; j < bezierSegmentCounts[i]; ++j, ++segmentIdx)
+        {
+            // Consecutive segments share their end points
+            const auto begin = bezierLines.ranges[segmentIdx] + (j > 0U ? 1U : 0U);
+            const auto end   = bezierLines.ranges[segmentIdx + 1U];
+
+            polyline->x.insert(polyline->x.end(), bezierLines.x.begin() + begin, bezierLines.x.begin() + end);
+            polyline->y.insert(polyline->y.end(), bezierLines.y.begin() + begin, bezierLines.y.begin() + end);
+        }
+
+        results.push_back(std::make_pair(bezierPrims[i], std::move(polyline)));
+    }
+
+    std::lock_guard<std::mutex> lock{mMutex};
+
+    for(auto& [prim, polyline] : results)
+    {
+        mCache.emplace(prim, std::move(polyline));
+    }
+}
+
+std::shared_ptr<const OOCP::Polyline> OOCP::TessellationCache::get(const PrimBase& aPrim)
+{
+    {
+        std::lock_guard<std::mutex> lock{mMutex};
+
+        const auto it = mCache.find(&aPrim);
+
+        if(it != mCache.end())
+        {
+            return it->second;
+        }
+    }
+
+    prepare({&aPrim});
+
+    std::lock_guard<std::mutex> lock{mMutex};
+
+    const auto it = mCache.find(&aPrim);
+
+    return it != mCache.end() ? it->second : std::shared_ptr<const Polyline>{};
+}
+
+std::size_t OOCP::TessellationCache::size() const
+{
+    std::lock_guard<std::mutex> lock{mMutex};
+
+    return mCache.size();
+}
+
+void OOCP::TessellationCache::clear()
+{
+    std::lock_guard<std::mutex> lock{mMutex};
+
+    mCache.clear();
+}
@@ -0,0 +1,233 @@
+#ifndef TESSELLATION_HPP
+#define TESSELLATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "General.hpp"
+
+namespace OOCP
+{
+class PrimArc;
+class PrimBase;
+class PrimBezier;
+class PrimEllipse;
+
+/**
+ * @brief Elliptic arcs in structure of arrays layout.
+ *
+ * @note Angles are parametric angles in radians, measured counterclockwise
+ *       as seen on the page. I.e. a point of the arc is located at
+ *       (centerX + radiusX * cos(t), centerY - radiusY * sin(t)) because
+ *       the Y-axis points downwards.
+ */
+struct EllipticArcBatch
+{
+    std::vector<double> centerX;
+    std::vector<double> centerY;
+    std::vector<double> radiusX;
+    std::vector<double> radiusY;
+    std::vector<double> startAngle;
+    std::vector<double> sweep; //!< Always positive, 2 * pi for a closed ellipse
+
+    std::size_t size() const
+    {
+        return centerX.size();
+    }
+
+    void add(double aCenterX, double aCenterY, double aRadiusX, double aRadiusY, double aStartAngle, double aSweep);
+
+    /**
+     * @brief Add the arc of a `PrimArc`.
+     * @note The arc is assumed to be drawn counterclockwise from its start to its end point.
+     */
+    void add(const PrimArc& aArc);
+
+    /**
+     * @brief Add the closed ellipse of a `PrimEllipse`.
+     */
+    void add(const PrimEllipse& aEllipse);
+};
+
+/**
+ * @brief Cubic bezier segments in structure of arrays layout.
+ */
+struct BezierBatch
+{
+    std::vector<double> x0;
+    std::vector<double> y0;
+    std::vector<double> x1;
+    std::vector<double> y1;
+    std::vector<double> x2;
+    std::vector<double> y2;
+    std::vector<double> x3;
+    std::vector<double> y3;
+
+    std::size_t size() const
+    {
+        return x0.size();
+    }
+
+    void add(double aX0, double aY0, double aX1, double aY1, double aX2, double aY2, double aX3, double aY3);
+
+    /**
+     * @brief Add all segments of a `PrimBezier`. Consecutive segments share their end points.
+     *
+     * @param aBezier Bezier primitive.
+     * @return std::size_t Number of segments that were added.
+     */
+    std::size_t add(const PrimBezier& aBezier);
+};
+
+/**
+ * @brief Packed polylines, i.e. the result of a batch tessellation.
+ *        Points of polyline i are located in [ranges[i], ranges[i + 1]).
+ */
+struct PolylineBatch
+{
+    std::vector<double> x;
+    std::vector<double> y;
+
+    std::vector<std::size_t> ranges{0U};
+
+    std::size_t size() const
+    {
+        return ranges.size() - 1U;
+    }
+
+    void clear()
+    {
+        x.clear();
+        y.clear();
+        ranges.assign(1U, 0U);
+    }
+};
+
+/**
+ * @brief A single tessellated curve.
+ */
+struct Polyline
+{
+    std::vector<double> x;
+    std::vector<double> y;
+};
+
+/**
+ * @brief Number of segments required to approximate an elliptic arc such that
+ *        the chordal deviation does not exceed the tolerance.
+ */
+std::size_t getArcSegmentCount(double aRadiusX, double aRadiusY, double aSweep, double aTolerance);
+
+/**
+ * @brief Number of uniform parameter steps required to approximate a cubic bezier
+ *        segment such that the deviation does not exceed the tolerance.
+ */
+std::size_t getBezierSegmentCount(
+    double aX0, double aY0, double aX1, double aY1, double aX2, double aY2, double aX3, double aY3, double aTolerance);
+
+/**
+ * @brief Tessellate all arcs of the batch. Results are appended to aOut.
+ *
+ * @note Curves are processed in groups, the points of a group are generated
+ *       by a rotation recurrence s.t. sin/cos is only evaluated once per curve.
+ *
+ * @param aArcs Arcs to tessellate.
+ * @param aTolerance Maximum allowed deviation from the exact curve.
+ * @param aOut Tessellated polylines, one per arc.
+ */
+void tessellate(const EllipticArcBatch& aArcs, double aTolerance, PolylineBatch& aOut);
+
+/**
+ * @brief Tessellate all bezier segments of the batch. Results are appended to aOut.
+ *
+ * @note Points are generated with forward differencing.
+ *
+ * @param aBeziers Bezier segments to tessellate.
+ * @param aTolerance Maximum allowed deviation from the exact curve.
+ * @param aOut Tessellated polylines, one per segment.
+ */
+void tessellate(const BezierBatch& aBeziers, double aTolerance, PolylineBatch& aOut);
+
+/**
+ * @brief Cache of tessellated curve primitives (`PrimArc`, `PrimEllipse` and `PrimBezier`).
+ *
+ * @note Entries are keyed by the primitive's address, i.e. the cache must not outlive
+ *       the parsed database. Access is thread safe.
+ */
+class TessellationCache
+{
+public:
+    TessellationCache(double aTolerance)
+        : mTolerance{aTolerance},
+          mMutex{},
+          mCache{}
+    {
+    }
+
+    /**
+     * @brief Tessellate all uncached curves in one batch and store the results.
+     *        Other primitives are ignored.
+     *
+     * @param aPrims Primitives to prepare.
+     */
+    void prepare(const std::vector<const PrimBase*>& aPrims);
+
+    /**
+     * @brief Get tessellated curve. It is computed on demand if not cached yet.
+     *
+     * @param aPrim Curve primitive.
+     * @return std::shared_ptr<const Polyline> Tessellated curve or nullptr for
+     *         primitives that are not curves.
+     */
+    std::shared_ptr<const Polyline> get(const PrimBase& aPrim);
+
+    double getTolerance() const
+    {
+        return mTolerance;
+    }
+
+    std::size_t size() const;
+
+    void clear();
+
+private:
+    double mTolerance;
+
+    mutable std::mutex mMutex;
+
+    std::unordered_map<const PrimBase*, std::shared_ptr<const Polyline>> mCache;
+};
+
+[[maybe_unused]]
+static std::string to_string(const Polyline& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}points:\n", indent(1));
+    for(size_t i = 0u; i < aObj.x.size() && i < aObj.y.size(); ++i)
+    {
+        str += indent(fmt::format("[{}]: ({}, {})\n", i, aObj.x[i], aObj.y[i]), 2);
+    }
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const Polyline& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // TESSELLATION_HPP
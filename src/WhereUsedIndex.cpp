@@ -0,0 +1,656 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "ContentHash.hpp"
+#include "Database.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+#include "WhereUsedIndex.hpp"
+
+namespace
+{
+constexpr char FileMagic[]       = "OOCPWUI";
+constexpr uint32_t FileVersion   = 2U; //!< Version 2 hashes the raw page streams
+constexpr std::size_t MagicLen   = sizeof(FileMagic) - 1U;
+constexpr uint64_t MaxStrLen     = 1U << 24U; //!< Sanity limit for corrupted files
+constexpr uint64_t MaxElementCtr = 1U << 28U; //!< Sanity limit for corrupted files
+constexpr std::size_t ChunkSize  = 65536U;
+
+uint64_t hashFile(const fs::path& aPath)
+{
+    std::ifstream is{aPath, std::ios::in | std::ios::binary};
+
+    if(!is)
+    {
+        throw std::runtime_error(fmt::format("{}: Can not open file for reading: {}", __func__, aPath.string()));
+    }
+
+    OOCP::ContentHash hash;
+
+    std::vector<char> chunk(ChunkSize);
+
+    while(is)
+    {
+        is.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+
+        hash.add(chunk.data(), static_cast<std::size_t>(is.gcount()));
+    }
+
+    return hash.getHash();
+}
+
+class FileWriter
+{
+public:
+    explicit FileWriter(std::ofstream& aOs)
+        : mOs{aOs}
+    {
+    }
+
+    void writeUint(uint64_t aVal)
+    {
+        uint8_t buf[8];
+
+        for(std::size_t i = 0U; i < sizeof(buf); ++i)
+        {
+            buf[i] = static_cast<uint8_t>(aVal >> (8U * i));
+        }
+
+        mOs.write(reinterpret_cast<const char*>(buf), sizeof(buf));
+    }
+
+    void writeStr(const std::string& aStr)
+    {
+        writeUint(aStr.size());
+        mOs.write(aStr.data(), static_cast<std::streamsize>(aStr.size()));
+    }
+
+private:
+    std::ofstream& mOs;
+};
+
+class FileReader
+{
+public:
+    FileReader(std::ifstream& aIs, const fs::path& aPath)
+        : mIs{aIs},
+          mPath{aPath}
+    {
+    }
+
+    uint64_t readUint()
+    {
+        uint8_t buf[8];
+
+        read(reinterpret_cast<char*>(buf), sizeof(buf));
+
+        uint64_t val = 0U;
+
+        for(std::size_t i = 0U; i < sizeof(buf); ++i)
+        {
+            val |= static_cast<uint64_t>(buf[i]) << (8U * i);
+        }
+
+        return val;
+    }
+
+    uint64_t readCtr()
+    {
+        const uint64_t ctr = readUint();
+
+        if(ctr > MaxElementCtr)
+        {
+            throw std::runtime_error(fmt::format("{}: Invalid element count {} in {}", __func__, ctr, mPath.string()));
+        }
+
+        return ctr;
+    }
+
+    std::string readStr()
+    {
+        const uint64_t len = readUint();
+
+        if(len > MaxStrLen)
+        {
+            throw std::runtime_error(fmt::format("{}: Invalid string length {} in {}", __func__, len, mPath.string()));
+        }
+
+        std::string str(len, '\0');
+
+        read(str.data(), str.size());
+
+        return str;
+    }
+
+    void read(char* aBuf, std::size_t aLen)
+    {
+        mIs.read(aBuf, static_cast<std::streamsize>(aLen));
+
+        if(static_cast<std::size_t>(mIs.gcount()) != aLen)
+        {
+            throw std::runtime_error(fmt::format("{}: Unexpected end of file {}", __func__, mPath.string()));
+        }
+    }
+
+private:
+    std::ifstream& mIs;
+    const fs::path& mPath;
+};
+} // namespace
+
+void OOCP::WhereUsedIndex::addLibrary(ContainerContext& aCtx)
+{
+    const std::string library = aCtx.mInputCfbfFile.string();
+
+    std::map<std::string, std::vector<std::string>> packages;
+
+    for(const auto& stream : aCtx.mDb.mStreams)
+    {
+        const auto package = std::dynamic_pointer_cast<StreamPackage>(stream);
+
+        if(!package || !package->package)
+        {
+            continue;
+        }
+
+        // Instances are placed either by the package name or by the name of one of its views
+        std::vector<std::string> names{package->package->name};
+
+        for(const auto& libraryPart : package->libraryParts)
+        {
+            if(libraryPart && !libraryPart->name.empty())
+            {
+                names.push_back(libraryPart->name);
+            }
+        }
+
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+
+        packages.insert_or_assign(package->package->name, std::move(names));
+    }
+
+    aCtx.mLogger.info("Registered {} packages of {}", packages.size(), library);
+
+    mLibraries.insert_or_assign(library, std::move(packages));
+}
+
+std::size_t OOCP::WhereUsedIndex::updateDesign(ContainerContext& aCtx)
+{
+    const std::string design = aCtx.mInputCfbfFile.string();
+
+    std::map<std::string, PageEntry> pages;
+
+    for(const auto& stream : aCtx.mDb.mStreams)
+    {
+        const auto page = std::dynamic_pointer_cast<StreamPage>(stream);
+
+        if(!page)
+        {
+            continue;
+        }
+
+        // Same hash as in `hashPageStreams` s.t. designs can be checked without parsing them
+        PageEntry entry{page->name, hashFile(page->mCtx.mInputStream), {}};
+
+        for(const auto& inst : page->placedInstances)
+        {
+            if(inst)
+            {
+                entry.instances.push_back(InstanceEntry{inst->dbId, inst->reference, inst->pkgName});
+            }
+        }
+
+        pages.insert_or_assign(to_string(page->mCtx.mCfbfStreamLocation), std::move(entry));
+    }
+
+    std::size_t updatedCtr = 0U;
+
+    if(const auto it = mPages.find(design); it != mPages.end())
+    {
+        // Copy as removing pages modifies the map
+        std::vector<std::string> streamLocations;
+
+        for(const auto& [streamLocation, entry] : it->second)
+        {
+            const auto newIt = pages.find(streamLocation);
+
+            if(newIt == pages.end() || newIt->second.contentHash != entry.contentHash)
+            {
+                streamLocations.push_back(streamLocation);
+            }
+        }
+
+        for(const auto& streamLocation : streamLocations)
+        {
+            removePage(design, streamLocation, mPages.at(design).at(streamLocation));
+        }
+    }
+
+    for(auto& [streamLocation, entry] : pages)
+    {
+        const auto designIt = mPages.find(design);
+
+        // Unchanged pages are kept
+        if(designIt != mPages.end() && designIt->second.count(streamLocation) > 0U)
+        {
+            continue;
+        }
+
+        addPage(design, streamLocation, std::move(entry));
+
+        ++updatedCtr;
+    }
+
+    // Keep designs without pages s.t. they are known to be indexed
+    mPages.try_emplace(design);
+
+    aCtx.mLogger.info("Indexed {} of {} pages of {}", updatedCtr, pages.size(), design);
+
+    return updatedCtr;
+}
+
+bool OOCP::WhereUsedIndex::isUpToDate(const ContainerContext& aCtx) const
+{
+    const auto it = mPages.find(aCtx.mInputCfbfFile.string());
+
+    if(it == mPages.cend())
+    {
+        return false;
+    }
+
+    const std::map<std::string, uint64_t> hashes = hashPageStreams(aCtx);
+
+    return hashes.size() == it->second.size() &&
+           std::all_of(hashes.cbegin(), hashes.cend(),
+               [&it](const auto& aHash)
+               {
+                   const auto pageIt = it->second.find(aHash.first);
+
+                   return pageIt != it->second.cend() && pageIt->second.contentHash == aHash.second;
+               });
+}
+
+std::map<std::string, uint64_t> OOCP::WhereUsedIndex::hashPageStreams(const ContainerContext& aCtx)
+{
+    std::map<std::string, uint64_t> hashes;
+
+    for(const auto& dirEntry : fs::recursive_directory_iterator(aCtx.mExtractedCfbfPath))
+    {
+        if(!dirEntry.is_regular_file())
+        {
+            continue;
+        }
+
+        CfbfStreamLocation streamLocation{dirEntry.path(), aCtx.mExtractedCfbfPath};
+
+        // Match `/Views/*/Pages/*`, same as in `StreamFactory`
+        if(streamLocation.matches_pattern({"Views", std::nullopt, "Pages", std::nullopt}))
+        {
+            hashes.emplace(to_string(streamLocation), hashFile(dirEntry.path()));
+        }
+    }
+
+    return hashes;
+}
+
+bool OOCP::WhereUsedIndex::removeDesign(const std::string& aDesign)
+{
+    const auto it = mPages.find(aDesign);
+
+    if(it == mPages.end())
+    {
+        return false;
+    }
+
+    for(const auto& [streamLocation, entry] : it->second)
+    {
+        for(const auto& inst : entry.instances)
+        {
+            const auto usedIt = mUsedBy.find(inst.pkgName);
+
+            if(usedIt != mUsedBy.end())
+            {
+                usedIt->second.erase(aDesign);
+
+                if(usedIt->second.empty())
+                {
+                    mUsedBy.erase(usedIt);
+                }
+            }
+        }
+    }
+
+    mPages.erase(it);
+
+    return true;
+}
+
+void OOCP::WhereUsedIndex::addPage(const std::string& aDesign, const std::string& aStreamLocation, PageEntry aEntry)
+{
+    for(const auto& inst : aEntry.instances)
+    {
+        mUsedBy[inst.pkgName][aDesign].insert(aStreamLocation);
+    }
+
+    mPages[aDesign].insert_or_assign(aStreamLocation, std::move(aEntry));
+}
+
+void OOCP::WhereUsedIndex::removePage(
+    const std::string& aDesign, const std::string& aStreamLocation, const PageEntry& aEntry)
+{
+    for(const auto& inst : aEntry.instances)
+    {
+        const auto usedIt = mUsedBy.find(inst.pkgName);
+
+        if(usedIt == mUsedBy.end())
+        {
+            continue;
+        }
+
+        const auto designIt = usedIt->second.find(aDesign);
+
+        if(designIt != usedIt->second.end())
+        {
+            designIt->second.erase(aStreamLocation);
+
+            if(designIt->second.empty())
+            {
+                usedIt->second.erase(designIt);
+            }
+        }
+
+        if(usedIt->second.empty())
+        {
+            mUsedBy.erase(usedIt);
+        }
+    }
+
+    // Erasing invalidates `aEntry`
+    mPages.at(aDesign).erase(aStreamLocation);
+}
+
+void OOCP::WhereUsedIndex::collectUsages(const std::string& aPkgName, std::vector<InstanceUsage>& aUsages) const
+{
+    const auto usedIt = mUsedBy.find(aPkgName);
+
+    if(usedIt == mUsedBy.cend())
+    {
+        return;
+    }
+
+    for(const auto& [design, streamLocations] : usedIt->second)
+    {
+        const auto& designPages = mPages.at(design);
+
+        for(const auto& streamLocation : streamLocations)
+        {
+            const PageEntry& entry = designPages.at(streamLocation);
+
+            for(const auto& inst : entry.instances)
+            {
+                if(inst.pkgName == aPkgName)
+                {
+                    aUsages.push_back(
+                        InstanceUsage{design, streamLocation, entry.page, inst.dbId, inst.reference, inst.pkgName});
+                }
+            }
+        }
+    }
+}
+
+std::vector<OOCP::InstanceUsage> OOCP::WhereUsedIndex::findUsages(
+    const std::string& aLibrary, const std::string& aPackage) const
+{
+    std::vector<std::string> names{aPackage};
+
+    if(const auto libIt = mLibraries.find(aLibrary); libIt != mLibraries.cend())
+    {
+        if(const auto pkgIt = libIt->second.find(aPackage); pkgIt != libIt->second.cend())
+        {
+            names = pkgIt->second;
+        }
+    }
+
+    std::vector<InstanceUsage> usages;
+
+    for(const auto& name : names)
+    {
+        collectUsages(name, usages);
+    }
+
+    std::sort(usages.begin(), usages.end(),
+        [](const InstanceUsage& aLhs, const InstanceUsage& aRhs)
+        {
+            return std::tie(aLhs.design, aLhs.streamLocation, aLhs.dbId) <
+                   std::tie(aRhs.design, aRhs.streamLocation, aRhs.dbId);
+        });
+
+    return usages;
+}
+
+std::vector<OOCP::InstanceUsage> OOCP::WhereUsedIndex::findUsages(const std::string& aPkgName) const
+{
+    std::vector<InstanceUsage> usages;
+
+    collectUsages(aPkgName, usages);
+
+    std::sort(usages.begin(), usages.end(),
+        [](const InstanceUsage& aLhs, const InstanceUsage& aRhs)
+        {
+            return std::tie(aLhs.design, aLhs.streamLocation, aLhs.dbId) <
+                   std::tie(aRhs.design, aRhs.streamLocation, aRhs.dbId);
+        });
+
+    return usages;
+}
+
+uint64_t OOCP::WhereUsedIndex::getPageHash(const std::string& aDesign, const std::string& aStreamLocation) const
+{
+    const auto designIt = mPages.find(aDesign);
+
+    if(designIt == mPages.cend())
+    {
+        return 0U;
+    }
+
+    const auto it = designIt->second.find(aStreamLocation);
+
+    return it != designIt->second.cend() ? it->second.contentHash : 0U;
+}
+
+std::size_t OOCP::WhereUsedIndex::getInstanceCtr() const
+{
+    std::size_t ctr = 0U;
+
+    for(const auto& [design, pages] : mPages)
+    {
+        for(const auto& [streamLocation, entry] : pages)
+        {
+            ctr += entry.instances.size();
+        }
+    }
+
+    return ctr;
+}
+
+void OOCP::WhereUsedIndex::save(const fs::path& aPath) const
+{
+    fs::path tmpPath = aPath;
+    tmpPath += ".tmp";
+
+    std::ofstream os{tmpPath, std::ios::out | std::ios::binary | std::ios::trunc};
+
+    if(!os)
+    {
+        throw std::runtime_error(fmt::format("{}: Can not open file for writing: {}", __func__, tmpPath.string()));
+    }
+
+    FileWriter writer{os};
+
+    os.write(FileMagic, MagicLen);
+    writer.writeUint(FileVersion);
+
+    writer.writeUint(mLibraries.size());
+
+    for(const auto& [library, packages] : mLibraries)
+    {
+        writer.writeStr(library);
+        writer.writeUint(packages.size());
+
+        for(const auto& [package, names] : packages)
+        {
+            writer.writeStr(package);
+            writer.writeUint(names.size());
+
+            for(const auto& name : names)
+            {
+                writer.writeStr(name);
+            }
+        }
+    }
+
+    writer.writeUint(mPages.size());
+
+    for(const auto& [design, pages] : mPages)
+    {
+        writer.writeStr(design);
+        writer.writeUint(pages.size());
+
+        for(const auto& [streamLocation, entry] : pages)
+        {
+            writer.writeStr(streamLocation);
+            writer.writeStr(entry.page);
+            writer.writeUint(entry.contentHash);
+            writer.writeUint(entry.instances.size());
+
+            for(const auto& inst : entry.instances)
+            {
+                writer.writeUint(inst.dbId);
+                writer.writeStr(inst.reference);
+                writer.writeStr(inst.pkgName);
+            }
+        }
+    }
+
+    os.close();
+
+    if(!os)
+    {
+        fs::remove(tmpPath);
+
+        throw std::runtime_error(fmt::format("{}: Failed writing {}", __func__, tmpPath.string()));
+    }
+
+    // Replaces an existing index atomically on POSIX systems
+    fs::rename(tmpPath, aPath);
+}
+
+void OOCP::WhereUsedIndex::load(const fs::path& aPath)
+{
+    std::ifstream is{aPath, std::ios::in | std::ios::binary};
+
+    if(!is)
+    {
+        throw std::runtime_error(fmt::format("{}: Can not open file for reading: {}", __func__, aPath.string()));
+    }
+
+    FileReader reader{is, aPath};
+
+    std::string magic(MagicLen, '\0');
+
+    reader.read(magic.data(), magic.size());
+
+    if(magic != FileMagic)
+    {
+        throw std::runtime_error(fmt::format("{}: {} is not a where-used index", __func__, aPath.string()));
+    }
+
+    const uint64_t version = reader.readUint();
+
+    if(version != FileVersion)
+    {
+        throw std::runtime_error(fmt::format(
+            "{}: Version {} of {} is not supported, expected {}", __func__, version, aPath.string(), FileVersion));
+    }
+
+    // Read into a new index s.t. this one stays untouched on errors
+    WhereUsedIndex index{};
+
+    const uint64_t libraryCtr = reader.readCtr();
+
+    for(uint64_t i = 0U; i < libraryCtr; ++i)
+    {
+        auto& packages = index.mLibraries[reader.readStr()];
+
+        const uint64_t packageCtr = reader.readCtr();
+
+        for(uint64_t j = 0U; j < packageCtr; ++j)
+        {
+            auto& names = packages[reader.readStr()];
+
+            const uint64_t nameCtr = reader.readCtr();
+
+            for(uint64_t k = 0U; k < nameCtr; ++k)
+            {
+                names.push_back(reader.readStr());
+            }
+        }
+    }
+
+    const uint64_t designCtr = reader.readCtr();
+
+    for(uint64_t i = 0U; i < designCtr; ++i)
+    {
+        const std::string design = reader.readStr();
+
+        index.mPages.try_emplace(design);
+
+        const uint64_t pageCtr = reader.readCtr();
+
+        for(uint64_t j = 0U; j < pageCtr; ++j)
+        {
+            const std::string streamLocation = reader.readStr();
+
+            PageEntry entry{};
+
+            entry.page        = reader.readStr();
+            entry.contentHash = reader.readUint();
+
+            const uint64_t instanceCtr = reader.readCtr();
+
+            for(uint64_t k = 0U; k < instanceCtr; ++k)
+            {
+                InstanceEntry inst{};
+
+                inst.dbId      = static_cast<uint32_t>(reader.readUint());
+                inst.reference = reader.readStr();
+                inst.pkgName   = reader.readStr();
+
+                entry.instances.push_back(std::move(inst));
+            }
+
+            index.addPage(design, streamLocation, std::move(entry));
+        }
+    }
+
+    *this = std::move(index);
+}
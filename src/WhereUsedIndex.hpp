@@ -0,0 +1,193 @@
+#ifndef WHEREUSEDINDEX_HPP
+#define WHEREUSEDINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/core.h>
+#include <nameof.hpp>
+
+#include "ContainerContext.hpp"
+#include "General.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OOCP
+{
+/**
+ * @brief Placed instance of a package in a design.
+ */
+struct InstanceUsage
+{
+    std::string design;         //!< Path to the design
+    std::string streamLocation; //!< Location of the page stream inside the CFBF container
+    std::string page;           //!< Page name
+
+    uint32_t dbId;
+    std::string reference; //!< Part reference, e.g. `R1`
+    std::string pkgName;   //!< Package or view name the instance was placed with
+};
+
+/**
+ * @brief Reverse index from library packages to the design instances that use them.
+ *
+ * @note Designs only store the package or view name of an instance but not
+ *       the library it was placed from. Libraries are therefore added to map
+ *       their packages to all names that can be used for placing them. Pages
+ *       are identified by the content hash of their raw stream and re-indexed
+ *       only if it changed. The index can be saved to and loaded from a file,
+ *       use `isUpToDate` to skip parsing designs that did not change.
+ */
+class WhereUsedIndex
+{
+public:
+    WhereUsedIndex()
+        : mLibraries{},
+          mPages{},
+          mUsedBy{}
+    {
+    }
+
+    /**
+     * @brief Register all packages of a parsed library, a previous registration of the same library is replaced.
+     *
+     * @param aCtx Context of the parsed library.
+     */
+    void addLibrary(ContainerContext& aCtx);
+
+    /**
+     * @brief Index all placed instances of a parsed design, pages indexed before are updated.
+     *
+     * @note Pages that do not exist anymore are removed.
+     *
+     * @param aCtx Context of the parsed design.
+     * @return std::size_t Number of pages that were (re-)indexed.
+     */
+    std::size_t updateDesign(ContainerContext& aCtx);
+
+    /**
+     * @brief Check if the indexed pages of a design match its raw page streams.
+     *
+     * @note Only reads the extracted container, i.e. call it before
+     *       `Container::parseDatabaseFile` and skip parsing if it returns true.
+     *
+     * @param aCtx Context of the extracted design.
+     * @return true If the design is indexed and none of its pages was added, removed or changed.
+     */
+    bool isUpToDate(const ContainerContext& aCtx) const;
+
+    /**
+     * @brief Content hashes of the raw page streams of an extracted design.
+     *
+     * @return std::map<std::string, uint64_t> Stream location -> content hash.
+     */
+    static std::map<std::string, uint64_t> hashPageStreams(const ContainerContext& aCtx);
+
+    /**
+     * @return true If the design was indexed before.
+     */
+    bool removeDesign(const std::string& aDesign);
+
+    /**
+     * @brief Find all instances of a library package.
+     *
+     * @note If the library was not added, only instances that were placed
+     *       with the package name itself are found.
+     *
+     * @return std::vector<InstanceUsage> Instances sorted by design, page and `dbId`.
+     */
+    std::vector<InstanceUsage> findUsages(const std::string& aLibrary, const std::string& aPackage) const;
+
+    /**
+     * @brief Find all instances placed with the given package or view name.
+     *
+     * @return std::vector<InstanceUsage> Instances sorted by design, page and `dbId`.
+     */
+    std::vector<InstanceUsage> findUsages(const std::string& aPkgName) const;
+
+    /**
+     * @brief Content hash of the raw stream of an indexed page.
+     *
+     * @return uint64_t 0 if the page is not indexed.
+     */
+    uint64_t getPageHash(const std::string& aDesign, const std::string& aStreamLocation) const;
+
+    std::size_t getDesignCtr() const
+    {
+        return mPages.size();
+    }
+
+    std::size_t getInstanceCtr() const;
+
+    /**
+     * @brief Write the index into a temporary file that replaces the given one
+     *        once it is complete, i.e. an interrupted save keeps the previous index.
+     */
+    void save(const fs::path& aPath) const;
+
+    /**
+     * @brief Replace the index with the one stored in the given file.
+     */
+    void load(const fs::path& aPath);
+
+private:
+    struct InstanceEntry
+    {
+        uint32_t dbId;
+        std::string reference;
+        std::string pkgName;
+    };
+
+    struct PageEntry
+    {
+        std::string page;
+        uint64_t contentHash;
+        std::vector<InstanceEntry> instances;
+    };
+
+    void addPage(const std::string& aDesign, const std::string& aStreamLocation, PageEntry aEntry);
+
+    void removePage(const std::string& aDesign, const std::string& aStreamLocation, const PageEntry& aEntry);
+
+    void collectUsages(const std::string& aPkgName, std::vector<InstanceUsage>& aUsages) const;
+
+    std::map<std::string, std::map<std::string, std::vector<std::string>>> mLibraries; //!< Library -> package -> names
+
+    std::map<std::string, std::map<std::string, PageEntry>> mPages; //!< Design -> stream location -> page
+
+    // Package or view name -> design -> stream locations of pages that place it
+    std::unordered_map<std::string, std::map<std::string, std::set<std::string>>> mUsedBy;
+};
+
+[[maybe_unused]]
+static std::string to_string(const InstanceUsage& aObj)
+{
+    std::string str;
+
+    str += fmt::format("{}:\n", nameof::nameof_type<decltype(aObj)>());
+    str += fmt::format("{}design         = {}\n", indent(1), aObj.design);
+    str += fmt::format("{}streamLocation = {}\n", indent(1), aObj.streamLocation);
+    str += fmt::format("{}page           = {}\n", indent(1), aObj.page);
+    str += fmt::format("{}dbId           = {}\n", indent(1), aObj.dbId);
+    str += fmt::format("{}reference      = {}\n", indent(1), aObj.reference);
+    str += fmt::format("{}pkgName        = {}\n", indent(1), aObj.pkgName);
+
+    return str;
+}
+
+[[maybe_unused]]
+static std::ostream& operator<<(std::ostream& aOs, const InstanceUsage& aVal)
+{
+    aOs << to_string(aVal);
+
+    return aOs;
+}
+} // namespace OOCP
+#endif // WHEREUSEDINDEX_HPP
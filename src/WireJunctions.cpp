@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "Streams/StreamPage.hpp"
+#include "Structures/StructWire.hpp"
+#include "Structures/StructWireBus.hpp"
+#include "WireJunctions.hpp"
+
+namespace
+{
+struct Interval
+{
+    int32_t start;
+    int32_t end;
+};
+
+bool isInside(const std::map<int32_t, std::vector<Interval>>& aLines, int32_t aLine, int32_t aPos)
+{
+    const auto it = aLines.find(aLine);
+
+    if(it == aLines.end())
+    {
+        return false;
+    }
+
+    return std::any_of(it->second.begin(), it->second.end(),
+        [aPos](const Interval& aInterval) { return aPos > aInterval.start && aPos < aInterval.end; });
+}
+
+bool isOnInnerPart(const OOCP::StructWire& aWire, int32_t aX, int32_t aY)
+{
+    const bool isStart = aX == aWire.startX && aY == aWire.startY;
+    const bool isEnd   = aX == aWire.endX && aY == aWire.endY;
+
+    if(isStart || isEnd)
+    {
+        return false;
+    }
+
+    // Collinear and within the bounding box of the wire
+    const int64_t cross = static_cast<int64_t>(aWire.endX - aWire.startX) * (aY - aWire.startY) -
+                          static_cast<int64_t>(aWire.endY - aWire.startY) * (aX - aWire.startX);
+
+    return cross == 0 && aX >= std::min(aWire.startX, aWire.endX) && aX <= std::max(aWire.startX, aWire.endX) &&
+           aY >= std::min(aWire.startY, aWire.endY) && aY <= std::max(aWire.startY, aWire.endY);
+}
+} // namespace
+
+std::vector<std::pair<int32_t, int32_t>> OOCP::getJunctions(const std::vector<const StructWire*>& aWires)
+{
+    std::map<std::pair<int32_t, int32_t>, std::size_t> endCtr;
+
+    // Horizontal wires grouped by their Y-coordinate and vertical ones by their X-coordinate,
+    // s.t. only diagonal wires need to be checked one by one
+    std::map<int32_t, std::vector<Interval>> horizontal;
+    std::map<int32_t, std::vector<Interval>> vertical;
+    std::vector<const StructWire*> diagonal;
+
+    for(const auto* wire : aWires)
+    {
+        ++endCtr[{wire->startX, wire->startY}];
+        ++endCtr[{wire->endX, wire->endY}];
+
+        if(wire->startY == wire->endY)
+        {
+            horizontal[wire->startY].push_back(
+                Interval{std::min(wire->startX, wire->endX), std::max(wire->startX, wire->endX)});
+        }
+        else if(wire->startX == wire->endX)
+        {
+            vertical[wire->startX].push_back(
+                Interval{std::min(wire->startY, wire->endY), std::max(wire->startY, wire->endY)});
+        }
+        else
+        {
+            diagonal.push_back(wire);
+        }
+    }
+
+    std::vector<std::pair<int32_t, int32_t>> junctions;
+
+    for(const auto& [point, ctr] : endCtr)
+    {
+        const auto [x, y] = point;
+
+        const bool isJunction = ctr >= 3U || isInside(horizontal, y, x) || isInside(vertical, x, y) ||
+                                std::any_of(diagonal.cbegin(), diagonal.cend(),
+                                    [x, y](const StructWire* aWire) { return isOnInnerPart(*aWire, x, y); });
+
+        if(isJunction)
+        {
+            junctions.push_back(point);
+        }
+    }
+
+    return junctions;
+}
+
+std::vector<std::pair<int32_t, int32_t>> OOCP::getJunctions(const StreamPage& aPage)
+{
+    std::vector<const StructWire*> wires;
+    std::vector<const StructWire*> buses;
+
+    for(const auto& wire : aPage.wires)
+    {
+        if(wire)
+        {
+            (dynamic_cast<const StructWireBus*>(wire.get()) ? buses : wires).push_back(wire.get());
+        }
+    }
+
+    std::vector<std::pair<int32_t, int32_t>> junctions = getJunctions(wires);
+
+    const std::vector<std::pair<int32_t, int32_t>> busJunctions = getJunctions(buses);
+
+    junctions.insert(junctions.end(), busJunctions.cbegin(), busJunctions.cend());
+
+    return junctions;
+}
@@ -0,0 +1,32 @@
+#ifndef WIREJUNCTIONS_HPP
+#define WIREJUNCTIONS_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace OOCP
+{
+class StreamPage;
+class StructWire;
+
+/**
+ * @brief Derive the junctions of a set of wires.
+ *
+ * @note Pages do not store explicit junction records, OrCAD derives them from
+ *       the wire connectivity. A junction is placed where at least three wire
+ *       ends meet or a wire ends on the inner part of another wire.
+ *
+ * @return std::vector<std::pair<int32_t, int32_t>> Junction coordinates sorted by X and Y.
+ */
+std::vector<std::pair<int32_t, int32_t>> getJunctions(const std::vector<const StructWire*>& aWires);
+
+/**
+ * @brief Junctions of all wires and buses on a page.
+ *
+ * @note Wires and buses are not connected to each other, i.e. a wire ending
+ *       on a bus is not a junction.
+ */
+std::vector<std::pair<int32_t, int32_t>> getJunctions(const StreamPage& aPage);
+} // namespace OOCP
+#endif // WIREJUNCTIONS_HPP
@@ -1,675 +1,910 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "CfbfStreamLocation.hpp"
+#include "Database.hpp"
+#include "GetStreamHelper.hpp"
+#include "OutputSink.hpp"
+#include "PageSettings.hpp"
+#include "ParallelFor.hpp"
+#include "Primitives/Point.hpp"
+#include "Primitives/PrimArc.hpp"
+#include "Primitives/PrimBase.hpp"
+#include "Primitives/PrimBezier.hpp"
+#include "Primitives/PrimBitmap.hpp"
+#include "Primitives/PrimCommentText.hpp"
+#include "Primitives/PrimEllipse.hpp"
+#include "Primitives/PrimLine.hpp"
+#include "Primitives/PrimPolygon.hpp"
+#include "Primitives/PrimPolyline.hpp"
+#include "Primitives/PrimRect.hpp"
+#include "Primitives/PrimSymbolVector.hpp"
+#include "Streams/StreamLibrary.hpp"
+#include "Streams/StreamPackage.hpp"
+#include "Streams/StreamPage.hpp"
+#include "Structures/StructAlias.hpp"
+#include "Structures/StructDevice.hpp"
+#include "Structures/StructLibraryPart.hpp"
+#include "Structures/StructPackage.hpp"
+#include "Structures/StructPartCell.hpp"
+#include "Structures/StructPlacedInstance.hpp"
+#include "Structures/StructSymbolDisplayProp.hpp"
+#include "Structures/StructSymbolPin.hpp"
+#include "Structures/StructSymbolPinBus.hpp"
+#include "Structures/StructWire.hpp"
+#include "Structures/StructWireBus.hpp"
 #include "XmlExporter.hpp"
+#include "XmlWriter.hpp"
 
-void OOCP::XmlExporter::visit(const Library& aObj)
+namespace
 {
-    mLib = &aObj;
-
-    for(const auto& package : aObj.packages)
-    {
-        mXml.Clear();
-
-        XMLDeclaration* std_declaration = mXml.NewDeclaration();
+std::string toBase64(const std::vector<uint8_t>& aData)
+{
+    static constexpr std::array<char, 64> Alphabet = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L',
+        'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h',
+        'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '0', '1', '2', '3',
+        '4', '5', '6', '7', '8', '9', '+', '/'};
 
-        mXml.InsertFirstChild(std_declaration);
+    std::string encoded;
+    encoded.reserve((aData.size() + 2U) / 3U * 4U);
 
-        XMLElement* eLib = mXml.NewElement("Lib");
-        mXml.InsertEndChild(eLib);
+    for(std::size_t i = 0U; i < aData.size(); i += 3U)
+    {
+        const std::size_t remaining = std::min<std::size_t>(aData.size() - i, 3U);
 
-        mCurXmlElem = eLib;
+        uint32_t triple = static_cast<uint32_t>(aData[i]) << 16U;
 
-        if(package)
+        if(remaining > 1U)
         {
-            package->accept(*this);
-
-            // @todo Use Package name
-            static uint32_t PackageCtr = 0;
-            const std::string pkgName  = "PackageName" + std::to_string(PackageCtr++) + ".xml";
-            mExportFilePath            = mExportBasePath / pkgName;
-
-            exportXml();
+            triple |= static_cast<uint32_t>(aData[i + 1U]) << 8U;
         }
-    }
-}
-
-void OOCP::XmlExporter::visit(const PrimArc& aObj)
-{
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* eArc = mXml.NewElement("Arc");
-    mCurXmlElem->InsertEndChild(eArc);
 
-    mCurXmlElem = eArc;
-
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+        if(remaining > 2U)
+        {
+            triple |= static_cast<uint32_t>(aData[i + 2U]);
+        }
 
-    eDefn->SetAttribute("endX", aObj.endX);
-    eDefn->SetAttribute("endY", aObj.endY);
-    eDefn->SetAttribute("lineStyle", static_cast<uint32_t>(aObj.getLineStyle()));
-    eDefn->SetAttribute("lineWidth", static_cast<uint32_t>(aObj.getLineWidth()));
-    eDefn->SetAttribute("startX", aObj.startX);
-    eDefn->SetAttribute("startY", aObj.startY);
-    eDefn->SetAttribute("x1", aObj.x1);
-    eDefn->SetAttribute("x2", aObj.x2);
-    eDefn->SetAttribute("y1", aObj.y1);
-    eDefn->SetAttribute("y2", aObj.y2);
+        encoded += Alphabet[(triple >> 18U) & 0x3fU];
+        encoded += Alphabet[(triple >> 12U) & 0x3fU];
+        encoded += remaining > 1U ? Alphabet[(triple >> 6U) & 0x3fU] : '=';
+        encoded += remaining > 2U ? Alphabet[triple & 0x3fU] : '=';
+    }
 
-    mCurXmlElem = parent;
+    return encoded;
 }
 
-void OOCP::XmlExporter::visit(const PrimBezier& aObj)
+// OrCAD's XML export stores uncompressed 24 bit BMP files with 32 bit per
+// pixel and a resolution of 96 DPI, other images are kept unchanged
+std::vector<uint8_t> toExportedBmp(const std::vector<uint8_t>& aBmpFile)
 {
-    XMLElement* parent = mCurXmlElem;
+    const auto read = [&aBmpFile](std::size_t aOffset, auto aVal)
+    {
+        std::memcpy(&aVal, aBmpFile.data() + aOffset, sizeof(aVal));
+        return aVal;
+    };
 
-    XMLElement* eBezier = mXml.NewElement("Bezier");
-    mCurXmlElem->InsertEndChild(eBezier);
+    const std::size_t headerSize = 54U;
 
-    mCurXmlElem = eBezier;
+    if(aBmpFile.size() < headerSize || read(14U, uint32_t{}) != 40U || read(28U, uint16_t{}) != 24U ||
+        read(30U, uint32_t{}) != 0U)
+    {
+        return aBmpFile;
+    }
 
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+    const int32_t width       = read(18U, int32_t{});
+    const int32_t height      = read(22U, int32_t{});
+    const uint32_t dataOffset = read(10U, uint32_t{});
 
-    eDefn->SetAttribute("lineStyle", static_cast<uint32_t>(aObj.getLineStyle()));
-    eDefn->SetAttribute("lineWidth", static_cast<uint32_t>(aObj.getLineWidth()));
+    const std::size_t rows      = static_cast<std::size_t>(std::abs(height));
+    const std::size_t cols      = static_cast<std::size_t>(std::abs(width));
+    const std::size_t srcStride = (cols * 3U + 3U) / 4U * 4U;
 
-    for(const auto& point : aObj.points)
+    if(dataOffset + rows * srcStride > aBmpFile.size())
     {
-        XMLElement* eBezierPoint = mXml.NewElement("BezierPoint");
-        mCurXmlElem->InsertEndChild(eBezierPoint);
+        return aBmpFile;
+    }
+
+    std::vector<uint8_t> bmp;
+    bmp.reserve(headerSize + rows * cols * 4U);
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eBezierPoint->InsertEndChild(eDefn);
+    const auto append = [&bmp](auto aVal)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&aVal);
+        bmp.insert(bmp.end(), bytes, bytes + sizeof(aVal));
+    };
+
+    // Bitmap file header
+    append(uint16_t{0x4d42});
+    append(static_cast<uint32_t>(headerSize + rows * cols * 4U));
+    append(uint32_t{0U});
+    append(static_cast<uint32_t>(headerSize));
+
+    // Bitmap info header
+    append(uint32_t{40U});
+    append(width);
+    append(height);
+    append(uint16_t{1U});
+    append(uint16_t{32U});
+    append(uint32_t{0U});  // Compression
+    append(uint32_t{0U});  // Image size, can be 0 for uncompressed images
+    append(int32_t{3780}); // Horizontal pixels per meter
+    append(int32_t{3780}); // Vertical pixels per meter
+    append(uint32_t{0U});  // Colors in the palette
+    append(uint32_t{0U});  // Important colors
+
+    for(std::size_t row = 0U; row < rows; ++row)
+    {
+        const uint8_t* src = aBmpFile.data() + dataOffset + row * srcStride;
 
-        eDefn->SetAttribute("x", point.x);
-        eDefn->SetAttribute("y", point.y);
+        for(std::size_t col = 0U; col < cols; ++col)
+        {
+            bmp.insert(bmp.end(), src + col * 3U, src + col * 3U + 3U);
+            bmp.push_back(0U);
+        }
     }
 
-    mCurXmlElem = parent;
+    return bmp;
 }
 
-void OOCP::XmlExporter::visit(const PrimEllipse& aObj)
+std::string removeSuffix(const std::string& aStr, const std::string& aSuffix)
 {
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* eEllipse = mXml.NewElement("Ellipse");
-    mCurXmlElem->InsertEndChild(eEllipse);
-
-    mCurXmlElem = eEllipse;
-
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
-
-    eDefn->SetAttribute("fillStyle", static_cast<uint32_t>(aObj.getFillStyle()));
-    eDefn->SetAttribute("hatchStyle", static_cast<uint32_t>(aObj.getHatchStyle()));
-    eDefn->SetAttribute("lineStyle", static_cast<uint32_t>(aObj.getLineStyle()));
-    eDefn->SetAttribute("lineWidth", static_cast<uint32_t>(aObj.getLineWidth()));
-    eDefn->SetAttribute("x1", aObj.x1);
-    eDefn->SetAttribute("x2", aObj.x2);
-    eDefn->SetAttribute("y1", aObj.y1);
-    eDefn->SetAttribute("y2", aObj.y2);
+    if(aStr.size() >= aSuffix.size() && aStr.compare(aStr.size() - aSuffix.size(), aSuffix.size(), aSuffix) == 0)
+    {
+        return aStr.substr(0U, aStr.size() - aSuffix.size());
+    }
 
-    mCurXmlElem = parent;
+    return aStr;
 }
 
-void OOCP::XmlExporter::visit(const PrimRect& aObj)
+// Sort streams by their location inside the container s.t. the output does not
+// depend on the order in which the file system enumerated them during parsing
+void sortByStreamLocation(std::vector<std::shared_ptr<OOCP::Stream>>& aStreams)
 {
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* eRect = mXml.NewElement("Rect");
-    mCurXmlElem->InsertEndChild(eRect);
-
-    mCurXmlElem = eRect;
-
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
-
-    eDefn->SetAttribute("fillStyle", static_cast<uint32_t>(aObj.fillStyle));
-    eDefn->SetAttribute("hatchStyle", static_cast<uint32_t>(aObj.hatchStyle));
-    eDefn->SetAttribute("lineStyle", static_cast<uint32_t>(aObj.getLineStyle()));
-    eDefn->SetAttribute("lineWidth", static_cast<uint32_t>(aObj.getLineWidth()));
-    eDefn->SetAttribute("x1", aObj.x1);
-    eDefn->SetAttribute("x2", aObj.x2);
-    eDefn->SetAttribute("y1", aObj.y1);
-    eDefn->SetAttribute("y2", aObj.y2);
-
-    mCurXmlElem = parent;
+    std::sort(aStreams.begin(), aStreams.end(),
+        [](const std::shared_ptr<OOCP::Stream>& aLhs, const std::shared_ptr<OOCP::Stream>& aRhs)
+        {
+            return aLhs->mCtx.mCfbfStreamLocation.get_vector() < aRhs->mCtx.mCfbfStreamLocation.get_vector();
+        });
 }
 
-void OOCP::XmlExporter::visit(const PrimPolygon& aObj)
+void writePoint(OOCP::XmlWriter& aWriter, const std::string& aElement, const OOCP::Point& aPoint)
 {
-    XMLElement* parent = mCurXmlElem;
+    aWriter.startElement(aElement);
+    aWriter.startElement("Defn");
+    aWriter.attribute("x", aPoint.x);
+    aWriter.attribute("y", aPoint.y);
+    aWriter.endElement();
+    aWriter.endElement();
+}
 
-    XMLElement* ePolygon = mXml.NewElement("Polygon");
-    mCurXmlElem->InsertEndChild(ePolygon);
+void writeValue(OOCP::XmlWriter& aWriter, const std::string& aElement, const std::string& aAttr, const auto& aVal)
+{
+    aWriter.startElement(aElement);
+    aWriter.startElement("Defn");
+    aWriter.attribute(aAttr, aVal);
+    aWriter.endElement();
+    aWriter.endElement();
+}
 
-    mCurXmlElem = ePolygon;
+void writePageSettings(OOCP::XmlWriter& aWriter, const OOCP::PageSettings& aSettings)
+{
+    aWriter.startElement("DefaultPageRec");
+    aWriter.startElement("Defn");
+    aWriter.attribute("ANSIGridRefs", aSettings.ansiGridRefs);
+    aWriter.attribute("BorderDisplayed", aSettings.borderDisplayed);
+    aWriter.attribute("BorderPrinted", aSettings.borderPrinted);
+    aWriter.attribute("GridRefDisplayed", aSettings.gridRefDisplayed);
+    aWriter.attribute("GridRefPrinted", aSettings.gridRefPrinted);
+    aWriter.attribute("HorizontalLabelCount", aSettings.horizontalCount);
+    aWriter.attribute("HorizontalLabelIsAscending", aSettings.horizontalAscending);
+    aWriter.attribute("HorizontalLabelIsChar", aSettings.horizontalChar);
+    aWriter.attribute("HorizontalLabelWidth", aSettings.horizontalWidth);
+    aWriter.attribute("IsMetric", aSettings.isMetric);
+    aWriter.attribute("PinToPin", aSettings.pinToPin);
+    aWriter.attribute("TitleBlockDisplayed", aSettings.titleblockDisplayed);
+    aWriter.attribute("TitleBlockPrinted", aSettings.titleblockPrinted);
+    aWriter.attribute("VerticalLabelCount", aSettings.verticalCount);
+    aWriter.attribute("VerticalLabelIsAscending", aSettings.verticalAscending);
+    aWriter.attribute("VerticalLabelIsChar", aSettings.verticalChar);
+    aWriter.attribute("VerticalLabelWidth", aSettings.verticalWidth);
+    aWriter.endElement();
+    aWriter.endElement();
+}
+} // namespace
 
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+fs::path OOCP::XmlExporter::exportXml(const fs::path& aOutDir)
+{
+    mLib = getLibraryStreamFromDb(mCtx.mDb);
 
-    eDefn->SetAttribute("fillStyle", static_cast<uint32_t>(aObj.fillStyle));
-    eDefn->SetAttribute("hatchStyle", static_cast<uint32_t>(aObj.hatchStyle));
-    eDefn->SetAttribute("lineStyle", static_cast<uint32_t>(aObj.getLineStyle()));
-    eDefn->SetAttribute("lineWidth", static_cast<uint32_t>(aObj.getLineWidth()));
+    std::vector<std::shared_ptr<Stream>> packages;
+    std::map<std::string, std::vector<std::shared_ptr<Stream>>> schematics; //!< Schematic name -> pages
 
-    for(const auto& point : aObj.points)
+    for(const auto& stream : mCtx.mDb.mStreams)
     {
-        XMLElement* ePolygonPoint = mXml.NewElement("PolygonPoint");
-        mCurXmlElem->InsertEndChild(ePolygonPoint);
+        if(std::dynamic_pointer_cast<StreamPackage>(stream))
+        {
+            packages.push_back(stream);
+        }
+        else if(std::dynamic_pointer_cast<StreamPage>(stream))
+        {
+            // Location is `Views/<Schematic>/Pages/<Page>`
+            const auto& location = stream->mCtx.mCfbfStreamLocation.get_vector();
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        ePolygonPoint->InsertEndChild(eDefn);
+            const std::string schematic = location.size() > 1U ? location.at(1U) : std::string{};
 
-        eDefn->SetAttribute("x", point.x);
-        eDefn->SetAttribute("y", point.y);
+            schematics[schematic].push_back(stream);
+        }
     }
 
-    mCurXmlElem = parent;
-}
-
-void OOCP::XmlExporter::visit(const PrimPolyline& aObj)
-{
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* ePolyline = mXml.NewElement("Polyline");
-    mCurXmlElem->InsertEndChild(ePolyline);
+    sortByStreamLocation(packages);
 
-    mCurXmlElem = ePolyline;
+    const bool isDesign = mLib ? mLib->mDbType == DatabaseType::Design : !schematics.empty();
 
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+    fs::path xmlPath = aOutDir;
 
-    eDefn->SetAttribute("lineStyle", static_cast<uint32_t>(aObj.getLineStyle()));
-    eDefn->SetAttribute("lineWidth", static_cast<uint32_t>(aObj.getLineWidth()));
-
-    for(const auto& point : aObj.points)
+    if(!OutputSink::isStdout(aOutDir))
     {
-        XMLElement* ePolylinePoint = mXml.NewElement("PolylinePoint");
-        mCurXmlElem->InsertEndChild(ePolylinePoint);
-
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        ePolylinePoint->InsertEndChild(eDefn);
+        fs::create_directories(aOutDir);
 
-        eDefn->SetAttribute("x", point.x);
-        eDefn->SetAttribute("y", point.y);
+        xmlPath = aOutDir / (mCtx.mInputCfbfFile.stem().string() + ".xml");
     }
 
-    mCurXmlElem = parent;
-}
+    OutputSink sink{xmlPath, mCtx.mCfg.mOutputCfg};
 
-void OOCP::XmlExporter::visit(const PrimLine& aObj)
-{
-    XMLElement* parent = mCurXmlElem;
+    std::ostream& xml = sink.getStream();
 
-    XMLElement* eLine = mXml.NewElement("Line");
-    mCurXmlElem->InsertEndChild(eLine);
+    mCtx.mLogger.info("Exporting {} packages and {} schematics to {}", packages.size(), schematics.size(),
+        sink.getPath().string());
 
-    mCurXmlElem = eLine;
+    XmlWriter writer{xml};
 
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+    writer.writeDeclaration();
 
-    eDefn->SetAttribute("lineStyle", static_cast<uint32_t>(aObj.getLineStyle()));
-    eDefn->SetAttribute("lineWidth", static_cast<uint32_t>(aObj.getLineWidth()));
-    eDefn->SetAttribute("x1", aObj.x1);
-    eDefn->SetAttribute("x2", aObj.x2);
-    eDefn->SetAttribute("y1", aObj.y1);
-    eDefn->SetAttribute("y2", aObj.y2);
+    writer.startElement(isDesign ? "Design" : "Lib");
 
-    mCurXmlElem = parent;
-}
-
-void OOCP::XmlExporter::visit(const PrimSymbolVector& aObj)
-{
-    XMLElement* parent = mCurXmlElem;
+    writer.startElement("Defn");
+    writer.attribute("name", mCtx.mInputCfbfFile.string());
+    writer.endElement();
 
-    XMLElement* eSymbolVector = mXml.NewElement("SymbolVector");
-    mCurXmlElem->InsertEndChild(eSymbolVector);
+    writeLibrary(writer);
 
-    mCurXmlElem = eSymbolVector;
+    // The root start tag is terminated at this point, fragments can be appended directly
+    writeStreams(xml, packages, 1U);
 
+    for(auto& [schematic, pages] : schematics)
     {
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        mCurXmlElem->InsertEndChild(eDefn);
+        sortByStreamLocation(pages);
 
-        eDefn->SetAttribute("locX", aObj.locX);
-        eDefn->SetAttribute("locY", aObj.locY);
-        eDefn->SetAttribute("name", aObj.name.c_str());
-    }
+        writer.startElement("Schematic");
 
-    for(const auto& primitive : aObj.primitives)
-    {
-        primitive->accept(*this);
-    }
+        writer.startElement("Defn");
+        writer.attribute("name", schematic);
+        writer.endElement();
 
-    mCurXmlElem = parent;
-}
+        writeStreams(xml, pages, 2U);
 
-void OOCP::XmlExporter::visit(const StructSymbolDisplayProp& aObj)
-{
-    XMLElement* parent = mCurXmlElem;
+        writer.endElement();
+    }
 
-    XMLElement* eSymbolDisplayProp = mXml.NewElement("SymbolDisplayProp");
-    mCurXmlElem->InsertEndChild(eSymbolDisplayProp);
+    writer.endElement();
 
-    mCurXmlElem = eSymbolDisplayProp;
+    sink.close();
 
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+    return sink.getPath();
+}
 
-    eDefn->SetAttribute("locX", aObj.x);
-    eDefn->SetAttribute("locY", aObj.y);
-    eDefn->SetAttribute("name", aObj.nameIdx); // @todo Value itself not index
-    eDefn->SetAttribute("rotation", static_cast<uint32_t>(aObj.rotation));
-    eDefn->SetAttribute("textJustification", "0"); // @todo
+void OOCP::XmlExporter::writeLibrary(XmlWriter& aWriter) const
+{
+    aWriter.startElement("DefaultValues");
 
-    XMLElement* ePropFont = mXml.NewElement("PropFont");
-    mCurXmlElem->InsertEndChild(ePropFont);
+    aWriter.startElement("Defn");
+    aWriter.endElement();
 
-    if(mLib && mLib->library && aObj.textFontIdx < mLib->library->textFonts.size())
+    if(mLib)
     {
-        XMLElement* parent = mCurXmlElem;
-
-        mCurXmlElem = ePropFont;
+        for(std::size_t i = 0U; i < mLib->defaultFontIdxs.size(); ++i)
+        {
+            writeFont(aWriter, "DefaultFont", mLib->getDefaultFont(i), i);
+        }
 
-        mLib->library->textFonts[aObj.textFontIdx].accept(*this);
+        writePageSettings(aWriter, mLib->pageSettings);
 
-        mCurXmlElem = parent;
+        for(std::size_t i = 0U; i < mLib->strLstPartField.size(); ++i)
+        {
+            aWriter.startElement("DefaultPartFieldMapping");
+            aWriter.startElement("Defn");
+            aWriter.attribute("index", i + 1U);
+            aWriter.attribute("val", mLib->strLstPartField[i]);
+            aWriter.endElement();
+            aWriter.endElement();
+        }
     }
 
-    XMLElement* ePropColor = mXml.NewElement("PropColor");
-    mCurXmlElem->InsertEndChild(ePropColor);
-
-    XMLElement* eDefn2 = mXml.NewElement("Defn");
-    ePropColor->InsertEndChild(eDefn2);
-
-    eDefn2->SetAttribute("val", static_cast<uint32_t>(aObj.propColor));
-
-    XMLElement* ePropDispType = mXml.NewElement("PropDispType");
-    mCurXmlElem->InsertEndChild(ePropDispType);
-
-    XMLElement* eDefn3 = mXml.NewElement("Defn");
-    ePropDispType->InsertEndChild(eDefn3);
-
-    eDefn3->SetAttribute("ValueIfValueExist", 1); // @todo
-    eDefn3->SetAttribute("val", 1);               // @todo
-
-    mCurXmlElem = parent;
+    aWriter.endElement();
 }
 
-void OOCP::XmlExporter::visit(const StructSymbolPin& aObj)
+void OOCP::XmlExporter::writeStreams(
+    std::ostream& aOs, const std::vector<std::shared_ptr<Stream>>& aStreams, std::size_t aDepth) const
 {
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+    const std::size_t batchSize = std::max<std::size_t>(mCtx.mCfg.mThreadCount, 1U);
 
-    eDefn->SetAttribute("hotptX", aObj.hotptX);
-    eDefn->SetAttribute("hotptY", aObj.hotptY);
-    eDefn->SetAttribute("name", aObj.name.c_str());
-    eDefn->SetAttribute("position", 0); // @todo
-    eDefn->SetAttribute("startX", aObj.startX);
-    eDefn->SetAttribute("startY", aObj.startY);
-    eDefn->SetAttribute("type", static_cast<uint32_t>(aObj.portType));
-    eDefn->SetAttribute("visible", 1); // @todo
+    std::vector<std::string> buffers(batchSize);
 
+    for(std::size_t batchStart = 0U; batchStart < aStreams.size(); batchStart += batchSize)
     {
-        XMLElement* eIsLong = mXml.NewElement("IsLong");
-        mCurXmlElem->InsertEndChild(eIsLong);
+        const std::size_t count = std::min(batchSize, aStreams.size() - batchStart);
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsLong->InsertEndChild(eDefn);
+        parallelFor(mCtx.mCfg.mThreadCount, count,
+            [&](std::size_t aIdx)
+            {
+                const auto& stream = aStreams[batchStart + aIdx];
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isLong));
-    }
+                std::ostringstream os;
 
-    {
-        XMLElement* eIsClock = mXml.NewElement("IsClock");
-        mCurXmlElem->InsertEndChild(eIsClock);
+                {
+                    XmlWriter writer{os, aDepth};
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsClock->InsertEndChild(eDefn);
+                    if(const auto package = std::dynamic_pointer_cast<StreamPackage>(stream))
+                    {
+                        writePackage(writer, *package);
+                    }
+                    else if(const auto page = std::dynamic_pointer_cast<StreamPage>(stream))
+                    {
+                        writePage(writer, *page);
+                    }
+                }
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isClock));
+                buffers[aIdx] = os.str();
+            });
+
+        // Write in stream order and release the buffers before the next batch
+        for(std::size_t i = 0U; i < count; ++i)
+        {
+            aOs << buffers[i];
+            buffers[i].clear();
+            buffers[i].shrink_to_fit();
+        }
     }
+}
 
+void OOCP::XmlExporter::writePackage(XmlWriter& aWriter, const StreamPackage& aPackage) const
+{
+    if(!aPackage.package)
     {
-        XMLElement* eIsDot = mXml.NewElement("IsDot");
-        mCurXmlElem->InsertEndChild(eIsDot);
-
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsDot->InsertEndChild(eDefn);
-
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isDot));
+        return;
     }
 
-    {
-        XMLElement* eIsLeftPointing = mXml.NewElement("IsLeftPointing");
-        mCurXmlElem->InsertEndChild(eIsLeftPointing);
+    const StructPackage& package = *aPackage.package;
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsLeftPointing->InsertEndChild(eDefn);
+    aWriter.startElement("Package");
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isLeftPointing));
-    }
+    // `alphabeticNumbering`, `pcbLib`, `timestamp` and `timezone` are not decoded yet and therefore omitted
+    aWriter.startElement("Defn");
+    aWriter.attribute("isHomogeneous", aPackage.partCells.size() <= 1U);
+    aWriter.attribute("name", package.name);
+    aWriter.attribute("pcbFootprint", package.pcbFootprint);
+    aWriter.attribute("refdesPrefix", package.refDes);
+    aWriter.endElement();
 
+    const auto findView = [&aPackage](const std::string& aName) -> const StructLibraryPart*
     {
-        XMLElement* eIsRightPointing = mXml.NewElement("IsRightPointing");
-        mCurXmlElem->InsertEndChild(eIsRightPointing);
+        for(const auto& libraryPart : aPackage.libraryParts)
+        {
+            if(libraryPart && !aName.empty() && libraryPart->name == aName)
+            {
+                return libraryPart.get();
+            }
+        }
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsRightPointing->InsertEndChild(eDefn);
+        return nullptr;
+    };
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isRightPointing));
-    }
+    const std::string normal  = ".Normal";
+    const std::string convert = ".Convert";
 
+    bool isFirstLibPart = true;
+
+    const auto writeLibPart = [&](const std::string& aCellName, const StructLibraryPart* aNormalView,
+                                  const StructLibraryPart* aConvertView)
     {
-        XMLElement* eIsNetStyle = mXml.NewElement("IsNetStyle");
-        mCurXmlElem->InsertEndChild(eIsNetStyle);
+        aWriter.startElement("LibPart");
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsNetStyle->InsertEndChild(eDefn);
+        aWriter.startElement("Defn");
+        aWriter.attribute("CellName", aCellName);
+        aWriter.endElement();
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isNetStyle));
-    }
+        if(aNormalView)
+        {
+            writeLibraryPart(aWriter, *aNormalView, "NormalView", normal);
+        }
 
-    {
-        XMLElement* eIsNoConnect = mXml.NewElement("IsNoConnect");
-        mCurXmlElem->InsertEndChild(eIsNoConnect);
+        if(aConvertView)
+        {
+            writeLibraryPart(aWriter, *aConvertView, "ConvertView", convert);
+        }
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsNoConnect->InsertEndChild(eDefn);
+        // @todo Devices are stored per package, it is not yet known how they map to cells
+        if(isFirstLibPart)
+        {
+            writePhysicalPart(aWriter, package);
+            isFirstLibPart = false;
+        }
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isNoConnect));
-    }
+        aWriter.endElement();
+    };
 
+    if(aPackage.partCells.empty())
     {
-        XMLElement* eIsGlobal = mXml.NewElement("IsGlobal");
-        mCurXmlElem->InsertEndChild(eIsGlobal);
-
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsGlobal->InsertEndChild(eDefn);
+        const StructLibraryPart* normalView =
+            aPackage.libraryParts.empty() ? nullptr : aPackage.libraryParts.front().get();
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.pinShape.isGlobal));
+        writeLibPart(package.name, normalView, nullptr);
     }
 
+    for(const auto& partCell : aPackage.partCells)
     {
-        XMLElement* eIsNumberVisible = mXml.NewElement("IsNumberVisible");
-        mCurXmlElem->InsertEndChild(eIsNumberVisible);
-
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsNumberVisible->InsertEndChild(eDefn);
-
-        eDefn->SetAttribute("val", 1 /* static_cast<uint32_t>(aObj.pinShape.isNumberVisible) */); // @todo
+        if(partCell)
+        {
+            writeLibPart(removeSuffix(partCell->normalName, normal), findView(partCell->normalName),
+                findView(partCell->convertName));
+        }
     }
-}
-
-void OOCP::XmlExporter::visit(const StructSymbolPinBus& aObj)
-{
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* eSymbolPinBus = mXml.NewElement("SymbolPinBus");
-    mCurXmlElem->InsertEndChild(eSymbolPinBus);
-
-    mCurXmlElem = eSymbolPinBus;
-
-    visit(static_cast<const StructSymbolPin&>(aObj));
 
-    mCurXmlElem = parent;
+    aWriter.endElement();
 }
 
-void OOCP::XmlExporter::visit(const StructSymbolPinScalar& aObj)
+void OOCP::XmlExporter::writeLibraryPart(XmlWriter& aWriter, const StructLibraryPart& aPart,
+    const std::string& aViewElement, const std::string& aSuffix) const
 {
-    XMLElement* parent = mCurXmlElem;
+    aWriter.startElement(aViewElement);
 
-    XMLElement* eSymbolPinScalar = mXml.NewElement("SymbolPinScalar");
-    mCurXmlElem->InsertEndChild(eSymbolPinScalar);
+    aWriter.startElement("Defn");
+    aWriter.attribute("suffix", aSuffix);
+    aWriter.endElement();
 
-    mCurXmlElem = eSymbolPinScalar;
+    for(const auto& symbolDisplayProp : aPart.symbolDisplayProps)
+    {
+        if(symbolDisplayProp)
+        {
+            writeSymbolDisplayProp(aWriter, *symbolDisplayProp);
+        }
+    }
 
-    visit(static_cast<const StructSymbolPin&>(aObj));
+    aWriter.startElement("SymbolBBox");
+    aWriter.startElement("Defn");
+    aWriter.attribute("x1", aPart.bboxX1);
+    aWriter.attribute("x2", aPart.bboxX2);
+    aWriter.attribute("y1", aPart.bboxY1);
+    aWriter.attribute("y2", aPart.bboxY2);
+    aWriter.endElement();
+    aWriter.endElement();
+
+    const auto& props = aPart.generalProperties;
+
+    writeValue(aWriter, "IsPinNumbersVisible", "val", props.pinNumberVisible);
+    writeValue(aWriter, "IsPinNamesRotated", "val", props.pinNameRotate);
+    writeValue(aWriter, "IsPinNamesVisible", "val", props.pinNameVisible);
+    writeValue(aWriter, "ContentsLibName", "name", props.implementationPath);
+    writeValue(aWriter, "ContentsViewName", "name", props.implementation);
+    writeValue(aWriter, "ContentsViewType", "type", props.implementationType);
+    writeValue(aWriter, "PartValue", "name", props.partValue);
+    writeValue(aWriter, "Reference", "name", props.refDes);
+
+    for(const auto& primitive : aPart.primitives)
+    {
+        if(primitive)
+        {
+            writePrimitive(aWriter, *primitive);
+        }
+    }
 
-    mCurXmlElem = parent;
+    for(const auto& symbolPin : aPart.symbolPins)
+    {
+        if(symbolPin)
+        {
+            writeSymbolPin(aWriter, *symbolPin);
+        }
+    }
+
+    aWriter.endElement();
 }
 
-void OOCP::XmlExporter::visit(const StructPackage& aObj)
+void OOCP::XmlExporter::writePhysicalPart(XmlWriter& aWriter, const StructPackage& aPackage) const
 {
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* ePhysicalPart = mXml.NewElement("PhysicalPart");
-    mCurXmlElem->InsertEndChild(ePhysicalPart);
-
-    mCurXmlElem = ePhysicalPart;
-
-    for(size_t i = 0U; i < aObj.devices.size(); ++i)
+    for(const auto& device : aPackage.devices)
     {
-        assert(aObj.devices.at(i)->pinMap.size() == aObj.devices.at(i)->pinIgnore.size());
-        assert(aObj.devices.at(i)->pinMap.size() == aObj.devices.at(i)->pinGroup.size());
-
-        for(size_t position = 0U; position < aObj.devices.at(i)->pinMap.size(); ++position)
+        if(!device)
         {
-            const auto& number = aObj.devices.at(i)->pinMap.at(position);
-            const auto& shared = aObj.devices.at(i)->pinIgnore.at(position);
-            const auto& swapid = aObj.devices.at(i)->pinGroup.at(position);
-
-            {
-                XMLElement* parent = mCurXmlElem;
-
-                XMLElement* ePinNumber = mXml.NewElement("PinNumber");
-                mCurXmlElem->InsertEndChild(ePinNumber);
-
-                mCurXmlElem = ePinNumber;
-
-                XMLElement* eDefn = mXml.NewElement("Defn");
-                mCurXmlElem->InsertEndChild(eDefn);
-
-                eDefn->SetAttribute("number", number.c_str());
-                eDefn->SetAttribute("position", position);
-
-                mCurXmlElem = parent;
-            }
-
-            {
-                XMLElement* parent = mCurXmlElem;
-
-                XMLElement* ePinShared = mXml.NewElement("PinShared");
-                mCurXmlElem->InsertEndChild(ePinShared);
-
-                mCurXmlElem = ePinShared;
-
-                XMLElement* eDefn = mXml.NewElement("Defn");
-                mCurXmlElem->InsertEndChild(eDefn);
-
-                eDefn->SetAttribute("position", position);
-                eDefn->SetAttribute("shared", static_cast<uint32_t>(shared));
-
-                mCurXmlElem = parent;
-            }
-
-            {
-                XMLElement* parent = mCurXmlElem;
+            continue;
+        }
 
-                XMLElement* ePinSwap = mXml.NewElement("PinSwap");
-                mCurXmlElem->InsertEndChild(ePinSwap);
+        aWriter.startElement("PhysicalPart");
 
-                mCurXmlElem = ePinSwap;
+        aWriter.startElement("Defn");
+        aWriter.endElement();
 
-                XMLElement* eDefn = mXml.NewElement("Defn");
-                mCurXmlElem->InsertEndChild(eDefn);
+        const std::size_t pinCount =
+            std::min({device->pinMap.size(), device->pinIgnore.size(), device->pinGroup.size()});
 
-                eDefn->SetAttribute("position", position);
-                eDefn->SetAttribute("swapid", swapid);
+        if(pinCount != device->pinMap.size())
+        {
+            mCtx.mLogger.warn("{}: Pin lists of device `{}` differ in size", __func__, device->unitRef);
+        }
 
-                mCurXmlElem = parent;
-            }
+        for(std::size_t position = 0U; position < pinCount; ++position)
+        {
+            aWriter.startElement("PinNumber");
+            aWriter.startElement("Defn");
+            aWriter.attribute("number", device->pinMap[position]);
+            aWriter.attribute("position", position);
+            aWriter.endElement();
+            aWriter.endElement();
+
+            aWriter.startElement("PinShared");
+            aWriter.startElement("Defn");
+            aWriter.attribute("position", position);
+            aWriter.attribute("shared", static_cast<bool>(device->pinIgnore[position]));
+            aWriter.endElement();
+            aWriter.endElement();
+
+            aWriter.startElement("PinSwap");
+            aWriter.startElement("Defn");
+            aWriter.attribute("position", position);
+            aWriter.attribute("swapid", device->pinGroup[position]);
+            aWriter.endElement();
+            aWriter.endElement();
         }
-    }
 
-    mCurXmlElem = parent;
+        aWriter.endElement();
+    }
 }
 
-void OOCP::XmlExporter::visit(const StreamPackage& aObj)
+void OOCP::XmlExporter::writePrimitive(XmlWriter& aWriter, const PrimBase& aPrim) const
 {
-    XMLElement* parent = mCurXmlElem;
-
-    const std::string normal = ".Normal";
-    std::string normalName   = aObj.properties.at(0)->normalName;
-    normalName.resize(normalName.size() - normal.size());
-
-    XMLElement* ePackage = mXml.NewElement("Package");
-    mCurXmlElem->InsertEndChild(ePackage);
+    if(const auto* arc = dynamic_cast<const PrimArc*>(&aPrim))
+    {
+        aWriter.startElement("Arc");
+        aWriter.startElement("Defn");
+        aWriter.attribute("endX", arc->endX);
+        aWriter.attribute("endY", arc->endY);
+        aWriter.attribute("lineStyle", arc->getLineStyle());
+        aWriter.attribute("lineWidth", arc->getLineWidth());
+        aWriter.attribute("startX", arc->startX);
+        aWriter.attribute("startY", arc->startY);
+        aWriter.attribute("x1", arc->x1);
+        aWriter.attribute("x2", arc->x2);
+        aWriter.attribute("y1", arc->y1);
+        aWriter.attribute("y2", arc->y2);
+        aWriter.endElement();
+        aWriter.endElement();
+    }
+    else if(const auto* bezier = dynamic_cast<const PrimBezier*>(&aPrim))
+    {
+        aWriter.startElement("Bezier");
+        aWriter.startElement("Defn");
+        aWriter.attribute("lineStyle", bezier->getLineStyle());
+        aWriter.attribute("lineWidth", bezier->getLineWidth());
+        aWriter.endElement();
 
-    mCurXmlElem = ePackage;
+        for(const auto& point : bezier->points)
+        {
+            writePoint(aWriter, "BezierPoint", point);
+        }
 
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
+        aWriter.endElement();
+    }
+    else if(const auto* bitmap = dynamic_cast<const PrimBitmap*>(&aPrim))
+    {
+        std::vector<uint8_t> data = bitmap->loadImgData();
 
-    eDefn->SetAttribute("alphabeticNumbering", "0"); // @todo
-    eDefn->SetAttribute("isHomogeneous", "1");       // @todo
-    eDefn->SetAttribute("name", normalName.c_str());
-    eDefn->SetAttribute("refdesPrefix", "unimplemented"); // @todo
-    eDefn->SetAttribute("pcbLib", "unimplemented");       // @todo
-    eDefn->SetAttribute("pcbFootprint", "unimplemented"); // @todo
-    eDefn->SetAttribute("sourcelib", "unimplemented");    // @todo
-    eDefn->SetAttribute("timestamp", "0");                // @todo
-    eDefn->SetAttribute("timezone", "0");                 // @todo
+        if(PrimBitmap::isBmpImage(data))
+        {
+            data = toExportedBmp(PrimBitmap::getBmpFileData(data));
+        }
 
+        aWriter.startElement("Bitmap");
+        aWriter.startElement("Defn");
+        aWriter.attribute("locX", bitmap->locX);
+        aWriter.attribute("locY", bitmap->locY);
+        aWriter.attribute("val", toBase64(data));
+        aWriter.attribute("x1", bitmap->x1);
+        aWriter.attribute("x2", bitmap->x2);
+        aWriter.attribute("y1", bitmap->y1);
+        aWriter.attribute("y2", bitmap->y2);
+        aWriter.endElement();
+        aWriter.endElement();
+    }
+    else if(const auto* commentText = dynamic_cast<const PrimCommentText*>(&aPrim))
     {
-        XMLElement* parent = mCurXmlElem;
-
-        XMLElement* eLibPart = mXml.NewElement("LibPart");
-        mCurXmlElem->InsertEndChild(eLibPart);
+        // `textJustification` is not decoded yet and therefore omitted
+        aWriter.startElement("CommentText");
+        aWriter.startElement("Defn");
+        aWriter.attribute("locX", commentText->locX);
+        aWriter.attribute("locY", commentText->locY);
+        aWriter.attribute("name", commentText->name);
+        aWriter.attribute("x1", commentText->x1);
+        aWriter.attribute("x2", commentText->x2);
+        aWriter.attribute("y1", commentText->y1);
+        aWriter.attribute("y2", commentText->y2);
+        aWriter.endElement();
+
+        writeFont(aWriter, "TextFont", commentText->getTextFont());
+
+        aWriter.endElement();
+    }
+    else if(const auto* ellipse = dynamic_cast<const PrimEllipse*>(&aPrim))
+    {
+        aWriter.startElement("Ellipse");
+        aWriter.startElement("Defn");
+        aWriter.attribute("fillStyle", ellipse->getFillStyle());
+        aWriter.attribute("hatchStyle", ellipse->getHatchStyle());
+        aWriter.attribute("lineStyle", ellipse->getLineStyle());
+        aWriter.attribute("lineWidth", ellipse->getLineWidth());
+        aWriter.attribute("x1", ellipse->x1);
+        aWriter.attribute("x2", ellipse->x2);
+        aWriter.attribute("y1", ellipse->y1);
+        aWriter.attribute("y2", ellipse->y2);
+        aWriter.endElement();
+        aWriter.endElement();
+    }
+    else if(const auto* line = dynamic_cast<const PrimLine*>(&aPrim))
+    {
+        aWriter.startElement("Line");
+        aWriter.startElement("Defn");
+        aWriter.attribute("lineStyle", line->getLineStyle());
+        aWriter.attribute("lineWidth", line->getLineWidth());
+        aWriter.attribute("x1", line->x1);
+        aWriter.attribute("x2", line->x2);
+        aWriter.attribute("y1", line->y1);
+        aWriter.attribute("y2", line->y2);
+        aWriter.endElement();
+        aWriter.endElement();
+    }
+    else if(const auto* polygon = dynamic_cast<const PrimPolygon*>(&aPrim))
+    {
+        aWriter.startElement("Polygon");
+        aWriter.startElement("Defn");
+        aWriter.attribute("fillStyle", polygon->fillStyle);
+        aWriter.attribute("hatchStyle", polygon->hatchStyle);
+        aWriter.attribute("lineStyle", polygon->getLineStyle());
+        aWriter.attribute("lineWidth", polygon->getLineWidth());
+        aWriter.endElement();
+
+        for(const auto& point : polygon->points)
+        {
+            writePoint(aWriter, "PolygonPoint", point);
+        }
 
-        mCurXmlElem = eLibPart;
+        aWriter.endElement();
+    }
+    else if(const auto* polyline = dynamic_cast<const PrimPolyline*>(&aPrim))
+    {
+        aWriter.startElement("Polyline");
+        aWriter.startElement("Defn");
+        aWriter.attribute("lineStyle", polyline->getLineStyle());
+        aWriter.attribute("lineWidth", polyline->getLineWidth());
+        aWriter.endElement();
 
+        for(const auto& point : polyline->points)
         {
-            XMLElement* eDefn = mXml.NewElement("Defn");
-            mCurXmlElem->InsertEndChild(eDefn);
-
-            eDefn->SetAttribute("CellName", normalName.c_str());
+            writePoint(aWriter, "PolylinePoint", point);
         }
 
-        for(const auto& primitive : aObj.primitives)
+        aWriter.endElement();
+    }
+    else if(const auto* rect = dynamic_cast<const PrimRect*>(&aPrim))
+    {
+        aWriter.startElement("Rect");
+        aWriter.startElement("Defn");
+        aWriter.attribute("fillStyle", rect->fillStyle);
+        aWriter.attribute("hatchStyle", rect->hatchStyle);
+        aWriter.attribute("lineStyle", rect->getLineStyle());
+        aWriter.attribute("lineWidth", rect->getLineWidth());
+        aWriter.attribute("x1", rect->x1);
+        aWriter.attribute("x2", rect->x2);
+        aWriter.attribute("y1", rect->y1);
+        aWriter.attribute("y2", rect->y2);
+        aWriter.endElement();
+        aWriter.endElement();
+    }
+    else if(const auto* symbolVector = dynamic_cast<const PrimSymbolVector*>(&aPrim))
+    {
+        aWriter.startElement("SymbolVector");
+        aWriter.startElement("Defn");
+        aWriter.attribute("locX", symbolVector->locX);
+        aWriter.attribute("locY", symbolVector->locY);
+        aWriter.attribute("name", symbolVector->name);
+        aWriter.endElement();
+
+        for(const auto& primitive : symbolVector->primitives)
         {
             if(primitive)
             {
-                primitive->accept(*this);
+                writePrimitive(aWriter, *primitive);
             }
         }
 
-        if(aObj.package)
-        {
-            visit(*aObj.package);
-        }
-
-        mCurXmlElem = parent;
+        aWriter.endElement();
+    }
+    else
+    {
+        mCtx.mLogger.debug("{}: Primitive {} is not exported", __func__, to_string(aPrim.getObjectType()));
     }
-
-    mCurXmlElem = parent;
 }
 
-void OOCP::XmlExporter::visit(const StructLibraryPart& aObj)
+void OOCP::XmlExporter::writeSymbolPin(XmlWriter& aWriter, const StructSymbolPin& aPin) const
 {
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* eNormalView = mXml.NewElement("NormalView");
-    mCurXmlElem->InsertEndChild(eNormalView);
-
-    mCurXmlElem = eNormalView;
-
-    {
-        XMLElement* eSymbolBBox = mXml.NewElement("SymbolBBox");
-        mCurXmlElem->InsertEndChild(eSymbolBBox);
+    aWriter.startElement(dynamic_cast<const StructSymbolPinBus*>(&aPin) ? "SymbolPinBus" : "SymbolPinScalar");
+
+    // `position` and `visible` are not decoded yet and therefore omitted
+    aWriter.startElement("Defn");
+    aWriter.attribute("hotptX", aPin.hotptX);
+    aWriter.attribute("hotptY", aPin.hotptY);
+    aWriter.attribute("name", aPin.name);
+    aWriter.attribute("startX", aPin.startX);
+    aWriter.attribute("startY", aPin.startY);
+    aWriter.attribute("type", aPin.portType);
+    aWriter.endElement();
+
+    const PinShape& shape = aPin.pinShape;
+
+    writeValue(aWriter, "IsLong", "val", shape.isLong);
+    writeValue(aWriter, "IsClock", "val", shape.isClock);
+    writeValue(aWriter, "IsDot", "val", shape.isDot);
+    writeValue(aWriter, "IsLeftPointing", "val", shape.isLeftPointing);
+    writeValue(aWriter, "IsRightPointing", "val", shape.isRightPointing);
+    writeValue(aWriter, "IsNetStyle", "val", shape.isNetStyle);
+    writeValue(aWriter, "IsNoConnect", "val", shape.isNoConnect);
+    writeValue(aWriter, "IsGlobal", "val", shape.isGlobal);
+    writeValue(aWriter, "IsNumberVisible", "val", shape.isNumberVisible);
+
+    aWriter.endElement();
+}
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eSymbolBBox->InsertEndChild(eDefn);
+void OOCP::XmlExporter::writeSymbolDisplayProp(XmlWriter& aWriter, const StructSymbolDisplayProp& aProp) const
+{
+    aWriter.startElement("SymbolDisplayProp");
 
-        eDefn->SetAttribute("x1", "0");  // @todo
-        eDefn->SetAttribute("x2", "30"); // @todo
-        eDefn->SetAttribute("y1", "0");  // @todo
-        eDefn->SetAttribute("y2", "60"); // @todo
-    }
+    // `textJustification` and the `PropDispType` element are not decoded yet and therefore omitted
+    aWriter.startElement("Defn");
+    aWriter.attribute("locX", aProp.x);
+    aWriter.attribute("locY", aProp.y);
+    aWriter.attribute("name", aProp.getName());
+    aWriter.attribute("rotation", aProp.rotation);
+    aWriter.endElement();
 
-    {
-        XMLElement* eIsPinNumbersVisible = mXml.NewElement("IsPinNumbersVisible");
-        mCurXmlElem->InsertEndChild(eIsPinNumbersVisible);
+    writeFont(aWriter, "PropFont", aProp.getTextFont());
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsPinNumbersVisible->InsertEndChild(eDefn);
+    writeValue(aWriter, "PropColor", "val", aProp.propColor);
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.generalProperties.pinNumberVisible));
-    }
-
-    {
-        XMLElement* eIsPinNamesRotated = mXml.NewElement("IsPinNamesRotated");
-        mCurXmlElem->InsertEndChild(eIsPinNamesRotated);
+    aWriter.endElement();
+}
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsPinNamesRotated->InsertEndChild(eDefn);
+void OOCP::XmlExporter::writePage(XmlWriter& aWriter, const StreamPage& aPage) const
+{
+    aWriter.startElement("Page");
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.generalProperties.pinNameRotate));
-    }
+    aWriter.startElement("Defn");
+    aWriter.attribute("name", aPage.name);
+    aWriter.endElement();
 
+    for(const auto& inst : aPage.placedInstances)
     {
-        XMLElement* eIsPinNamesVisible = mXml.NewElement("IsPinNamesVisible");
-        mCurXmlElem->InsertEndChild(eIsPinNamesVisible);
-
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        eIsPinNamesVisible->InsertEndChild(eDefn);
+        if(!inst)
+        {
+            continue;
+        }
 
-        eDefn->SetAttribute("val", static_cast<uint32_t>(aObj.generalProperties.pinNameVisible));
-    }
+        aWriter.startElement("PartInst");
 
-    {
-        XMLElement* ePartValue = mXml.NewElement("PartValue");
-        mCurXmlElem->InsertEndChild(ePartValue);
+        aWriter.startElement("Defn");
+        aWriter.attribute("locX", inst->locX);
+        aWriter.attribute("locY", inst->locY);
+        aWriter.attribute("mirror", inst->mirrored);
+        aWriter.attribute("name", inst->pkgName);
+        aWriter.attribute("reference", inst->reference);
+        aWriter.attribute("rotation", inst->rotation);
+        aWriter.endElement();
 
-        XMLElement* eDefn = mXml.NewElement("Defn");
-        ePartValue->InsertEndChild(eDefn);
+        for(const auto& symbolDisplayProp : inst->symbolDisplayProps)
+        {
+            if(symbolDisplayProp)
+            {
+                writeSymbolDisplayProp(aWriter, *symbolDisplayProp);
+            }
+        }
 
-        eDefn->SetAttribute("name", aObj.generalProperties.partValue.c_str());
+        aWriter.endElement();
     }
 
-    for(const auto& primitive : aObj.primitives)
+    for(const auto& wire : aPage.wires)
     {
-        if(primitive)
+        if(wire)
         {
-            primitive->accept(*this);
+            writeWire(aWriter, *wire);
         }
     }
 
-    for(const auto& symbolPin : aObj.symbolPins)
+    aWriter.endElement();
+}
+
+void OOCP::XmlExporter::writeWire(XmlWriter& aWriter, const StructWire& aWire) const
+{
+    aWriter.startElement(dynamic_cast<const StructWireBus*>(&aWire) ? "WireBus" : "WireScalar");
+
+    aWriter.startElement("Defn");
+    aWriter.attribute("color", aWire.color);
+    aWriter.attribute("endX", aWire.endX);
+    aWriter.attribute("endY", aWire.endY);
+    aWriter.attribute("id", aWire.id);
+    aWriter.attribute("startX", aWire.startX);
+    aWriter.attribute("startY", aWire.startY);
+    aWriter.endElement();
+
+    for(const auto& alias : aWire.aliases)
     {
-        if(symbolPin)
+        if(!alias)
         {
-            symbolPin->accept(*this);
+            continue;
         }
+
+        aWriter.startElement("Alias");
+        aWriter.startElement("Defn");
+        aWriter.attribute("locX", alias->locX);
+        aWriter.attribute("locY", alias->locY);
+        aWriter.attribute("name", alias->name);
+        aWriter.attribute("rotation", alias->rotation);
+        aWriter.endElement();
+        aWriter.endElement();
     }
 
-    for(const auto& symbolDisplayProp : aObj.symbolDisplayProps)
+    for(const auto& symbolDisplayProp : aWire.symbolDisplayProps)
     {
         if(symbolDisplayProp)
         {
-            symbolDisplayProp->accept(*this);
+            writeSymbolDisplayProp(aWriter, *symbolDisplayProp);
         }
     }
 
-    mCurXmlElem = parent;
+    aWriter.endElement();
 }
 
-void OOCP::XmlExporter::visit(const tagLOGFONTA& aObj)
+void OOCP::XmlExporter::writeFont(
+    XmlWriter& aWriter, const std::string& aElement, const LOGFONTA& aFont, std::optional<std::size_t> aIndex) const
 {
-    XMLElement* parent = mCurXmlElem;
-
-    XMLElement* eDefn = mXml.NewElement("Defn");
-    mCurXmlElem->InsertEndChild(eDefn);
-
-    eDefn->SetAttribute("escapement", aObj.lfEscapement);
-    eDefn->SetAttribute("height", aObj.lfHeight);
-    eDefn->SetAttribute("italic", aObj.lfItalic);
-    eDefn->SetAttribute("name", aObj.lfFaceName);
-    eDefn->SetAttribute("orientation", aObj.lfOrientation);
-    eDefn->SetAttribute("weight", aObj.lfWeight);
-    eDefn->SetAttribute("width", aObj.lfWidth);
-    eDefn->SetAttribute("charset", aObj.lfCharSet);
-
-    mCurXmlElem = parent;
-}
\ No newline at end of file
+    aWriter.startElement(aElement);
+
+    aWriter.startElement("Defn");
+    aWriter.attribute("charset", aFont.lfCharSet);
+    aWriter.attribute("escapement", aFont.lfEscapement);
+    aWriter.attribute("height", aFont.lfHeight);
+
+    if(aIndex.has_value())
+    {
+        aWriter.attribute("index", aIndex.value());
+    }
+
+    aWriter.attribute("italic", aFont.lfItalic);
+    aWriter.attribute("name", std::string{aFont.lfFaceName, strnlen(aFont.lfFaceName, sizeof(aFont.lfFaceName))});
+    aWriter.attribute("orientation", aFont.lfOrientation);
+    aWriter.attribute("weight", aFont.lfWeight);
+    aWriter.attribute("width", aFont.lfWidth);
+    aWriter.endElement();
+
+    aWriter.endElement();
+}
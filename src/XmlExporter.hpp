@@ -1,335 +1,93 @@
 #ifndef XMLEXPORTER_HPP
 #define XMLEXPORTER_HPP
 
+#include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
-// @todo Why does the compiler not find the lib? Check target_include_directory
-#include "../build/vcpkg_installed/x64-linux/include/tinyxml2.h"
-
-#include "Database.hpp"
-#include "Enums/Color.hpp"
-#include "Primitives/PrimArc.hpp"
-#include "Primitives/PrimBezier.hpp"
-#include "Primitives/PrimEllipse.hpp"
-#include "Primitives/PrimLine.hpp"
-#include "Primitives/PrimPolygon.hpp"
-#include "Primitives/PrimPolyline.hpp"
-#include "Primitives/PrimRect.hpp"
-#include "Primitives/PrimSymbolVector.hpp"
-#include "Streams/StreamPackage.hpp"
-#include "Structures/StructSymbolDisplayProp.hpp"
-#include "Structures/StructSymbolPin.hpp"
-#include "Structures/StructSymbolPinBus.hpp"
-#include "Structures/StructSymbolPinScalar.hpp"
-#include "VisitorPattern.hpp"
+#include "ContainerContext.hpp"
 #include "Win32/LOGFONTA.hpp"
+#include "XmlWriter.hpp"
 
 namespace fs = std::filesystem;
 
-using namespace tinyxml2;
-
 namespace OOCP
 {
-class XmlExporter : public Visitor
+class PrimBase;
+class Stream;
+class StreamLibrary;
+class StreamPackage;
+class StreamPage;
+class StructLibraryPart;
+class StructPackage;
+class StructSymbolDisplayProp;
+class StructSymbolPin;
+class StructWire;
+
+/**
+ * @brief Exports a parsed database to XML, following the structure of
+ *        OrCAD's `olb.xsd` for libraries and `dsn.xsd` for designs.
+ *
+ * @note Packages and pages are rendered in parallel, each thread into its own
+ *       buffer. Buffers are written in a deterministic order and released batch
+ *       by batch, i.e. memory usage does not depend on the size of the database.
+ */
+class XmlExporter
 {
 public:
-    XmlExporter(const fs::path& aExportPath)
-        : mExportBasePath{aExportPath},
-          mExportFilePath{},
-          mXml{},
-          mCurXmlElem{mXml.RootElement()},
-          mLib{nullptr}
-    {
-    }
-
-    void exportXml()
-    {
-        const XMLError result = mXml.SaveFile(mExportFilePath.c_str());
-
-        if(result != XML_SUCCESS)
-        {
-            throw std::runtime_error("Saving XML file to " + mExportFilePath.string() + " failed with error code " +
-                                     std::to_string(result) + "!");
-        }
-    }
-
-    virtual void visit(const Library& aObj) override;
-
-    virtual void visit(const PageSettings& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const Point& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const PrimArc& aObj) override;
-    virtual void visit(const PrimBezier& aObj) override;
-
-    virtual void visit(const PrimBitmap& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const PrimCommentText& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const PrimEllipse& aObj) override;
-    virtual void visit(const PrimLine& aObj) override;
-    virtual void visit(const PrimPolygon& aObj) override;
-    virtual void visit(const PrimPolyline& aObj) override;
-    virtual void visit(const PrimRect& aObj) override;
-    virtual void visit(const PrimSymbolVector& aObj) override;
-
-    virtual void visit(const StreamAdminData& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamBOMDataStream& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamCache& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamDirectoryStruct& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamDsnStream& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamDTypeD& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamERC& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamHierarchy& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamHSObjects& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamLibrary& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamNetBundleMapData& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamPackage& aObj) override;
-
-    virtual void visit(const StreamPage& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamSchematic& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StreamSymbol& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructAlias& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructBookMarkSymbolInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructBusEntry& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructDevice& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructERCObject& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructERCSymbol& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGeneralProperties& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGlobal& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGlobalSymbol& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicArcInst& /* aObj */) override
+    XmlExporter(ContainerContext& aCtx)
+        : mCtx{aCtx},
+          mLib{}
     {
     }
 
-    virtual void visit(const StructGraphicBezierInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicBitMapInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicBoxInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicCommentTextInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicEllipseInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicLineInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicOleEmbedInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicPolygonInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructGraphicPolylineInst& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructLibraryPart& aObj) override;
-
-    virtual void visit(const StructNetDbIdMapping& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructOffPageConnector& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructOffPageSymbol& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructPackage& aObj) override;
-
-    virtual void visit(const StructPartCell& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructPinShapeSymbol& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructPlacedInstance& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructPort& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructPortSymbol& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructSthInHierarchy1& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructSthInHierarchy2& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructSthInHierarchy3& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructSthInPages0& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructSymbol& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructSymbolBBox& /* aObj */) override
-    {
-    }
-
-    virtual void visit(const StructSymbolDisplayProp& aObj) override;
-    virtual void visit(const StructSymbolPin& aObj) override;
-    virtual void visit(const StructSymbolPinBus& aObj) override;
-    virtual void visit(const StructSymbolPinScalar& aObj) override;
+    /**
+     * @brief Export the database into a single XML file, compressed according to the output configuration.
+     *
+     * @param aOutDir Output directory or `OutputSink::StdoutPath`.
+     * @return fs::path Path to the XML file, named after the input file.
+     */
+    fs::path exportXml(const fs::path& aOutDir);
 
-    virtual void visit(const StructT0x10& /* aObj */) override
-    {
-    }
+private:
+    void writeLibrary(XmlWriter& aWriter) const;
 
-    virtual void visit(const StructT0x34& /* aObj */) override
-    {
-    }
+    void writePackage(XmlWriter& aWriter, const StreamPackage& aPackage) const;
 
-    virtual void visit(const StructT0x35& /* aObj */) override
-    {
-    }
+    void writeLibraryPart(XmlWriter& aWriter, const StructLibraryPart& aPart, const std::string& aViewElement,
+        const std::string& aSuffix) const;
 
-    virtual void visit(const StructT0x45& /* aObj */) override
-    {
-    }
+    void writePhysicalPart(XmlWriter& aWriter, const StructPackage& aPackage) const;
 
-    virtual void visit(const StructT0x5b& /* aObj */) override
-    {
-    }
+    void writePrimitive(XmlWriter& aWriter, const PrimBase& aPrim) const;
 
-    virtual void visit(const StructTitleBlock& /* aObj */) override
-    {
-    }
+    void writeSymbolPin(XmlWriter& aWriter, const StructSymbolPin& aPin) const;
 
-    virtual void visit(const StructTitleBlockSymbol& /* aObj */) override
-    {
-    }
+    void writeSymbolDisplayProp(XmlWriter& aWriter, const StructSymbolDisplayProp& aProp) const;
 
-    virtual void visit(const StructWire& /* aObj */) override
-    {
-    }
+    void writePage(XmlWriter& aWriter, const StreamPage& aPage) const;
 
-    virtual void visit(const StructWireBus& /* aObj */) override
-    {
-    }
+    void writeWire(XmlWriter& aWriter, const StructWire& aWire) const;
 
-    virtual void visit(const StructWireScalar& /* aObj */) override
-    {
-    }
+    void writeFont(XmlWriter& aWriter, const std::string& aElement, const LOGFONTA& aFont,
+        std::optional<std::size_t> aIndex = std::nullopt) const;
 
-    virtual void visit(const tagLOGFONTA& aObj) override;
-
-private:
-    const fs::path mExportBasePath;
-    fs::path mExportFilePath;
+    /**
+     * @brief Render streams in parallel batches and append them in order to the output.
+     *
+     * @param aOs Output stream.
+     * @param aStreams Streams to render.
+     * @param aDepth Indentation depth of the rendered fragments.
+     */
+    void writeStreams(
+        std::ostream& aOs, const std::vector<std::shared_ptr<Stream>>& aStreams, std::size_t aDepth) const;
 
-    XMLDocument mXml;
-    XMLElement* mCurXmlElem;
+    ContainerContext& mCtx;
 
-    const Library* mLib;
+    std::shared_ptr<StreamLibrary> mLib;
 };
 } // namespace OOCP
-#endif // XMLEXPORTER_HPP
\ No newline at end of file
+#endif // XMLEXPORTER_HPP
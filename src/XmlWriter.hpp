@@ -0,0 +1,195 @@
+#ifndef XMLWRITER_HPP
+#define XMLWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "Encoding.hpp"
+
+namespace OOCP
+{
+/**
+ * @brief Minimal streaming XML writer.
+ *
+ * @note Elements are written as soon as they are started, nothing is kept in
+ *       memory except the names of the currently open elements. Elements without
+ *       children are closed with `/>`.
+ */
+class XmlWriter
+{
+public:
+    /**
+     * @param aOs Output stream.
+     * @param aDepth Initial indentation depth, e.g. when writing a fragment of a larger document.
+     */
+    XmlWriter(std::ostream& aOs, std::size_t aDepth = 0U)
+        : mOs{aOs},
+          mBaseDepth{aDepth},
+          mOpenElements{},
+          mIsTagOpen{false}
+    {
+    }
+
+    ~XmlWriter()
+    {
+        // Unbalanced elements are a programming error, close them anyway
+        while(!mOpenElements.empty())
+        {
+            endElement();
+        }
+    }
+
+    void writeDeclaration()
+    {
+        mOs << R"(<?xml version="1.0" encoding="UTF-8" standalone="no" ?>)" << '\n';
+    }
+
+    void startElement(std::string_view aName)
+    {
+        closeStartTag();
+
+        mOs << std::string(2U * getDepth(), ' ') << '<' << aName;
+
+        mOpenElements.push_back(std::string{aName});
+        mIsTagOpen = true;
+    }
+
+    void endElement()
+    {
+        if(mOpenElements.empty())
+        {
+            throw std::logic_error("XmlWriter: No element is open");
+        }
+
+        const std::string name = mOpenElements.back();
+        mOpenElements.pop_back();
+
+        if(mIsTagOpen)
+        {
+            mOs << "/>\n";
+            mIsTagOpen = false;
+        }
+        else
+        {
+            mOs << std::string(2U * getDepth(), ' ') << "</" << name << ">\n";
+        }
+    }
+
+    void attribute(std::string_view aName, std::string_view aVal)
+    {
+        if(!mIsTagOpen)
+        {
+            throw std::logic_error(fmt::format("XmlWriter: Attribute `{}` written outside of a start tag", aName));
+        }
+
+        mOs << ' ' << aName << "=\"" << escape(aVal) << '"';
+    }
+
+    void attribute(std::string_view aName, const char* aVal)
+    {
+        attribute(aName, std::string_view{aVal});
+    }
+
+    void attribute(std::string_view aName, const std::string& aVal)
+    {
+        attribute(aName, std::string_view{aVal});
+    }
+
+    void attribute(std::string_view aName, bool aVal)
+    {
+        attribute(aName, aVal ? "1" : "0");
+    }
+
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void attribute(std::string_view aName, T aVal)
+    {
+        // Print characters as numbers, e.g. `LOGFONTA::lfItalic`
+        if constexpr(sizeof(T) == 1U)
+        {
+            attribute(aName, fmt::format("{}", static_cast<int32_t>(aVal)));
+        }
+        else
+        {
+            attribute(aName, fmt::format("{}", aVal));
+        }
+    }
+
+    template <typename T>
+        requires std::is_enum_v<T>
+    void attribute(std::string_view aName, T aVal)
+    {
+        attribute(aName, static_cast<std::underlying_type_t<T>>(aVal));
+    }
+
+    /**
+     * @brief Escape a CP1252 string and transcode it to UTF-8.
+     *
+     * @note Control characters other than tab, line feed and carriage return
+     *       are not allowed in XML 1.0, they are replaced by U+FFFD.
+     */
+    static std::string escape(std::string_view aVal)
+    {
+        std::string escaped;
+        escaped.reserve(aVal.size());
+
+        for(const char c : aVal)
+        {
+            switch(c)
+            {
+                case '&':  escaped += "&amp;"; break;
+                case '<':  escaped += "&lt;"; break;
+                case '>':  escaped += "&gt;"; break;
+                case '"':  escaped += "&quot;"; break;
+                case '\t': escaped += "&#x9;"; break;
+                case '\n': escaped += "&#xA;"; break;
+                case '\r': escaped += "&#xD;"; break;
+                default:
+                    if(static_cast<unsigned char>(c) < 0x20U)
+                    {
+                        escaped += "\xef\xbf\xbd";
+                    }
+                    else
+                    {
+                        appendCp1252AsUtf8(escaped, static_cast<unsigned char>(c));
+                    }
+                    break;
+            }
+        }
+
+        return escaped;
+    }
+
+private:
+    std::size_t getDepth() const
+    {
+        return mBaseDepth + mOpenElements.size();
+    }
+
+    void closeStartTag()
+    {
+        if(mIsTagOpen)
+        {
+            mOs << ">\n";
+            mIsTagOpen = false;
+        }
+    }
+
+    std::ostream& mOs;
+
+    std::size_t mBaseDepth;
+
+    std::vector<std::string> mOpenElements; //!< Names of the currently open elements
+
+    bool mIsTagOpen; //!< Start tag of the innermost element is not yet terminated
+};
+} // namespace OOCP
+#endif // XMLWRITER_HPP
@@ -1,29 +1,65 @@
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/program_options.hpp>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 
+#include "ArrowExporter.hpp"
 #include "Container.hpp"
-// #include "XmlExporter.hpp"
+#include "JsonExporter.hpp"
+#include "KiCadSchematicExporter.hpp"
+#include "KiCadSymbolExporter.hpp"
+#include "LibraryMerger.hpp"
+#include "OutputSink.hpp"
+#include "SqliteExporter.hpp"
+#include "StreamFactory.hpp"
+#include "Streams/StreamPage.hpp"
+#include "XmlExporter.hpp"
 
 namespace fs = std::filesystem;
 namespace po = boost::program_options;
 
 void parseArgs(int argc, char* argv[], fs::path& input, bool& printTree, bool& extract, fs::path& output,
-    int& verbosity, bool& stopParsing, bool& keep, unsigned int& jobs)
+    int& verbosity, bool& stopParsing, bool& keep, unsigned int& jobs, bool& exportXml, bool& exportJson,
+    bool& exportKiCad, bool& exportArrow, fs::path& sqlitePath, std::vector<fs::path>& mergeLibs, bool& splitLib,
+    bool& extractImages, bool& listInstances, OOCP::OutputConfig& outputCfg)
 {
     po::options_description desc("Allowed options");
     desc.add_options()("help,h", "produce help message")("print_tree,t", po::bool_switch()->default_value(false),
         "print container tree")("extract,e", po::bool_switch()->default_value(false),
         "extract binary files from CFBF container")("input,i", po::value<std::string>(), "input file to parse")(
-        "output,o", po::value<std::string>(), "output path (required iff extract is set)")(
+        "output,o", po::value<std::string>(),
+        "output path (required iff extract, xml, json, kicad, arrow, merge or split is set), `-` writes xml or json to "
+        "stdout")(
         "verbosity,v", po::value<int>()->default_value(4), "verbosity level (0 = off, 6 = highest)")(
         "stop,s", po::bool_switch()->default_value(false), "stop parsing on low severity errors")(
         "keep,k", po::bool_switch()->default_value(false), "keep temporary files after parser completed")("jobs,j",
-        po::value<unsigned int>()->default_value(1U), "number of threads (jobs) to run stream parsing in parallel");
+        po::value<unsigned int>()->default_value(1U), "number of threads (jobs) to run stream parsing in parallel")(
+        "xml,x", po::bool_switch()->default_value(false), "export parsed database as XML into the output path")(
+        "json", po::bool_switch()->default_value(false),
+        "export parsed streams as newline-delimited JSON into the output path")("kicad",
+        po::bool_switch()->default_value(false),
+        "export packages as KiCad symbol library and pages as KiCad schematic into the output path")("arrow",
+        po::bool_switch()->default_value(false), "export tables for analytics as Arrow IPC files into the output path")(
+        "sqlite", po::value<std::string>(),
+        "load parsed libraries and designs into the given SQLite database, it is created if it does not exist")(
+        "merge", po::value<std::vector<std::string>>()->multitoken(),
+        "merge the given libraries into the input library, the result is written into the output path")("split",
+        po::bool_switch()->default_value(false),
+        "split the input library by reference designator prefix into libraries in the output path")("images",
+        po::bool_switch()->default_value(false), "extract embedded images next to the temporary files")("instances",
+        po::bool_switch()->default_value(false),
+        "print the placed instances of all pages to stdout without parsing the whole database")(
+        "compress", po::value<std::string>()->default_value("none"),
+        "compression of xml and json exports (none, gzip)")(
+        "compress_level", po::value<int>()->default_value(6), "compression level from 1 (fastest) to 9 (smallest)");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -41,6 +77,49 @@ void parseArgs(int argc, char* argv[], fs::path& input, bool& printTree, bool& e
     stopParsing = vm.count("stop") ? vm["stop"].as<bool>() : false;
     keep        = vm.count("keep") ? vm["keep"].as<bool>() : false;
     jobs        = vm.count("jobs") ? vm["jobs"].as<unsigned int>() : 1U;
+    exportXml   = vm.count("xml") ? vm["xml"].as<bool>() : false;
+    exportJson  = vm.count("json") ? vm["json"].as<bool>() : false;
+    exportKiCad = vm.count("kicad") ? vm["kicad"].as<bool>() : false;
+    exportArrow = vm.count("arrow") ? vm["arrow"].as<bool>() : false;
+
+    if(vm.count("sqlite") > 0U)
+    {
+        sqlitePath = fs::path{vm["sqlite"].as<std::string>()};
+    }
+
+    if(vm.count("merge") > 0U)
+    {
+        for(const auto& lib : vm["merge"].as<std::vector<std::string>>())
+        {
+            if(!fs::is_regular_file(lib))
+            {
+                std::cout << "The following library to merge was not found: " << lib << std::endl;
+                std::cout << desc << std::endl;
+                std::exit(1);
+            }
+
+            mergeLibs.push_back(fs::path{lib});
+        }
+    }
+
+    splitLib   = vm.count("split") ? vm["split"].as<bool>() : false;
+    extractImages = vm.count("images") ? vm["images"].as<bool>() : false;
+    listInstances = vm.count("instances") ? vm["instances"].as<bool>() : false;
+
+    const std::string compression = vm.count("compress") ? vm["compress"].as<std::string>() : "none";
+
+    if(compression == "gzip")
+    {
+        outputCfg.mCompression = OOCP::Compression::Gzip;
+    }
+    else if(compression != "none")
+    {
+        std::cout << "Unknown compression: " << compression << std::endl;
+        std::cout << desc << std::endl;
+        std::exit(1);
+    }
+
+    outputCfg.mLevel = vm.count("compress_level") ? vm["compress_level"].as<int>() : 6;
 
     if(vm.count("input") > 0U)
     {
@@ -66,7 +145,18 @@ void parseArgs(int argc, char* argv[], fs::path& input, bool& printTree, bool& e
         std::exit(1);
     }
 
-    if(vm.count("output") > 0U)
+    if(vm.count("output") > 0U && OOCP::OutputSink::isStdout(vm["output"].as<std::string>()))
+    {
+        output = fs::path{OOCP::OutputSink::StdoutPath};
+
+        if(extract || exportKiCad || exportArrow || !mergeLibs.empty() || splitLib || (exportXml && exportJson))
+        {
+            std::cout << "Only a single xml or json export can be written to stdout." << std::endl;
+            std::cout << desc << std::endl;
+            std::exit(1);
+        }
+    }
+    else if(vm.count("output") > 0U)
     {
         output = fs::path{vm["output"].as<std::string>()};
         if(!fs::exists(output))
@@ -89,7 +179,7 @@ void parseArgs(int argc, char* argv[], fs::path& input, bool& printTree, bool& e
             std::exit(1);
         }
     }
-    else if(extract)
+    else if(extract || exportXml || exportJson || exportKiCad || exportArrow || !mergeLibs.empty() || splitLib)
     {
         std::cout << "output was not specified but is required." << std::endl;
         std::cout << desc << std::endl;
@@ -113,11 +203,32 @@ int main(int argc, char* argv[])
     bool stopParsing; // on low severity errors
     bool keepTmpFiles;
     unsigned int jobs;
-
-    parseArgs(argc, argv, inputFile, printTree, extract, outputPath, verbosity, stopParsing, keepTmpFiles, jobs);
-
-    // Creating console logger
-    auto console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    bool exportXml;
+    bool exportJson;
+    bool exportKiCad;
+    bool exportArrow;
+    fs::path sqlitePath;
+    std::vector<fs::path> mergeLibs;
+    bool splitLib;
+    bool extractImages;
+    bool listInstances;
+    OOCP::OutputConfig outputCfg;
+
+    parseArgs(argc, argv, inputFile, printTree, extract, outputPath, verbosity, stopParsing, keepTmpFiles, jobs,
+        exportXml, exportJson, exportKiCad, exportArrow, sqlitePath, mergeLibs, splitLib, extractImages, listInstances,
+        outputCfg);
+
+    // Creating console logger, stdout is reserved for the export if requested
+    spdlog::sink_ptr console_sink;
+
+    if(OOCP::OutputSink::isStdout(outputPath))
+    {
+        console_sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+    }
+    else
+    {
+        console_sink = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    }
 
     // Creating file logger
     auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>("OpenOrCadParser.log");
@@ -170,6 +281,93 @@ int main(int argc, char* argv[])
     cfg.mSkipUnknownPrim   = allowSkipping;
     cfg.mSkipInvalidPrim   = allowSkipping;
     cfg.mKeepTmpFiles      = keepTmpFiles;
+    cfg.mExtractImages     = extractImages;
+
+    cfg.mOutputCfg              = outputCfg;
+    cfg.mOutputCfg.mThreadCount = jobs;
+
+    // Merging and splitting copies streams between containers instead of exporting them
+    if(!mergeLibs.empty() || splitLib)
+    {
+        OOCP::LibraryMerger merger{inputFile, cfg};
+
+        if(!mergeLibs.empty())
+        {
+            try
+            {
+                merger.merge(mergeLibs);
+            }
+            catch(const std::exception& e)
+            {
+                spdlog::error("{}", e.what());
+                return 1;
+            }
+
+            const fs::path mergedPath =
+                outputPath / (inputFile.stem().string() + "_merged" + inputFile.extension().string());
+
+            merger.write(mergedPath);
+
+            spdlog::info("Merged {} libraries into {}: {} added, {} duplicates, {} conflicts", mergeLibs.size(),
+                mergedPath.string(), merger.getAddedCtr(), merger.getDuplicateCtr(), merger.getConflictCtr());
+        }
+
+        if(splitLib)
+        {
+            const std::vector<fs::path> splitPaths = merger.split(outputPath);
+
+            spdlog::info("Split library into {} libraries in {}", splitPaths.size(), outputPath.string());
+        }
+
+        return 0;
+    }
+
+    const bool parseDatabase = !printTree && !extract && !listInstances;
+
+    // Records are written as soon as their stream completed parsing
+    const OOCP::JsonFormat jsonFormat = OOCP::JsonFormat::Ndjson;
+
+    const fs::path jsonPath = OOCP::OutputSink::isStdout(outputPath)
+                                  ? outputPath
+                                  : outputPath / (inputFile.stem().string() +
+                                                     OOCP::JsonExporter::getFileExtension(jsonFormat));
+
+    // Exporters that receive streams as soon as they completed parsing
+    std::vector<std::function<void(OOCP::Stream&)>> streamCallbacks;
+
+    std::unique_ptr<OOCP::OutputSink> json;
+    std::unique_ptr<OOCP::JsonExporter> jsonExporter;
+
+    if(parseDatabase && exportJson)
+    {
+        json = std::make_unique<OOCP::OutputSink>(jsonPath, cfg.mOutputCfg);
+
+        jsonExporter = std::make_unique<OOCP::JsonExporter>(json->getStream(), jsonFormat);
+        jsonExporter->begin();
+
+        streamCallbacks.push_back([&jsonExporter](OOCP::Stream& aStream) { jsonExporter->writeStream(aStream); });
+    }
+
+    std::unique_ptr<OOCP::SqliteExporter> sqliteExporter;
+
+    if(parseDatabase && !sqlitePath.empty())
+    {
+        sqliteExporter = std::make_unique<OOCP::SqliteExporter>(sqlitePath, inputFile);
+        sqliteExporter->begin();
+
+        streamCallbacks.push_back([&sqliteExporter](OOCP::Stream& aStream) { sqliteExporter->writeStream(aStream); });
+    }
+
+    if(!streamCallbacks.empty())
+    {
+        cfg.mStreamParsedCallback = [&streamCallbacks](OOCP::Stream& aStream)
+        {
+            for(const auto& callback : streamCallbacks)
+            {
+                callback(aStream);
+            }
+        };
+    }
 
     OOCP::Container parser{inputFile, cfg};
 
@@ -185,23 +383,94 @@ int main(int argc, char* argv[])
         parser.extractContainer(outputPath);
     }
 
-    if(!printTree && !extract)
+    if(listInstances)
+    {
+        // Pages are decoded one placed instance at a time, other streams are not parsed at all
+        for(const auto& dirEntry : fs::recursive_directory_iterator(ctx.mExtractedCfbfPath))
+        {
+            if(!dirEntry.is_regular_file())
+            {
+                continue;
+            }
+
+            const auto stream = OOCP::StreamFactory::build(ctx, dirEntry.path());
+            const auto* page  = dynamic_cast<const OOCP::StreamPage*>(stream.get());
+
+            if(!page)
+            {
+                continue;
+            }
+
+            const std::string streamLocation = to_string(page->mCtx.mCfbfStreamLocation);
+
+            try
+            {
+                for(const auto& inst : page->iterPlacedInstances())
+                {
+                    std::cout << fmt::format("{}\t{}\t{}\n", streamLocation, inst.reference, inst.pkgName);
+                }
+            }
+            catch(const std::exception& e)
+            {
+                spdlog::error("{}: {}", streamLocation, e.what());
+            }
+        }
+    }
+
+    if(parseDatabase)
     {
         parser.parseDatabaseFile();
 
-        // Database db = parser.getDb();
+        if(jsonExporter)
+        {
+            jsonExporter->end();
+            json->close();
 
-        const fs::path xmlDir = ctx.mExtractedCfbfPath / "xml";
-        fs::create_directory(xmlDir);
+            spdlog::info("Exported {} JSON records to {}", jsonExporter->getRecordCount(), json->getPath().string());
+        }
 
-        spdlog::info("Setting XML path to {}", xmlDir.string());
+        if(sqliteExporter)
+        {
+            sqliteExporter->end();
 
-        // XmlExporter xml{xmlDir};
+            spdlog::info("Loaded {} rows into {}", sqliteExporter->getRowCount(), sqlitePath.string());
+        }
 
-        // xml.visit(parser.getLibrary());
+        if(exportXml)
+        {
+            OOCP::XmlExporter xml{ctx};
+
+            const fs::path xmlPath = xml.exportXml(outputPath);
+
+            spdlog::info("Exported XML to {}", xmlPath.string());
+        }
 
-        // @todo Use CLI option for export
-        // xml.exportXml();
+        if(exportKiCad)
+        {
+            OOCP::KiCadSymbolExporter kicad{ctx};
+
+            const fs::path symPath = kicad.exportSymbolLibrary(outputPath);
+
+            spdlog::info("Exported KiCad symbol library to {}", symPath.string());
+
+            if(parser.getDatabaseTypeByFileExtension(inputFile) == OOCP::DatabaseType::Design)
+            {
+                OOCP::KiCadSchematicExporter kicadSch{ctx};
+
+                const fs::path schPath = kicadSch.exportSchematic(outputPath);
+
+                spdlog::info("Exported KiCad schematic to {}", schPath.string());
+            }
+        }
+
+        if(exportArrow)
+        {
+            OOCP::ArrowExporter arrow{ctx};
+
+            const std::vector<fs::path> arrowPaths = arrow.exportTables(outputPath);
+
+            spdlog::info("Exported {} Arrow tables to {}", arrowPaths.size(), outputPath.string());
+        }
     }
 
     return 0;
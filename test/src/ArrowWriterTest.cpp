@@ -0,0 +1,136 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <catch2/catch_all.hpp>
+
+#include <ArrowWriter.hpp>
+
+
+namespace
+{
+std::size_t countOccurrences(const std::string& aData, const std::string& aPattern)
+{
+    std::size_t ctr = 0U;
+
+    for(auto pos = aData.find(aPattern); pos != std::string::npos; pos = aData.find(aPattern, pos + 1U))
+    {
+        ++ctr;
+    }
+
+    return ctr;
+}
+
+
+const OOCP::ArrowSchema Schema{
+    {"name",    OOCP::ArrowType::String },
+    {"x",       OOCP::ArrowType::Int32  },
+    {"id",      OOCP::ArrowType::Int64  },
+    {"scale",   OOCP::ArrowType::Float64},
+    {"visible", OOCP::ArrowType::Bool   }
+};
+} // namespace
+
+
+TEST_CASE("Write an Arrow IPC file with merged dictionaries", "[ArrowWriter]")
+{
+    std::stringstream ss;
+
+    OOCP::ArrowFileWriter writer{ss, Schema};
+
+    const int64_t id = 0x1122334455667788;
+
+    OOCP::ArrowBatch batch1{Schema};
+
+    batch1.addRow("CAPACITOR_NONPOLARIZED", 10, id, 1.5, true);
+    batch1.addRow("RESISTOR_VARIABLE", 20, id + 1, 2.5, false);
+
+    OOCP::ArrowBatch batch2{Schema};
+
+    // Strings already contained in the first batch must not be written again
+    batch2.addRow("RESISTOR_VARIABLE", 30, id + 2, 3.5, true);
+    batch2.addRow("INDUCTOR_COUPLED", 40, id + 3, 4.5, false);
+    batch2.addRow("CAPACITOR_NONPOLARIZED", 50, id + 4, 5.5, true);
+
+    CHECK(batch2.getRowCount() == 3U);
+
+    writer.addBatch(std::move(batch1));
+    writer.addBatch(std::move(batch2));
+
+    writer.finish();
+
+    CHECK(writer.getRowCount() == 5U);
+    CHECK_THROWS_AS(writer.finish(), std::logic_error);
+
+    const std::string data = ss.str();
+
+    REQUIRE(data.size() > 24U);
+
+    // File starts with the padded magic and ends with the footer size followed by the magic
+    CHECK(data.compare(0U, 8U, std::string{"ARROW1\0\0", 8U}) == 0);
+    CHECK(data.compare(data.size() - 6U, 6U, "ARROW1") == 0);
+
+    int32_t footerSize = 0;
+    std::memcpy(&footerSize, data.data() + data.size() - 10U, sizeof(footerSize));
+
+    CHECK(footerSize > 0);
+    CHECK(static_cast<std::size_t>(footerSize) < data.size() - 18U);
+
+    CHECK(countOccurrences(data, "CAPACITOR_NONPOLARIZED") == 1U);
+    CHECK(countOccurrences(data, "RESISTOR_VARIABLE") == 1U);
+    CHECK(countOccurrences(data, "INDUCTOR_COUPLED") == 1U);
+
+    // Column names are part of the schema which is repeated in the footer
+    CHECK(countOccurrences(data, "visible") == 2U);
+
+    const std::string idBytes{reinterpret_cast<const char*>(&id), sizeof(id)};
+
+    CHECK(countOccurrences(data, idBytes) == 1U);
+}
+
+
+TEST_CASE("Transcode string columns to UTF-8", "[ArrowWriter]")
+{
+    std::stringstream ss;
+
+    OOCP::ArrowFileWriter writer{ss, Schema};
+
+    OOCP::ArrowBatch batch{Schema};
+
+    // CP1252 `µ` and `€`
+    batch.addRow("100\xb5" "F_\x80", 10, 1, 1.0, true);
+
+    writer.addBatch(std::move(batch));
+    writer.finish();
+
+    const std::string data = ss.str();
+
+    CHECK(countOccurrences(data, "100\xc2\xb5" "F_\xe2\x82\xac") == 1U);
+    CHECK(countOccurrences(data, "100\xb5") == 0U);
+}
+
+
+TEST_CASE("Reject rows and batches that do not match the schema", "[ArrowWriter]")
+{
+    OOCP::ArrowBatch batch{Schema};
+
+    CHECK_THROWS_AS(batch.addRow("R1", 1, 2, 3.0), std::logic_error);
+    CHECK_THROWS_AS(batch.addRow(1, 1, 2, 3.0, true), std::logic_error);
+    CHECK_THROWS_AS(batch.addRow("R1", "1", 2, 3.0, true), std::logic_error);
+    CHECK_THROWS_AS(batch.addRow("R1", 1, 2, 3.0, 1), std::logic_error);
+
+    std::stringstream ss;
+
+    OOCP::ArrowFileWriter writer{ss, Schema};
+
+    CHECK_THROWS_AS(writer.addBatch(OOCP::ArrowBatch{{{"name", OOCP::ArrowType::String}}}), std::logic_error);
+
+    writer.finish();
+
+    CHECK(writer.getRowCount() == 0U);
+    CHECK_THROWS_AS(writer.addBatch(OOCP::ArrowBatch{Schema}), std::logic_error);
+}
@@ -0,0 +1,113 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <BlobStore.hpp>
+#include <ContentHash.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+// Stream file with the given blobs stored one after another
+fs::path writeStream(const fs::path& aPath, const std::vector<std::string>& aBlobs)
+{
+    std::ofstream os{aPath, std::ios::out | std::ios::binary};
+
+    for(const auto& blob : aBlobs)
+    {
+        os.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+    }
+
+    return aPath;
+}
+
+
+OOCP::BlobRef getBlobRef(const std::string& aData, std::size_t aOffset)
+{
+    OOCP::ContentHash hash;
+    hash.add(aData.data(), aData.size());
+
+    return OOCP::BlobRef{OOCP::BlobKind::Image, aOffset, aData.size(), hash.getHash(), ".bmp"};
+}
+} // namespace
+
+
+TEST_CASE("Deduplicate equal blobs across streams", "[BlobStore]")
+{
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_BlobStoreTest";
+    fs::create_directories(tmpDir);
+
+    const std::string logo  = "logo logo logo logo";
+    const std::string photo = "photo";
+
+    const fs::path page1 = writeStream(tmpDir / "page1.bin", {logo, photo});
+    const fs::path page2 = writeStream(tmpDir / "page2.bin", {photo, logo});
+
+    OOCP::BlobStore store;
+
+    CHECK(store.add(getBlobRef(logo, 0U), OOCP::BlobSource{"a.DSN", "Views/S/Pages/1", page1, 0U}));
+    CHECK(store.add(getBlobRef(photo, logo.size()), OOCP::BlobSource{"a.DSN", "Views/S/Pages/1", page1, logo.size()}));
+    CHECK_FALSE(store.add(getBlobRef(photo, 0U), OOCP::BlobSource{"a.DSN", "Views/S/Pages/2", page2, 0U}));
+    CHECK_FALSE(
+        store.add(getBlobRef(logo, photo.size()), OOCP::BlobSource{"a.DSN", "Views/S/Pages/2", page2, photo.size()}));
+
+    // Adding the same occurrence again is ignored
+    CHECK_FALSE(store.add(getBlobRef(logo, 0U), OOCP::BlobSource{"a.DSN", "Views/S/Pages/1", page1, 0U}));
+
+    REQUIRE(store.getBlobCtr() == 2U);
+    CHECK(store.getRefCtr() == 4U);
+    CHECK(store.getTotalSize() == 2U * (logo.size() + photo.size()));
+    CHECK(store.getUniqueSize() == logo.size() + photo.size());
+
+    const auto logoBlob = store.findBySource("a.DSN", "Views/S/Pages/2", photo.size());
+
+    REQUIRE(logoBlob.has_value());
+    CHECK(store.getBlob(logoBlob.value()).sources.size() == 2U);
+    CHECK(store.find(getBlobRef(logo, 0U).hash) == logoBlob);
+
+    const std::vector<uint8_t> data = store.loadData(logoBlob.value());
+
+    CHECK(std::string{data.cbegin(), data.cend()} == logo);
+
+    fs::remove_all(tmpDir);
+}
+
+
+TEST_CASE("Keep blobs with colliding hashes apart", "[BlobStore]")
+{
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_BlobStoreTest";
+    fs::create_directories(tmpDir);
+
+    const fs::path page = writeStream(tmpDir / "page.bin", {"aaaa", "bbbb"});
+
+    // Simulate a hash collision by assigning the same hash to different content
+    OOCP::BlobRef refA = getBlobRef("aaaa", 0U);
+    OOCP::BlobRef refB = getBlobRef("bbbb", 4U);
+
+    refB.hash = refA.hash;
+
+    OOCP::BlobStore store;
+
+    CHECK(store.add(refA, OOCP::BlobSource{"a.OLB", "Symbols/A", page, 0U}));
+    CHECK(store.add(refB, OOCP::BlobSource{"a.OLB", "Symbols/A", page, 4U}));
+
+    REQUIRE(store.getBlobCtr() == 2U);
+    CHECK(store.getBlob(0U).getFileName() != store.getBlob(1U).getFileName());
+    CHECK(store.getBlob(1U).variant == 1U);
+
+    const std::vector<uint8_t> data = store.loadData(1U);
+
+    CHECK(std::string{data.cbegin(), data.cend()} == "bbbb");
+
+    fs::remove_all(tmpDir);
+}
@@ -0,0 +1,280 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <BoundingBox.hpp>
+#include <BoundingBoxIndex.hpp>
+#include <Container.hpp>
+#include <InstanceTransform.hpp>
+#include <Streams/StreamPackage.hpp>
+#include <Streams/StreamPage.hpp>
+#include <Structures/StructLibraryPart.hpp>
+#include <Structures/StructPlacedInstance.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+TEST_CASE("Extend and intersect bounding boxes", "[BoundingBox]")
+{
+    OOCP::BoundingBox bbox;
+
+    CHECK(bbox.isEmpty());
+    CHECK(bbox.getWidth() == 0);
+    CHECK_FALSE(bbox.contains(0, 0));
+
+    // Extending by an empty bounding box keeps it empty
+    bbox.extend(OOCP::BoundingBox{});
+
+    CHECK(bbox.isEmpty());
+
+    bbox.extend(10, -5);
+    bbox.extend(-20, 15);
+
+    CHECK(bbox == OOCP::BoundingBox{-20, -5, 10, 15});
+    CHECK(bbox.getWidth() == 30);
+    CHECK(bbox.getHeight() == 20);
+    CHECK(bbox.contains(10, 15));
+    CHECK_FALSE(bbox.contains(11, 15));
+
+    CHECK(bbox.intersects(OOCP::BoundingBox{10, 15, 20, 20}));
+    CHECK_FALSE(bbox.intersects(OOCP::BoundingBox{11, 15, 20, 20}));
+    CHECK_FALSE(bbox.intersects(OOCP::BoundingBox{}));
+}
+
+
+TEST_CASE("Transform bounding boxes into page coordinates", "[BoundingBox]")
+{
+    const OOCP::BoundingBox bbox{0, 0, 10, 20};
+
+    CHECK(OOCP::transform(bbox, OOCP::InstanceTransform{}) == bbox);
+    CHECK(OOCP::transform(OOCP::BoundingBox{}, OOCP::InstanceTransform{}).isEmpty());
+
+    // Rotation by 90° maps (x, y) -> (y, -x) before translating to the location
+    const OOCP::InstanceTransform rotated{100, 100, OOCP::Orientation{OOCP::Rotation::Deg_90, false}};
+
+    CHECK(OOCP::transform(bbox, rotated) == OOCP::BoundingBox{100, 90, 120, 100});
+
+    // Mirroring along the Y-axis maps (x, y) -> (-x, y)
+    const OOCP::InstanceTransform mirrored{0, 0, OOCP::Orientation{OOCP::Rotation::Deg_0, true}};
+
+    CHECK(OOCP::transform(bbox, mirrored) == OOCP::BoundingBox{-10, 0, 0, 20});
+}
+
+
+TEST_CASE("Batch transformation matches the scalar one", "[InstanceTransform]")
+{
+    std::vector<OOCP::Orientation> orientations;
+
+    for(const auto rotation :
+        {OOCP::Rotation::Deg_0, OOCP::Rotation::Deg_90, OOCP::Rotation::Deg_180, OOCP::Rotation::Deg_270})
+    {
+        orientations.push_back(OOCP::Orientation{rotation, false});
+        orientations.push_back(OOCP::Orientation{rotation, true});
+    }
+
+    // Range lengths cover empty instances, the SIMD kernels
+    // with 4 and 8 lanes as well as their scalar remainder
+    const std::vector<std::size_t> lengths{0U, 1U, 3U, 4U, 5U, 7U, 8U, 9U, 17U};
+
+    std::mt19937 gen{42U};
+    std::uniform_int_distribution<int32_t> dist{-100000, 100000};
+
+    std::vector<OOCP::InstanceTransform> transforms;
+    std::vector<std::size_t> ranges{0U};
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+
+    for(const auto& orientation : orientations)
+    {
+        for(const auto length : lengths)
+        {
+            transforms.push_back(OOCP::InstanceTransform{dist(gen), dist(gen), orientation});
+
+            for(std::size_t i = 0U; i < length; ++i)
+            {
+                xs.push_back(dist(gen));
+                ys.push_back(dist(gen));
+            }
+
+            ranges.push_back(xs.size());
+        }
+    }
+
+    const std::vector<int32_t> localXs = xs;
+    const std::vector<int32_t> localYs = ys;
+
+    OOCP::transformInstances(transforms, ranges, xs, ys);
+
+    INFO("Kernel: " << OOCP::getTransformKernelName());
+
+    for(std::size_t i = 0U; i < transforms.size(); ++i)
+    {
+        for(std::size_t j = ranges[i]; j < ranges[i + 1U]; ++j)
+        {
+            const auto [x, y] = transforms[i].apply(localXs[j], localYs[j]);
+
+            REQUIRE(xs[j] == x);
+            REQUIRE(ys[j] == y);
+        }
+    }
+
+    SECTION("Bounding boxes")
+    {
+        std::vector<OOCP::BoundingBox> bboxes;
+
+        for(std::size_t i = 0U; i < transforms.size(); ++i)
+        {
+            OOCP::BoundingBox bbox;
+
+            for(std::size_t j = ranges[i]; j < ranges[i + 1U]; ++j)
+            {
+                bbox.extend(localXs[j], localYs[j]);
+            }
+
+            bboxes.push_back(bbox);
+        }
+
+        const auto transformed = OOCP::transform(bboxes, transforms);
+
+        REQUIRE(transformed.size() == bboxes.size());
+
+        for(std::size_t i = 0U; i < bboxes.size(); ++i)
+        {
+            CHECK(transformed[i] == OOCP::transform(bboxes[i], transforms[i]));
+        }
+    }
+
+    CHECK_THROWS(OOCP::transformInstances(transforms, std::vector<std::size_t>{0U}, xs, ys));
+}
+
+
+TEST_CASE("Approximate text extents from the font", "[BoundingBox]")
+{
+    OOCP::LOGFONTA font;
+
+    font.lfHeight = -9;
+    font.lfWidth  = 4;
+
+    // Anchored at its bottom left corner
+    CHECK(OOCP::getTextBoundingBox("Value", font, 10, 50) == OOCP::BoundingBox{10, 41, 30, 50});
+    CHECK(OOCP::getTextBoundingBox("Value", font, 10, 50, OOCP::Rotation::Deg_90) ==
+          OOCP::BoundingBox{1, 30, 10, 50});
+    CHECK(OOCP::getTextBoundingBox("", font, 10, 50).isEmpty());
+}
+
+
+TEST_CASE("0000: Bounding box of a package view", "[BoundingBox]")
+{
+    configure_spdlog();
+
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    OOCP::ParserConfig cfg = get_parser_config();
+
+    OOCP::Container parser{inputFile, cfg};
+
+    parser.parseDatabaseFile();
+
+    std::shared_ptr<OOCP::StreamPackage> package;
+
+    for(auto& stream : parser.getContext().mDb.mStreams)
+    {
+        if(auto ptr = std::dynamic_pointer_cast<OOCP::StreamPackage>(stream))
+        {
+            package = ptr;
+        }
+    }
+
+    REQUIRE(package);
+    REQUIRE(package->libraryParts.size() == 1U);
+
+    OOCP::StructLibraryPart& part = *package->libraryParts.front();
+
+    // The view only contains a single line from (10, 20) to (20, 40)
+    const OOCP::BoundingBox geometry = OOCP::getBoundingBox(part, false);
+
+    CHECK(geometry == OOCP::BoundingBox{10, 20, 20, 40});
+
+    // Display properties `Part Reference` at (7, -14) and `Value` at (8, 54)
+    const OOCP::BoundingBox withText = OOCP::getBoundingBox(part);
+
+    CHECK(withText.contains(geometry.x1, geometry.y1));
+    CHECK(withText.contains(geometry.x2, geometry.y2));
+    CHECK(withText.x1 <= 7);
+    CHECK(withText.y1 < -14);
+    CHECK(withText.y2 >= 54);
+
+    // The displayed value determines the extent, not the property name
+    part.generalProperties.partValue = std::string(100U, 'X');
+
+    CHECK(OOCP::getBoundingBox(part).x2 > withText.x2 + 100);
+}
+
+
+TEST_CASE("0000: Bounding boxes of placed instances and pages", "[BoundingBox]")
+{
+    configure_spdlog();
+
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    OOCP::ParserConfig cfg = get_parser_config();
+
+    OOCP::Container parser{inputFile, cfg};
+
+    parser.parseDatabaseFile();
+
+    OOCP::ContainerContext& ctx = parser.getContext();
+
+    // The library does not contain pages, place its package on a page created in memory
+    const auto page = add_page(ctx, "PAGE1");
+
+    const auto addInstance = [&page](const std::string& aPkgName, int32_t aX, int32_t aY, OOCP::Rotation aRotation)
+    {
+        OOCP::StructPlacedInstance& inst = add_instance(*page, "U1", aPkgName);
+
+        inst.locX     = aX;
+        inst.locY     = aY;
+        inst.rotation = aRotation;
+    };
+
+    addInstance("0000", 100, 200, OOCP::Rotation::Deg_90);
+    addInstance("DOES_NOT_EXIST", -30, -40, OOCP::Rotation::Deg_0);
+
+    OOCP::BoundingBoxIndex index{ctx};
+
+    index.build();
+
+    const auto viewBBox = index.getViewBBox("0000");
+
+    REQUIRE(viewBBox.has_value());
+    CHECK_FALSE(viewBBox->isEmpty());
+    CHECK_FALSE(index.getViewBBox("DOES_NOT_EXIST").has_value());
+
+    REQUIRE(index.getPages().size() == 1U);
+
+    const OOCP::PageBBoxes& pageBBoxes = index.getPages().front();
+
+    REQUIRE(pageBBoxes.placedInstances.size() == 2U);
+
+    const OOCP::InstanceTransform rotated{100, 200, OOCP::Orientation{OOCP::Rotation::Deg_90, false}};
+
+    CHECK(pageBBoxes.placedInstances[0] == OOCP::transform(viewBBox.value(), rotated));
+
+    // Unresolved instances only contain their location
+    CHECK(pageBBoxes.placedInstances[1] == OOCP::BoundingBox{-30, -40, -30, -40});
+    CHECK(pageBBoxes.unresolvedInstances == 1U);
+
+    CHECK(pageBBoxes.bbox.contains(-30, -40));
+    CHECK(pageBBoxes.bbox.contains(pageBBoxes.placedInstances[0].x1, pageBBoxes.placedInstances[0].y1));
+    CHECK(pageBBoxes.bbox.contains(pageBBoxes.placedInstances[0].x2, pageBBoxes.placedInstances[0].y2));
+}
@@ -0,0 +1,186 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <CfbWriter.hpp>
+#include <Container.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+using Location = std::vector<std::string>;
+
+
+std::vector<uint8_t> getData(std::size_t aSize, uint8_t aSeed)
+{
+    std::vector<uint8_t> data(aSize);
+
+    for(std::size_t i = 0U; i < aSize; ++i)
+    {
+        data[i] = static_cast<uint8_t>(aSeed + i * 7U);
+    }
+
+    return data;
+}
+
+
+void checkEqualStreams(const OOCP::CfbWriter& aExpected, const OOCP::CfbWriter& aActual)
+{
+    const auto locations = aExpected.getStreamLocations();
+
+    REQUIRE(aActual.getStreamLocations() == locations);
+
+    for(const auto& location : locations)
+    {
+        CHECK(aActual.readStream(location) == aExpected.readStream(location));
+    }
+}
+} // namespace
+
+
+TEST_CASE("0000: Rewrite a container without changes", "[CfbWriter]")
+{
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_CfbWriterTest";
+    fs::create_directories(tmpDir);
+
+    const fs::path outputFile = tmpDir / "0000.OLB";
+
+    const OOCP::CfbWriter source{inputFile};
+
+    REQUIRE_FALSE(source.getStreamLocations().empty());
+    CHECK(source.hasStream({"Library"}));
+
+    source.write(outputFile);
+
+    checkEqualStreams(source, OOCP::CfbWriter{outputFile});
+
+    // The rewritten container needs to be readable by the parser
+    configure_spdlog();
+
+    OOCP::ParserConfig cfg = get_parser_config();
+
+    OOCP::Container original{inputFile, cfg};
+    original.parseDatabaseFile();
+
+    OOCP::Container rewritten{outputFile, cfg};
+    rewritten.parseDatabaseFile();
+
+    CHECK(rewritten.getFileErrCtr() == original.getFileErrCtr());
+
+    fs::remove_all(tmpDir);
+}
+
+
+TEST_CASE("0000: Replace, add and remove streams", "[CfbWriter]")
+{
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_CfbWriterTest";
+    fs::create_directories(tmpDir);
+
+    const fs::path outputFile = tmpDir / "0000.OLB";
+
+    OOCP::CfbWriter writer{inputFile};
+
+    const auto locations = writer.getStreamLocations();
+
+    REQUIRE(locations.size() >= 2U);
+
+    const Location& replaced = locations.front();
+    const Location& removed  = locations.back();
+
+    // Larger than the mini stream cutoff s.t. the stream moves from the mini stream into regular sectors
+    const std::vector<uint8_t> replacedData = getData(10000U, 1U);
+    const std::vector<uint8_t> addedData    = getData(100U, 2U);
+
+    const Location added{"NewStorage", "NewStream"};
+
+    writer.replaceStream(replaced, replacedData);
+    writer.addStream(added, addedData);
+    writer.removeStream(removed);
+
+    CHECK_THROWS(writer.replaceStream({"DoesNotExist"}, {}));
+    CHECK_THROWS(writer.removeStream(removed));
+
+    CHECK(writer.readStream(replaced) == replacedData);
+
+    writer.write(outputFile);
+
+    const OOCP::CfbWriter result{outputFile};
+
+    CHECK(result.getStreamLocations().size() == locations.size());
+    CHECK(result.readStream(replaced) == replacedData);
+    CHECK(result.readStream(added) == addedData);
+    CHECK_FALSE(result.hasStream(removed));
+
+    for(std::size_t i = 1U; i + 1U < locations.size(); ++i)
+    {
+        CHECK(result.readStream(locations[i]) == writer.readStream(locations[i]));
+    }
+
+    fs::remove_all(tmpDir);
+}
+
+
+TEST_CASE("0000: Rewrite changed sectors in place", "[CfbWriter]")
+{
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_CfbWriterTest";
+    fs::create_directories(tmpDir);
+
+    const fs::path copyFile = tmpDir / "0000.OLB";
+    fs::copy_file(inputFile, copyFile, fs::copy_options::overwrite_existing);
+
+    const OOCP::CfbWriter source{inputFile};
+
+    const Location location = source.getStreamLocations().front();
+
+    std::vector<uint8_t> data = source.readStream(location);
+
+    REQUIRE_FALSE(data.empty());
+
+    // Same size, i.e. the stream occupies the same sectors as before
+    for(auto& byte : data)
+    {
+        byte = static_cast<uint8_t>(~byte);
+    }
+
+    OOCP::CfbWriter writer{copyFile};
+
+    writer.replaceStream(location, data);
+
+    REQUIRE(writer.writeInPlace());
+
+    const OOCP::CfbWriter result{copyFile};
+
+    CHECK(result.readStream(location) == data);
+
+    for(const auto& other : source.getStreamLocations())
+    {
+        if(other != location)
+        {
+            CHECK(result.readStream(other) == source.readStream(other));
+        }
+    }
+
+    // A stream that grows does not fit into its sectors anymore
+    data.resize(data.size() + 10000U);
+
+    writer.replaceStream(location, data);
+
+    CHECK_FALSE(writer.writeInPlace());
+
+    fs::remove_all(tmpDir);
+}
@@ -0,0 +1,149 @@
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+#include <catch2/catch_all.hpp>
+
+#include <Container.hpp>
+#include <DuplicateDetector.hpp>
+#include <Enums/LineStyle.hpp>
+#include <Enums/LineWidth.hpp>
+#include <PinTable.hpp>
+#include <Primitives/PrimLine.hpp>
+#include <Streams/StreamPackage.hpp>
+#include <Structures/StructLibraryPart.hpp>
+#include <Structures/StructPackage.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+std::shared_ptr<OOCP::StreamPackage> getPackage(OOCP::Container& aParser)
+{
+    for(auto& stream : aParser.getContext().mDb.mStreams)
+    {
+        if(auto package = std::dynamic_pointer_cast<OOCP::StreamPackage>(stream))
+        {
+            return package;
+        }
+    }
+
+    return std::shared_ptr<OOCP::StreamPackage>{};
+}
+} // namespace
+
+
+TEST_CASE("0000: Fingerprint ignores position, direction and cosmetics", "[DuplicateDetector]")
+{
+    configure_spdlog();
+
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    OOCP::ParserConfig cfg = get_parser_config();
+
+    OOCP::Container parser{inputFile, cfg};
+
+    parser.parseDatabaseFile();
+
+    const auto package = getPackage(parser);
+
+    REQUIRE(package);
+    REQUIRE(package->package);
+    REQUIRE(package->libraryParts.size() == 1U);
+    REQUIRE(package->libraryParts.front()->primitives.size() == 1U);
+
+    // The view only contains a single line from (10, 20) to (20, 40)
+    auto* line = dynamic_cast<OOCP::PrimLine*>(package->libraryParts.front()->primitives.front().get());
+
+    REQUIRE(line);
+
+    const OOCP::SymbolFingerprint original = OOCP::getFingerprint(*package, OOCP::PinTable{*package}, 10);
+
+    SECTION("Translated")
+    {
+        line->x1 += 100;
+        line->x2 += 100;
+        line->y1 -= 30;
+        line->y2 -= 30;
+
+        CHECK(OOCP::getFingerprint(*package, OOCP::PinTable{*package}, 10) == original);
+    }
+
+    SECTION("Drawn in reverse")
+    {
+        std::swap(line->x1, line->x2);
+        std::swap(line->y1, line->y2);
+
+        CHECK(OOCP::getFingerprint(*package, OOCP::PinTable{*package}, 10) == original);
+    }
+
+    SECTION("Different line style and width")
+    {
+        line->setLineStyle(OOCP::LineStyle::Dot);
+        line->setLineWidth(OOCP::LineWidth::Wide);
+
+        CHECK(OOCP::getFingerprint(*package, OOCP::PinTable{*package}, 10) == original);
+    }
+
+    SECTION("Slightly moved end point")
+    {
+        line->x2 += 1;
+
+        const OOCP::SymbolFingerprint moved = OOCP::getFingerprint(*package, OOCP::PinTable{*package}, 10);
+
+        CHECK(moved.exact != original.exact);
+        CHECK(moved.near == original.near);
+    }
+
+    SECTION("Different footprint")
+    {
+        package->package->pcbFootprint += "_alt";
+
+        const OOCP::SymbolFingerprint other = OOCP::getFingerprint(*package, OOCP::PinTable{*package}, 10);
+
+        CHECK(other.exact != original.exact);
+        CHECK(other.near == original.near);
+    }
+}
+
+
+TEST_CASE("0000: Detect the same package in two libraries", "[DuplicateDetector]")
+{
+    configure_spdlog();
+
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_DuplicateDetectorTest";
+    fs::create_directories(tmpDir);
+
+    const fs::path copyFile = tmpDir / "0000_copy.OLB";
+    fs::copy_file(inputFile, copyFile, fs::copy_options::overwrite_existing);
+
+    OOCP::ParserConfig cfg = get_parser_config();
+
+    OOCP::DuplicateDetector detector;
+
+    for(const auto& file : {inputFile, copyFile})
+    {
+        OOCP::Container parser{file, cfg};
+
+        parser.parseDatabaseFile();
+
+        detector.addLibrary(parser.getContext());
+    }
+
+    fs::remove_all(tmpDir);
+
+    const auto groups = detector.findDuplicates();
+
+    REQUIRE(groups.size() == 1U);
+    CHECK(groups.front().kind == OOCP::DuplicateKind::Exact);
+    REQUIRE(groups.front().entries.size() == 2U);
+    CHECK(groups.front().entries[0].name == "0000");
+    CHECK(groups.front().entries[0].library != groups.front().entries[1].library);
+    CHECK(groups.front().entries[0].streamLocation == groups.front().entries[1].streamLocation);
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <ContainerContext.hpp>
+#include <FullTextIndex.hpp>
+#include <Streams/StreamPage.hpp>
+#include <Structures/StructGlobal.hpp>
+#include <Structures/StructPlacedInstance.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+void addGlobal(OOCP::StreamPage& aPage, const std::string& aName)
+{
+    auto global = std::make_unique<OOCP::StructGlobal>(aPage.mCtx);
+
+    global->name = aName;
+
+    aPage.globals.push_back(std::move(global));
+}
+} // namespace
+
+
+TEST_CASE("Tokenize texts", "[FullTextIndex]")
+{
+    CHECK(OOCP::FullTextIndex::tokenize("Hello, World-42 (R1)") ==
+          std::vector<std::string>{"hello", "world", "42", "r1"});
+    CHECK(OOCP::FullTextIndex::tokenize("  \n").empty());
+}
+
+
+TEST_CASE("Index page texts and update changed pages only", "[FullTextIndex]")
+{
+    configure_spdlog();
+
+    // Pages are created in memory s.t. no design file is required
+    InMemoryContainer container{"FullTextIndexTest", "design.DSN"};
+
+    OOCP::ContainerContext& ctx = container.ctx;
+
+    const auto page1 = add_page(ctx, "PAGE1");
+
+    add_instance(*page1, "R1", "RESISTOR");
+    add_instance(*page1, "U1", "LM7805");
+    addGlobal(*page1, "VCC");
+
+    const auto page2 = add_page(ctx, "PAGE2");
+
+    add_instance(*page2, "C1", "CAPACITOR");
+    addGlobal(*page2, "VCC");
+
+    OOCP::FullTextIndex index;
+
+    REQUIRE(index.updateDesign(ctx) == 2U);
+    CHECK(index.getDocumentCtr() == 5U);
+
+    SECTION("Search objects")
+    {
+        const auto hits = index.search("LM7805");
+
+        REQUIRE(hits.size() == 1U);
+
+        const OOCP::TextDocument& doc = index.getDocument(hits.front().docId);
+
+        CHECK(doc.page == "PAGE1");
+        CHECK(doc.object == "placedInstances[1]");
+        CHECK(doc.source == OOCP::TextSource::Part);
+        CHECK(hits.front().score > 0.0);
+
+        // All tokens need to match
+        CHECK(index.search("r1 resistor").size() == 1U);
+        CHECK(index.search("r1 capacitor").empty());
+        CHECK(index.search("vcc").size() == 2U);
+        CHECK(index.search("vcc", 1U).size() == 1U);
+    }
+
+    SECTION("Search pages")
+    {
+        const auto hits = index.searchPages("vcc");
+
+        REQUIRE(hits.size() == 2U);
+        CHECK(hits[0].page != hits[1].page);
+        CHECK(hits[0].documentCtr == 1U);
+    }
+
+    SECTION("Update changed and removed pages")
+    {
+        // Unchanged pages are not indexed again
+        CHECK(index.updateDesign(ctx) == 0U);
+
+        page2->placedInstances.front()->reference = "C2";
+
+        CHECK(index.updateDesign(ctx) == 1U);
+        CHECK(index.getDocumentCtr() == 5U);
+        CHECK(index.search("c1").empty());
+        CHECK(index.search("c2").size() == 1U);
+        CHECK(index.search("capacitor").size() == 1U);
+
+        // Removing the page drops its documents, the index is compacted afterwards
+        auto& streams = ctx.mDb.mStreams;
+        streams.erase(std::remove(streams.begin(), streams.end(), page2), streams.end());
+
+        CHECK(index.updateDesign(ctx) == 0U);
+        CHECK(index.getDocumentCtr() == 3U);
+        CHECK(index.search("capacitor").empty());
+
+        const auto hits = index.search("vcc");
+
+        REQUIRE(hits.size() == 1U);
+        CHECK(index.getDocument(hits.front().docId).page == "PAGE1");
+    }
+
+    SECTION("Remove design")
+    {
+        CHECK(index.removeDesign(ctx.mInputCfbfFile.string()));
+        CHECK_FALSE(index.removeDesign(ctx.mInputCfbfFile.string()));
+
+        CHECK(index.getDocumentCtr() == 0U);
+        CHECK(index.search("vcc").empty());
+    }
+}
@@ -8,12 +8,22 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <system_error>
 #include <thread>
+#include <utility>
 
 #include <spdlog/spdlog.h>
 
 #include <Container.hpp>
+#include <ContainerContext.hpp>
+#include <Database.hpp>
+#include <Streams/StreamPackage.hpp>
+#include <Streams/StreamPage.hpp>
+#include <Structures/StructLibraryPart.hpp>
+#include <Structures/StructPackage.hpp>
+#include <Structures/StructPlacedInstance.hpp>
 
 
 namespace fs = std::filesystem;
@@ -37,6 +47,115 @@ inline OOCP::ParserConfig get_parser_config()
 }
 
 
+/**
+ * @brief Temporary directory that is deleted with all its content when it goes out of scope.
+ */
+class ScopedTmpDir
+{
+public:
+    explicit ScopedTmpDir(const std::string& aName)
+        : mPath{fs::temp_directory_path() / ("OpenOrCadParser_" + aName)}
+    {
+        // Left overs from a previous run that was aborted
+        fs::remove_all(mPath);
+        fs::create_directories(mPath);
+    }
+
+    ~ScopedTmpDir()
+    {
+        // Destructors must not throw, a failed cleanup is not a test failure
+        std::error_code ec;
+        fs::remove_all(mPath, ec);
+    }
+
+    ScopedTmpDir(const ScopedTmpDir&)            = delete;
+    ScopedTmpDir& operator=(const ScopedTmpDir&) = delete;
+
+    const fs::path& getPath() const
+    {
+        return mPath;
+    }
+
+private:
+    fs::path mPath;
+};
+
+
+/**
+ * @brief Database whose streams are created in memory, i.e. no file needs to be parsed.
+ */
+struct InMemoryContainer
+{
+    InMemoryContainer(const std::string& aName, const fs::path& aInputFile)
+        : tmpDir{aName},
+          db{},
+          ctx{aInputFile, tmpDir.getPath() / aInputFile.stem(), get_parser_config(), db}
+    {
+    }
+
+    ScopedTmpDir tmpDir;
+    OOCP::Database db;
+    OOCP::ContainerContext ctx;
+};
+
+
+/**
+ * @brief Add a package with the empty view `<name>.Normal` to the database.
+ */
+[[maybe_unused]]
+inline std::shared_ptr<OOCP::StreamPackage> add_package(OOCP::ContainerContext& aCtx, const std::string& aName)
+{
+    auto package = std::make_shared<OOCP::StreamPackage>(aCtx, aCtx.mExtractedCfbfPath / "Packages" / (aName + ".bin"));
+
+    package->package       = std::make_unique<OOCP::StructPackage>(package->mCtx);
+    package->package->name = aName;
+
+    auto libraryPart  = std::make_unique<OOCP::StructLibraryPart>(package->mCtx);
+    libraryPart->name = aName + ".Normal";
+
+    package->libraryParts.push_back(std::move(libraryPart));
+
+    aCtx.mDb.mStreams.push_back(package);
+
+    return package;
+}
+
+
+/**
+ * @brief Add an empty page of the schematic `SCHEMATIC1` to the database.
+ */
+[[maybe_unused]]
+inline std::shared_ptr<OOCP::StreamPage> add_page(OOCP::ContainerContext& aCtx, const std::string& aName)
+{
+    auto page = std::make_shared<OOCP::StreamPage>(
+        aCtx, aCtx.mExtractedCfbfPath / "Views" / "SCHEMATIC1" / "Pages" / (aName + ".bin"));
+
+    page->name = aName;
+
+    aCtx.mDb.mStreams.push_back(page);
+
+    return page;
+}
+
+
+/**
+ * @brief Place an instance of a package on a page.
+ */
+[[maybe_unused]]
+inline OOCP::StructPlacedInstance& add_instance(
+    OOCP::StreamPage& aPage, const std::string& aReference, const std::string& aPkgName)
+{
+    auto inst = std::make_unique<OOCP::StructPlacedInstance>(aPage.mCtx);
+
+    inst->reference = aReference;
+    inst->pkgName   = aPkgName;
+
+    aPage.placedInstances.push_back(std::move(inst));
+
+    return *aPage.placedInstances.back();
+}
+
+
 [[maybe_unused]]
 inline void configure_spdlog()
 {
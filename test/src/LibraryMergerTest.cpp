@@ -0,0 +1,158 @@
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <CfbWriter.hpp>
+#include <Container.hpp>
+#include <GetStreamHelper.hpp>
+#include <LibraryMerger.hpp>
+#include <Streams/StreamPackage.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+struct ParsedLibrary
+{
+    std::set<std::string> packages;        //!< Names of the packages in `Packages/<name>`
+    std::set<std::string> aliasedPackages; //!< Packages the part aliases refer to
+    std::size_t errCtr;
+};
+
+
+ParsedLibrary parseLibrary(const fs::path& aLibrary)
+{
+    ParsedLibrary parsed{};
+
+    for(const auto& location : OOCP::CfbWriter{aLibrary}.getStreamLocations())
+    {
+        if(location.size() == 2U && location.front() == "Packages" && location.back() != "$Types$")
+        {
+            parsed.packages.insert(location.back());
+        }
+    }
+
+    OOCP::Container container{aLibrary, get_parser_config()};
+    container.parseDatabaseFile();
+
+    parsed.errCtr = container.getFileErrCtr();
+
+    OOCP::Database db = container.getDb();
+
+    const auto libStream = OOCP::getLibraryStreamFromDb(db);
+
+    REQUIRE(libStream);
+
+    for(const auto& [alias, package] : libStream->partAliases)
+    {
+        parsed.aliasedPackages.insert(package);
+    }
+
+    // Each copied package needs to be parsed with the remapped string and font indices
+    std::set<std::string> parsedPackages;
+
+    for(const auto& stream : db.mStreams)
+    {
+        const auto package = std::dynamic_pointer_cast<OOCP::StreamPackage>(stream);
+
+        if(package && package->mCtx.mParsedSuccessfully == true)
+        {
+            parsedPackages.insert(package->mCtx.mCfbfStreamLocation.get_vector().back());
+        }
+    }
+
+    CHECK(parsedPackages == parsed.packages);
+
+    return parsed;
+}
+} // namespace
+
+
+TEST_CASE("0000: Merge and split libraries", "[LibraryMerger]")
+{
+    configure_spdlog();
+
+    const fs::path baseLibrary{"test/test_cases/0000.OLB"};
+
+    const std::vector<fs::path> libraries{
+        "test/test_cases/0001.OLB", "test/test_cases/0002.OLB", "test/test_cases/0003.OLB"};
+
+    const ScopedTmpDir tmpDir{"LibraryMergerTest"};
+
+    const std::size_t baseErrCtr = parseLibrary(baseLibrary).errCtr;
+
+    std::set<std::string> expectedPackages = parseLibrary(baseLibrary).packages;
+
+    for(const auto& library : libraries)
+    {
+        const auto packages = parseLibrary(library).packages;
+        expectedPackages.insert(packages.begin(), packages.end());
+    }
+
+    OOCP::LibraryMerger merger{baseLibrary, get_parser_config()};
+
+    merger.merge(libraries);
+
+    CHECK(merger.getConflictCtr() == 0U);
+    CHECK(merger.getAddedCtr() + merger.getDuplicateCtr() >= expectedPackages.size() - 1U);
+
+    const fs::path merged = tmpDir.getPath() / "merged.OLB";
+
+    merger.write(merged);
+
+    const ParsedLibrary parsedMerged = parseLibrary(merged);
+
+    CHECK(parsedMerged.packages == expectedPackages);
+    CHECK(parsedMerged.errCtr == baseErrCtr);
+
+    SECTION("Merging the same libraries again only finds duplicates")
+    {
+        OOCP::LibraryMerger again{merged, get_parser_config()};
+
+        again.merge(libraries);
+
+        CHECK(again.getAddedCtr() == 0U);
+        CHECK(again.getDuplicateCtr() > 0U);
+        CHECK(again.getConflictCtr() == 0U);
+    }
+
+    SECTION("Split the merged library")
+    {
+        const std::vector<fs::path> outputs = merger.split(tmpDir.getPath());
+
+        REQUIRE_FALSE(outputs.empty());
+
+        // Output files are unique, even if prefixes map to the same file name
+        CHECK(std::set<fs::path>{outputs.begin(), outputs.end()}.size() == outputs.size());
+
+        std::set<std::string> splitPackages;
+
+        for(const auto& output : outputs)
+        {
+            const ParsedLibrary parsed = parseLibrary(output);
+
+            // Aliases are only kept in the library of their package
+            for(const auto& package : parsed.aliasedPackages)
+            {
+                CHECK((parsed.packages.count(package) > 0U || expectedPackages.count(package) == 0U));
+            }
+
+            for(const auto& package : parsed.packages)
+            {
+                // Each package is written to a single library
+                CHECK(splitPackages.insert(package).second);
+            }
+        }
+
+        CHECK(splitPackages == expectedPackages);
+    }
+}
@@ -0,0 +1,240 @@
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <utility>
+
+#include <catch2/catch_all.hpp>
+
+#include <BoundingBoxIndex.hpp>
+#include <ContainerContext.hpp>
+#include <PageLod.hpp>
+#include <Primitives/PrimLine.hpp>
+#include <StreamContext.hpp>
+#include <Streams/StreamLibrary.hpp>
+#include <Streams/StreamPackage.hpp>
+#include <Streams/StreamPage.hpp>
+#include <Structures/StructLibraryPart.hpp>
+#include <Structures/StructPlacedInstance.hpp>
+#include <Structures/StructSymbolDisplayProp.hpp>
+#include <Structures/StructWireScalar.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+void addWire(OOCP::StreamPage& aPage, int32_t aStartX, int32_t aStartY, int32_t aEndX, int32_t aEndY)
+{
+    auto wire = std::make_unique<OOCP::StructWireScalar>(aPage.mCtx);
+
+    wire->startX = aStartX;
+    wire->startY = aStartY;
+    wire->endX   = aEndX;
+    wire->endY   = aEndY;
+
+    aPage.wires.push_back(std::move(wire));
+}
+} // namespace
+
+
+TEST_CASE("Simplify page geometry per zoom level", "[PageLod]")
+{
+    configure_spdlog();
+
+    // Package and page are created in memory s.t. no design file is required
+    InMemoryContainer container{"PageLodTest", "design.DSN"};
+
+    OOCP::ContainerContext& ctx = container.ctx;
+
+    // Package `R` with a 40 x 40 symbol
+    const auto package = add_package(ctx, "R");
+
+    auto line = std::make_unique<OOCP::PrimLine>(package->mCtx);
+    line->x2  = 40;
+    line->y2  = 40;
+
+    package->libraryParts.front()->primitives.push_back(std::move(line));
+
+    const auto page = add_page(ctx, "PAGE1");
+
+    OOCP::StructPlacedInstance& inst = add_instance(*page, "R1", "R");
+
+    inst.locX = 300;
+    inst.locY = 300;
+
+    // Two horizontal wires with a small gap, two vertical ones end on the first one
+    addWire(*page, 0, 0, 100, 0);
+    addWire(*page, 102, 0, 200, 0);
+    addWire(*page, 50, 0, 50, 100);
+    addWire(*page, 60, 0, 60, 100);
+
+    OOCP::BoundingBoxIndex bboxIndex{ctx};
+
+    bboxIndex.build();
+
+    OOCP::LodConfig cfg{};
+
+    cfg.mScales = {1.0, 0.25, 0.0625};
+
+    OOCP::LodBuilder builder{ctx, bboxIndex, cfg};
+
+    const auto lods = builder.buildAll();
+
+    REQUIRE(lods.size() == 1U);
+    REQUIRE(lods.front()->levels.size() == 3U);
+
+    const OOCP::LodLevel& detailed = lods.front()->levels[0];
+    const OOCP::LodLevel& medium   = lods.front()->levels[1];
+    const OOCP::LodLevel& coarse   = lods.front()->levels[2];
+
+    SECTION("Wires")
+    {
+        // The gap of 2 units is only closed once it is smaller than a pixel
+        CHECK(detailed.wires.size() == 4U);
+        CHECK(medium.wires.size() == 3U);
+        CHECK(coarse.wires.size() == 3U);
+    }
+
+    SECTION("Instances")
+    {
+        CHECK(detailed.detailedInstances.size() == 1U);
+        CHECK(detailed.instanceBoxes.empty());
+
+        // 40 units at 0.0625 pixel per unit are below the minimum symbol size
+        REQUIRE(coarse.instanceBoxes.size() == 1U);
+        CHECK(coarse.detailedInstances.empty());
+        CHECK(coarse.instanceBoxes.front() == bboxIndex.getPages().front().placedInstances.front());
+    }
+
+    SECTION("Junctions")
+    {
+        REQUIRE(detailed.junctions.size() == 2U);
+        CHECK(detailed.junctions[0].count == 1U);
+
+        // Junctions closer than the cluster size are merged
+        REQUIRE(coarse.junctions.size() == 1U);
+        CHECK(coarse.junctions.front().count == 2U);
+        CHECK(coarse.junctions.front().x == 55);
+        CHECK(coarse.junctions.front().y == 0);
+    }
+
+    SECTION("Cache")
+    {
+        CHECK(builder.getCacheSize() == 1U);
+        CHECK(builder.build(bboxIndex.getPages().front()) == lods.front());
+
+        // A modified page is built again
+        page->wires.front()->endX = 90;
+
+        const auto modified = builder.build(bboxIndex.getPages().front());
+
+        CHECK(modified != lods.front());
+        CHECK(builder.getCacheSize() == 2U);
+
+        builder.clearCache();
+
+        CHECK(builder.getCacheSize() == 0U);
+    }
+}
+
+
+TEST_CASE("Cluster junctions across cell borders", "[PageLod]")
+{
+    configure_spdlog();
+
+    InMemoryContainer container{"PageLodTest", "design.DSN"};
+
+    OOCP::ContainerContext& ctx = container.ctx;
+
+    const auto page = add_page(ctx, "PAGE1");
+
+    // Vertical wires end on the horizontal one, at a scale of 1/16 the
+    // cells are 64 units wide, i.e. x = 62 and x = 66 are in different cells
+    addWire(*page, 0, 0, 300, 0);
+
+    for(const int32_t x : {10, 62, 66, 200})
+    {
+        addWire(*page, x, 0, x, 100);
+    }
+
+    OOCP::BoundingBoxIndex bboxIndex{ctx};
+
+    bboxIndex.build();
+
+    OOCP::LodConfig cfg{};
+
+    cfg.mScales = {0.0625};
+
+    OOCP::LodBuilder builder{ctx, bboxIndex, cfg};
+
+    const auto lod = builder.build(bboxIndex.getPages().front());
+
+    const auto& junctions = lod->levels.front().junctions;
+
+    REQUIRE(junctions.size() == 2U);
+
+    // Junctions in neighbouring cells are merged if they are close to each other
+    CHECK(junctions[0].count == 3U);
+    CHECK(junctions[0].x == 46);
+
+    CHECK(junctions[1].count == 1U);
+    CHECK(junctions[1].x == 200);
+}
+
+
+TEST_CASE("Texts show the values of the displayed properties", "[PageLod]")
+{
+    configure_spdlog();
+
+    InMemoryContainer container{"PageLodTest", "design.DSN"};
+
+    OOCP::ContainerContext& ctx = container.ctx;
+
+    const auto lib = std::make_shared<OOCP::StreamLibrary>(ctx, ctx.mExtractedCfbfPath / "Library.bin");
+
+    lib->strLst = {"Value", "1k", "2k"};
+
+    ctx.mDb.mStreams.push_back(lib);
+
+    const auto page = add_page(ctx, "PAGE1");
+
+    page->mCtx.mNameValueMappings = {
+        OOCP::NameValueMapping{100U, OOCP::Structure::PlacedInstance, 0U, 1U}
+    };
+
+    OOCP::StructPlacedInstance& inst = add_instance(*page, "R1", "R");
+
+    inst.propOffset = 100U;
+
+    auto prop     = std::make_unique<OOCP::StructSymbolDisplayProp>(page->mCtx);
+    prop->nameIdx = 0U;
+
+    inst.symbolDisplayProps.push_back(std::move(prop));
+
+    OOCP::BoundingBoxIndex bboxIndex{ctx};
+
+    bboxIndex.build();
+
+    OOCP::LodConfig cfg{};
+
+    cfg.mScales = {1.0};
+
+    OOCP::LodBuilder builder{ctx, bboxIndex, cfg};
+
+    const auto lod = builder.build(bboxIndex.getPages().front());
+
+    REQUIRE(lod->levels.front().texts.size() == 1U);
+    CHECK(lod->levels.front().texts.front().text == "1k");
+
+    // A modified value is built again although the page geometry did not change
+    page->mCtx.mNameValueMappings.front().valueIdx = 2U;
+
+    const auto modified = builder.build(bboxIndex.getPages().front());
+
+    CHECK(modified != lod);
+    REQUIRE(modified->levels.front().texts.size() == 1U);
+    CHECK(modified->levels.front().texts.front().text == "2k");
+}
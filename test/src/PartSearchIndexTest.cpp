@@ -0,0 +1,109 @@
+#include <filesystem>
+
+#include <catch2/catch_all.hpp>
+
+#include <Container.hpp>
+#include <PartSearchIndex.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+TEST_CASE("0000: Search parts across libraries", "[PartSearchIndex]")
+{
+    configure_spdlog();
+
+    const fs::path inputFile{"test/test_cases/0000.OLB"};
+
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_PartSearchIndexTest";
+    fs::create_directories(tmpDir);
+
+    const fs::path copyFile = tmpDir / "0000_copy.OLB";
+    fs::copy_file(inputFile, copyFile, fs::copy_options::overwrite_existing);
+
+    OOCP::ParserConfig cfg = get_parser_config();
+
+    OOCP::PartSearchIndex index;
+
+    // Package `0000` with the reference designator prefix `U`
+    OOCP::Container parser{inputFile, cfg};
+
+    parser.parseDatabaseFile();
+
+    index.addLibrary(parser.getContext());
+
+    REQUIRE(index.getLibraryCtr() == 1U);
+    REQUIRE(index.getPartCtr() == 1U);
+
+    SECTION("Prefix")
+    {
+        const auto hits = index.findPrefix("00");
+
+        REQUIRE(hits.size() == 1U);
+        CHECK(hits.front().package == "0000");
+        CHECK(hits.front().library == inputFile.string());
+        CHECK(hits.front().score == 1.0);
+
+        // Case-insensitive
+        const auto refDesHits = index.findPrefix("U");
+
+        REQUIRE(refDesHits.size() == 1U);
+        CHECK(refDesHits.front().field == OOCP::PartSearchField::RefDes);
+        CHECK(refDesHits.front().term == "u");
+
+        CHECK(index.findPrefix("0001").empty());
+        CHECK(index.findPrefix("", 1U).size() == 1U);
+    }
+
+    SECTION("Substring")
+    {
+        const auto hits = index.findSubstring("000");
+
+        REQUIRE(hits.size() == 1U);
+        CHECK(hits.front().package == "0000");
+
+        CHECK(index.findSubstring("001").empty());
+    }
+
+    SECTION("Fuzzy")
+    {
+        const auto hits = index.findFuzzy("0001");
+
+        REQUIRE(hits.size() == 1U);
+        CHECK(hits.front().package == "0000");
+        CHECK(hits.front().score > 0.3);
+        CHECK(hits.front().score < 1.0);
+
+        CHECK(index.findFuzzy("0001", 100U, 0.9).empty());
+    }
+
+    SECTION("Add, replace and remove libraries")
+    {
+        OOCP::Container copy{copyFile, cfg};
+
+        copy.parseDatabaseFile();
+
+        index.addLibrary(copy.getContext());
+
+        CHECK(index.getLibraryCtr() == 2U);
+        CHECK(index.findPrefix("u").size() == 2U);
+
+        // Adding a library again replaces its previous index
+        index.addLibrary(copy.getContext());
+
+        CHECK(index.getLibraryCtr() == 2U);
+        CHECK(index.getPartCtr() == 2U);
+
+        CHECK(index.removeLibrary(inputFile.string()));
+        CHECK_FALSE(index.removeLibrary(inputFile.string()));
+
+        const auto hits = index.findPrefix("u");
+
+        REQUIRE(hits.size() == 1U);
+        CHECK(hits.front().library == copyFile.string());
+    }
+
+    fs::remove_all(tmpDir);
+}
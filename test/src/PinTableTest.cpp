@@ -0,0 +1,171 @@
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <ContainerContext.hpp>
+#include <Database.hpp>
+#include <PinTable.hpp>
+#include <Streams/StreamPackage.hpp>
+#include <Structures/StructDevice.hpp>
+#include <Structures/StructLibraryPart.hpp>
+#include <Structures/StructPackage.hpp>
+#include <Structures/StructPartCell.hpp>
+#include <Structures/StructSymbolPinScalar.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+void addView(OOCP::StreamPackage& aPackage, const std::string& aName, const std::vector<std::string>& aPinNames)
+{
+    auto view  = std::make_unique<OOCP::StructLibraryPart>(aPackage.mCtx);
+    view->name = aName;
+
+    for(const auto& pinName : aPinNames)
+    {
+        auto pin  = std::make_unique<OOCP::StructSymbolPinScalar>(aPackage.mCtx);
+        pin->name = pinName;
+
+        view->symbolPins.push_back(std::move(pin));
+    }
+
+    aPackage.libraryParts.push_back(std::move(view));
+}
+
+
+void addDevice(OOCP::StreamPackage& aPackage, const std::vector<std::string>& aPinMap)
+{
+    auto device    = std::make_unique<OOCP::StructDevice>(aPackage.mCtx);
+    device->pinMap = aPinMap;
+
+    device->pinIgnore.resize(aPinMap.size(), false);
+    device->pinGroup.resize(aPinMap.size(), OOCP::PinTable::NoGroup);
+
+    aPackage.package->devices.push_back(std::move(device));
+}
+
+
+std::shared_ptr<OOCP::StreamPackage> makePackage(OOCP::ContainerContext& aCtx, const std::string& aName)
+{
+    auto package = std::make_shared<OOCP::StreamPackage>(aCtx, aCtx.mExtractedCfbfPath / "Packages" / aName);
+
+    package->package       = std::make_unique<OOCP::StructPackage>(package->mCtx);
+    package->package->name = aName;
+
+    return package;
+}
+} // namespace
+
+
+TEST_CASE("Look up pins by number and name across units", "[PinTable]")
+{
+    configure_spdlog();
+
+    const fs::path tmpDir = fs::temp_directory_path() / "OpenOrCadParser_PinTableTest";
+
+    OOCP::Database db;
+
+    OOCP::ContainerContext ctx{fs::path{"library.OLB"}, tmpDir / "library", get_parser_config(), db};
+
+    SECTION("Homogeneous package")
+    {
+        // Two gates share the view, only the pin numbers differ
+        const auto package = makePackage(ctx, "7400");
+
+        addView(*package, "7400.Normal", {"A", "B", "Y"});
+        addDevice(*package, {"1", "2", "3"});
+        addDevice(*package, {"4", "5", "6"});
+
+        const OOCP::PinTable table{*package};
+
+        CHECK(table.getPackage() == "7400");
+        REQUIRE(table.getUnitCtr() == 2U);
+        REQUIRE(table.getPinCtr() == 6U);
+
+        const auto pin5 = table.findPinByNumber("5");
+
+        REQUIRE(pin5.has_value());
+        CHECK(table.getUnit(pin5.value()) == 1U);
+        CHECK(table.getPosition(pin5.value()) == 1U);
+        CHECK(table.getName(pin5.value()) == "B");
+
+        // Names are looked up per unit
+        const auto pinY = table.findPinByName(0U, "Y");
+
+        REQUIRE(pinY.has_value());
+        CHECK(table.getNumber(pinY.value()) == "3");
+        CHECK(table.getNumber(table.findPinByName(1U, "Y").value()) == "6");
+
+        CHECK(table.findPin(1U, 0U) == table.findPinByNumber("4"));
+
+        CHECK_FALSE(table.findPinByNumber("7").has_value());
+        CHECK_FALSE(table.findPinByName(2U, "A").has_value());
+        CHECK_FALSE(table.findPinByName(0U, "Z").has_value());
+    }
+
+    SECTION("Heterogeneous package")
+    {
+        // Each part cell has its own view, e.g. a relay with coil and contact
+        const auto package = makePackage(ctx, "RELAY");
+
+        addView(*package, "RELAY.Coil", {"COIL+", "COIL-"});
+        addView(*package, "RELAY.Contact", {"COM", "NO", "NC"});
+
+        for(const std::string viewName : {"RELAY.Coil", "RELAY.Contact"})
+        {
+            auto partCell        = std::make_unique<OOCP::StructPartCell>(package->mCtx);
+            partCell->normalName = viewName;
+
+            package->partCells.push_back(std::move(partCell));
+        }
+
+        addDevice(*package, {"1", "2"});
+        addDevice(*package, {"3", "4", "5"});
+
+        const auto views = OOCP::PinTable::getUnitViews(*package);
+
+        REQUIRE(views.size() == 2U);
+        CHECK(views.at(1U).normalView->name == "RELAY.Contact");
+        CHECK(views.at(1U).convertView == nullptr);
+
+        const OOCP::PinTable table{*package};
+
+        REQUIRE(table.getUnitCtr() == 2U);
+        REQUIRE(table.getPinCtr() == 5U);
+
+        const auto pin4 = table.findPinByNumber("4");
+
+        REQUIRE(pin4.has_value());
+        CHECK(table.getUnit(pin4.value()) == 1U);
+        CHECK(table.getName(pin4.value()) == "NO");
+
+        CHECK(table.getNumber(table.findPinByName(0U, "COIL-").value()) == "2");
+        CHECK_FALSE(table.findPinByName(0U, "COM").has_value());
+    }
+
+    SECTION("Pin tables of all packages")
+    {
+        const auto package = makePackage(ctx, "R");
+
+        addView(*package, "R.Normal", {"1", "2"});
+        addDevice(*package, {"1", "2"});
+
+        ctx.mDb.mStreams.push_back(package);
+
+        const auto tables = OOCP::buildPinTables(ctx);
+
+        REQUIRE(tables.size() == 1U);
+        CHECK(tables.at("R").getPinCtr() == 2U);
+    }
+
+    fs::remove_all(tmpDir);
+}
@@ -0,0 +1,117 @@
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <catch2/catch_all.hpp>
+
+#include <ContainerContext.hpp>
+#include <PropertyTable.hpp>
+#include <Streams/StreamLibrary.hpp>
+#include <Streams/StreamPackage.hpp>
+#include <Streams/StreamPage.hpp>
+#include <Structures/StructLibraryPart.hpp>
+#include <Structures/StructPackage.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+TEST_CASE("Collect properties into a table", "[PropertyTable]")
+{
+    configure_spdlog();
+
+    // Streams are created in memory s.t. no design file is required
+    InMemoryContainer container{"PropertyTableTest", "design.DSN"};
+
+    OOCP::ContainerContext& ctx = container.ctx;
+
+    const auto lib = std::make_shared<OOCP::StreamLibrary>(ctx, ctx.mExtractedCfbfPath / "Library.bin");
+
+    lib->strLst = {"Tolerance", "1%", "Power", "0.25W"};
+
+    ctx.mDb.mStreams.push_back(lib);
+
+    // Two instances with name/value mappings, the last one can not be resolved
+    const auto page = add_page(ctx, "PAGE1");
+
+    page->mCtx.mNameValueMappings = {
+        OOCP::NameValueMapping{100U, OOCP::Structure::PlacedInstance, 0U, 1U},
+        OOCP::NameValueMapping{100U, OOCP::Structure::PlacedInstance, 2U, 3U},
+        OOCP::NameValueMapping{200U, OOCP::Structure::PlacedInstance, 0U, 1U},
+        OOCP::NameValueMapping{300U, OOCP::Structure::PlacedInstance, 0U, 42U},
+    };
+
+    // Package `R` with the view `R.Normal`
+    const auto package = add_package(ctx, "R");
+
+    package->package->refDes       = "R";
+    package->package->pcbFootprint = "0603";
+
+    package->libraryParts.front()->generalProperties.partValue = "10k";
+
+    const OOCP::PropertyTable table{ctx};
+
+    REQUIRE(table.getObjectCtr() == 4U);
+
+    // Empty values are skipped
+    REQUIRE(table.getRowCtr() == 6U);
+
+    const std::string pageLocation = to_string(page->mCtx.mCfbfStreamLocation);
+
+    SECTION("Name/value mappings")
+    {
+        const auto object = table.findObject(pageLocation, 100U);
+
+        REQUIRE(object.has_value());
+        CHECK(table.getSource(object.value()) == OOCP::PropertySource::NameValue);
+        CHECK(table.getStructure(object.value()) == OOCP::Structure::PlacedInstance);
+        CHECK(table.getOffset(object.value()) == 100U);
+        CHECK(table.getName(object.value()).empty());
+
+        CHECK(table.findValue(object.value(), "Tolerance") == "1%");
+        CHECK(table.findValue(object.value(), "Power") == "0.25W");
+        CHECK_FALSE(table.findValue(object.value(), "Value").has_value());
+
+        const auto rows = table.getRows(object.value());
+
+        REQUIRE(rows.size() == 2U);
+        CHECK(table.getKey(rows[0]) == "Tolerance");
+        CHECK(table.getKey(rows[1]) == "Power");
+
+        CHECK(table.findObject(pageLocation, 200U).has_value());
+        CHECK_FALSE(table.findObject(pageLocation, 300U).has_value());
+        CHECK_FALSE(table.findObject("DOES_NOT_EXIST", 100U).has_value());
+    }
+
+    SECTION("Package properties")
+    {
+        const auto rows = table.findRows("Part Reference Prefix");
+
+        REQUIRE(rows.size() == 1U);
+
+        const std::size_t object = table.getObject(rows.front());
+
+        CHECK(table.getSource(object) == OOCP::PropertySource::Package);
+        CHECK(table.getName(object) == "R");
+        CHECK(table.getOffset(object) == OOCP::PropertyTable::NoOffset);
+        CHECK(table.findValue(object, "PCB Footprint") == "0603");
+
+        const auto valueRows = table.findRows("Value");
+
+        REQUIRE(valueRows.size() == 1U);
+        CHECK(table.getName(table.getObject(valueRows.front())) == "R.Normal");
+        CHECK(table.getSource(table.getObject(valueRows.front())) == OOCP::PropertySource::GeneralProperties);
+    }
+
+    SECTION("Find rows by key and value")
+    {
+        CHECK(table.findRows("Tolerance").size() == 2U);
+        CHECK(table.findRows("Tolerance", "1%").size() == 2U);
+        CHECK(table.findRows("Tolerance", "5%").empty());
+        CHECK(table.findRows("Power", "1%").empty());
+        CHECK(table.findRows("DOES_NOT_EXIST").empty());
+    }
+}
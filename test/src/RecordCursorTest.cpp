@@ -0,0 +1,155 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <ContainerContext.hpp>
+#include <RecordCursor.hpp>
+#include <StreamContext.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+// Each byte is a record, 0 marks a record that is skipped by the parser
+bool readByte(OOCP::StreamContext& aCtx, std::unique_ptr<uint8_t>& aRecord)
+{
+    if(aCtx.mDs.isEoF())
+    {
+        return false;
+    }
+
+    const uint8_t val = aCtx.mDs.readUint8();
+
+    if(val != 0U)
+    {
+        aRecord = std::make_unique<uint8_t>(val);
+    }
+
+    // Record references like the parser does for indices into the string list
+    aCtx.mStrLstRefs.push_back(aCtx.mDs.getCurrentOffset());
+    aCtx.mNameValueMappings.push_back(OOCP::NameValueMapping{});
+
+    return true;
+}
+} // namespace
+
+
+TEST_CASE("Decode records one at a time", "[RecordCursor]")
+{
+    configure_spdlog();
+
+    InMemoryContainer container{"RecordCursorTest", "design.DSN"};
+
+    OOCP::ContainerContext& ctx = container.ctx;
+
+    const fs::path inputStream = ctx.mExtractedCfbfPath / "Records.bin";
+
+    fs::create_directories(inputStream.parent_path());
+
+    {
+        std::ofstream os{inputStream, std::ios::out | std::ios::binary | std::ios::trunc};
+
+        const std::vector<char> data{1, 0, 2, 0, 0, 3};
+
+        os.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    const OOCP::StreamContext streamCtx{ctx, inputStream};
+
+    const auto makeCursor = [&streamCtx]()
+    {
+        return OOCP::RecordCursor<uint8_t>{std::make_unique<OOCP::StreamContext>(streamCtx), readByte};
+    };
+
+    SECTION("Iterate")
+    {
+        auto cursor = makeCursor();
+
+        std::vector<uint8_t> records;
+
+        for(const auto& record : cursor)
+        {
+            records.push_back(record);
+        }
+
+        // Skipped records are not visited
+        CHECK(records == std::vector<uint8_t>{1U, 2U, 3U});
+        CHECK(cursor.getCtr() == 3U);
+
+        CHECK_FALSE(cursor.next());
+        CHECK(cursor.getCtr() == 3U);
+    }
+
+    SECTION("Advance and release")
+    {
+        auto cursor = makeCursor();
+
+        REQUIRE(cursor.next());
+        CHECK(cursor.get() == 1U);
+
+        // Released records are kept beyond the next advance
+        const std::unique_ptr<uint8_t> first = cursor.release();
+
+        REQUIRE(cursor.next());
+        CHECK(cursor.get() == 2U);
+
+        REQUIRE(first);
+        CHECK(*first == 1U);
+
+        // `begin` continues with the current record
+        std::vector<uint8_t> records;
+
+        for(const auto& record : cursor)
+        {
+            records.push_back(record);
+        }
+
+        CHECK(records == std::vector<uint8_t>{2U, 3U});
+    }
+
+    SECTION("Independent cursors")
+    {
+        auto cursor = makeCursor();
+        auto other  = makeCursor();
+
+        REQUIRE(cursor.next());
+        REQUIRE(cursor.next());
+
+        // Each cursor reads the stream through its own context
+        REQUIRE(other.next());
+        CHECK(other.get() == 1U);
+        CHECK(cursor.get() == 2U);
+    }
+
+    SECTION("References are bounded")
+    {
+        auto cursor = makeCursor();
+
+        std::size_t ctr = 0U;
+
+        while(cursor.next())
+        {
+            // Only the references of the current record and the skipped ones before it are kept
+            const OOCP::StreamRefsMark mark = cursor.getRefsMark();
+
+            CHECK(mark.strLstRefs <= 3U);
+            CHECK(mark.nameValueMappings == mark.strLstRefs);
+            CHECK(mark.fontIdxRefs == 0U);
+            CHECK(mark.blobRefs == 0U);
+
+            ++ctr;
+        }
+
+        CHECK(ctr == 3U);
+        CHECK(cursor.getRefsMark().strLstRefs == 0U);
+    }
+}
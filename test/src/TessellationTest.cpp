@@ -0,0 +1,153 @@
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+#include <utility>
+
+#include <catch2/catch_all.hpp>
+
+#include <Tessellation.hpp>
+
+
+namespace
+{
+constexpr double Tolerance = 0.5;
+
+// Rounding of the rotation recurrence and forward differencing
+constexpr double Epsilon = 1e-6;
+
+
+double getDistance(double aX0, double aY0, double aX1, double aY1)
+{
+    return std::hypot(aX1 - aX0, aY1 - aY0);
+}
+} // namespace
+
+
+TEST_CASE("Tessellate elliptic arcs within the tolerance", "[Tessellation]")
+{
+    OOCP::EllipticArcBatch arcs;
+
+    // More arcs than processed in one group, with a partially filled last group
+    arcs.add(0.0, 0.0, 100.0, 100.0, 0.0, 2.0 * std::numbers::pi);
+    arcs.add(50.0, -20.0, 200.0, 50.0, std::numbers::pi / 4.0, std::numbers::pi / 2.0);
+    arcs.add(-10.0, 10.0, 5.0, 5.0, std::numbers::pi, std::numbers::pi);
+    arcs.add(0.0, 0.0, 1000.0, 400.0, 0.0, 3.0 * std::numbers::pi / 2.0);
+    arcs.add(300.0, 300.0, 30.0, 60.0, -std::numbers::pi / 2.0, std::numbers::pi / 3.0);
+    arcs.add(0.0, 0.0, 1.0, 1.0, 0.0, 0.1);
+
+    OOCP::PolylineBatch polylines;
+
+    OOCP::tessellate(arcs, Tolerance, polylines);
+
+    REQUIRE(polylines.size() == arcs.size());
+    REQUIRE(polylines.x.size() == polylines.ranges.back());
+    REQUIRE(polylines.y.size() == polylines.ranges.back());
+
+    for(std::size_t i = 0U; i < arcs.size(); ++i)
+    {
+        INFO(i);
+
+        const std::size_t first = polylines.ranges[i];
+        const std::size_t n     = polylines.ranges[i + 1U] - first - 1U;
+
+        REQUIRE(n == OOCP::getArcSegmentCount(arcs.radiusX[i], arcs.radiusY[i], arcs.sweep[i], Tolerance));
+
+        const auto getPoint = [&](double aT)
+        {
+            const double angle = arcs.startAngle[i] + arcs.sweep[i] * aT;
+
+            return std::make_pair(arcs.centerX[i] + arcs.radiusX[i] * std::cos(angle),
+                arcs.centerY[i] - arcs.radiusY[i] * std::sin(angle));
+        };
+
+        for(std::size_t k = 0U; k <= n; ++k)
+        {
+            const auto [x, y] = getPoint(static_cast<double>(k) / n);
+
+            CHECK(getDistance(polylines.x[first + k], polylines.y[first + k], x, y) < Epsilon);
+        }
+
+        // Deviation of each chord from the curve
+        for(std::size_t k = 0U; k < n; ++k)
+        {
+            const auto [x, y] = getPoint((k + 0.5) / n);
+
+            const double midX = (polylines.x[first + k] + polylines.x[first + k + 1U]) / 2.0;
+            const double midY = (polylines.y[first + k] + polylines.y[first + k + 1U]) / 2.0;
+
+            CHECK(getDistance(midX, midY, x, y) <= Tolerance + Epsilon);
+        }
+    }
+}
+
+
+TEST_CASE("Keep at least 4 segments for a full ellipse", "[Tessellation]")
+{
+    CHECK(OOCP::getArcSegmentCount(1.0, 1.0, 2.0 * std::numbers::pi, 100.0) == 4U);
+    CHECK(OOCP::getArcSegmentCount(0.0, 0.0, 2.0 * std::numbers::pi, 0.5) == 1U);
+}
+
+
+TEST_CASE("Tessellate bezier segments within the tolerance", "[Tessellation]")
+{
+    OOCP::BezierBatch beziers;
+
+    beziers.add(0.0, 0.0, 100.0, 0.0, 100.0, 100.0, 0.0, 100.0);
+    beziers.add(0.0, 0.0, 10.0, 10.0, 20.0, 20.0, 30.0, 30.0);
+    beziers.add(-50.0, 20.0, 400.0, -300.0, -400.0, -300.0, 50.0, 20.0);
+    beziers.add(0.0, 0.0, 0.0, 1000.0, 1000.0, 1000.0, 1000.0, 0.0);
+    beziers.add(5.0, 5.0, 6.0, 4.0, 7.0, 6.0, 8.0, 5.0);
+
+    OOCP::PolylineBatch polylines;
+
+    OOCP::tessellate(beziers, Tolerance, polylines);
+
+    REQUIRE(polylines.size() == beziers.size());
+
+    for(std::size_t i = 0U; i < beziers.size(); ++i)
+    {
+        INFO(i);
+
+        const std::size_t first = polylines.ranges[i];
+        const std::size_t n     = polylines.ranges[i + 1U] - first - 1U;
+
+        const auto getPoint = [&](double aT)
+        {
+            const double u = 1.0 - aT;
+
+            const double b0 = u * u * u;
+            const double b1 = 3.0 * u * u * aT;
+            const double b2 = 3.0 * u * aT * aT;
+            const double b3 = aT * aT * aT;
+
+            return std::make_pair(
+                b0 * beziers.x0[i] + b1 * beziers.x1[i] + b2 * beziers.x2[i] + b3 * beziers.x3[i],
+                b0 * beziers.y0[i] + b1 * beziers.y1[i] + b2 * beziers.y2[i] + b3 * beziers.y3[i]);
+        };
+
+        CHECK(polylines.x[first] == beziers.x0[i]);
+        CHECK(polylines.y[first] == beziers.y0[i]);
+        CHECK(polylines.x[first + n] == beziers.x3[i]);
+        CHECK(polylines.y[first + n] == beziers.y3[i]);
+
+        for(std::size_t k = 0U; k <= n; ++k)
+        {
+            const auto [x, y] = getPoint(static_cast<double>(k) / n);
+
+            CHECK(getDistance(polylines.x[first + k], polylines.y[first + k], x, y) < Epsilon);
+        }
+
+        for(std::size_t k = 0U; k < n; ++k)
+        {
+            const auto [x, y] = getPoint((k + 0.5) / n);
+
+            const double midX = (polylines.x[first + k] + polylines.x[first + k + 1U]) / 2.0;
+            const double midY = (polylines.y[first + k] + polylines.y[first + k + 1U]) / 2.0;
+
+            CHECK(getDistance(midX, midY, x, y) <= Tolerance + Epsilon);
+        }
+    }
+
+    // Straight lines are not subdivided
+    CHECK(polylines.ranges[2U] - polylines.ranges[1U] == 2U);
+}
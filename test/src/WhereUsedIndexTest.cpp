@@ -0,0 +1,161 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <catch2/catch_all.hpp>
+
+#include <ContainerContext.hpp>
+#include <Streams/StreamPage.hpp>
+#include <Structures/StructPlacedInstance.hpp>
+#include <WhereUsedIndex.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+void writeFile(const fs::path& aPath, const std::string& aContent)
+{
+    fs::create_directories(aPath.parent_path());
+
+    std::ofstream os{aPath, std::ios::out | std::ios::binary | std::ios::trunc};
+
+    os << aContent;
+}
+
+
+// Pages are hashed by their raw stream, therefore a stand-in stream file is written as well
+std::shared_ptr<OOCP::StreamPage> addPage(OOCP::ContainerContext& aCtx, const std::string& aName)
+{
+    const auto page = add_page(aCtx, aName);
+
+    writeFile(page->mCtx.mInputStream, aName);
+
+    return page;
+}
+
+
+void addInstance(OOCP::StreamPage& aPage, uint32_t aDbId, const std::string& aReference, const std::string& aPkgName)
+{
+    add_instance(aPage, aReference, aPkgName).dbId = aDbId;
+}
+} // namespace
+
+
+TEST_CASE("Find usages of library packages in designs", "[WhereUsedIndex]")
+{
+    configure_spdlog();
+
+    // Library and design are created in memory s.t. no design file is required
+    InMemoryContainer library{"WhereUsedIndexTest_Library", "library.OLB"};
+    InMemoryContainer design{"WhereUsedIndexTest", "design.DSN"};
+
+    OOCP::ContainerContext& libCtx = library.ctx;
+    OOCP::ContainerContext& ctx    = design.ctx;
+
+    // Package `R` with the view `R.Normal`
+    add_package(libCtx, "R");
+
+    const auto page1 = addPage(ctx, "PAGE1");
+
+    addInstance(*page1, 2U, "R2", "R.Normal");
+    addInstance(*page1, 1U, "R1", "R");
+    addInstance(*page1, 3U, "C1", "C");
+
+    const auto page2 = addPage(ctx, "PAGE2");
+
+    addInstance(*page2, 4U, "R3", "R.Normal");
+
+    OOCP::WhereUsedIndex index;
+
+    CHECK_FALSE(index.isUpToDate(ctx));
+
+    index.addLibrary(libCtx);
+
+    REQUIRE(index.updateDesign(ctx) == 2U);
+    CHECK(index.getDesignCtr() == 1U);
+    CHECK(index.getInstanceCtr() == 4U);
+    CHECK(index.isUpToDate(ctx));
+
+    SECTION("Find usages")
+    {
+        // The library maps the package to all names it can be placed with
+        const auto usages = index.findUsages(libCtx.mInputCfbfFile.string(), "R");
+
+        REQUIRE(usages.size() == 3U);
+        CHECK(usages[0].reference == "R1");
+        CHECK(usages[0].page == "PAGE1");
+        CHECK(usages[0].design == ctx.mInputCfbfFile.string());
+        CHECK(usages[1].reference == "R2");
+        CHECK(usages[1].pkgName == "R.Normal");
+        CHECK(usages[2].reference == "R3");
+        CHECK(usages[2].page == "PAGE2");
+
+        // Without the library only the package name itself is known
+        CHECK(index.findUsages("unknown.OLB", "R").size() == 1U);
+        CHECK(index.findUsages("R.Normal").size() == 2U);
+        CHECK(index.findUsages("C").size() == 1U);
+        CHECK(index.findUsages("L").empty());
+
+        CHECK(index.getPageHash(ctx.mInputCfbfFile.string(), usages[0].streamLocation) != 0U);
+        CHECK(index.getPageHash(ctx.mInputCfbfFile.string(), "DOES_NOT_EXIST") == 0U);
+    }
+
+    SECTION("Update changed pages")
+    {
+        // Unchanged pages are not indexed again
+        CHECK(index.updateDesign(ctx) == 0U);
+
+        writeFile(page2->mCtx.mInputStream, "PAGE2 modified");
+
+        CHECK_FALSE(index.isUpToDate(ctx));
+
+        page2->placedInstances.front()->pkgName = "C";
+
+        CHECK(index.updateDesign(ctx) == 1U);
+        CHECK(index.isUpToDate(ctx));
+        CHECK(index.findUsages("R.Normal").size() == 1U);
+        CHECK(index.findUsages("C").size() == 2U);
+
+        // Removed page streams are detected before the design is parsed again
+        fs::remove(page2->mCtx.mInputStream);
+
+        CHECK_FALSE(index.isUpToDate(ctx));
+    }
+
+    SECTION("Save and load")
+    {
+        const fs::path indexFile = design.tmpDir.getPath() / "where_used.idx";
+
+        index.save(indexFile);
+
+        OOCP::WhereUsedIndex loaded;
+
+        loaded.load(indexFile);
+
+        CHECK(loaded.getDesignCtr() == 1U);
+        CHECK(loaded.getInstanceCtr() == 4U);
+        CHECK(loaded.isUpToDate(ctx));
+        CHECK(loaded.findUsages(libCtx.mInputCfbfFile.string(), "R").size() == 3U);
+
+        // Corrupted files are rejected
+        writeFile(indexFile, "OOCPWUI");
+
+        CHECK_THROWS(loaded.load(indexFile));
+    }
+
+    SECTION("Remove design")
+    {
+        CHECK(index.removeDesign(ctx.mInputCfbfFile.string()));
+        CHECK_FALSE(index.removeDesign(ctx.mInputCfbfFile.string()));
+
+        CHECK(index.getDesignCtr() == 0U);
+        CHECK(index.findUsages("R").empty());
+        CHECK_FALSE(index.isUpToDate(ctx));
+    }
+}
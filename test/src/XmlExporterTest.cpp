@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+#include <fmt/core.h>
+
+#include <Container.hpp>
+#include <XmlExporter.hpp>
+#include <XmlWriter.hpp>
+
+#include "Helper.hpp"
+
+
+namespace fs = std::filesystem;
+
+
+namespace
+{
+using Attributes = std::map<std::string, std::string>;
+
+
+// `Defn` elements by the path of their parent elements, e.g. `Lib/Package/LibPart`, in document order
+std::map<std::string, std::vector<Attributes>> getDefns(const fs::path& aXmlFile)
+{
+    std::ifstream is{aXmlFile};
+    std::stringstream ss;
+    ss << is.rdbuf();
+
+    const std::string xml = ss.str();
+
+    const std::regex tagRegex{R"(<(/?)([A-Za-z]\w*)([^>]*?)(/?)>)"};
+    const std::regex attrRegex{R"(([\w:]+)=\"([^\"]*)\")"};
+
+    std::map<std::string, std::vector<Attributes>> defns;
+    std::vector<std::string> elements;
+
+    for(auto it = std::sregex_iterator{xml.cbegin(), xml.cend(), tagRegex}; it != std::sregex_iterator{}; ++it)
+    {
+        const std::smatch& tag = *it;
+
+        const bool isEndTag      = tag[1].length() > 0;
+        const bool isSelfClosing = tag[4].length() > 0;
+
+        if(isEndTag)
+        {
+            elements.pop_back();
+            continue;
+        }
+
+        if(tag[2] == "Defn")
+        {
+            std::string path;
+
+            for(const auto& element : elements)
+            {
+                path += path.empty() ? element : "/" + element;
+            }
+
+            Attributes attributes;
+
+            const std::string attrs = tag[3];
+
+            for(auto attrIt = std::sregex_iterator{attrs.cbegin(), attrs.cend(), attrRegex};
+                attrIt != std::sregex_iterator{}; ++attrIt)
+            {
+                attributes[(*attrIt)[1]] = (*attrIt)[2];
+            }
+
+            defns[path].push_back(attributes);
+        }
+
+        if(!isSelfClosing)
+        {
+            elements.push_back(tag[2]);
+        }
+    }
+
+    return defns;
+}
+
+
+std::string getElement(const std::string& aPath)
+{
+    return aPath.substr(aPath.find_last_of('/') + 1U);
+}
+
+
+std::string toLower(std::string aStr)
+{
+    std::transform(aStr.begin(), aStr.end(), aStr.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    return aStr;
+}
+} // namespace
+
+
+TEST_CASE("Compare XML export with OrCAD's XML export", "[XmlExporter]")
+{
+    configure_spdlog();
+
+    const std::string testCase = GENERATE("0000", "0001", "0002", "0003", "0004", "0005", "0006", "0007");
+
+    INFO(testCase);
+
+    const fs::path inputFile{fmt::format("test/test_cases/{}.OLB", testCase)};
+    const fs::path referenceFile{fmt::format("test/test_cases/{}.xml", testCase)};
+
+    const fs::path outDir = fs::temp_directory_path() / "OpenOrCadParser_XmlExporterTest";
+
+    OOCP::ParserConfig cfg = get_parser_config();
+
+    OOCP::Container parser{inputFile, cfg};
+
+    parser.parseDatabaseFile();
+
+    OOCP::XmlExporter exporter{parser.getContext()};
+
+    auto actual   = getDefns(exporter.exportXml(outDir));
+    auto expected = getDefns(referenceFile);
+
+    fs::remove_all(outDir);
+
+    // Elements that are not exported yet
+    const std::set<std::string> notExported{
+        "DefaultDrawnInstIsPrimitive", "DefaultPlacedInstIsPrimitive", "PropDispType", "SymbolColor"};
+
+    // Attributes that are not decoded yet and therefore omitted by the exporter
+    const std::map<std::string, std::set<std::string>> notDecoded{
+        {"CommentText", {"textJustification"}},
+        {"Package", {"alphabeticNumbering", "pcbLib", "timestamp", "timezone"}},
+        {"SymbolDisplayProp", {"textJustification"}},
+        {"SymbolPinBus", {"position", "visible"}},
+        {"SymbolPinScalar", {"position", "visible"}}
+    };
+
+    // OrCAD stores the absolute path of the library it exported
+    REQUIRE(actual.count("Lib") == 1U);
+    REQUIRE(expected.count("Lib") == 1U);
+
+    std::string expectedName = expected.at("Lib").front().at("name");
+    expectedName             = expectedName.substr(expectedName.find_last_of('\\') + 1U);
+
+    CHECK(toLower(expectedName) == toLower(inputFile.filename().string()));
+
+    actual.erase("Lib");
+    expected.erase("Lib");
+
+    for(auto it = expected.begin(); it != expected.end();)
+    {
+        it = notExported.count(getElement(it->first)) > 0U ? expected.erase(it) : std::next(it);
+    }
+
+    for(const auto& [path, defns] : actual)
+    {
+        INFO(path);
+
+        CHECK(expected.count(path) == 1U);
+    }
+
+    for(auto& [path, expectedDefns] : expected)
+    {
+        INFO(path);
+
+        REQUIRE(actual.count(path) == 1U);
+
+        const std::vector<Attributes>& actualDefns = actual.at(path);
+
+        REQUIRE(actualDefns.size() == expectedDefns.size());
+
+        const auto omittedIt = notDecoded.find(getElement(path));
+
+        for(std::size_t i = 0U; i < actualDefns.size(); ++i)
+        {
+            if(omittedIt != notDecoded.cend())
+            {
+                for(const auto& name : omittedIt->second)
+                {
+                    expectedDefns[i].erase(name);
+                }
+            }
+
+            CHECK(actualDefns[i] == expectedDefns[i]);
+        }
+    }
+}
+
+
+TEST_CASE("Escape and transcode attribute values", "[XmlExporter]")
+{
+    CHECK(OOCP::XmlWriter::escape("a<b & \"c\">") == "a&lt;b &amp; &quot;c&quot;&gt;");
+    CHECK(OOCP::XmlWriter::escape("\t\n\r") == "&#x9;&#xA;&#xD;");
+
+    // CP1252 `µ`, `°` and `€` are transcoded to UTF-8
+    CHECK(OOCP::XmlWriter::escape("10\xb5H 5\xb0 \x80") == "10\xc2\xb5H 5\xc2\xb0 \xe2\x82\xac");
+
+    // Control characters are not allowed in XML
+    CHECK(OOCP::XmlWriter::escape(std::string{"a\x01\x1f" "b"}) == "a\xef\xbf\xbd\xef\xbf\xbd" "b");
+}